@@ -2,10 +2,13 @@
 
 #include <functional>
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/pure.h"
 #include "envoy/network/address.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "source/common/common/assert.h"
+
 namespace Envoy {
 namespace Io {
 
@@ -29,7 +32,10 @@ public:
     Shutdown = 0x40,
   };
 
-  Request(RequestType type, IoUringSocket& socket) : type_(type), socket_(socket) {}
+  Request(RequestType type, IoUringSocket& socket) : type_(type), socket_(&socket) {}
+  // A request which does not belong to an io_uring socket, e.g. a file read. The completions of
+  // such requests must be handled by whoever owns the ring rather than by an IoUringWorker.
+  explicit Request(RequestType type) : type_(type) {}
   virtual ~Request() = default;
 
   /**
@@ -40,11 +46,14 @@ public:
   /**
    * Returns the io_uring socket the request belongs to.
    */
-  IoUringSocket& socket() const { return socket_; }
+  IoUringSocket& socket() const {
+    ASSERT(socket_ != nullptr);
+    return *socket_;
+  }
 
 private:
   RequestType type_;
-  IoUringSocket& socket_;
+  IoUringSocket* socket_{};
 };
 
 /**
@@ -52,9 +61,12 @@ private:
  * @param user_data is any data attached to an entry submitted to the submission
  * queue.
  * @param result is a return code of submitted system call.
+ * @param flags is the IORING_CQE_F_* flags of the completion entry. It is always 0 for injected
+ * completions.
  * @param injected indicates whether the completion is injected or not.
  */
-using CompletionCb = std::function<void(Request* user_data, int32_t result, bool injected)>;
+using CompletionCb =
+    std::function<void(Request* user_data, int32_t result, uint32_t flags, bool injected)>;
 
 /**
  * Callback for releasing the user data.
@@ -118,6 +130,17 @@ public:
   virtual IoUringResult prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                      off_t offset, Request* user_data) PURE;
 
+  /**
+   * Prepares a multishot recv system call and puts it into the submission queue. The request
+   * keeps posting a completion for every receive into a buffer selected from the provided buffer
+   * ring until it fails, is canceled or the peer closes the connection. Completions carry the
+   * IORING_CQE_F_MORE flag as long as the request remains armed. Requires
+   * registerProvidedBuffers() to have succeeded.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareRecvMultishot(os_fd_t fd, Request* user_data) PURE;
+
   /**
    * Prepares a writev system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -147,6 +170,37 @@ public:
    */
   virtual IoUringResult prepareShutdown(os_fd_t fd, int how, Request* user_data) PURE;
 
+  /**
+   * Registers a ring of provided buffers with the kernel, used by requests prepared with
+   * prepareRecvMultishot(). The buffers are owned by the ring and lent out as buffer fragments
+   * by takeProvidedBuffer().
+   * Returns IoUringResult::Failed if the kernel does not support provided buffer rings and
+   * IoUringResult::Ok otherwise.
+   * @param count the number of buffers in the ring. Rounded up to a power of 2.
+   * @param buffer_size the size in bytes of each buffer.
+   */
+  virtual IoUringResult registerProvidedBuffers(uint32_t count, uint32_t buffer_size) PURE;
+
+  /**
+   * Returns the number of provided buffers currently available to the kernel. Zero if no provided
+   * buffer ring is registered.
+   */
+  virtual uint32_t availableProvidedBuffers() const PURE;
+
+  /**
+   * Takes ownership of the provided buffer selected by the kernel for a completion. The returned
+   * fragment hands the buffer back to the ring once it is done, which may happen on any thread.
+   * @param buffer_id the buffer id from the IORING_CQE_F_BUFFER completion flags.
+   * @param length the number of bytes of data in the buffer.
+   */
+  virtual Buffer::BufferFragment* takeProvidedBuffer(uint16_t buffer_id, uint32_t length) PURE;
+
+  /**
+   * Hands a provided buffer selected by the kernel back to the ring without consuming its data.
+   * @param buffer_id the buffer id from the IORING_CQE_F_BUFFER completion flags.
+   */
+  virtual void recycleProvidedBuffer(uint16_t buffer_id) PURE;
+
   /**
    * Submits the entries in the submission queue to the kernel using the
    * `io_uring_enter()` system call.
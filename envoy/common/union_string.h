@@ -125,6 +125,18 @@ public:
                    absl::get<InlinedStringVector>(buffer_).begin(), unary_op);
   }
 
+  /**
+   * Transforms the inlined vector data in place by handing the whole buffer to the given
+   * operation at once. Prefer this over inlineTransform() for transforms that work on blocks of
+   * characters, e.g. vectorized case folding.
+   * @param op callable with the signature void(char* data, size_t size).
+   */
+  template <typename BufferOperation> void inlineTransformBuffer(BufferOperation&& op) {
+    ASSERT(type() == Type::Inline);
+    InlinedStringVector& buffer = absl::get<InlinedStringVector>(buffer_);
+    op(buffer.data(), buffer.size());
+  }
+
   /**
    * Trim trailing whitespaces from the InlinedString. Only supported by the "Inline" InlinedString
    * representation.
@@ -81,6 +81,19 @@ public:
    */
   virtual ProtobufTypes::MessagePtr decodeResource(const Protobuf::Any& resource) PURE;
 
+  /**
+   * Decodes a resource into a message allocated on an arena, so that the resources of a large
+   * response can be decoded with a small number of allocations.
+   * @param resource some opaque resource (Protobuf::Any).
+   * @param arena the arena to allocate the decoded message on. The message lives as long as the
+   *        arena.
+   * @return Protobuf::Message* the decoded message, or nullptr if the decoder does not support
+   *         arenas, in which case decodeResource() is used instead.
+   */
+  virtual Protobuf::Message* decodeResourceOnArena(const Protobuf::Any&, Protobuf::Arena&) {
+    return nullptr;
+  }
+
   /**
    * @param resource some opaque resource (Protobuf::Message).
    * @return std::String the resource name in a Protobuf::Message returned by decodeResource(), e.g.
@@ -12,6 +12,7 @@
 
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -77,6 +78,15 @@ public:
    */
   virtual Api::IoCallSizeResult write(absl::string_view buffer) PURE;
 
+  /**
+   * Write the buffers to the file in order, with as few system calls as the platform allows. The
+   * file must be explicitly opened before writing. Like write(), this may write fewer bytes than
+   * the buffers hold in total.
+   *
+   * @return ssize_t number of bytes written, or -1 for failure
+   */
+  virtual Api::IoCallSizeResult writev(absl::Span<const absl::string_view> buffers) PURE;
+
   /**
    * Get additional details about the file. May or may not require a file system operation.
    *
@@ -186,6 +186,11 @@ public:
     MustStaple,
   };
 
+  struct SessionCacheConfig {
+    uint64_t max_size_bytes_;
+    uint32_t shard_count_;
+  };
+
   /**
    * @return True if client certificate is required, false otherwise.
    */
@@ -220,6 +225,12 @@ public:
    */
   virtual bool disableStatefulSessionResumption() const PURE;
 
+  /**
+   * @return the configuration of the shared server-side session cache, if one is configured. If
+   * not set, stateful resumption uses the TLS library's internal cache.
+   */
+  virtual const absl::optional<SessionCacheConfig>& sessionCacheConfig() const PURE;
+
   /**
    * @return True if we allow full scan certificates when there is no cert matching SNI during
    * downstream TLS handshake, false otherwise.
@@ -10,6 +10,7 @@
 
 #include "envoy/common/pure.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/stats_matcher.h"
 #include "envoy/stats/tag.h"
 
 #include "absl/strings/string_view.h"
@@ -99,6 +100,15 @@ public:
    */
   virtual void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) PURE;
 
+  /**
+   * Set the matcher selecting counters that are stored sharded across threads. Counters whose
+   * names are accepted by the matcher spread their increments over per-thread cache-line sized
+   * slots that are summed when read, trading memory and read cost for contention-free increments.
+   * Only counters created after this call are affected.
+   * @param matcher supplies the matcher; counters rejected by it use the regular representation.
+   */
+  virtual void setShardedCounterMatcher(StatsMatcherPtr&& matcher) PURE;
+
   // TODO(jmarantz): create a parallel mechanism to instantiate histograms. At
   // the moment, histograms don't fit the same pattern of counters and gauges
   // as they are not actually created in the context of a stats allocator.
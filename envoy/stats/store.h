@@ -243,6 +243,13 @@ public:
    */
   virtual void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) PURE;
 
+  /**
+   * Attach a StatsMatcher selecting the counters that should be stored sharded across threads.
+   * See Allocator::setShardedCounterMatcher().
+   * @param matcher a StatsMatcher accepting the counters to shard.
+   */
+  virtual void setShardedCounterMatcher(StatsMatcherPtr&& matcher) PURE;
+
   /**
    * Initialize the store for threading. This will be called once after all worker threads have
    * been initialized. At this point the store can initialize itself for multi-threaded operation.
@@ -288,6 +288,22 @@ public:
   addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                      const std::string& version_info, const bool avoid_cds_removal = false) PURE;
 
+  /**
+   * Same as addOrUpdateCluster(), for callers that have already computed the config hash, e.g. off
+   * the main thread while processing a large CDS update.
+   *
+   * @param cluster supplies the cluster configuration.
+   * @param version_info supplies the xDS version of the cluster.
+   * @param config_hash supplies MessageUtil::hash() of the cluster configuration.
+   * @param avoid_cds_removal see addOrUpdateCluster().
+   * @return true if the action results in an add/update of a cluster, an error
+   * status if the config is invalid.
+   */
+  virtual absl::StatusOr<bool>
+  addOrUpdateClusterWithHash(const envoy::config::cluster::v3::Cluster& cluster,
+                             const std::string& version_info, uint64_t config_hash,
+                             const bool avoid_cds_removal = false) PURE;
+
   /**
    * Set a callback that will be invoked when all primary clusters have been initialized.
    */
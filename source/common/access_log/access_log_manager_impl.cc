@@ -1,5 +1,6 @@
 #include "source/common/access_log/access_log_manager_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
@@ -10,6 +11,7 @@
 #include "source/common/common/lock_guard.h"
 
 #include "absl/container/fixed_array.h"
+#include "absl/container/inlined_vector.h"
 
 namespace Envoy {
 namespace AccessLog {
@@ -92,8 +94,9 @@ AccessLogFileImpl::~AccessLogFileImpl() {
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    collectWriteShards(about_to_write_buffer_);
+    if (about_to_write_buffer_.length() > 0) {
+      doWrite(about_to_write_buffer_);
     }
     const Api::IoCallBoolResult result = file_->close();
     ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
@@ -114,14 +117,23 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   //            process lock or had multiple locks.
   {
     Thread::LockGuard lock(file_lock_);
-    for (const Buffer::RawSlice& slice : slices) {
-      absl::string_view data(static_cast<char*>(slice.mem_), slice.len_);
-      const Api::IoCallSizeResult result = file_->write(data);
-      if (result.ok() && result.return_value_ == static_cast<ssize_t>(slice.len_)) {
-        stats_.write_completed_.inc();
+    absl::InlinedVector<absl::string_view, MaxSlicesPerWrite> batch;
+    for (size_t start = 0; start < slices.size(); start += MaxSlicesPerWrite) {
+      const size_t end = std::min<size_t>(slices.size(), start + MaxSlicesPerWrite);
+      batch.clear();
+      ssize_t batch_length = 0;
+      for (size_t i = start; i < end; i++) {
+        batch.emplace_back(static_cast<char*>(slices[i].mem_), slices[i].len_);
+        batch_length += slices[i].len_;
+      }
+      const Api::IoCallSizeResult result = file_->writev(batch);
+      if (result.ok() && result.return_value_ == batch_length) {
+        stats_.write_completed_.add(batch.size());
       } else {
-        // Probably disk full.
-        stats_.write_failed_.inc();
+        // Probably disk full. The rest is dropped rather than written after a gap, which would
+        // corrupt framed entries.
+        stats_.write_failed_.add(slices.size() - start);
+        break;
       }
     }
   }
@@ -143,13 +155,14 @@ void AccessLogFileImpl::flushThreadFunc() {
     {
       Thread::LockGuard write_lock(write_lock_);
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
+      // flush_event_ can be woken up either by enough buffered data or by timer.
+      // In case it was timer, the staging buffers can be empty.
       //
       // Note: do not stop waiting when only `do_reopen` is true. In this case, we tried to
       // reopen and failed. We don't want to retry this in a tight loop, so wait for the next
       // event (timer or flush).
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
+      while (buffered_bytes_.load(std::memory_order_relaxed) == 0 && !flush_thread_exit_ &&
+             !reopen_file_) {
         // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
         flush_event_.wait(write_lock_);
       }
@@ -159,8 +172,7 @@ void AccessLogFileImpl::flushThreadFunc() {
       }
 
       flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
+      collectWriteShards(about_to_write_buffer_);
 
       if (reopen_file_) {
         do_reopen = true;
@@ -194,37 +206,55 @@ void AccessLogFileImpl::flush() {
 
     // flush_lock_ must be held while checking this or else it is
     // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
+    // write_shards_ to about_to_write_buffer_, has unlocked write_lock_,
     // but has not yet completed doWrite(). This would allow flush() to
     // return before the pending data has actually been written to disk.
     flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
 
-    if (flush_buffer_.length() == 0) {
+    collectWriteShards(about_to_write_buffer_);
+    if (about_to_write_buffer_.length() == 0) {
       return;
     }
-
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
   }
 
   doWrite(about_to_write_buffer_);
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
+  // The shard of a thread is picked the first time it writes to any access log file, so workers
+  // are spread evenly over the shards.
+  static std::atomic<uint32_t> next_shard{0};
+  thread_local const uint32_t shard_index = next_shard.fetch_add(1, std::memory_order_relaxed);
+  WriteShard& shard = write_shards_[shard_index % NumWriteShards];
 
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+  uint64_t buffered;
+  {
+    // buffered_bytes_ is updated under the shard lock so that it never runs behind the data that
+    // collectWriteShards() drains.
+    Thread::LockGuard lock(shard.lock_);
+    shard.buffer_.add(data.data(), data.size());
+    buffered = buffered_bytes_.fetch_add(data.size(), std::memory_order_relaxed) + data.size();
   }
-
   stats_.write_buffered_.inc();
   stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > min_flush_size_) {
+
+  // The flush thread is started after the data is buffered, so that its first loop flushes it.
+  absl::call_once(flush_thread_once_, [this]() { createFlushStructures(); });
+
+  if (buffered > min_flush_size_) {
+    Thread::LockGuard lock(write_lock_);
     flush_event_.notifyOne();
   }
 }
 
+void AccessLogFileImpl::collectWriteShards(Buffer::Instance& buffer) {
+  for (WriteShard& shard : write_shards_) {
+    Thread::LockGuard lock(shard.lock_);
+    buffered_bytes_.fetch_sub(shard.buffer_.length(), std::memory_order_relaxed);
+    buffer.move(shard.buffer_);
+  }
+}
+
 void AccessLogFileImpl::createFlushStructures() {
   flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
                                                Thread::Options{"AccessLogFlush"});
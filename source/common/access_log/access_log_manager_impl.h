@@ -2,6 +2,8 @@
 
 #include <sys/types.h>
 
+#include <array>
+#include <atomic>
 #include <string>
 
 #include "envoy/access_log/access_log.h"
@@ -15,6 +17,7 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 
+#include "absl/base/call_once.h"
 #include "absl/container/node_hash_map.h"
 
 namespace Envoy {
@@ -65,6 +68,11 @@ private:
  * This implementation uses a flush thread per file, with the idea there aren't that many
  * files. If this turns out to be a good implementation we can potentially have a single flush
  * thread that flushes all files, but we will start with this.
+ *
+ * Writers append to one of several staging buffers, picked per thread, so that workers logging
+ * at high rates do not serialize on a single lock. The flush thread drains all staging buffers
+ * and hands the collected slices to the file with vectored writes. Entries written by one thread
+ * stay in order; entries written by different threads may be reordered within a flush.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
@@ -77,6 +85,11 @@ public:
   // AccessLog::AccessLogFile
   void write(absl::string_view data) override;
 
+  // Number of staging buffers. Threads are mapped to them round robin.
+  static constexpr uint32_t NumWriteShards = 16;
+  // Maximum number of buffer slices passed to a single vectored write.
+  static constexpr uint32_t MaxSlicesPerWrite = 64;
+
   /**
    * Reopen file asynchronously.
    * This only sets reopen flag, actual reopen operation is delayed.
@@ -86,16 +99,26 @@ public:
   void flush() override;
 
 private:
+  // A staging buffer, on its own cache line so that workers appending to different shards do not
+  // contend with each other.
+  struct alignas(64) WriteShard {
+    Thread::MutexBasicLockable lock_;
+    Buffer::OwnedImpl buffer_ ABSL_GUARDED_BY(lock_);
+  };
+
   void doWrite(Buffer::Instance& buffer);
   void flushThreadFunc();
   void createFlushStructures();
+  // Moves the contents of all staging buffers into the given buffer.
+  void collectWriteShards(Buffer::Instance& buffer);
 
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
   //    1) write_lock_
   //    2) flush_lock_
-  //    3) file_lock_
+  //    3) WriteShard::lock_
+  //    4) file_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
                                           // not get interleaved by multiple processes writing to
@@ -105,24 +128,25 @@ private:
                                           // concurrent access to the about_to_write_buffer_, fd_,
                                           // and all other data used during flushing and file
                                           // re-opening.
-  Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
+  Thread::MutexBasicLockable write_lock_; // This lock protects the flush thread state and is used
+                                          // with flush_event_. Writers only take it to wake up
+                                          // the flush thread once enough data is buffered.
   Thread::ThreadPtr flush_thread_;
+  absl::once_flag flush_thread_once_;
   Thread::CondVar flush_event_;
   bool flush_thread_exit_ ABSL_GUARDED_BY(write_lock_){false};
   bool reopen_file_ ABSL_GUARDED_BY(write_lock_){false};
-  Buffer::OwnedImpl
-      flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
-                                                  // gets filled and then flushed either when max
-                                                  // size is reached or when a timer fires.
+  std::array<WriteShard, NumWriteShards> write_shards_; // These buffers are filled by the
+                                                        // writing threads and then flushed
+                                                        // either when max size is reached or
+                                                        // when a timer fires.
+  std::atomic<uint64_t> buffered_bytes_{0}; // Total size of the data in write_shards_.
   // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
   // through the std::make_unique assignment. I do not believe it's possible to annotate this
   // properly now due to limitations in the clang thread annotation analysis.
   Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
+                                            // is moved from write_shards_ under lock, and then
+                                            // the locks are released so that write_shards_ can
                                             // continue to fill. This buffer is then used for the
                                             // final write to disk.
   Event::TimerPtr flush_timer_;
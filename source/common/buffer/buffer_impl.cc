@@ -1,5 +1,6 @@
 #include "source/common/buffer/buffer_impl.h"
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -17,11 +18,77 @@ namespace {
 // TODO(yanavlasov): This may not be optimal for all hardware configurations or traffic patterns and
 // may need to be configurable in the future.
 constexpr uint64_t CopyThreshold = 512;
+
+// The blocks cached by a single thread. The cache is destroyed when its thread exits; slices that
+// outlive it (e.g. buffers with static storage duration destroyed after the main thread's thread
+// locals) bypass the cache via `thread_cache_destroyed`.
+struct SliceStorageThreadCache {
+  ~SliceStorageThreadCache();
+  void clear();
+
+  std::array<uint8_t*, SliceStoragePool::MaxCachedPerThread> blocks_{};
+  uint32_t size_{};
+  SliceStoragePool::Stats stats_;
+};
+
+thread_local SliceStorageThreadCache thread_cache;
+// Trivially destructible, so it remains safe to read after `thread_cache` has been destroyed.
+thread_local bool thread_cache_destroyed = false;
+
+SliceStorageThreadCache::~SliceStorageThreadCache() {
+  clear();
+  thread_cache_destroyed = true;
+}
+
+void SliceStorageThreadCache::clear() {
+  for (uint32_t i = 0; i < size_; ++i) {
+    delete[] blocks_[i];
+  }
+  size_ = 0;
+}
+
 } // namespace
 
-thread_local absl::InlinedVector<Slice::StoragePtr,
-                                 OwnedImpl::OwnedImplReservationSlicesOwnerMultiple::free_list_max_>
-    OwnedImpl::OwnedImplReservationSlicesOwnerMultiple::free_list_;
+uint8_t* SliceStoragePool::allocate() {
+  if (!thread_cache_destroyed) {
+    SliceStorageThreadCache& cache = thread_cache;
+    if (cache.size_ > 0) {
+      ++cache.stats_.hits_;
+      return cache.blocks_[--cache.size_];
+    }
+    ++cache.stats_.misses_;
+  }
+  return new uint8_t[StorageSize];
+}
+
+void SliceStoragePool::release(uint8_t* mem) {
+  ASSERT(mem != nullptr);
+  if (!thread_cache_destroyed) {
+    SliceStorageThreadCache& cache = thread_cache;
+    if (cache.size_ < MaxCachedPerThread) {
+      ++cache.stats_.recycled_;
+      cache.blocks_[cache.size_++] = mem;
+      return;
+    }
+    ++cache.stats_.released_;
+  }
+  delete[] mem;
+}
+
+SliceStoragePool::Stats SliceStoragePool::statsForThisThread() {
+  return thread_cache_destroyed ? Stats{} : thread_cache.stats_;
+}
+
+uint32_t SliceStoragePool::cachedForThisThread() {
+  return thread_cache_destroyed ? 0 : thread_cache.size_;
+}
+
+void SliceStoragePool::clearForTest() {
+  if (!thread_cache_destroyed) {
+    thread_cache.clear();
+    thread_cache.stats_ = Stats{};
+  }
+}
 
 uint64_t Slice::prepend(const void* data, uint64_t size) {
   const uint8_t* src = static_cast<const uint8_t*>(data);
@@ -19,6 +19,58 @@
 namespace Envoy {
 namespace Buffer {
 
+/**
+ * Per-thread cache of fixed size backing stores for mutable slices. Each worker thread allocates
+ * and frees the default sized slice storage on every socket read and write, so recycling these
+ * blocks locally keeps them out of the global allocator's central free lists. Storage freed on a
+ * thread other than the one that allocated it is cached by the freeing thread; all cached blocks
+ * are plain heap allocations, so they may be released with delete[] from any thread.
+ */
+class SliceStoragePool {
+public:
+  // Size in bytes of the backing stores managed by the pool.
+  static constexpr uint64_t StorageSize = 16384;
+  // Maximum number of backing stores cached by a single thread.
+  static constexpr uint32_t MaxCachedPerThread = 16;
+
+  struct Stats {
+    // Allocations satisfied from the thread's cache.
+    uint64_t hits_{};
+    // Allocations that fell through to the global allocator.
+    uint64_t misses_{};
+    // Frees that were returned to the thread's cache.
+    uint64_t recycled_{};
+    // Frees that were released to the global allocator because the cache was full.
+    uint64_t released_{};
+  };
+
+  /**
+   * @return a block of StorageSize bytes, reusing a cached block when one is available.
+   */
+  static uint8_t* allocate();
+
+  /**
+   * Return a block of StorageSize bytes obtained from allocate() or new uint8_t[StorageSize].
+   * @param mem the block to return. Must not be null.
+   */
+  static void release(uint8_t* mem);
+
+  /**
+   * @return the pool statistics for the calling thread.
+   */
+  static Stats statsForThisThread();
+
+  /**
+   * @return the number of blocks currently cached by the calling thread.
+   */
+  static uint32_t cachedForThisThread();
+
+  /**
+   * Release all blocks cached by the calling thread and reset its statistics.
+   */
+  static void clearForTest();
+};
+
 /**
  * A Slice manages a contiguous block of bytes.
  * The block is arranged like this:
@@ -57,7 +109,7 @@ public:
    * @param account the account to charge.
    */
   Slice(uint64_t min_capacity, const BufferMemoryAccountSharedPtr& account)
-      : capacity_(sliceSize(min_capacity)), storage_(new uint8_t[capacity_]),
+      : capacity_(sliceSize(min_capacity)), storage_(allocateStorage(capacity_)),
         base_(storage_.get()) {
     if (account) {
       account->charge(capacity_);
@@ -115,6 +167,7 @@ public:
     if (this != &rhs) {
       callAndClearDrainTrackersAndCharges();
 
+      releaseStorage();
       capacity_ = rhs.capacity_;
       storage_ = std::move(rhs.storage_);
       base_ = rhs.base_;
@@ -139,6 +192,7 @@ public:
 
   ~Slice() {
     callAndClearDrainTrackersAndCharges();
+    releaseStorage();
     if (releasor_) {
       releasor_();
     }
@@ -342,7 +396,7 @@ public:
     account_ = account;
   }
 
-  static constexpr uint32_t default_slice_size_ = 16384;
+  static constexpr uint32_t default_slice_size_ = SliceStoragePool::StorageSize;
 
 public:
   /**
@@ -365,10 +419,33 @@ public:
    */
   static inline SizedStorage newStorage(uint64_t min_capacity) {
     const uint64_t slice_size = sliceSize(min_capacity);
-    return {StoragePtr{new uint8_t[slice_size]}, static_cast<size_t>(slice_size)};
+    return {StoragePtr{allocateStorage(slice_size)}, static_cast<size_t>(slice_size)};
   }
 
 protected:
+  /**
+   * Allocate backing storage of the given size, drawing default sized storage from the
+   * SliceStoragePool.
+   * @param capacity the size of the storage, as computed by sliceSize().
+   */
+  static uint8_t* allocateStorage(uint64_t capacity) {
+    if (capacity == SliceStoragePool::StorageSize) {
+      return SliceStoragePool::allocate();
+    }
+    return new uint8_t[capacity];
+  }
+
+  /**
+   * Release the owned backing storage, if any, returning default sized storage to the
+   * SliceStoragePool.
+   */
+  void releaseStorage() {
+    if (storage_ != nullptr && capacity_ == SliceStoragePool::StorageSize) {
+      SliceStoragePool::release(storage_.release());
+    }
+    storage_.reset();
+  }
+
   /** Length of the byte array that base_ points to. This is also the offset in bytes from the start
    * of the slice to the end of the Reservable section. */
   uint64_t capacity_ = 0;
@@ -763,32 +840,18 @@ private:
 
   struct OwnedImplReservationSlicesOwnerMultiple : public OwnedImplReservationSlicesOwner {
   public:
-    static constexpr uint32_t free_list_max_ = Buffer::Reservation::MAX_SLICES_;
-
-    OwnedImplReservationSlicesOwnerMultiple() : free_list_ref_(free_list_) {}
     ~OwnedImplReservationSlicesOwnerMultiple() override {
       for (auto r = owned_storages_.rbegin(); r != owned_storages_.rend(); r++) {
         if (r->mem_ != nullptr) {
           ASSERT(r->len_ == Slice::default_slice_size_);
-          if (free_list_ref_.size() < free_list_max_) {
-            free_list_ref_.push_back(std::move(r->mem_));
-          }
+          SliceStoragePool::release(r->mem_.release());
         }
       }
     }
 
     Slice::SizedStorage newStorage() {
       ASSERT(Slice::sliceSize(Slice::default_slice_size_) == Slice::default_slice_size_);
-
-      Slice::SizedStorage storage{nullptr, Slice::default_slice_size_};
-      if (!free_list_ref_.empty()) {
-        storage.mem_ = std::move(free_list_ref_.back());
-        free_list_ref_.pop_back();
-      } else {
-        storage.mem_.reset(new uint8_t[Slice::default_slice_size_]);
-      }
-
-      return storage;
+      return {Slice::StoragePtr{SliceStoragePool::allocate()}, Slice::default_slice_size_};
     }
 
     absl::Span<Slice::SizedStorage> ownedStorages() override {
@@ -796,16 +859,6 @@ private:
     }
 
     absl::InlinedVector<Slice::SizedStorage, Buffer::Reservation::MAX_SLICES_> owned_storages_;
-
-  private:
-    // Thread local resolving introduces additional overhead. Initialize this reference once when
-    // constructing the owner to reduce thread local resolving to improve performance.
-    absl::InlinedVector<Slice::StoragePtr, free_list_max_>& free_list_ref_;
-
-    // Simple thread local cache to reduce unnecessary memory allocation and release. This cache
-    // is currently only used for multiple slices reservation because of the additional overhead
-    // that thread local resolving would introduce.
-    static thread_local absl::InlinedVector<Slice::StoragePtr, free_list_max_> free_list_;
   };
 
   struct OwnedImplReservationSlicesOwnerSingle : public OwnedImplReservationSlicesOwner {
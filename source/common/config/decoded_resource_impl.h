@@ -5,6 +5,7 @@
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
 #include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "xds/core/v3/collection_entry.pb.h"
 
@@ -25,53 +26,81 @@ repeatedPtrFieldToVector(const Protobuf::RepeatedPtrField<std::string>& xs) {
 class DecodedResourceImpl;
 using DecodedResourceImplPtr = std::unique_ptr<DecodedResourceImpl>;
 
+/**
+ * Arena shared by the resources decoded from one response. Each resource keeps a reference, so
+ * the arena is freed together with the last of them.
+ */
+using DecodeArenaSharedPtr = std::shared_ptr<Protobuf::Arena>;
+
+/**
+ * @return a new arena for decoding the resources of a response, or nullptr if arena decoding is
+ *         disabled. Blocks grow up to 1MiB, so that even a very large response is decoded with a
+ *         bounded number of allocations.
+ */
+inline DecodeArenaSharedPtr createDecodeArena() {
+  if (!Runtime::runtimeFeatureEnabled("envoy.reloadable_features.xds_decode_on_arena")) {
+    return nullptr;
+  }
+  Protobuf::ArenaOptions options;
+  options.max_block_size = 1024 * 1024;
+  return std::make_shared<Protobuf::Arena>(options);
+}
+
 class DecodedResourceImpl : public DecodedResource {
 public:
   static absl::StatusOr<DecodedResourceImplPtr>
   fromResource(OpaqueResourceDecoder& resource_decoder, const Protobuf::Any& resource,
-               const std::string& version) {
+               const std::string& version, const DecodeArenaSharedPtr& arena = nullptr) {
     if (resource.Is<envoy::service::discovery::v3::Resource>()) {
+      // The wrapper is only needed while decoding, so it is not put on the arena where it would
+      // be kept alive with the decoded resources.
       envoy::service::discovery::v3::Resource r;
       RETURN_IF_NOT_OK(MessageUtil::unpackTo(resource, r));
       r.set_version(version);
-      return std::make_unique<DecodedResourceImpl>(resource_decoder, r);
+      return std::make_unique<DecodedResourceImpl>(resource_decoder, r, arena);
     }
 
     return std::unique_ptr<DecodedResourceImpl>(new DecodedResourceImpl(
         resource_decoder, absl::nullopt, Protobuf::RepeatedPtrField<std::string>(), resource, true,
-        version, absl::nullopt, absl::nullopt));
+        version, absl::nullopt, absl::nullopt, arena));
   }
 
   static DecodedResourceImplPtr
   fromResource(OpaqueResourceDecoder& resource_decoder,
-               const envoy::service::discovery::v3::Resource& resource) {
-    return std::make_unique<DecodedResourceImpl>(resource_decoder, resource);
+               const envoy::service::discovery::v3::Resource& resource,
+               const DecodeArenaSharedPtr& arena = nullptr) {
+    return std::make_unique<DecodedResourceImpl>(resource_decoder, resource, arena);
   }
 
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder,
-                      const envoy::service::discovery::v3::Resource& resource)
+                      const envoy::service::discovery::v3::Resource& resource,
+                      const DecodeArenaSharedPtr& arena = nullptr)
       : DecodedResourceImpl(
             resource_decoder, resource.name(), resource.aliases(), resource.resource(),
             resource.has_resource(), resource.version(),
             resource.has_ttl() ? absl::make_optional(std::chrono::milliseconds(
                                      DurationUtil::durationToMilliseconds(resource.ttl())))
                                : absl::nullopt,
-            resource.has_metadata() ? absl::make_optional(resource.metadata()) : absl::nullopt) {}
+            resource.has_metadata() ? absl::make_optional(resource.metadata()) : absl::nullopt,
+            arena) {}
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder,
                       const xds::core::v3::CollectionEntry::InlineEntry& inline_entry)
       : DecodedResourceImpl(resource_decoder, inline_entry.name(),
                             Protobuf::RepeatedPtrField<std::string>(), inline_entry.resource(),
-                            true, inline_entry.version(), absl::nullopt, absl::nullopt) {}
+                            true, inline_entry.version(), absl::nullopt, absl::nullopt, nullptr) {}
   DecodedResourceImpl(ProtobufTypes::MessagePtr resource, const std::string& name,
                       const std::vector<std::string>& aliases, const std::string& version)
-      : resource_(std::move(resource)), has_resource_(true), name_(name), aliases_(aliases),
-        version_(version), ttl_(absl::nullopt), metadata_(absl::nullopt) {}
+      : arena_(nullptr), arena_resource_(nullptr), owned_resource_(std::move(resource)),
+        has_resource_(true), name_(name), aliases_(aliases), version_(version), ttl_(absl::nullopt),
+        metadata_(absl::nullopt) {}
 
   // Config::DecodedResource
   const std::string& name() const override { return name_; }
   const std::vector<std::string>& aliases() const override { return aliases_; }
   const std::string& version() const override { return version_; };
-  const Protobuf::Message& resource() const override { return *resource_; };
+  const Protobuf::Message& resource() const override {
+    return arena_resource_ != nullptr ? *arena_resource_ : *owned_resource_;
+  };
   bool hasResource() const override { return has_resource_; }
   absl::optional<std::chrono::milliseconds> ttl() const override { return ttl_; }
   const OptRef<const envoy::config::core::v3::Metadata> metadata() const override {
@@ -83,13 +112,24 @@ private:
                       const Protobuf::RepeatedPtrField<std::string>& aliases,
                       const Protobuf::Any& resource, bool has_resource, const std::string& version,
                       absl::optional<std::chrono::milliseconds> ttl,
-                      const absl::optional<envoy::config::core::v3::Metadata>& metadata)
-      : resource_(resource_decoder.decodeResource(resource)), has_resource_(has_resource),
-        name_(name ? *name : resource_decoder.resourceName(*resource_)),
+                      const absl::optional<envoy::config::core::v3::Metadata>& metadata,
+                      const DecodeArenaSharedPtr& arena)
+      : arena_(arena),
+        arena_resource_(arena_ != nullptr
+                            ? resource_decoder.decodeResourceOnArena(resource, *arena_)
+                            : nullptr),
+        owned_resource_(arena_resource_ == nullptr ? resource_decoder.decodeResource(resource)
+                                                   : nullptr),
+        has_resource_(has_resource),
+        name_(name ? *name : resource_decoder.resourceName(resource())),
         aliases_(repeatedPtrFieldToVector(aliases)), version_(version), ttl_(ttl),
         metadata_(metadata) {}
 
-  const ProtobufTypes::MessagePtr resource_;
+  // Keeps the arena that arena_resource_ was allocated on alive.
+  const DecodeArenaSharedPtr arena_;
+  const Protobuf::Message* const arena_resource_;
+  // Set when the resource was decoded without an arena.
+  const ProtobufTypes::MessagePtr owned_resource_;
   const bool has_resource_;
   const std::string name_;
   const std::vector<std::string> aliases_;
@@ -108,9 +148,10 @@ struct DecodedResourcesWrapper {
   create(OpaqueResourceDecoder& resource_decoder,
          const Protobuf::RepeatedPtrField<Protobuf::Any>& resources, const std::string& version) {
     std::unique_ptr<DecodedResourcesWrapper> ret = std::make_unique<DecodedResourcesWrapper>();
+    const DecodeArenaSharedPtr arena = createDecodeArena();
     for (const auto& resource : resources) {
       absl::StatusOr<DecodedResourceImplPtr> resource_or_error =
-          DecodedResourceImpl::fromResource(resource_decoder, resource, version);
+          DecodedResourceImpl::fromResource(resource_decoder, resource, version, arena);
       RETURN_IF_NOT_OK_REF(resource_or_error.status());
       ret->pushBack(std::move(resource_or_error.value()));
     }
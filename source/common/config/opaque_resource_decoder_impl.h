@@ -24,6 +24,15 @@ public:
     return typed_message;
   }
 
+  Protobuf::Message* decodeResourceOnArena(const Protobuf::Any& resource,
+                                           Protobuf::Arena& arena) override {
+    Current* typed_message = Protobuf::Arena::Create<Current>(&arena);
+    if (!resource.type_url().empty()) {
+      MessageUtil::anyConvertAndValidate<Current>(resource, *typed_message, validation_visitor_);
+    }
+    return typed_message;
+  }
+
   std::string resourceName(const Protobuf::Message& resource) override {
     return MessageUtil::getStringField(resource, name_field_);
   }
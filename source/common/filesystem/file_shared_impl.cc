@@ -21,6 +21,22 @@ Api::IoError::IoErrorCode IoFileError::getErrorCode() const {
 
 std::string IoFileError::getErrorDetails() const { return errorDetails(errno_); }
 
+Api::IoCallSizeResult FileSharedImpl::writev(absl::Span<const absl::string_view> buffers) {
+  ssize_t total = 0;
+  for (absl::string_view buffer : buffers) {
+    Api::IoCallSizeResult result = write(buffer);
+    if (!result.ok()) {
+      return total > 0 ? resultSuccess(total) : std::move(result);
+    }
+    total += result.return_value_;
+    // Writing the later buffers after a short write would leave a gap in the output.
+    if (result.return_value_ < static_cast<ssize_t>(buffer.size())) {
+      break;
+    }
+  }
+  return resultSuccess(total);
+}
+
 bool FileSharedImpl::isOpen() const { return fd_ != INVALID_HANDLE; };
 
 absl::string_view FileSharedImpl::path() const { return filepath_and_type_.path_; };
@@ -43,6 +43,8 @@ public:
 
   ~FileSharedImpl() override = default;
 
+  // Writes the buffers one at a time. Platforms with a vectored write call override this.
+  Api::IoCallSizeResult writev(absl::Span<const absl::string_view> buffers) override;
   bool isOpen() const override;
   absl::string_view path() const override;
   DestinationType destinationType() const override;
@@ -3,6 +3,7 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <cstdlib>
@@ -20,6 +21,7 @@
 #include "source/common/common/utility.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/container/fixed_array.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 
@@ -101,6 +103,16 @@ Api::IoCallSizeResult FileImplPosix::write(absl::string_view buffer) {
   return rc != -1 ? resultSuccess(rc) : resultFailure(rc, errno);
 };
 
+Api::IoCallSizeResult FileImplPosix::writev(absl::Span<const absl::string_view> buffers) {
+  absl::FixedArray<iovec> iov(buffers.size());
+  for (size_t i = 0; i < buffers.size(); i++) {
+    iov[i].iov_base = const_cast<char*>(buffers[i].data());
+    iov[i].iov_len = buffers[i].size();
+  }
+  const ssize_t rc = ::writev(fd_, iov.data(), iov.size());
+  return rc != -1 ? resultSuccess(rc) : resultFailure(rc, errno);
+}
+
 Api::IoCallBoolResult FileImplPosix::close() {
   ASSERT(isOpen());
   int rc = ::close(fd_);
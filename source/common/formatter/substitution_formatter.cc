@@ -363,61 +363,114 @@ FormatterImpl::create(absl::string_view format, bool omit_empty_values,
   return ret;
 }
 
-std::string FormatterImpl::format(const Context& context,
-                                  const StreamInfo::StreamInfo& stream_info) const {
-  std::string log_line;
-  log_line.reserve(256);
-
-  for (const auto& provider : providers_) {
-    const absl::optional<std::string> bit = provider->format(context, stream_info);
-    // Add the formatted value if there is one. Otherwise add a default value
-    // of "-" if omit_empty_values_ is not set.
-    if (bit.has_value()) {
-      log_line += bit.value();
-    } else if (!omit_empty_values_) {
-      log_line += DefaultUnspecifiedValueStringView;
+CompiledFormat::CompiledFormat(std::vector<FormatterProviderPtr>&& providers, bool json_sanitize)
+    : json_sanitize_(json_sanitize) {
+  std::string sanitize_buffer;
+  for (FormatterProviderPtr& provider : providers) {
+    const auto* plain = dynamic_cast<const PlainStringFormatter*>(provider.get());
+    if (plain == nullptr) {
+      steps_.push_back(Step{provider.get(), 0, 0});
+      providers_.push_back(std::move(provider));
+      continue;
     }
-  }
 
-  return log_line;
+    absl::string_view literal = plain->value();
+    if (json_sanitize_) {
+      literal = Json::sanitize(sanitize_buffer, literal);
+    }
+    if (literal.empty()) {
+      continue;
+    }
+    // Fuse with the previous literal segment if there is one.
+    if (steps_.empty() || steps_.back().provider_ != nullptr) {
+      steps_.push_back(Step{nullptr, static_cast<uint32_t>(literals_.size()), 0});
+    }
+    literals_.append(literal);
+    steps_.back().length_ += static_cast<uint32_t>(literal.size());
+  }
 }
 
-void stringValueToLogLine(const JsonFormatterImpl::Formatters& formatters, const Context& context,
-                          const StreamInfo::StreamInfo& info, std::string& log_line,
-                          std::string& sanitize, bool omit_empty_values) {
-  log_line.push_back('"'); // Start the JSON string.
-  for (const JsonFormatterImpl::Formatter& formatter : formatters) {
-    const absl::optional<std::string> value = formatter->format(context, info);
+void CompiledFormat::formatToString(const Context& context,
+                                    const StreamInfo::StreamInfo& stream_info,
+                                    bool omit_empty_values, std::string& sanitize_buffer,
+                                    std::string& output) const {
+  for (const Step& step : steps_) {
+    if (step.provider_ == nullptr) {
+      output.append(literals_, step.offset_, step.length_);
+      continue;
+    }
+    const absl::optional<std::string> value = step.provider_->format(context, stream_info);
     if (!value.has_value()) {
-      // Add the empty value. This needn't be sanitized.
-      log_line.append(omit_empty_values ? EMPTY_STRING : DefaultUnspecifiedValueStringView);
+      // Add a default value of "-" if omit_empty_values is not set. This needn't be sanitized.
+      if (!omit_empty_values) {
+        output.append(DefaultUnspecifiedValueStringView);
+      }
       continue;
     }
-    // Sanitize the string value and add it to the buffer. The string value will not be quoted
-    // since we handle the quoting by ourselves at the outer level.
-    log_line.append(Json::sanitize(sanitize, value.value()));
+    if (json_sanitize_) {
+      // The string value will not be quoted since the quoting is handled at the outer level.
+      output.append(Json::sanitize(sanitize_buffer, value.value()));
+    } else {
+      output.append(value.value());
+    }
   }
-  log_line.push_back('"'); // End the JSON string.
+}
+
+std::string FormatterImpl::format(const Context& context,
+                                  const StreamInfo::StreamInfo& stream_info) const {
+  std::string log_line;
+  log_line.reserve(size_hint_->get());
+
+  // The sanitize buffer is unused because the text format isn't JSON sanitized.
+  std::string unused;
+  compiled_->formatToString(context, stream_info, omit_empty_values_, unused, log_line);
+
+  size_hint_->update(log_line.size());
+  return log_line;
 }
 
 JsonFormatterImpl::JsonFormatterImpl(const Protobuf::Struct& struct_format, bool omit_empty_values,
                                      const CommandParsers& commands)
     : omit_empty_values_(omit_empty_values) {
-  for (JsonFormatBuilder::FormatElement& element : JsonFormatBuilder().fromStruct(struct_format)) {
-    if (element.is_template_) {
-      parsed_elements_.emplace_back(
-          THROW_OR_RETURN_VALUE(SubstitutionFormatParser::parse(element.value_, commands),
-                                std::vector<FormatterProviderPtr>));
+  size_t size_estimate = 0;
+  const auto append_raw = [this, &size_estimate](absl::string_view raw) {
+    size_estimate += raw.size();
+    // Fuse adjacent raw JSON pieces so that they are written with a single append.
+    if (!parsed_elements_.empty() &&
+        absl::holds_alternative<std::string>(parsed_elements_.back())) {
+      absl::get<std::string>(parsed_elements_.back()).append(raw);
     } else {
-      parsed_elements_.emplace_back(std::move(element.value_));
+      parsed_elements_.emplace_back(std::string(raw));
+    }
+  };
+
+  for (JsonFormatBuilder::FormatElement& element : JsonFormatBuilder().fromStruct(struct_format)) {
+    if (!element.is_template_) {
+      append_raw(element.value_);
+      continue;
     }
+
+    CompiledFormat compiled(
+        THROW_OR_RETURN_VALUE(SubstitutionFormatParser::parse(element.value_, commands),
+                              std::vector<FormatterProviderPtr>),
+        true);
+    if (compiled.literalOnly()) {
+      // A template without any substitution commands (e.g. only escaped '%%') is a constant
+      // JSON string. The literals are already sanitized.
+      append_raw(absl::StrCat("\"", compiled.literals(), "\""));
+      continue;
+    }
+    size_estimate += compiled.literals().size() + compiled.providerCount() * 32;
+    parsed_elements_.emplace_back(std::move(compiled));
   }
+
+  size_hint_.emplace(size_estimate + 1);
 }
 
 std::string JsonFormatterImpl::format(const Context& context,
                                       const StreamInfo::StreamInfo& info) const {
   std::string log_line;
-  log_line.reserve(2048);
+  log_line.reserve(size_hint_->get());
   std::string sanitize; // Helper to serialize the value to log line.
 
   for (const ParsedFormatElement& element : parsed_elements_) {
@@ -429,22 +482,23 @@ std::string JsonFormatterImpl::format(const Context& context,
       continue;
     }
 
-    ASSERT(absl::holds_alternative<Formatters>(element));
-    const Formatters& formatters = absl::get<Formatters>(element);
-    ASSERT(!formatters.empty());
+    ASSERT(absl::holds_alternative<CompiledFormat>(element));
+    const CompiledFormat& compiled = absl::get<CompiledFormat>(element);
 
-    if (formatters.size() != 1) {
-      // 2. Handle the formatter element with multiple or zero providers.
-      stringValueToLogLine(formatters, context, info, log_line, sanitize, omit_empty_values_);
-    } else {
-      // 3. Handle the formatter element with a single provider and value
-      //    type needs to be kept.
-      const auto value = formatters[0]->formatValue(context, info);
+    if (const FormatterProvider* provider = compiled.singleProvider(); provider != nullptr) {
+      // 2. Handle the template with a single provider and value type needs to be kept.
+      const auto value = provider->formatValue(context, info);
       Json::Utility::appendValueToString(value, log_line);
+    } else {
+      // 3. Handle the template with multiple providers or literals. The value is a string.
+      log_line.push_back('"'); // Start the JSON string.
+      compiled.formatToString(context, info, omit_empty_values_, sanitize, log_line);
+      log_line.push_back('"'); // End the JSON string.
     }
   }
 
   log_line.push_back('\n');
+  size_hint_->update(log_line.size());
   return log_line;
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <bitset>
 #include <functional>
 #include <list>
@@ -32,6 +34,11 @@ class PlainStringFormatter : public FormatterProvider {
 public:
   PlainStringFormatter(absl::string_view str) { str_.set_string_value(str); }
 
+  /**
+   * @return the literal this formatter was initialized with.
+   */
+  absl::string_view value() const { return str_.string_value(); }
+
   // FormatterProvider
   absl::optional<std::string> format(const Context&, const StreamInfo::StreamInfo&) const override {
     return str_.string_value();
@@ -75,6 +82,91 @@ public:
 
 inline constexpr absl::string_view DefaultUnspecifiedValueStringView = "-";
 
+/**
+ * A parsed format template compiled into a flat plan when the configuration is loaded.
+ * Adjacent literal segments are fused into a single buffer so that formatting a line only
+ * dispatches to providers for real substitution commands and appends literals directly into
+ * the caller's output buffer.
+ */
+class CompiledFormat {
+public:
+  /**
+   * @param providers the providers returned by SubstitutionFormatParser::parse().
+   * @param json_sanitize whether the literal segments and the substituted values are JSON
+   *        sanitized. Literal segments are sanitized once here rather than per log line.
+   */
+  CompiledFormat(std::vector<FormatterProviderPtr>&& providers, bool json_sanitize);
+
+  /**
+   * Append the formatted template to the output buffer.
+   * @param sanitize_buffer scratch buffer used for JSON sanitizing. It is only used if the
+   *        format was compiled with json_sanitize and is reused across calls by the caller.
+   */
+  void formatToString(const Context& context, const StreamInfo::StreamInfo& stream_info,
+                      bool omit_empty_values, std::string& sanitize_buffer,
+                      std::string& output) const;
+
+  /**
+   * @return the provider if the template consists of exactly one substitution command and no
+   *         literals, nullptr otherwise.
+   */
+  const FormatterProvider* singleProvider() const {
+    return steps_.size() == 1 ? steps_[0].provider_ : nullptr;
+  }
+
+  /**
+   * @return true if the template has no substitution commands.
+   */
+  bool literalOnly() const { return providers_.empty(); }
+
+  /**
+   * @return the fused literal segments of the template.
+   */
+  absl::string_view literals() const { return literals_; }
+
+  /**
+   * @return the number of substitution commands in the template.
+   */
+  size_t providerCount() const { return providers_.size(); }
+
+private:
+  // A step is either a substitution command (provider_ is set) or a literal segment stored
+  // at [offset_, offset_ + length_) of literals_.
+  struct Step {
+    const FormatterProvider* provider_{};
+    uint32_t offset_{};
+    uint32_t length_{};
+  };
+
+  const bool json_sanitize_;
+  std::vector<FormatterProviderPtr> providers_;
+  std::string literals_;
+  std::vector<Step> steps_;
+};
+
+/**
+ * Adaptive output size estimate shared by the formatters. The first lines are sized from the
+ * compiled template and the estimate then tracks the largest line seen so far, so steady state
+ * formatting performs a single allocation per line.
+ */
+class FormatSizeHint {
+public:
+  // Upper bound of the estimate so that one very large line doesn't inflate every later line.
+  static constexpr size_t MaxSizeHint = 16 * 1024;
+
+  explicit FormatSizeHint(size_t initial) : hint_(std::min(initial, MaxSizeHint)) {}
+
+  size_t get() const { return hint_.load(std::memory_order_relaxed); }
+  void update(size_t size) const {
+    if (size > get()) {
+      hint_.store(std::min(size, MaxSizeHint), std::memory_order_relaxed);
+    }
+  }
+
+private:
+  mutable std::atomic<size_t> hint_;
+};
+
 /**
  * Composite formatter implementation.
  */
@@ -96,12 +188,14 @@ protected:
       : omit_empty_values_(omit_empty_values) {
     auto providers_or_error = SubstitutionFormatParser::parse(format, command_parsers);
     SET_AND_RETURN_IF_NOT_OK(providers_or_error.status(), creation_status);
-    providers_ = std::move(*providers_or_error);
+    compiled_.emplace(std::move(*providers_or_error), false);
+    size_hint_.emplace(compiled_->literals().size() + compiled_->providerCount() * 32);
   }
 
 private:
   const bool omit_empty_values_;
-  std::vector<FormatterProviderPtr> providers_;
+  absl::optional<CompiledFormat> compiled_;
+  absl::optional<FormatSizeHint> size_hint_;
 };
 
 class JsonFormatterImpl : public Formatter {
@@ -118,8 +212,11 @@ public:
 
 private:
   const bool omit_empty_values_;
-  using ParsedFormatElement = absl::variant<std::string, Formatters>;
+  // Raw JSON pieces are fused with their neighbours at load time, so elements alternate
+  // between raw JSON and compiled templates.
+  using ParsedFormatElement = absl::variant<std::string, CompiledFormat>;
   std::vector<ParsedFormatElement> parsed_elements_;
+  absl::optional<FormatSizeHint> size_hint_;
 };
 
 } // namespace Formatter
@@ -0,0 +1,400 @@
+#include "source/common/http/header_char_scan.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "source/common/common/assert.h"
+#include "source/common/http/character_set_validation.h"
+
+#include "absl/strings/ascii.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ENVOY_HEADER_CHAR_SCAN_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define ENVOY_HEADER_CHAR_SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+// Token characters only live in the 0x20-0x7f range, i.e. high nibbles 2 through 7. Each of those
+// high nibbles gets its own bit, and for every low nibble we record which high nibbles combine
+// with it into a valid character. A byte is then valid iff
+// kTokenLowNibbleTable[c & 0xf] & kTokenHighNibbleTable[c >> 4] is non-zero, which maps directly
+// onto 16 entry byte shuffles.
+constexpr std::array<uint8_t, 16> buildTokenLowNibbleTable() {
+  std::array<uint8_t, 16> table{};
+  for (unsigned low = 0; low < 16; ++low) {
+    for (unsigned high = 2; high < 8; ++high) {
+      if (testCharInTable(kGenericHeaderNameCharTable, static_cast<char>((high << 4) | low))) {
+        table[low] |= 1 << (high - 2);
+      }
+    }
+  }
+  return table;
+}
+
+constexpr std::array<uint8_t, 16> buildTokenHighNibbleTable() {
+  std::array<uint8_t, 16> table{};
+  for (unsigned high = 2; high < 8; ++high) {
+    table[high] = 1 << (high - 2);
+  }
+  return table;
+}
+
+constexpr std::array<uint8_t, 16> kTokenLowNibbleTable = buildTokenLowNibbleTable();
+constexpr std::array<uint8_t, 16> kTokenHighNibbleTable = buildTokenHighNibbleTable();
+
+// The nibble tables must describe exactly the generic header name character set.
+constexpr bool nibbleTablesMatchCharTable() {
+  for (unsigned c = 0; c < 256; ++c) {
+    const bool nibble_valid = (kTokenLowNibbleTable[c & 0xf] & kTokenHighNibbleTable[c >> 4]) != 0;
+    if (nibble_valid != testCharInTable(kGenericHeaderNameCharTable, static_cast<char>(c))) {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(nibbleTablesMatchCharTable());
+
+// Vector kernels process partial blocks by copying them into a block padded with a byte that is
+// a valid token character, is not upper case and is neither CR nor LF, so the padding never
+// changes the outcome of any scan.
+constexpr char kPaddingChar = 'a';
+
+bool isTokenValidScalar(const char* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (!testCharInTable(kGenericHeaderNameCharTable, data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void toLowerInPlaceScalar(char* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = absl::ascii_tolower(data[i]);
+  }
+}
+
+bool containsCrOrLfScalar(const char* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (data[i] == '\r' || data[i] == '\n') {
+      return true;
+    }
+  }
+  return false;
+}
+
+#if defined(ENVOY_HEADER_CHAR_SCAN_X86)
+
+__attribute__((target("sse4.2"))) inline bool isTokenBlockValidSse42(__m128i block) {
+  const __m128i low_table =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(kTokenLowNibbleTable.data()));
+  const __m128i high_table =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(kTokenHighNibbleTable.data()));
+  const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+  const __m128i low = _mm_shuffle_epi8(low_table, _mm_and_si128(block, nibble_mask));
+  const __m128i high =
+      _mm_shuffle_epi8(high_table, _mm_and_si128(_mm_srli_epi16(block, 4), nibble_mask));
+  const __m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128());
+  return _mm_movemask_epi8(invalid) == 0;
+}
+
+__attribute__((target("sse4.2"))) inline __m128i toLowerBlockSse42(__m128i block) {
+  const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('A' - 1)),
+                                      _mm_cmplt_epi8(block, _mm_set1_epi8('Z' + 1)));
+  return _mm_or_si128(block, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+__attribute__((target("sse4.2"))) inline bool hasCrOrLfBlockSse42(__m128i block) {
+  const __m128i found = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\r')),
+                                     _mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+  return _mm_movemask_epi8(found) != 0;
+}
+
+__attribute__((target("sse4.2"))) inline __m128i loadPaddedSse42(const char* data, size_t size) {
+  ASSERT(size < 16);
+  alignas(16) char padded[16];
+  memset(padded, kPaddingChar, sizeof(padded));
+  memcpy(padded, data, size);
+  return _mm_load_si128(reinterpret_cast<const __m128i*>(padded));
+}
+
+__attribute__((target("sse4.2"))) bool isTokenValidSse42(const char* data, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    if (!isTokenBlockValidSse42(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)))) {
+      return false;
+    }
+  }
+  return i == size || isTokenBlockValidSse42(loadPaddedSse42(data + i, size - i));
+}
+
+__attribute__((target("sse4.2"))) void toLowerInPlaceSse42(char* data, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m128i* block = reinterpret_cast<__m128i*>(data + i);
+    _mm_storeu_si128(block, toLowerBlockSse42(_mm_loadu_si128(block)));
+  }
+  if (i != size) {
+    alignas(16) char padded[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(padded),
+                    toLowerBlockSse42(loadPaddedSse42(data + i, size - i)));
+    memcpy(data + i, padded, size - i);
+  }
+}
+
+__attribute__((target("sse4.2"))) bool containsCrOrLfSse42(const char* data, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    if (hasCrOrLfBlockSse42(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)))) {
+      return true;
+    }
+  }
+  return i != size && hasCrOrLfBlockSse42(loadPaddedSse42(data + i, size - i));
+}
+
+// The AVX2 kernels handle 32 byte blocks and hand any remainder to the SSE4.2 kernels, which every
+// AVX2 capable CPU also supports.
+__attribute__((target("avx2"))) bool isTokenValidAvx2(const char* data, size_t size) {
+  const __m256i low_table = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(kTokenLowNibbleTable.data())));
+  const __m256i high_table = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(kTokenHighNibbleTable.data())));
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const __m256i low = _mm256_shuffle_epi8(low_table, _mm256_and_si256(block, nibble_mask));
+    const __m256i high =
+        _mm256_shuffle_epi8(high_table, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble_mask));
+    const __m256i invalid =
+        _mm256_cmpeq_epi8(_mm256_and_si256(low, high), _mm256_setzero_si256());
+    if (_mm256_movemask_epi8(invalid) != 0) {
+      return false;
+    }
+  }
+  return isTokenValidSse42(data + i, size - i);
+}
+
+__attribute__((target("avx2"))) void toLowerInPlaceAvx2(char* data, size_t size) {
+  const __m256i below_upper = _mm256_set1_epi8('A' - 1);
+  const __m256i above_upper = _mm256_set1_epi8('Z' + 1);
+  const __m256i case_bit = _mm256_set1_epi8(0x20);
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    __m256i* block_ptr = reinterpret_cast<__m256i*>(data + i);
+    const __m256i block = _mm256_loadu_si256(block_ptr);
+    const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(block, below_upper),
+                                           _mm256_cmpgt_epi8(above_upper, block));
+    _mm256_storeu_si256(block_ptr, _mm256_or_si256(block, _mm256_and_si256(upper, case_bit)));
+  }
+  toLowerInPlaceSse42(data + i, size - i);
+}
+
+__attribute__((target("avx2"))) bool containsCrOrLfAvx2(const char* data, size_t size) {
+  const __m256i cr = _mm256_set1_epi8('\r');
+  const __m256i lf = _mm256_set1_epi8('\n');
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const __m256i found =
+        _mm256_or_si256(_mm256_cmpeq_epi8(block, cr), _mm256_cmpeq_epi8(block, lf));
+    if (_mm256_movemask_epi8(found) != 0) {
+      return true;
+    }
+  }
+  return containsCrOrLfSse42(data + i, size - i);
+}
+
+#endif // ENVOY_HEADER_CHAR_SCAN_X86
+
+#if defined(ENVOY_HEADER_CHAR_SCAN_NEON)
+
+inline bool isTokenBlockValidNeon(uint8x16_t block) {
+  const uint8x16_t low_table = vld1q_u8(kTokenLowNibbleTable.data());
+  const uint8x16_t high_table = vld1q_u8(kTokenHighNibbleTable.data());
+  const uint8x16_t low = vqtbl1q_u8(low_table, vandq_u8(block, vdupq_n_u8(0x0f)));
+  const uint8x16_t high = vqtbl1q_u8(high_table, vshrq_n_u8(block, 4));
+  return vminvq_u8(vandq_u8(low, high)) != 0;
+}
+
+inline uint8x16_t toLowerBlockNeon(uint8x16_t block) {
+  const uint8x16_t upper = vcleq_u8(vsubq_u8(block, vdupq_n_u8('A')), vdupq_n_u8('Z' - 'A'));
+  return vorrq_u8(block, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+
+inline bool hasCrOrLfBlockNeon(uint8x16_t block) {
+  const uint8x16_t found =
+      vorrq_u8(vceqq_u8(block, vdupq_n_u8('\r')), vceqq_u8(block, vdupq_n_u8('\n')));
+  return vmaxvq_u8(found) != 0;
+}
+
+inline uint8x16_t loadPaddedNeon(const char* data, size_t size) {
+  ASSERT(size < 16);
+  uint8_t padded[16];
+  memset(padded, kPaddingChar, sizeof(padded));
+  memcpy(padded, data, size);
+  return vld1q_u8(padded);
+}
+
+bool isTokenValidNeon(const char* data, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    if (!isTokenBlockValidNeon(vld1q_u8(reinterpret_cast<const uint8_t*>(data + i)))) {
+      return false;
+    }
+  }
+  return i == size || isTokenBlockValidNeon(loadPaddedNeon(data + i, size - i));
+}
+
+void toLowerInPlaceNeon(char* data, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    uint8_t* block = reinterpret_cast<uint8_t*>(data + i);
+    vst1q_u8(block, toLowerBlockNeon(vld1q_u8(block)));
+  }
+  if (i != size) {
+    uint8_t padded[16];
+    vst1q_u8(padded, toLowerBlockNeon(loadPaddedNeon(data + i, size - i)));
+    memcpy(data + i, padded, size - i);
+  }
+}
+
+bool containsCrOrLfNeon(const char* data, size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    if (hasCrOrLfBlockNeon(vld1q_u8(reinterpret_cast<const uint8_t*>(data + i)))) {
+      return true;
+    }
+  }
+  return i != size && hasCrOrLfBlockNeon(loadPaddedNeon(data + i, size - i));
+}
+
+#endif // ENVOY_HEADER_CHAR_SCAN_NEON
+
+struct Kernels {
+  bool (*is_token_valid_)(const char*, size_t);
+  void (*to_lower_in_place_)(char*, size_t);
+  bool (*contains_cr_or_lf_)(const char*, size_t);
+};
+
+const Kernels& kernelsFor(HeaderCharScan::Kernel kernel) {
+  static constexpr Kernels scalar{isTokenValidScalar, toLowerInPlaceScalar, containsCrOrLfScalar};
+  switch (kernel) {
+  case HeaderCharScan::Kernel::Scalar:
+    return scalar;
+#if defined(ENVOY_HEADER_CHAR_SCAN_X86)
+  case HeaderCharScan::Kernel::Sse42: {
+    static constexpr Kernels sse42{isTokenValidSse42, toLowerInPlaceSse42, containsCrOrLfSse42};
+    return sse42;
+  }
+  case HeaderCharScan::Kernel::Avx2: {
+    static constexpr Kernels avx2{isTokenValidAvx2, toLowerInPlaceAvx2, containsCrOrLfAvx2};
+    return avx2;
+  }
+#endif
+#if defined(ENVOY_HEADER_CHAR_SCAN_NEON)
+  case HeaderCharScan::Kernel::Neon: {
+    static constexpr Kernels neon{isTokenValidNeon, toLowerInPlaceNeon, containsCrOrLfNeon};
+    return neon;
+  }
+#endif
+  default:
+    break;
+  }
+  IS_ENVOY_BUG("header char scan kernel not supported on this platform");
+  return scalar;
+}
+
+HeaderCharScan::Kernel detectKernel() {
+#if defined(ENVOY_HEADER_CHAR_SCAN_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return HeaderCharScan::Kernel::Avx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return HeaderCharScan::Kernel::Sse42;
+  }
+#elif defined(ENVOY_HEADER_CHAR_SCAN_NEON)
+  // NEON is part of the aarch64 baseline.
+  return HeaderCharScan::Kernel::Neon;
+#endif
+  return HeaderCharScan::Kernel::Scalar;
+}
+
+const Kernels& activeKernels() {
+  static const Kernels& kernels = kernelsFor(HeaderCharScan::activeKernel());
+  return kernels;
+}
+
+} // namespace
+
+bool HeaderCharScan::isTokenValid(absl::string_view token) {
+  return activeKernels().is_token_valid_(token.data(), token.size());
+}
+
+void HeaderCharScan::toLowerInPlace(char* data, size_t size) {
+  activeKernels().to_lower_in_place_(data, size);
+}
+
+bool HeaderCharScan::containsCrOrLf(absl::string_view value) {
+  return activeKernels().contains_cr_or_lf_(value.data(), value.size());
+}
+
+bool HeaderCharScan::isTokenValid(absl::string_view token, Kernel kernel) {
+  return kernelsFor(kernel).is_token_valid_(token.data(), token.size());
+}
+
+void HeaderCharScan::toLowerInPlace(char* data, size_t size, Kernel kernel) {
+  kernelsFor(kernel).to_lower_in_place_(data, size);
+}
+
+bool HeaderCharScan::containsCrOrLf(absl::string_view value, Kernel kernel) {
+  return kernelsFor(kernel).contains_cr_or_lf_(value.data(), value.size());
+}
+
+HeaderCharScan::Kernel HeaderCharScan::activeKernel() {
+  static const Kernel kernel = detectKernel();
+  return kernel;
+}
+
+std::vector<HeaderCharScan::Kernel> HeaderCharScan::supportedKernels() {
+  std::vector<Kernel> kernels{Kernel::Scalar};
+  switch (activeKernel()) {
+  case Kernel::Avx2:
+    kernels.push_back(Kernel::Sse42);
+    kernels.push_back(Kernel::Avx2);
+    break;
+  case Kernel::Sse42:
+  case Kernel::Neon:
+    kernels.push_back(activeKernel());
+    break;
+  case Kernel::Scalar:
+    break;
+  }
+  return kernels;
+}
+
+absl::string_view HeaderCharScan::kernelName(Kernel kernel) {
+  switch (kernel) {
+  case Kernel::Scalar:
+    return "scalar";
+  case Kernel::Sse42:
+    return "sse4.2";
+  case Kernel::Avx2:
+    return "avx2";
+  case Kernel::Neon:
+    return "neon";
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+} // namespace Http
+} // namespace Envoy
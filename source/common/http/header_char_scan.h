@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Vectorized scans over header bytes used on the HTTP/1 parsing path. The kernel is selected once
+ * per process based on the CPU: AVX2 or SSE4.2 on x86-64, NEON on aarch64, and a scalar table
+ * lookup everywhere else. All kernels produce identical results. The overloads taking a kernel
+ * exist for tests and benchmarks and must only be given one of supportedKernels().
+ */
+class HeaderCharScan {
+public:
+  enum class Kernel { Scalar, Sse42, Avx2, Neon };
+
+  /**
+   * @return true if every character of the token is a tchar as defined by RFC 9110 section 5.6.2.
+   *         An empty token is considered valid; callers check emptiness where it matters.
+   */
+  static bool isTokenValid(absl::string_view token);
+  static bool isTokenValid(absl::string_view token, Kernel kernel);
+
+  /**
+   * Convert ASCII upper case characters to lower case in place. Other bytes are left untouched.
+   */
+  static void toLowerInPlace(char* data, size_t size);
+  static void toLowerInPlace(char* data, size_t size, Kernel kernel);
+
+  /**
+   * @return true if the value contains a CR or LF character.
+   */
+  static bool containsCrOrLf(absl::string_view value);
+  static bool containsCrOrLf(absl::string_view value, Kernel kernel);
+
+  /**
+   * @return the kernel selected for the running CPU.
+   */
+  static Kernel activeKernel();
+
+  /**
+   * @return all kernels the running CPU can execute, including the scalar one. Intended for tests
+   *         and benchmarks.
+   */
+  static std::vector<Kernel> supportedKernels();
+
+  static absl::string_view kernelName(Kernel kernel);
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -1,8 +1,11 @@
 #include "source/common/http/header_map_impl.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <new>
 #include <string>
 
 #include "envoy/http/header_map.h"
@@ -46,6 +49,52 @@ HeaderString::HeaderString(UnionString&& move_value) noexcept {
   ASSERT(valid());
 }
 
+HeaderMapImpl::HeaderNodePool::~HeaderNodePool() {
+  for (char* slab : slabs_) {
+    delete[] slab;
+  }
+}
+
+void* HeaderMapImpl::HeaderNodePool::allocate(size_t size) {
+  // Round up so that nodes carved out of a slab stay suitably aligned.
+  size = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+  if (node_size_ == 0) {
+    node_size_ = size;
+  }
+  if (size != node_size_) {
+    return ::operator new(size);
+  }
+  if (free_list_ != nullptr) {
+    FreeNode* node = free_list_;
+    free_list_ = node->next_;
+    return node;
+  }
+  return allocateFromSlab();
+}
+
+void* HeaderMapImpl::HeaderNodePool::allocateFromSlab() {
+  if (slab_cursor_ == slab_end_) {
+    const size_t slab_size = node_size_ * next_slab_nodes_;
+    slab_cursor_ = new char[slab_size];
+    slab_end_ = slab_cursor_ + slab_size;
+    slabs_.push_back(slab_cursor_);
+    next_slab_nodes_ = std::min(next_slab_nodes_ * 2, MaxSlabNodes);
+  }
+  void* node = slab_cursor_;
+  slab_cursor_ += node_size_;
+  return node;
+}
+
+void HeaderMapImpl::HeaderNodePool::deallocate(void* node, size_t size) {
+  size = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+  if (size != node_size_) {
+    ::operator delete(node);
+    return;
+  }
+  // The node memory is owned by a slab; keep it for reuse by later inserts.
+  free_list_ = new (node) FreeNode{free_list_};
+}
+
 // Specialization needed for HeaderMapImpl::HeaderList::insert() when key is LowerCaseString.
 // A fully specialized template must be defined once in the program, hence this may not be in
 // a header file.
@@ -16,6 +16,8 @@
 #include "source/common/common/utility.h"
 #include "source/common/http/headers.h"
 
+#include "absl/container/inlined_vector.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -113,6 +115,80 @@ public:
   StatefulHeaderKeyFormatterOptRef formatter() { return makeOptRefFromPtr(formatter_.get()); }
 
 protected:
+  /**
+   * Per header map storage for the header list nodes. Nodes are carved out of slabs that grow
+   * geometrically, so a typical request or response header map performs a handful of allocations
+   * instead of one per header and keeps its entries close together in memory. Removed nodes are
+   * recycled through a free list and all slabs are released when the header map (and so the
+   * stream owning it) is destroyed.
+   */
+  class HeaderNodePool : NonCopyable {
+  public:
+    ~HeaderNodePool();
+
+    void* allocate(size_t size);
+    void deallocate(void* node, size_t size);
+
+  private:
+    static constexpr size_t MinSlabNodes = 4;
+    static constexpr size_t MaxSlabNodes = 32;
+
+    struct FreeNode {
+      FreeNode* next_;
+    };
+
+    void* allocateFromSlab();
+
+    // The list only allocates nodes of a single size, which is latched by the first allocation.
+    size_t node_size_{};
+    FreeNode* free_list_{};
+    char* slab_cursor_{};
+    char* slab_end_{};
+    size_t next_slab_nodes_{MinSlabNodes};
+    absl::InlinedVector<char*, 4> slabs_;
+  };
+
+  /**
+   * Stateful allocator routing the header list node allocations to a HeaderNodePool.
+   */
+  template <class T> class HeaderNodeAllocator {
+  public:
+    using value_type = T;
+
+    explicit HeaderNodeAllocator(HeaderNodePool& pool) : pool_(&pool) {}
+    template <class U>
+    HeaderNodeAllocator(const HeaderNodeAllocator<U>& other) : pool_(other.pool_) {}
+
+    T* allocate(size_t n) {
+      if (n != 1) {
+        return std::allocator<T>().allocate(n);
+      }
+      return static_cast<T*>(pool_->allocate(sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+      if (n != 1) {
+        std::allocator<T>().deallocate(p, n);
+        return;
+      }
+      pool_->deallocate(p, sizeof(T));
+    }
+
+    template <class U> bool operator==(const HeaderNodeAllocator<U>& other) const {
+      return pool_ == other.pool_;
+    }
+    template <class U> bool operator!=(const HeaderNodeAllocator<U>& other) const {
+      return pool_ != other.pool_;
+    }
+
+  private:
+    template <class U> friend class HeaderNodeAllocator;
+
+    HeaderNodePool* pool_;
+  };
+
+  struct HeaderEntryImpl;
+  using HeaderEntryList = std::list<HeaderEntryImpl, HeaderNodeAllocator<HeaderEntryImpl>>;
+
   struct HeaderEntryImpl : public HeaderEntry, NonCopyable {
     HeaderEntryImpl(const LowerCaseString& key);
     HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value);
@@ -128,9 +204,9 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    HeaderEntryList::iterator entry_;
   };
-  using HeaderNode = std::list<HeaderEntryImpl>::iterator;
+  using HeaderNode = HeaderEntryList::iterator;
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
@@ -209,7 +285,9 @@ protected:
     using HeaderNodeVector = absl::InlinedVector<HeaderNode, 1>;
     using HeaderLazyMap = absl::flat_hash_map<absl::string_view, HeaderNodeVector>;
 
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    HeaderList()
+        : headers_(HeaderNodeAllocator<HeaderEntryImpl>(pool_)),
+          pseudo_headers_end_(headers_.end()) {}
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
@@ -299,12 +377,12 @@ protected:
      */
     size_t remove(absl::string_view key);
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
+    HeaderEntryList::iterator begin() { return headers_.begin(); }
+    HeaderEntryList::iterator end() { return headers_.end(); }
+    HeaderEntryList::const_iterator begin() const { return headers_.begin(); }
+    HeaderEntryList::const_iterator end() const { return headers_.end(); }
+    HeaderEntryList::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
+    HeaderEntryList::const_reverse_iterator rend() const { return headers_.rend(); }
     HeaderLazyMap::iterator mapFind(absl::string_view key) { return lazy_map_.find(key); }
     HeaderLazyMap::iterator mapEnd() { return lazy_map_.end(); }
     size_t size() const { return headers_.size(); }
@@ -316,7 +394,9 @@ protected:
     }
 
   private:
-    std::list<HeaderEntryImpl> headers_;
+    // The pool must outlive the list, so it is declared first.
+    HeaderNodePool pool_;
+    HeaderEntryList headers_;
     HeaderNode pseudo_headers_end_;
     HeaderLazyMap lazy_map_;
   };
@@ -18,6 +18,7 @@
 #include "source/common/common/utility.h"
 #include "source/common/grpc/common.h"
 #include "source/common/http/exception.h"
+#include "source/common/http/header_char_scan.h"
 #include "source/common/http/header_utility.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/http1/balsa_parser.h"
@@ -565,7 +566,8 @@ Status ConnectionImpl::completeCurrentHeader() {
     if (formatter.has_value()) {
       formatter->processKey(current_header_field_.getStringView());
     }
-    current_header_field_.inlineTransform([](char c) { return absl::ascii_tolower(c); });
+    current_header_field_.inlineTransformBuffer(
+        [](char* data, size_t size) { HeaderCharScan::toLowerInPlace(data, size); });
 
     headers_or_trailers.addViaMove(std::move(current_header_field_),
                                    std::move(current_header_value_));
@@ -2,9 +2,38 @@
 
 #include <sys/eventfd.h>
 
+#include "absl/numeric/bits.h"
+
 namespace Envoy {
 namespace Io {
 
+namespace {
+
+// A provided buffer lent to a read buffer. The buffer is handed back to the ring once the data has
+// been drained.
+class ProvidedBufferFragment : public Buffer::BufferFragment {
+public:
+  ProvidedBufferFragment(ProvidedBufferRingSharedPtr ring, uint16_t buffer_id, const void* data,
+                         size_t size)
+      : ring_(std::move(ring)), buffer_id_(buffer_id), data_(data), size_(size) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  void done() override {
+    ring_->recycle(buffer_id_);
+    delete this;
+  }
+
+private:
+  const ProvidedBufferRingSharedPtr ring_;
+  const uint16_t buffer_id_;
+  const void* const data_;
+  const size_t size_;
+};
+
+} // namespace
+
 bool isIoUringSupported() {
   struct io_uring_params p {};
   struct io_uring ring;
@@ -17,6 +46,88 @@ bool isIoUringSupported() {
   return is_supported;
 }
 
+ProvidedBufferRing::ProvidedBufferRing(uint32_t count, uint32_t buffer_size)
+    : count_(count), buffer_size_(buffer_size), owner_thread_id_(std::this_thread::get_id()),
+      memory_(std::make_unique<uint8_t[]>(static_cast<size_t>(count) * buffer_size)) {
+  ASSERT(absl::has_single_bit(count_));
+}
+
+bool ProvidedBufferRing::registerWith(struct io_uring& ring) {
+  ASSERT(ring_ == nullptr);
+  int ret = 0;
+  buf_ring_ = io_uring_setup_buf_ring(&ring, count_, GroupId, 0, &ret);
+  if (buf_ring_ == nullptr) {
+    ENVOY_LOG(warn, "unable to register io_uring provided buffer ring: {}", errorDetails(-ret));
+    return false;
+  }
+  ring_ = &ring;
+  {
+    absl::MutexLock lock(mutex_);
+    registered_ = true;
+  }
+  for (uint32_t i = 0; i < count_; ++i) {
+    provide(static_cast<uint16_t>(i));
+  }
+  return true;
+}
+
+void ProvidedBufferRing::unregister() {
+  ASSERT(std::this_thread::get_id() == owner_thread_id_);
+  if (ring_ == nullptr) {
+    return;
+  }
+  {
+    absl::MutexLock lock(mutex_);
+    registered_ = false;
+    pending_.clear();
+  }
+  io_uring_free_buf_ring(ring_, buf_ring_, count_, GroupId);
+  buf_ring_ = nullptr;
+  ring_ = nullptr;
+  available_ = 0;
+}
+
+Buffer::BufferFragment* ProvidedBufferRing::take(uint16_t buffer_id, uint32_t length) {
+  ASSERT(buffer_id < count_);
+  ASSERT(length <= buffer_size_);
+  return new ProvidedBufferFragment(shared_from_this(), buffer_id,
+                                    memory_.get() + static_cast<size_t>(buffer_id) * buffer_size_,
+                                    length);
+}
+
+void ProvidedBufferRing::recycle(uint16_t buffer_id) {
+  if (std::this_thread::get_id() == owner_thread_id_) {
+    if (ring_ != nullptr) {
+      provide(buffer_id);
+    }
+    return;
+  }
+  absl::MutexLock lock(mutex_);
+  if (registered_) {
+    pending_.push_back(buffer_id);
+  }
+}
+
+void ProvidedBufferRing::recyclePending() {
+  ASSERT(std::this_thread::get_id() == owner_thread_id_);
+  std::vector<uint16_t> pending;
+  {
+    absl::MutexLock lock(mutex_);
+    pending.swap(pending_);
+  }
+  for (uint16_t buffer_id : pending) {
+    provide(buffer_id);
+  }
+}
+
+void ProvidedBufferRing::provide(uint16_t buffer_id) {
+  ASSERT(available_ < count_);
+  io_uring_buf_ring_add(buf_ring_, memory_.get() + static_cast<size_t>(buffer_id) * buffer_size_,
+                        buffer_size_, buffer_id, io_uring_buf_ring_mask(count_), 0);
+  io_uring_buf_ring_advance(buf_ring_, 1);
+  ++available_;
+}
+
 IoUringImpl::IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polling)
     : cqes_(io_uring_size, nullptr) {
   struct io_uring_params p {};
@@ -30,7 +141,12 @@ IoUringImpl::IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polli
   RELEASE_ASSERT(ret == 0, fmt::format("unable to initialize io_uring: {}", errorDetails(-ret)));
 }
 
-IoUringImpl::~IoUringImpl() { io_uring_queue_exit(&ring_); }
+IoUringImpl::~IoUringImpl() {
+  if (provided_buffers_ != nullptr) {
+    provided_buffers_->unregister();
+  }
+  io_uring_queue_exit(&ring_);
+}
 
 os_fd_t IoUringImpl::registerEventfd() {
   ASSERT(!isEventfdRegistered());
@@ -65,11 +181,20 @@ void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
     }
   }
 
+  // Hand the buffers released on other threads back to the kernel before reaping completions
+  // which may have run out of buffers.
+  if (provided_buffers_ != nullptr) {
+    provided_buffers_->recyclePending();
+  }
+
   unsigned count = io_uring_peek_batch_cqe(&ring_, cqes_.data(), cqes_.size());
 
   for (unsigned i = 0; i < count; ++i) {
     struct io_uring_cqe* cqe = cqes_[i];
-    completion_cb(reinterpret_cast<Request*>(cqe->user_data), cqe->res, false);
+    if (provided_buffers_ != nullptr && (cqe->flags & IORING_CQE_F_BUFFER)) {
+      provided_buffers_->onBufferSelected();
+    }
+    completion_cb(reinterpret_cast<Request*>(cqe->user_data), cqe->res, cqe->flags, false);
   }
 
   io_uring_cq_advance(&ring_, count);
@@ -80,7 +205,7 @@ void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
   // Iterate the injected completion.
   while (!injected_completions_.empty()) {
     auto& completion = injected_completions_.front();
-    completion_cb(completion.user_data_, completion.result_, true);
+    completion_cb(completion.user_data_, completion.result_, 0, true);
     // The socket may closed in the completion_cb and all the related completions are
     // removed.
     if (injected_completions_.empty()) {
@@ -136,6 +261,23 @@ IoUringResult IoUringImpl::prepareReadv(os_fd_t fd, const struct iovec* iovecs,
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::prepareRecvMultishot(os_fd_t fd, Request* user_data) {
+  ENVOY_LOG(trace, "prepare multishot recv for fd = {}", fd);
+  ASSERT(provided_buffers_ != nullptr);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_recv_multishot(sqe, fd, nullptr, 0, 0);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = ProvidedBufferRing::GroupId;
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                          off_t offset, Request* user_data) {
   ENVOY_LOG(trace, "prepare writev for fd = {}", fd);
@@ -195,6 +337,32 @@ IoUringResult IoUringImpl::prepareShutdown(os_fd_t fd, int how, Request* user_da
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::registerProvidedBuffers(uint32_t count, uint32_t buffer_size) {
+  ASSERT(provided_buffers_ == nullptr);
+  // The kernel limits a buffer ring to 32768 entries.
+  count = std::min<uint32_t>(absl::bit_ceil(std::max<uint32_t>(count, 1)), 32768);
+  auto provided_buffers = std::make_shared<ProvidedBufferRing>(count, buffer_size);
+  if (!provided_buffers->registerWith(ring_)) {
+    return IoUringResult::Failed;
+  }
+  provided_buffers_ = std::move(provided_buffers);
+  return IoUringResult::Ok;
+}
+
+uint32_t IoUringImpl::availableProvidedBuffers() const {
+  return provided_buffers_ != nullptr ? provided_buffers_->available() : 0;
+}
+
+Buffer::BufferFragment* IoUringImpl::takeProvidedBuffer(uint16_t buffer_id, uint32_t length) {
+  ASSERT(provided_buffers_ != nullptr);
+  return provided_buffers_->take(buffer_id, length);
+}
+
+void IoUringImpl::recycleProvidedBuffer(uint16_t buffer_id) {
+  ASSERT(provided_buffers_ != nullptr);
+  provided_buffers_->recycle(buffer_id);
+}
+
 IoUringResult IoUringImpl::submit() {
   int res = io_uring_submit(&ring_);
   RELEASE_ASSERT(res >= 0 || res == -EBUSY, "unable to submit io_uring queue entries");
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <thread>
+
 #include "envoy/common/io/io_uring.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "source/common/common/logger.h"
 
+#include "absl/synchronization/mutex.h"
 #include "liburing.h"
 
 namespace Envoy {
@@ -21,6 +24,74 @@ struct InjectedCompletion {
   const int32_t result_;
 };
 
+/**
+ * A ring of buffers provided to the kernel for buffer selecting requests, registered with
+ * IORING_REGISTER_PBUF_RING. The kernel picks a buffer for every receive, and the buffer is lent
+ * to the read buffer of the socket as a fragment until the data has been drained. The buffer
+ * memory is kept alive by the outstanding fragments, so the ring may be unregistered while
+ * fragments are still in use.
+ */
+class ProvidedBufferRing : public std::enable_shared_from_this<ProvidedBufferRing>,
+                           protected Logger::Loggable<Logger::Id::io> {
+public:
+  // The buffer group id of the ring. Each io_uring instance registers at most one ring.
+  static constexpr uint16_t GroupId = 0;
+
+  ProvidedBufferRing(uint32_t count, uint32_t buffer_size);
+
+  /**
+   * Registers the ring with an io_uring instance and provides all buffers to the kernel.
+   * @return false if the kernel does not support provided buffer rings.
+   */
+  bool registerWith(struct io_uring& ring);
+
+  /**
+   * Unregisters the ring. Must be called before the io_uring instance is destroyed. Buffers which
+   * are returned after this are discarded.
+   */
+  void unregister();
+
+  Buffer::BufferFragment* take(uint16_t buffer_id, uint32_t length);
+
+  /**
+   * Hands a buffer back to the kernel. Buffers returned on other threads are queued and handed
+   * back by the owner thread in recyclePending().
+   */
+  void recycle(uint16_t buffer_id);
+
+  /**
+   * Hands the buffers queued by other threads back to the kernel.
+   */
+  void recyclePending();
+
+  /**
+   * Records that the kernel selected a buffer from the ring for a completion.
+   */
+  void onBufferSelected() {
+    ASSERT(available_ > 0);
+    --available_;
+  }
+
+  uint32_t available() const { return available_; }
+
+private:
+  void provide(uint16_t buffer_id);
+
+  const uint32_t count_;
+  const uint32_t buffer_size_;
+  const std::thread::id owner_thread_id_;
+  std::unique_ptr<uint8_t[]> memory_;
+  struct io_uring* ring_{};
+  struct io_uring_buf_ring* buf_ring_{};
+  // The number of buffers currently owned by the kernel. Only accessed by the owner thread.
+  uint32_t available_{};
+  absl::Mutex mutex_;
+  std::vector<uint16_t> pending_ ABSL_GUARDED_BY(mutex_);
+  bool registered_ ABSL_GUARDED_BY(mutex_){false};
+};
+
+using ProvidedBufferRingSharedPtr = std::shared_ptr<ProvidedBufferRing>;
+
 class IoUringImpl : public IoUring,
                     public ThreadLocal::ThreadLocalObject,
                     protected Logger::Loggable<Logger::Id::io> {
@@ -38,11 +109,16 @@ public:
                                Request* user_data) override;
   IoUringResult prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                              Request* user_data) override;
+  IoUringResult prepareRecvMultishot(os_fd_t fd, Request* user_data) override;
   IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                               off_t offset, Request* user_data) override;
   IoUringResult prepareClose(os_fd_t fd, Request* user_data) override;
   IoUringResult prepareCancel(Request* cancelling_user_data, Request* user_data) override;
   IoUringResult prepareShutdown(os_fd_t fd, int how, Request* user_data) override;
+  IoUringResult registerProvidedBuffers(uint32_t count, uint32_t buffer_size) override;
+  uint32_t availableProvidedBuffers() const override;
+  Buffer::BufferFragment* takeProvidedBuffer(uint16_t buffer_id, uint32_t length) override;
+  void recycleProvidedBuffer(uint16_t buffer_id) override;
   IoUringResult submit() override;
   void injectCompletion(os_fd_t fd, Request* user_data, int32_t result) override;
   void removeInjectedCompletion(os_fd_t fd) override;
@@ -52,6 +128,7 @@ private:
   std::vector<struct io_uring_cqe*> cqes_;
   os_fd_t event_fd_{INVALID_SOCKET};
   std::list<InjectedCompletion> injected_completions_;
+  ProvidedBufferRingSharedPtr provided_buffers_;
 };
 
 } // namespace Io
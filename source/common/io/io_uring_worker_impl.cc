@@ -10,6 +10,37 @@ ReadRequest::ReadRequest(IoUringSocket& socket, uint32_t size)
   iov_->iov_len = size;
 }
 
+void ReadRequest::moveDataToBuffer(Buffer::Instance& buffer, uint32_t length) {
+  Buffer::BufferFragment* fragment = new Buffer::BufferFragmentImpl(
+      buf_.release(), length,
+      [](const void* data, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
+        delete[] reinterpret_cast<const uint8_t*>(data);
+        delete this_fragment;
+      });
+  buffer.addBufferFragment(*fragment);
+}
+
+void RecvMultishotRequest::moveDataToBuffer(Buffer::Instance& buffer, uint32_t length) {
+  ASSERT(buffer_id_.has_value());
+  buffer.addBufferFragment(*io_uring_.takeProvidedBuffer(buffer_id_.value(), length));
+  buffer_id_.reset();
+}
+
+void RecvMultishotRequest::onCompletion(uint32_t flags) {
+  ASSERT(!buffer_id_.has_value());
+  more_ = (flags & IORING_CQE_F_MORE) != 0;
+  if (flags & IORING_CQE_F_BUFFER) {
+    buffer_id_ = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+  }
+}
+
+void RecvMultishotRequest::recycleUnconsumedBuffer() {
+  if (buffer_id_.has_value()) {
+    io_uring_.recycleProvidedBuffer(buffer_id_.value());
+    buffer_id_.reset();
+  }
+}
+
 WriteRequest::WriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices)
     : Request(RequestType::Write, socket), iov_(std::make_unique<struct iovec[]>(slices.size())) {
   for (size_t i = 0; i < slices.size(); i++) {
@@ -60,14 +91,22 @@ void IoUringSocketEntry::onRemoteClose() {
 
 IoUringWorkerImpl::IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                                      uint32_t read_buffer_size, uint32_t write_timeout_ms,
-                                     Event::Dispatcher& dispatcher)
+                                     Event::Dispatcher& dispatcher, uint32_t provided_buffer_count)
     : IoUringWorkerImpl(std::make_unique<IoUringImpl>(io_uring_size, use_submission_queue_polling),
-                        read_buffer_size, write_timeout_ms, dispatcher) {}
+                        read_buffer_size, write_timeout_ms, dispatcher, provided_buffer_count) {}
 
 IoUringWorkerImpl::IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size,
-                                     uint32_t write_timeout_ms, Event::Dispatcher& dispatcher)
+                                     uint32_t write_timeout_ms, Event::Dispatcher& dispatcher,
+                                     uint32_t provided_buffer_count)
     : io_uring_(std::move(io_uring)), read_buffer_size_(read_buffer_size),
       write_timeout_ms_(write_timeout_ms), dispatcher_(dispatcher) {
+  if (provided_buffer_count > 0) {
+    // Fall back to single shot reads into heap buffers if the kernel lacks provided buffer rings.
+    multishot_recv_enabled_ = io_uring_->registerProvidedBuffers(
+                                  provided_buffer_count, read_buffer_size_) == IoUringResult::Ok;
+    ENVOY_LOG(debug, "io_uring multishot recv is {}",
+              multishot_recv_enabled_ ? "enabled" : "not supported");
+  }
   const os_fd_t event_fd = io_uring_->registerEventfd();
   // We only care about the read event of Eventfd, since we only receive the
   // event here.
@@ -153,6 +192,14 @@ IoUringWorkerImpl::submitConnectRequest(IoUringSocket& socket,
 }
 
 Request* IoUringWorkerImpl::submitReadRequest(IoUringSocket& socket) {
+  // A disabled socket only reads to detect the remote close, so it keeps using single shot reads
+  // which don't keep draining the socket. Single shot reads are also used as long as all the
+  // provided buffers are lent out.
+  if (multishot_recv_enabled_ && socket.getStatus() == ReadEnabled &&
+      io_uring_->availableProvidedBuffers() > 0) {
+    return submitRecvMultishotRequest(socket);
+  }
+
   ReadRequest* req = new ReadRequest(socket, read_buffer_size_);
 
   ENVOY_LOG(trace, "submit read request, fd = {}, read req = {}", socket.fd(), fmt::ptr(req));
@@ -168,6 +215,23 @@ Request* IoUringWorkerImpl::submitReadRequest(IoUringSocket& socket) {
   return req;
 }
 
+Request* IoUringWorkerImpl::submitRecvMultishotRequest(IoUringSocket& socket) {
+  RecvMultishotRequest* req = new RecvMultishotRequest(socket, *io_uring_);
+
+  ENVOY_LOG(trace, "submit multishot recv request, fd = {}, read req = {}", socket.fd(),
+            fmt::ptr(req));
+
+  auto res = io_uring_->prepareRecvMultishot(socket.fd(), req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareRecvMultishot(socket.fd(), req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare multishot recv");
+  }
+  submit();
+  return req;
+}
+
 Request* IoUringWorkerImpl::submitWriteRequest(IoUringSocket& socket,
                                                const Buffer::RawSliceVector& slices) {
   WriteRequest* req = new WriteRequest(socket, slices);
@@ -251,7 +315,8 @@ void IoUringWorkerImpl::injectCompletion(IoUringSocket& socket, Request::Request
 void IoUringWorkerImpl::onFileEvent() {
   ENVOY_LOG(trace, "io uring worker, on file event");
   delay_submit_ = true;
-  io_uring_->forEveryCompletion([](Request* req, int32_t result, bool injected) {
+  io_uring_->forEveryCompletion([this](Request* req, int32_t result, uint32_t flags,
+                                       bool injected) {
     ENVOY_LOG(trace, "receive request completion, type = {}, req = {}",
               static_cast<uint8_t>(req->type()), fmt::ptr(req));
     ASSERT(req != nullptr);
@@ -270,6 +335,20 @@ void IoUringWorkerImpl::onFileEvent() {
     case Request::RequestType::Read:
       ENVOY_LOG(trace, "receive Read request completion, fd = {}, req = {}", req->socket().fd(),
                 fmt::ptr(req));
+      // Non-injected read completions always belong to a ReadRequest, and only an armed
+      // multishot recv request expects more completions.
+      if (multishot_recv_enabled_ && !injected &&
+          static_cast<ReadRequest*>(req)->hasMoreCompletions()) {
+        RecvMultishotRequest* recv_req = static_cast<RecvMultishotRequest*>(req);
+        recv_req->onCompletion(flags);
+        req->socket().onRead(req, result, injected);
+        recv_req->recycleUnconsumedBuffer();
+        if (recv_req->hasMoreCompletions()) {
+          // The request stays armed, so it must not be released yet.
+          return;
+        }
+        break;
+      }
       req->socket().onRead(req, result, injected);
       break;
     case Request::RequestType::Write:
@@ -338,7 +417,7 @@ void IoUringServerSocket::close(bool keep_fd_open, IoUringSocketOnClosedCb cb) {
     return;
   }
 
-  if (read_req_ != nullptr) {
+  if (read_req_ != nullptr && read_cancel_req_ == nullptr) {
     ENVOY_LOG(trace, "cancel the read request, fd = {}", fd_);
     read_cancel_req_ = parent_.submitCancelRequest(*this, read_req_);
   }
@@ -372,7 +451,20 @@ void IoUringServerSocket::enableRead() {
   submitReadRequest();
 }
 
-void IoUringServerSocket::disableRead() { IoUringSocketEntry::disableRead(); }
+void IoUringServerSocket::disableRead() {
+  IoUringSocketEntry::disableRead();
+  // An armed multishot recv keeps reading regardless of the socket status, so cancel it. Once it
+  // terminates a single shot read is submitted to detect the remote close.
+  if (isRecvMultishotArmed() && read_cancel_req_ == nullptr) {
+    ENVOY_LOG(trace, "cancel the multishot recv request, fd = {}", fd_);
+    read_cancel_req_ = parent_.submitCancelRequest(*this, read_req_);
+  }
+}
+
+bool IoUringServerSocket::isRecvMultishotArmed() const {
+  return read_req_ != nullptr && read_req_->type() == Request::RequestType::Read &&
+         static_cast<ReadRequest*>(read_req_)->hasMoreCompletions();
+}
 
 void IoUringServerSocket::write(Buffer::Instance& data) {
   ENVOY_LOG(trace, "write, buffer size = {}, fd = {}", data.length(), fd_);
@@ -429,14 +521,7 @@ void IoUringServerSocket::onCancel(Request* req, int32_t result, bool injected)
 }
 
 void IoUringServerSocket::moveReadDataToBuffer(Request* req, size_t data_length) {
-  ReadRequest* read_req = static_cast<ReadRequest*>(req);
-  Buffer::BufferFragment* fragment = new Buffer::BufferFragmentImpl(
-      read_req->buf_.release(), data_length,
-      [](const void* data, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
-        delete[] reinterpret_cast<const uint8_t*>(data);
-        delete this_fragment;
-      });
-  read_buf_.addBufferFragment(*fragment);
+  static_cast<ReadRequest*>(req)->moveDataToBuffer(read_buf_, data_length);
 }
 
 void IoUringServerSocket::onReadCompleted(int32_t result) {
@@ -457,10 +542,13 @@ void IoUringServerSocket::onRead(Request* req, int32_t result, bool injected) {
             "onRead with result {}, fd = {}, injected = {}, status_ = {}, enable_close_event = {}",
             result, fd_, injected, static_cast<int>(status_), enable_close_event_);
   if (!injected) {
-    read_req_ = nullptr;
+    // An armed multishot recv request stays in flight after this completion.
+    if (!static_cast<ReadRequest*>(req)->hasMoreCompletions()) {
+      read_req_ = nullptr;
+    }
     // If the socket is going to close, discard all results.
-    if (status_ == Closed && write_or_shutdown_req_ == nullptr && read_cancel_req_ == nullptr &&
-        write_or_shutdown_cancel_req_ == nullptr) {
+    if (status_ == Closed && read_req_ == nullptr && write_or_shutdown_req_ == nullptr &&
+        read_cancel_req_ == nullptr && write_or_shutdown_cancel_req_ == nullptr) {
       if (result > 0 && keep_fd_open_) {
         moveReadDataToBuffer(req, result);
       }
@@ -473,7 +561,9 @@ void IoUringServerSocket::onRead(Request* req, int32_t result, bool injected) {
   if (result > 0) {
     moveReadDataToBuffer(req, result);
   } else {
-    if (result != -ECANCELED) {
+    // A multishot recv terminates with -ENOBUFS once all provided buffers are lent out, which is
+    // not an error of the socket. The next read request falls back to a single shot read.
+    if (result != -ECANCELED && result != -ENOBUFS) {
       read_error_ = result;
     }
   }
@@ -14,8 +14,54 @@ class ReadRequest : public Request {
 public:
   ReadRequest(IoUringSocket& socket, uint32_t size);
 
+  /**
+   * Moves the data read by the request into the buffer without copying.
+   * @param buffer the buffer to move the data to.
+   * @param length the number of bytes read.
+   */
+  virtual void moveDataToBuffer(Buffer::Instance& buffer, uint32_t length);
+
+  /**
+   * @return true if the kernel will post more completions for this request.
+   */
+  virtual bool hasMoreCompletions() const { return false; }
+
   std::unique_ptr<uint8_t[]> buf_;
   std::unique_ptr<struct iovec> iov_;
+
+protected:
+  explicit ReadRequest(IoUringSocket& socket) : Request(RequestType::Read, socket) {}
+};
+
+/**
+ * A multishot recv request which reads into buffers selected from the provided buffer ring. A
+ * single submission keeps draining the socket until it is canceled or fails.
+ */
+class RecvMultishotRequest : public ReadRequest {
+public:
+  RecvMultishotRequest(IoUringSocket& socket, IoUring& io_uring)
+      : ReadRequest(socket), io_uring_(io_uring) {}
+
+  // ReadRequest
+  void moveDataToBuffer(Buffer::Instance& buffer, uint32_t length) override;
+  bool hasMoreCompletions() const override { return more_; }
+
+  /**
+   * Records the flags of a completion of this request.
+   */
+  void onCompletion(uint32_t flags);
+
+  /**
+   * Hands the buffer of the last completion back to the ring if the socket did not consume it.
+   */
+  void recycleUnconsumedBuffer();
+
+private:
+  IoUring& io_uring_;
+  // The request remains armed until a completion without IORING_CQE_F_MORE is posted.
+  bool more_{true};
+  // The provided buffer selected by the kernel for the last completion, if not consumed yet.
+  absl::optional<uint16_t> buffer_id_;
 };
 
 class WriteRequest : public Request {
@@ -30,11 +76,16 @@ using IoUringSocketEntryPtr = std::unique_ptr<IoUringSocketEntry>;
 
 class IoUringWorkerImpl : public IoUringWorker, private Logger::Loggable<Logger::Id::io> {
 public:
+  /**
+   * @param provided_buffer_count the number of read_buffer_size buffers to register as a provided
+   * buffer ring for multishot recv. Multishot recv is disabled if zero or if the kernel does not
+   * support provided buffer rings.
+   */
   IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                     uint32_t read_buffer_size, uint32_t write_timeout_ms,
-                    Event::Dispatcher& dispatcher);
+                    Event::Dispatcher& dispatcher, uint32_t provided_buffer_count = 0);
   IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size, uint32_t write_timeout_ms,
-                    Event::Dispatcher& dispatcher);
+                    Event::Dispatcher& dispatcher, uint32_t provided_buffer_count = 0);
   ~IoUringWorkerImpl() override;
 
   // IoUringWorker
@@ -64,11 +115,15 @@ public:
   // Return the number of sockets in this worker.
   uint32_t getNumOfSockets() const override { return sockets_.size(); }
 
+  // Return whether read requests of read enabled sockets use multishot recv.
+  bool multishotRecvEnabled() const { return multishot_recv_enabled_; }
+
 protected:
   // Add a socket to the worker.
   IoUringSocketEntry& addSocket(IoUringSocketEntryPtr&& socket);
   void onFileEvent();
   void submit();
+  Request* submitRecvMultishotRequest(IoUringSocket& socket);
 
   // The iouring instance.
   IoUringPtr io_uring_;
@@ -84,6 +139,8 @@ protected:
   // The IoUringWorker will delay the submit the requests which are submitted in request completion
   // callback.
   bool delay_submit_{false};
+  // Whether a provided buffer ring is registered and multishot recv is used for reading.
+  bool multishot_recv_enabled_{false};
 };
 
 class IoUringSocketEntry : public IoUringSocket,
@@ -247,6 +304,7 @@ protected:
   void submitReadRequest();
   void submitWriteOrShutdownRequest();
   void moveReadDataToBuffer(Request* req, size_t data_length);
+  bool isRecvMultishotArmed() const;
   void onReadCompleted(int32_t result);
   void onWriteCompleted(int32_t result);
 };
@@ -1785,39 +1785,164 @@ VirtualHostImpl::VirtualHostImpl(const envoy::config::route::v3::VirtualHost& vi
       SET_AND_RETURN_IF_NOT_OK(route_or_error.status(), creation_status);
       routes_.emplace_back(route_or_error.value());
     }
+    route_index_ = RouteIndex::create(
+        routes_, shared_virtual_host_->globalRouteConfig().ignorePathParametersInPathMatching());
   }
 }
 
-RouteConstSharedPtr VirtualHostImpl::getRouteFromRoutes(
-    const RouteCallback& cb, const Http::RequestHeaderMap& headers,
-    const StreamInfo::StreamInfo& stream_info, uint64_t random_value,
-    absl::Span<const RouteEntryImplBaseConstSharedPtr> routes) const {
-  for (auto route = routes.begin(); route != routes.end(); ++route) {
-    if (!headers.Path() && !(*route)->supportsPathlessHeaders()) {
-      continue;
+std::unique_ptr<const RouteIndex>
+RouteIndex::create(absl::Span<const RouteEntryImplBaseConstSharedPtr> routes,
+                   bool ignore_path_parameters) {
+  if (routes.size() < MinRoutesForIndex) {
+    return nullptr;
+  }
+
+  std::unique_ptr<RouteIndex> index(new RouteIndex(ignore_path_parameters));
+  index->prefix_trie_.emplace_back();
+  for (uint32_t position = 0; position < routes.size(); position++) {
+    const RouteEntryImplBase* route = routes[position].get();
+    // Only the case sensitive exact and prefix routes can be pruned by path. The route classes
+    // are matched exactly so that other route types with the same match type are never indexed.
+    if (const auto* path_route = dynamic_cast<const PathRouteEntryImpl*>(route);
+        path_route != nullptr && path_route->case_sensitive()) {
+      index->exact_[path_route->matcher()].push_back(position);
+    } else if (const auto* prefix_route = dynamic_cast<const PrefixRouteEntryImpl*>(route);
+               prefix_route != nullptr && prefix_route->case_sensitive()) {
+      index->addPrefix(prefix_route->matcher(), position);
+    } else {
+      index->fallback_.push_back(position);
     }
+  }
 
-    RouteConstSharedPtr route_entry = (*route)->matches(headers, stream_info, random_value);
-    if (route_entry == nullptr) {
-      continue;
+  // The index doesn't pay off if nearly every route must be evaluated anyway.
+  if (index->fallback_.size() + MinRoutesForIndex / 2 >= routes.size()) {
+    return nullptr;
+  }
+  return index;
+}
+
+void RouteIndex::addPrefix(absl::string_view prefix, uint32_t position) {
+  uint32_t node = 0;
+  for (const char c : prefix) {
+    auto it = prefix_trie_[node].children_.find(c);
+    if (it == prefix_trie_[node].children_.end()) {
+      const uint32_t child = prefix_trie_.size();
+      prefix_trie_[node].children_.emplace(c, child);
+      prefix_trie_.emplace_back();
+      node = child;
+    } else {
+      node = it->second;
     }
+  }
+  prefix_trie_[node].routes_.push_back(position);
+}
 
-    if (cb == nullptr) {
-      return route_entry;
+void RouteIndex::candidates(absl::string_view path, Candidates& out) const {
+  // Derive the path exactly as the path and prefix route entries do before matching.
+  if (ignore_path_parameters_) {
+    const size_t pos = path.find_first_of(';');
+    if (pos != absl::string_view::npos) {
+      path.remove_suffix(path.length() - pos);
     }
+  }
+  path = Http::PathUtil::removeQueryAndFragment(path);
+
+  if (const auto it = exact_.find(path); it != exact_.end()) {
+    out.insert(out.end(), it->second.begin(), it->second.end());
+  }
+
+  uint32_t node = 0;
+  for (size_t i = 0;; i++) {
+    const TrieNode& trie_node = prefix_trie_[node];
+    out.insert(out.end(), trie_node.routes_.begin(), trie_node.routes_.end());
+    if (i == path.size()) {
+      break;
+    }
+    const auto it = trie_node.children_.find(path[i]);
+    if (it == trie_node.children_.end()) {
+      break;
+    }
+    node = it->second;
+  }
+
+  std::sort(out.begin(), out.end());
+}
 
-    RouteEvalStatus eval_status = (std::next(route) == routes.end())
-                                      ? RouteEvalStatus::NoMoreRoutes
-                                      : RouteEvalStatus::HasMoreRoutes;
-    RouteMatchStatus match_status = cb(route_entry, eval_status);
-    if (match_status == RouteMatchStatus::Accept) {
+RouteConstSharedPtr VirtualHostImpl::evaluateRoute(const RouteCallback& cb,
+                                                   const Http::RequestHeaderMap& headers,
+                                                   const StreamInfo::StreamInfo& stream_info,
+                                                   uint64_t random_value,
+                                                   const RouteEntryImplBase& route,
+                                                   bool last_route, bool& stop) const {
+  if (!headers.Path() && !route.supportsPathlessHeaders()) {
+    return nullptr;
+  }
+
+  RouteConstSharedPtr route_entry = route.matches(headers, stream_info, random_value);
+  if (route_entry == nullptr) {
+    return nullptr;
+  }
+
+  stop = true;
+  if (cb == nullptr) {
+    return route_entry;
+  }
+
+  RouteEvalStatus eval_status =
+      last_route ? RouteEvalStatus::NoMoreRoutes : RouteEvalStatus::HasMoreRoutes;
+  RouteMatchStatus match_status = cb(route_entry, eval_status);
+  if (match_status == RouteMatchStatus::Accept) {
+    return route_entry;
+  }
+  if (match_status == RouteMatchStatus::Continue && eval_status == RouteEvalStatus::NoMoreRoutes) {
+    ENVOY_LOG(debug, "return null when route match status is Continue but there is no more routes");
+    return nullptr;
+  }
+  stop = false;
+  return nullptr;
+}
+
+RouteConstSharedPtr VirtualHostImpl::getRouteFromIndex(const RouteCallback& cb,
+                                                       const Http::RequestHeaderMap& headers,
+                                                       const StreamInfo::StreamInfo& stream_info,
+                                                       uint64_t random_value) const {
+  RouteIndex::Candidates candidates;
+  route_index_->candidates(headers.getPathValue(), candidates);
+  const std::vector<uint32_t>& fallback = route_index_->fallback();
+
+  // Merge the indexed candidates with the fallback routes so that all of them are evaluated in
+  // configuration order. The eval status passed to the callback reflects the position in the full
+  // route list, as with the linear scan.
+  size_t i = 0;
+  size_t j = 0;
+  while (i < candidates.size() || j < fallback.size()) {
+    const uint32_t position =
+        (j == fallback.size() || (i < candidates.size() && candidates[i] < fallback[j]))
+            ? candidates[i++]
+            : fallback[j++];
+    bool stop = false;
+    RouteConstSharedPtr route_entry =
+        evaluateRoute(cb, headers, stream_info, random_value, *routes_[position],
+                      position + 1 == routes_.size(), stop);
+    if (stop) {
       return route_entry;
     }
-    if (match_status == RouteMatchStatus::Continue &&
-        eval_status == RouteEvalStatus::NoMoreRoutes) {
-      ENVOY_LOG(debug,
-                "return null when route match status is Continue but there is no more routes");
-      return nullptr;
+  }
+
+  ENVOY_LOG(debug, "route was resolved but final route list did not match incoming request");
+  return nullptr;
+}
+
+RouteConstSharedPtr VirtualHostImpl::getRouteFromRoutes(
+    const RouteCallback& cb, const Http::RequestHeaderMap& headers,
+    const StreamInfo::StreamInfo& stream_info, uint64_t random_value,
+    absl::Span<const RouteEntryImplBaseConstSharedPtr> routes) const {
+  for (auto route = routes.begin(); route != routes.end(); ++route) {
+    bool stop = false;
+    RouteConstSharedPtr route_entry = evaluateRoute(cb, headers, stream_info, random_value, **route,
+                                                    std::next(route) == routes.end(), stop);
+    if (stop) {
+      return route_entry;
     }
   }
 
@@ -1875,6 +2000,9 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
   }
 
   // Check for a route that matches the request.
+  if (route_index_ != nullptr && headers.Path() != nullptr) {
+    return getRouteFromIndex(cb, headers, stream_info, random_value);
+  }
   return getRouteFromRoutes(cb, headers, stream_info, random_value, routes_);
 }
 
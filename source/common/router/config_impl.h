@@ -38,6 +38,7 @@
 #include "source/common/router/tls_context_match_criteria_impl.h"
 #include "source/common/stats/symbol_table.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/container/node_hash_map.h"
@@ -360,6 +361,58 @@ private:
   const bool include_is_timeout_retry_header_ : 1;
 };
 
+/**
+ * Index over the ordered routes of a virtual host, built when the route configuration is loaded.
+ * Case sensitive exact path routes are indexed by path in a hash map and case sensitive prefix
+ * routes in a trie. All other routes (regex, path template, path separated prefix, CONNECT and
+ * case insensitive routes) are kept in an ordered fallback list.
+ *
+ * The index only prunes routes whose path condition cannot hold for a request. The remaining
+ * candidates are still evaluated with their full matches() in configuration order, so the first
+ * matching route is the same as with a linear scan over all routes.
+ */
+class RouteIndex {
+public:
+  // Below this many routes the linear scan is at least as cheap as the index.
+  static constexpr size_t MinRoutesForIndex = 16;
+
+  /**
+   * @return the index for the routes, or nullptr if the routes are not worth indexing.
+   */
+  static std::unique_ptr<const RouteIndex>
+  create(absl::Span<const RouteEntryImplBaseConstSharedPtr> routes,
+         bool ignore_path_parameters);
+
+  using Candidates = absl::InlinedVector<uint32_t, 8>;
+
+  /**
+   * Collect the positions of the indexed routes whose path condition may match the request path,
+   * in ascending order. Routes in fallback() are not included.
+   */
+  void candidates(absl::string_view path, Candidates& out) const;
+
+  /**
+   * @return the positions of the routes that are not indexed, in ascending order.
+   */
+  const std::vector<uint32_t>& fallback() const { return fallback_; }
+
+private:
+  struct TrieNode {
+    absl::flat_hash_map<char, uint32_t> children_;
+    // Positions of the prefix routes whose prefix ends at this node.
+    std::vector<uint32_t> routes_;
+  };
+
+  RouteIndex(bool ignore_path_parameters) : ignore_path_parameters_(ignore_path_parameters) {}
+
+  void addPrefix(absl::string_view prefix, uint32_t position);
+
+  const bool ignore_path_parameters_;
+  absl::flat_hash_map<std::string, std::vector<uint32_t>> exact_;
+  std::vector<TrieNode> prefix_trie_;
+  std::vector<uint32_t> fallback_;
+};
+
 /**
  * Virtual host that holds a collection of routes.
  */
@@ -386,12 +439,24 @@ public:
 private:
   enum class SslRequirements : uint8_t { None, ExternalOnly, All };
 
+  // Evaluate a single route. Sets stop to true if the route evaluation is finished and the
+  // returned route (possibly nullptr) is the final result.
+  RouteConstSharedPtr evaluateRoute(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
+                                    const StreamInfo::StreamInfo& stream_info,
+                                    uint64_t random_value, const RouteEntryImplBase& route,
+                                    bool last_route, bool& stop) const;
+  RouteConstSharedPtr getRouteFromIndex(const RouteCallback& cb,
+                                        const Http::RequestHeaderMap& headers,
+                                        const StreamInfo::StreamInfo& stream_info,
+                                        uint64_t random_value) const;
+
   CommonVirtualHostSharedPtr shared_virtual_host_;
 
   std::shared_ptr<const SslRedirectRoute> ssl_redirect_route_;
   SslRequirements ssl_requirements_;
 
   absl::InlinedVector<RouteEntryImplBaseConstSharedPtr, 2> routes_;
+  std::unique_ptr<const RouteIndex> route_index_;
   Matcher::MatchTreeSharedPtr<Http::HttpMatchingData> matcher_;
 };
 
@@ -991,6 +1056,7 @@ public:
 
 private:
   friend class RouteCreator;
+  friend class RouteIndex;
   PrefixRouteEntryImpl(const CommonVirtualHostSharedPtr& vhost,
                        const envoy::config::route::v3::Route& route,
                        Server::Configuration::ServerFactoryContext& factory_context,
@@ -1025,6 +1091,7 @@ public:
 
 private:
   friend class RouteCreator;
+  friend class RouteIndex;
   PathRouteEntryImpl(const CommonVirtualHostSharedPtr& vhost,
                      const envoy::config::route::v3::Route& route,
                      Server::Configuration::ServerFactoryContext& factory_context,
@@ -1,7 +1,11 @@
 #include "source/common/stats/allocator_impl.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
 
 #include "envoy/stats/sink.h"
 #include "envoy/stats/stats.h"
@@ -23,6 +27,33 @@ namespace Stats {
 
 const char AllocatorImpl::DecrementToZeroSyncPoint[] = "decrement-zero";
 
+namespace {
+
+// Upper bound on the number of slots of a sharded counter. Threads beyond this share slots.
+constexpr uint32_t MaxCounterShards = 64;
+
+uint32_t counterShardCount() {
+  const uint32_t concurrency = std::max(1U, std::thread::hardware_concurrency());
+  uint32_t shards = 1;
+  while (shards < concurrency && shards < MaxCounterShards) {
+    shards <<= 1;
+  }
+  return shards;
+}
+
+// Each thread picks a slot on its first increment of any sharded counter and keeps it, so a
+// worker always hits the same cache line of a given counter.
+uint32_t threadCounterShard() {
+  static std::atomic<uint32_t> next_shard{0};
+  thread_local const uint32_t shard = next_shard.fetch_add(1, std::memory_order_relaxed);
+  return shard;
+}
+
+} // namespace
+
+AllocatorImpl::AllocatorImpl(SymbolTable& symbol_table)
+    : symbol_table_(symbol_table), counter_shards_(counterShardCount()) {}
+
 AllocatorImpl::~AllocatorImpl() {
   ASSERT(counters_.empty());
   ASSERT(gauges_.empty());
@@ -167,6 +198,66 @@ private:
   std::atomic<uint64_t> pending_increment_{0};
 };
 
+// A counter whose value is spread over per-thread slots, each on its own cache line, so that hot
+// counters incremented by every worker do not bounce a single cache line between cores. Reads
+// sum the slots and are therefore O(shards); they happen on flush and admin paths only.
+class ShardedCounterImpl : public StatsSharedImpl<Counter> {
+public:
+  ShardedCounterImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
+                     const StatNameTagVector& stat_name_tags, uint32_t shards)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags),
+        shards_(std::make_unique<Shard[]>(shards)), shard_mask_(shards - 1) {
+    ASSERT(shards > 0 && (shards & shard_mask_) == 0);
+  }
+
+  void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) override {
+    const size_t count = alloc_.counters_.erase(statName());
+    ASSERT(count == 1);
+    alloc_.sinked_counters_.erase(this);
+  }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    Shard& shard = shards_[threadCounterShard() & shard_mask_];
+    shard.value_.fetch_add(amount, std::memory_order_relaxed);
+    shard.pending_increment_.fetch_add(amount, std::memory_order_relaxed);
+    // Only write the shared flags word when the bit changes, otherwise every increment would
+    // contend on it again.
+    if (!(flags_.load(std::memory_order_relaxed) & Flags::Used)) {
+      flags_ |= Flags::Used;
+    }
+  }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    uint64_t pending = 0;
+    for (uint32_t i = 0; i <= shard_mask_; ++i) {
+      pending += shards_[i].pending_increment_.exchange(0);
+    }
+    return pending;
+  }
+  void reset() override {
+    for (uint32_t i = 0; i <= shard_mask_; ++i) {
+      shards_[i].value_ = 0;
+    }
+  }
+  uint64_t value() const override {
+    uint64_t value = 0;
+    for (uint32_t i = 0; i <= shard_mask_; ++i) {
+      value += shards_[i].value_.load(std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value_{0};
+    std::atomic<uint64_t> pending_increment_{0};
+  };
+
+  const std::unique_ptr<Shard[]> shards_;
+  const uint32_t shard_mask_;
+};
+
 class GaugeImpl : public StatsSharedImpl<Gauge> {
 public:
   GaugeImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
@@ -367,9 +458,20 @@ bool AllocatorImpl::isMutexLockedForTest() {
 
 Counter* AllocatorImpl::makeCounterInternal(StatName name, StatName tag_extracted_name,
                                             const StatNameTagVector& stat_name_tags) {
+  // Called from makeCounter() with mutex_ held.
+  if (sharded_counter_matcher_ != nullptr && !sharded_counter_matcher_->rejects(name)) {
+    return new ShardedCounterImpl(name, *this, tag_extracted_name, stat_name_tags,
+                                  counter_shards_);
+  }
   return new CounterImpl(name, *this, tag_extracted_name, stat_name_tags);
 }
 
+void AllocatorImpl::setShardedCounterMatcher(StatsMatcherPtr&& matcher) {
+  Thread::LockGuard lock(mutex_);
+  // A matcher rejecting everything is equivalent to no sharding; skip the per-counter match.
+  sharded_counter_matcher_ = matcher->rejectsAll() ? nullptr : std::move(matcher);
+}
+
 void AllocatorImpl::forEachCounter(SizeFn f_size, StatFn<Counter> f_stat) const {
   Thread::LockGuard lock(mutex_);
   if (f_size != nullptr) {
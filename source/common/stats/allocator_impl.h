@@ -6,6 +6,7 @@
 #include "envoy/stats/allocator.h"
 #include "envoy/stats/sink.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/stats_matcher.h"
 
 #include "source/common/common/thread_synchronizer.h"
 #include "source/common/stats/metric_impl.h"
@@ -20,7 +21,7 @@ class AllocatorImpl : public Allocator {
 public:
   static const char DecrementToZeroSyncPoint[];
 
-  AllocatorImpl(SymbolTable& symbol_table) : symbol_table_(symbol_table) {}
+  AllocatorImpl(SymbolTable& symbol_table);
   ~AllocatorImpl() override;
 
   // Allocator
@@ -45,6 +46,7 @@ public:
   void forEachSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) const override;
 
   void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) override;
+  void setShardedCounterMatcher(StatsMatcherPtr&& matcher) override;
 #ifndef ENVOY_CONFIG_COVERAGE
   void debugPrint();
 #endif
@@ -70,6 +72,7 @@ protected:
 private:
   template <class BaseClass> friend class StatsSharedImpl;
   friend class CounterImpl;
+  friend class ShardedCounterImpl;
   friend class GaugeImpl;
   friend class TextReadoutImpl;
   friend class NotifyingAllocatorImpl;
@@ -94,6 +97,12 @@ private:
   std::unique_ptr<SinkPredicates> sink_predicates_;
   SymbolTable& symbol_table_;
 
+  // Selects the counters created as ShardedCounterImpl; null when sharding is disabled. Written
+  // with mutex_ held and read from makeCounterInternal(), which makeCounter() calls under mutex_.
+  StatsMatcherPtr sharded_counter_matcher_;
+  // Number of slots of each sharded counter, a power of two.
+  const uint32_t counter_shards_;
+
   Thread::ThreadSynchronizer sync_;
 
   // Retain storage for deleted stats; these are no longer in maps because
@@ -1,11 +1,15 @@
 #include "source/common/stats/histogram_impl.h"
 
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <string>
 
 #include "source/common/common/utility.h"
 #include "source/common/protobuf/utility.h"
 
+#include "absl/base/optimization.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -13,6 +17,86 @@ namespace Stats {
 
 namespace {
 const ConstSupportedBuckets default_buckets{};
+
+// Powers of ten up to 10^18, the largest below INT64_MAX.
+constexpr std::array<uint64_t, 19> Pow10 = [] {
+  std::array<uint64_t, 19> pow10{};
+  uint64_t power = 1;
+  for (uint64_t& entry : pow10) {
+    entry = power;
+    power *= 10;
+  }
+  return pow10;
+}();
+
+hist_bucket_t makeBucket(uint32_t val, uint32_t exp) {
+  hist_bucket_t bucket;
+  bucket.val = static_cast<int8_t>(val);
+  bucket.exp = static_cast<int8_t>(exp);
+  return bucket;
+}
+} // namespace
+
+LogLinearBuckets::~LogLinearBuckets() {
+  if (overflow_ != nullptr) {
+    hist_free(overflow_);
+  }
+}
+
+histogram_t& LogLinearBuckets::overflow() {
+  if (overflow_ == nullptr) {
+    overflow_ = hist_alloc();
+  }
+  return *overflow_;
+}
+
+void LogLinearBuckets::recordValue(uint64_t value) {
+  if (value == 0) {
+    ++zero_count_;
+    return;
+  }
+  if (ABSL_PREDICT_FALSE(value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))) {
+    // circllhist takes signed values; keep its handling of these rather than guess at it.
+    hist_insert_intscale(&overflow(), value, 0, 1);
+    return;
+  }
+
+  // floor(log10(value)), estimated from the bit width and then corrected.
+  uint32_t exp = (absl::bit_width(value) * 1233) >> 12;
+  exp -= value < Pow10[exp];
+  // The two most significant decimal digits, as circllhist scales single digit values up.
+  const uint32_t val = exp == 0 ? value * 10 : value / Pow10[exp - 1];
+
+  std::unique_ptr<Row>& row = rows_[exp];
+  if (row == nullptr) {
+    row = std::make_unique<Row>();
+  }
+  if (ABSL_PREDICT_FALSE(++(*row)[val - 10] == 0)) {
+    hist_insert_raw(&overflow(), makeBucket(val, exp), 1ULL << 32);
+  }
+}
+
+void LogLinearBuckets::mergeInto(histogram_t* target) {
+  if (zero_count_ > 0) {
+    hist_insert_raw(target, makeBucket(0, 0), zero_count_);
+    zero_count_ = 0;
+  }
+  for (uint32_t exp = 0; exp < NumRows; ++exp) {
+    if (rows_[exp] == nullptr) {
+      continue;
+    }
+    Row& row = *rows_[exp];
+    for (uint32_t i = 0; i < RowSize; ++i) {
+      if (row[i] != 0) {
+        hist_insert_raw(target, makeBucket(i + 10, exp), row[i]);
+      }
+    }
+    row.fill(0);
+  }
+  if (overflow_ != nullptr) {
+    hist_accumulate(target, &overflow_, 1);
+    hist_clear(overflow_);
+  }
 }
 
 HistogramStatisticsImpl::HistogramStatisticsImpl()
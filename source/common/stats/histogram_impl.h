@@ -1,6 +1,8 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "envoy/config/metrics/v3/stats.pb.h"
@@ -78,6 +80,42 @@ private:
   const Histogram::Unit unit_{Histogram::Unit::Unspecified};
 };
 
+/**
+ * Counts of integer samples kept in the log-linear buckets of circllhist, so that recording a
+ * sample is a few comparisons and an increment rather than a sorted insert into a circllhist. The
+ * counts are added to a circllhist on merge. Each decimal exponent has a row of 90 bucket counts,
+ * allocated when the exponent is first recorded. Not thread-safe.
+ */
+class LogLinearBuckets : NonCopyable {
+public:
+  LogLinearBuckets() = default;
+  ~LogLinearBuckets();
+
+  /**
+   * Records a sample, with the same bucketing as hist_insert_intscale(hist, value, 0, 1).
+   */
+  void recordValue(uint64_t value);
+
+  /**
+   * Adds the recorded samples to target and clears them, keeping the allocated rows.
+   */
+  void mergeInto(histogram_t* target);
+
+private:
+  // A row counts the values val / 10 * 10^exp for val in [10, 99] and a single exponent.
+  static constexpr uint32_t RowSize = 90;
+  // Exponents 0 through 18 cover the values in [1, INT64_MAX].
+  static constexpr uint32_t NumRows = 19;
+  using Row = std::array<uint32_t, RowSize>;
+
+  histogram_t& overflow();
+
+  std::array<std::unique_ptr<Row>, NumRows> rows_;
+  uint64_t zero_count_{0};
+  // Holds values above INT64_MAX and the counts of buckets that wrapped, allocated on first use.
+  histogram_t* overflow_{nullptr};
+};
+
 class HistogramImplHelper : public MetricImpl<Histogram> {
 public:
   HistogramImplHelper(StatName name, StatName tag_extracted_name,
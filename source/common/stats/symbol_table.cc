@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <iostream>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "source/common/common/assert.h"
@@ -261,7 +262,7 @@ bool StatName::startsWith(StatName prefix) const {
 
 std::vector<absl::string_view> SymbolTable::decodeStrings(StatName stat_name) const {
   std::vector<absl::string_view> strings;
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(lock_);
   Encoding::decodeTokens(
       stat_name,
       [this, &strings](Symbol symbol)
@@ -313,16 +314,39 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
   symbols.reserve(tokens.size());
 
   // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
+  // ref-counts in this. Most names only have tokens that are already in the
+  // table, and bumping their ref-counts does not change the maps, so we first
+  // look them up sharing the lock with other threads. That can't record the
+  // lookup in recent_lookups_, so it is skipped while those are remembered.
   {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(lock_);
+    if (recent_lookups_.capacity() == 0) {
+      for (auto& token : tokens) {
+        const auto encode_find = std::as_const(encode_map_).find(token);
+        if (encode_find == encode_map_.end()) {
+          break;
+        }
+        encode_find->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
+        symbols.push_back(encode_find->second.symbol_);
+      }
+      if (symbols.size() == tokens.size()) {
+        shared_lookups_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Symbolize the remaining tokens, starting with the first one not found
+  // above, under the exclusive lock. The symbols found above hold references,
+  // so they can't be freed in between.
+  if (symbols.size() < tokens.size()) {
+    absl::MutexLock lock(lock_);
     recent_lookups_.lookup(name);
-    for (auto& token : tokens) {
+    for (size_t i = symbols.size(); i < tokens.size(); ++i) {
       // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
       // length below some threshold, say 4 bytes. It might be preferable not to
       // reserve Symbols for every 3 digit number found (for example) in ipv4
       // addresses.
-      symbols.push_back(toSymbol(token));
+      symbols.push_back(toSymbol(tokens[i]));
     }
   }
 
@@ -331,7 +355,7 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
 }
 
 uint64_t SymbolTable::numSymbols() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(lock_);
   ASSERT(encode_map_.size() == decode_map_.size());
   return encode_map_.size();
 }
@@ -340,25 +364,29 @@ std::string SymbolTable::toString(const StatName& stat_name) const {
   return absl::StrJoin(decodeStrings(stat_name), ".");
 }
 
+const SymbolTable::SharedSymbol& SymbolTable::sharedSymbol(Symbol symbol) const {
+  auto decode_search = decode_map_.find(symbol);
+  ASSERT(decode_search != decode_map_.end(),
+         "Please see "
+         "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
+         "debugging-symbol-table-assertions");
+  auto encode_search = encode_map_.find(decode_search->second->toStringView());
+  ASSERT(encode_search != encode_map_.end(),
+         "Please see "
+         "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
+         "debugging-symbol-table-assertions");
+  return encode_search->second;
+}
+
 void SymbolTable::incRefCount(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
+  // Adding references to symbols that are already in the table does not change
+  // the maps, so the lock can be shared.
+  absl::ReaderMutexLock lock(lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-
-    ASSERT(decode_search != decode_map_.end(),
-           "Please see "
-           "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
-           "debugging-symbol-table-assertions");
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end(),
-           "Please see "
-           "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
-           "debugging-symbol-table-assertions");
-
-    ++encode_search->second.ref_count_;
+    sharedSymbol(symbol).ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
@@ -366,8 +394,24 @@ void SymbolTable::free(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
-  for (Symbol symbol : symbols) {
+  // Dropping a reference that is not the last one of its symbol does not change
+  // the maps either, so those are dropped sharing the lock. Only the symbols
+  // that may need to be erased are released under the exclusive lock.
+  SymbolVec last_references;
+  {
+    absl::ReaderMutexLock lock(lock_);
+    for (Symbol symbol : symbols) {
+      if (!sharedSymbol(symbol).releaseIfNotLast()) {
+        last_references.push_back(symbol);
+      }
+    }
+  }
+  if (last_references.empty()) {
+    return;
+  }
+
+  absl::MutexLock lock(lock_);
+  for (Symbol symbol : last_references) {
     auto decode_search = decode_map_.find(symbol);
     ASSERT(decode_search != decode_map_.end());
 
@@ -395,11 +439,11 @@ uint64_t SymbolTable::getRecentLookups(const RecentLookupsFn& iter) const {
   // We don't want to hold lock_ while calling the iterator, but we need it to
   // access recent_lookups_, so we buffer in name_count_map.
   {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(lock_);
     recent_lookups_.forEach(
         [&name_count_map](absl::string_view str, uint64_t count)
             ABSL_NO_THREAD_SAFETY_ANALYSIS { name_count_map[std::string(str)] += count; });
-    total += recent_lookups_.total();
+    total += recent_lookups_.total() + shared_lookups_.load(std::memory_order_relaxed);
   }
 
   // Now we have the collated name-count map data: we need to vectorize and
@@ -444,17 +488,18 @@ DynamicSpans SymbolTable::getDynamicSpans(StatName stat_name) const {
 }
 
 void SymbolTable::setRecentLookupCapacity(uint64_t capacity) {
-  Thread::LockGuard lock(lock_);
+  absl::MutexLock lock(lock_);
   recent_lookups_.setCapacity(capacity);
 }
 
 void SymbolTable::clearRecentLookups() {
-  Thread::LockGuard lock(lock_);
+  absl::MutexLock lock(lock_);
   recent_lookups_.clear();
+  shared_lookups_.store(0, std::memory_order_relaxed);
 }
 
 uint64_t SymbolTable::recentLookupCapacity() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(lock_);
   return recent_lookups_.capacity();
 }
 
@@ -491,7 +536,7 @@ Symbol SymbolTable::toSymbol(absl::string_view sv) {
 }
 
 absl::string_view SymbolTable::fromSymbol(const Symbol symbol) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    ABSL_SHARED_LOCKS_REQUIRED(lock_) {
   auto search = decode_map_.find(symbol);
   RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
   return search->second->toStringView();
@@ -512,12 +557,12 @@ bool SymbolTable::lessThan(const StatName& a, const StatName& b) const {
   // Proactively take the table lock in anticipation that we'll need to
   // convert at least one symbol to a string_view, and it's easier not to
   // bother to lazily take the lock.
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(lock_);
   return lessThanLockHeld(a, b);
 }
 
 bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    ABSL_SHARED_LOCKS_REQUIRED(lock_) {
   Encoding::TokenIter a_iter(a), b_iter(b);
   while (true) {
     Encoding::TokenIter::TokenType a_type = a_iter.next();
@@ -547,7 +592,7 @@ bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTable::debugPrint() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(lock_);
   std::vector<Symbol> symbols;
   for (const auto& p : decode_map_) {
     symbols.push_back(p.first);
@@ -556,7 +601,8 @@ void SymbolTable::debugPrint() const {
   for (Symbol symbol : symbols) {
     const InlineString& token = *decode_map_.find(symbol)->second;
     const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(),
+                   shared_symbol.ref_count_.load());
   }
 }
 #endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <stack>
 #include <string>
@@ -19,6 +20,7 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Stats {
@@ -349,7 +351,7 @@ public:
   void sortByStatNames(Iter begin, Iter end, GetStatName get_stat_name) const {
     // Grab the lock once before sorting begins, so we don't have to re-take
     // it on every comparison.
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(lock_);
     StatNameCompare<GetStatName, Obj> compare(*this, get_stat_name);
     std::sort(begin, end, compare);
   }
@@ -397,13 +399,35 @@ private:
 
   struct SharedSymbol {
     SharedSymbol(Symbol symbol) : symbol_(symbol) {}
+    // Entries are only moved when the encode map is rehashed, which requires the exclusive lock.
+    SharedSymbol(SharedSymbol&& src) noexcept
+        : symbol_(src.symbol_), ref_count_(src.ref_count_.load(std::memory_order_relaxed)) {}
+
+    /**
+     * Drops a reference unless it is the last one, which may only be dropped along with erasing
+     * the symbol under the exclusive lock.
+     * @return true if a reference was dropped.
+     */
+    bool releaseIfNotLast() const {
+      uint32_t ref_count = ref_count_.load(std::memory_order_relaxed);
+      while (ref_count > 1) {
+        if (ref_count_.compare_exchange_weak(ref_count, ref_count - 1,
+                                             std::memory_order_relaxed)) {
+          return true;
+        }
+      }
+      return false;
+    }
 
     Symbol symbol_;
-    uint32_t ref_count_{1};
+    // References may be added, and dropped if not the last, while holding lock_ in shared mode,
+    // as neither changes the maps.
+    mutable std::atomic<uint32_t> ref_count_{1};
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // This must be held exclusively to add or remove symbols, and shared to look them up or to
+  // change the reference counts of symbols that stay in the table.
+  mutable absl::Mutex lock_;
 
   /**
    * Decodes a uint8_t array into an array of period-delimited strings. Note
@@ -428,13 +452,19 @@ private:
    */
   Symbol toSymbol(absl::string_view sv) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  /**
+   * @param symbol a symbol that is in the table.
+   * @return the encode map entry of the symbol.
+   */
+  const SharedSymbol& sharedSymbol(Symbol symbol) const ABSL_SHARED_LOCKS_REQUIRED(lock_);
+
   /**
    * Convenience function for decode(), decoding one symbol at a time.
    *
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const ABSL_SHARED_LOCKS_REQUIRED(lock_);
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
@@ -451,7 +481,7 @@ private:
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(lock_);
     return monotonic_counter_;
   }
 
@@ -475,6 +505,10 @@ private:
   // using an Envoy::IntervalSet.
   std::stack<Symbol> pool_ ABSL_GUARDED_BY(lock_);
   RecentLookups recent_lookups_ ABSL_GUARDED_BY(lock_);
+
+  // Lookups of names encoded while holding lock_ in shared mode, which is only done while
+  // recent_lookups_ has no capacity, and so would only have counted them.
+  std::atomic<uint64_t> shared_lookups_{0};
 };
 
 // Base class for holding the backing-storing for a StatName. The two derived
@@ -840,23 +840,35 @@ ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Uni
                                                    absl::optional<uint32_t> bins)
     : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table), unit_(unit),
       used_(false), created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {
-  histograms_[0] = bins ? hist_alloc_nbins(bins.value()) : hist_alloc();
-  histograms_[1] = bins ? hist_alloc_nbins(bins.value()) : hist_alloc();
+  if (bins) {
+    histograms_[0] = hist_alloc_nbins(bins.value());
+    histograms_[1] = hist_alloc_nbins(bins.value());
+  }
 }
 
 ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
   MetricImpl::clear(symbol_table_);
-  hist_free(histograms_[0]);
-  hist_free(histograms_[1]);
+  if (histograms_[0] != nullptr) {
+    hist_free(histograms_[0]);
+    hist_free(histograms_[1]);
+  }
 }
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  if (histograms_[0] == nullptr) {
+    buckets_[current_active_].recordValue(value);
+  } else {
+    hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  }
   used_ = true;
 }
 
 void ThreadLocalHistogramImpl::merge(histogram_t* target) {
+  if (histograms_[0] == nullptr) {
+    buckets_[otherHistogramIndex()].mergeInto(target);
+    return;
+  }
   histogram_t** other_histogram = &histograms_[otherHistogramIndex()];
   hist_accumulate(target, other_histogram, 1);
   hist_clear(*other_histogram);
@@ -29,7 +29,9 @@ namespace Stats {
 /**
  * A histogram that is stored in TLS and used to record values per thread. This holds two
  * histograms, one to collect the values and other as backup that is used for merge process. The
- * swap happens during the merge process.
+ * swap happens during the merge process. Values are counted in LogLinearBuckets, unless a number
+ * of bins is configured for the histogram, in which case they are inserted into circllhists with
+ * that many preallocated bins.
  */
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
@@ -68,7 +70,9 @@ private:
   const Histogram::Unit unit_;
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_{0};
-  histogram_t* histograms_[2];
+  // Only allocated when bins are configured.
+  histogram_t* histograms_[2]{};
+  LogLinearBuckets buckets_[2];
   std::atomic<bool> used_;
   const std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -200,6 +204,9 @@ public:
   }
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override;
   void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) override;
+  void setShardedCounterMatcher(StatsMatcherPtr&& matcher) override {
+    alloc_.setShardedCounterMatcher(std::move(matcher));
+  }
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
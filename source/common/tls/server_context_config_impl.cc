@@ -106,6 +106,9 @@ const std::string ServerContextConfigImpl::DEFAULT_CURVES = "X25519:"
 
 const std::string ServerContextConfigImpl::DEFAULT_CURVES_FIPS = "P-256";
 
+const uint64_t ServerContextConfigImpl::DEFAULT_SESSION_CACHE_MAX_SIZE_BYTES = 10 * 1024 * 1024;
+const uint32_t ServerContextConfigImpl::DEFAULT_SESSION_CACHE_SHARD_COUNT = 16;
+
 absl::StatusOr<std::unique_ptr<ServerContextConfigImpl>> ServerContextConfigImpl::create(
     const envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext& config,
     Server::Configuration::TransportSocketFactoryContext& secret_provider_context,
@@ -168,6 +171,20 @@ ServerContextConfigImpl::ServerContextConfigImpl(
         std::chrono::seconds(DurationUtil::durationToSeconds(config.session_timeout()));
   }
 
+  if (config.has_session_cache()) {
+    if (disable_stateful_session_resumption_) {
+      creation_status = absl::InvalidArgumentError(
+          "session_cache cannot be set when disable_stateful_session_resumption is true");
+      return;
+    }
+    const auto& session_cache = config.session_cache();
+    session_cache_config_ = SessionCacheConfig{
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(session_cache, max_size_bytes,
+                                        DEFAULT_SESSION_CACHE_MAX_SIZE_BYTES),
+        session_cache.shard_count() > 0 ? session_cache.shard_count()
+                                        : DEFAULT_SESSION_CACHE_SHARD_COUNT};
+  }
+
   if (!config.has_require_client_certificate() &&
       config.common_tls_context().validation_context_type_case() !=
           envoy::extensions::transport_sockets::tls::v3::CommonTlsContext::
@@ -39,6 +39,9 @@ public:
   bool disableStatefulSessionResumption() const override {
     return disable_stateful_session_resumption_;
   }
+  const absl::optional<SessionCacheConfig>& sessionCacheConfig() const override {
+    return session_cache_config_;
+  }
 
   bool fullScanCertsOnSNIMismatch() const override { return full_scan_certs_on_sni_mismatch_; }
   bool preferClientCiphers() const override { return prefer_client_ciphers_; }
@@ -58,6 +61,8 @@ private:
   static const std::string DEFAULT_CIPHER_SUITES_FIPS;
   static const std::string DEFAULT_CURVES;
   static const std::string DEFAULT_CURVES_FIPS;
+  static const uint64_t DEFAULT_SESSION_CACHE_MAX_SIZE_BYTES;
+  static const uint32_t DEFAULT_SESSION_CACHE_SHARD_COUNT;
 
   const std::vector<std::string> server_names_;
   const bool require_client_certificate_;
@@ -78,6 +83,7 @@ private:
   absl::optional<std::chrono::seconds> session_timeout_;
   const bool disable_stateless_session_resumption_;
   const bool disable_stateful_session_resumption_;
+  absl::optional<SessionCacheConfig> session_cache_config_;
   bool full_scan_certs_on_sni_mismatch_;
   const bool prefer_client_ciphers_;
   // Certificate selector contains a reference to this context so should be destroyed first.
@@ -143,6 +143,14 @@ ServerContextImpl::ServerContextImpl(
     session_id = *id_or_error;
   }
 
+  // A single session cache is shared by every certificate context, so a session established with
+  // one certificate can be looked up whichever context the resuming handshake selects.
+  if (config.sessionCacheConfig().has_value() &&
+      !config.capabilities().handles_session_resumption) {
+    session_cache_ = std::make_unique<SessionCache>(config.sessionCacheConfig().value(), scope,
+                                                    factory_context_.timeSource());
+  }
+
   for (uint32_t i = 0; i < tls_contexts_.size(); ++i) {
     auto& ctx = tls_contexts_[i];
     if (!config.capabilities().verifies_peer_certificates) {
@@ -186,6 +194,8 @@ ServerContextImpl::ServerContextImpl(
 
     if (config.disableStatefulSessionResumption()) {
       SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(), SSL_SESS_CACHE_OFF);
+    } else if (session_cache_ != nullptr) {
+      installSessionCache(ctx.ssl_ctx_.get());
     }
 
     if (config.sessionTimeout() && !config.capabilities().handles_session_resumption) {
@@ -229,6 +239,29 @@ ServerContextImpl::ServerContextImpl(
   }
 }
 
+void ServerContextImpl::installSessionCache(SSL_CTX* ssl_ctx) {
+  // Sessions are stored and looked up only through the shared cache. The library's internal
+  // cache is per SSL_CTX and unbounded in bytes.
+  SSL_CTX_set_session_cache_mode(ssl_ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+  SSL_CTX_sess_set_new_cb(ssl_ctx, [](SSL* ssl, SSL_SESSION* session) -> int {
+    static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+        ->session_cache_->insert(session);
+    // The cache keeps a serialized copy, so the library retains ownership of the session.
+    return 0;
+  });
+  SSL_CTX_sess_set_get_cb(
+      ssl_ctx, [](SSL* ssl, const uint8_t* id, int id_len, int* out_copy) -> SSL_SESSION* {
+        SSL_CTX* ssl_ctx = SSL_get_SSL_CTX(ssl);
+        // The returned session is a new reference, which the library takes ownership of.
+        *out_copy = 0;
+        return static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(ssl_ctx))
+            ->session_cache_->lookup({id, static_cast<size_t>(id_len)}, ssl_ctx)
+            .release();
+      });
+  // No remove callback is installed: the library only invokes it for sessions held in its internal
+  // cache, which is disabled here. The shared cache drops expired sessions on lookup.
+}
+
 absl::StatusOr<ServerContextImpl::SessionContextID>
 ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string>& server_names) {
   uint8_t hash_buffer[EVP_MAX_MD_SIZE];
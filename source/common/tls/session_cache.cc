@@ -0,0 +1,146 @@
+#include "source/common/tls/session_cache.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+
+#include "absl/hash/hash.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+namespace {
+
+// Approximate bookkeeping cost of an entry beyond its ID and serialized session.
+constexpr uint64_t EntryOverheadBytes =
+    sizeof(std::string) * 2 + sizeof(MonotonicTime) + sizeof(uint64_t) + 4 * sizeof(void*);
+
+absl::string_view toStringView(absl::Span<const uint8_t> bytes) {
+  return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+} // namespace
+
+SessionCache::SessionCache(const Ssl::ServerContextConfig::SessionCacheConfig& config,
+                           Stats::Scope& scope, TimeSource& time_source)
+    : stats_(generateStats(scope)), time_source_(time_source),
+      shard_max_size_bytes_(config.max_size_bytes_ / std::max<uint32_t>(config.shard_count_, 1)) {
+  const uint32_t shard_count = std::max<uint32_t>(config.shard_count_, 1);
+  shards_.reserve(shard_count);
+  for (uint32_t i = 0; i < shard_count; i++) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+SessionCache::~SessionCache() {
+  // The gauges may be shared with other contexts in the same scope, so only remove what this
+  // cache added.
+  for (auto& shard : shards_) {
+    absl::MutexLock lock(shard->mutex_);
+    stats_.entries_.sub(shard->map_.size());
+    stats_.size_bytes_.sub(shard->size_bytes_);
+  }
+}
+
+SslSessionCacheStats SessionCache::generateStats(Stats::Scope& scope) {
+  const std::string prefix("ssl.session_cache.");
+  return {ALL_SSL_SESSION_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                      POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+SessionCache::Shard& SessionCache::shardFor(absl::string_view session_id) {
+  return *shards_[absl::Hash<absl::string_view>()(session_id) % shards_.size()];
+}
+
+void SessionCache::erase(Shard& shard, EntryList::iterator it) {
+  shard.size_bytes_ -= it->size_bytes_;
+  stats_.size_bytes_.sub(it->size_bytes_);
+  stats_.entries_.dec();
+  shard.map_.erase(it->id_);
+  shard.lru_.erase(it);
+}
+
+bool SessionCache::insert(SSL_SESSION* session) {
+  unsigned int id_length = 0;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_length);
+  if (id_length == 0) {
+    stats_.insert_rejected_.inc();
+    return false;
+  }
+
+  uint8_t* bytes = nullptr;
+  size_t bytes_length = 0;
+  if (!SSL_SESSION_to_bytes(session, &bytes, &bytes_length)) {
+    stats_.insert_rejected_.inc();
+    return false;
+  }
+  Entry entry;
+  entry.id_.assign(reinterpret_cast<const char*>(id), id_length);
+  entry.session_.assign(reinterpret_cast<const char*>(bytes), bytes_length);
+  OPENSSL_free(bytes);
+  entry.expiry_ =
+      time_source_.monotonicTime() + std::chrono::seconds(SSL_SESSION_get_timeout(session));
+  entry.size_bytes_ = entry.id_.size() + entry.session_.size() + EntryOverheadBytes;
+  if (entry.size_bytes_ > shard_max_size_bytes_) {
+    stats_.insert_rejected_.inc();
+    return false;
+  }
+
+  Shard& shard = shardFor(entry.id_);
+  absl::MutexLock lock(shard.mutex_);
+  if (auto it = shard.map_.find(entry.id_); it != shard.map_.end()) {
+    erase(shard, it->second);
+  }
+  while (shard.size_bytes_ + entry.size_bytes_ > shard_max_size_bytes_) {
+    ASSERT(!shard.lru_.empty());
+    erase(shard, std::prev(shard.lru_.end()));
+    stats_.eviction_.inc();
+  }
+  shard.size_bytes_ += entry.size_bytes_;
+  stats_.size_bytes_.add(entry.size_bytes_);
+  stats_.entries_.inc();
+  stats_.insert_.inc();
+  shard.lru_.push_front(std::move(entry));
+  shard.map_.emplace(shard.lru_.front().id_, shard.lru_.begin());
+  return true;
+}
+
+bssl::UniquePtr<SSL_SESSION> SessionCache::lookup(absl::Span<const uint8_t> session_id,
+                                                  const SSL_CTX* ctx) {
+  const absl::string_view key = toStringView(session_id);
+  std::string serialized;
+  {
+    Shard& shard = shardFor(key);
+    absl::MutexLock lock(shard.mutex_);
+    auto it = shard.map_.find(key);
+    if (it == shard.map_.end()) {
+      stats_.miss_.inc();
+      return nullptr;
+    }
+    if (it->second->expiry_ <= time_source_.monotonicTime()) {
+      erase(shard, it->second);
+      stats_.expired_.inc();
+      stats_.miss_.inc();
+      return nullptr;
+    }
+    shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second);
+    serialized = it->second->session_;
+  }
+
+  // Deserialize outside the shard lock; this is the only per-lookup cost of any size.
+  bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_from_bytes(
+      reinterpret_cast<const uint8_t*>(serialized.data()), serialized.size(), ctx));
+  if (session == nullptr) {
+    stats_.miss_.inc();
+    return nullptr;
+  }
+  stats_.hit_.inc();
+  return session;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
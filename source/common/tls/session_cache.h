@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/ssl/context_config.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#define ALL_SSL_SESSION_CACHE_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  COUNTER(insert)                                                                                  \
+  COUNTER(insert_rejected)                                                                         \
+  COUNTER(eviction)                                                                                \
+  COUNTER(expired)                                                                                 \
+  GAUGE(entries, Accumulate)                                                                       \
+  GAUGE(size_bytes, Accumulate)
+
+/**
+ * Wrapper struct for SSL session cache stats. @see stats_macros.h
+ */
+struct SslSessionCacheStats {
+  ALL_SSL_SESSION_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * A bounded cache of serialized TLS sessions keyed by session ID, used for stateful resumption
+ * by a server context. The cache is split into shards, each with its own lock and an equal share
+ * of the size limit, and evicts the least recently used sessions when a shard is full. Sessions
+ * expire after their own timeout. All methods are thread-safe.
+ */
+class SessionCache {
+public:
+  SessionCache(const Ssl::ServerContextConfig::SessionCacheConfig& config, Stats::Scope& scope,
+               TimeSource& time_source);
+  ~SessionCache();
+
+  /**
+   * Stores a session, replacing any session with the same ID.
+   * @return false if the session has no ID or is larger than a shard.
+   */
+  bool insert(SSL_SESSION* session);
+
+  /**
+   * @return the session with the given ID, or nullptr if it is absent or expired.
+   */
+  bssl::UniquePtr<SSL_SESSION> lookup(absl::Span<const uint8_t> session_id, const SSL_CTX* ctx);
+
+  const SslSessionCacheStats& stats() const { return stats_; }
+
+private:
+  struct Entry {
+    std::string id_;
+    std::string session_;
+    MonotonicTime expiry_;
+    uint64_t size_bytes_;
+  };
+  // Most recently used entries are at the front.
+  using EntryList = std::list<Entry>;
+
+  struct Shard {
+    absl::Mutex mutex_;
+    EntryList lru_ ABSL_GUARDED_BY(mutex_);
+    // Keys refer to the id_ of the entry in lru_.
+    absl::flat_hash_map<absl::string_view, EntryList::iterator> map_ ABSL_GUARDED_BY(mutex_);
+    uint64_t size_bytes_ ABSL_GUARDED_BY(mutex_){0};
+  };
+
+  static SslSessionCacheStats generateStats(Stats::Scope& scope);
+
+  Shard& shardFor(absl::string_view session_id);
+  void erase(Shard& shard, EntryList::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
+  SslSessionCacheStats stats_;
+  TimeSource& time_source_;
+  const uint64_t shard_max_size_bytes_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+using SessionCachePtr = std::unique_ptr<SessionCache>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -1,5 +1,7 @@
 #include "source/common/upstream/cds_api_helper.h"
 
+#include <algorithm>
+
 #include "envoy/common/exception.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
@@ -7,6 +9,7 @@
 
 #include "source/common/common/fmt.h"
 #include "source/common/config/resource_name.h"
+#include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/flat_hash_set.h"
@@ -14,6 +17,44 @@
 namespace Envoy {
 namespace Upstream {
 
+namespace {
+
+// Below this many added clusters the hashes are computed on the main thread, as starting threads
+// would cost more than it saves.
+constexpr size_t MinClustersForParallelHash = 256;
+// Number of threads that hash alongside the main thread.
+constexpr size_t ParallelHashThreads = 3;
+
+// Computes MessageUtil::hash() of each added cluster, splitting the resources into contiguous
+// chunks hashed concurrently by the calling thread and ParallelHashThreads short-lived threads.
+// Hashing only reads the decoded protos, which are not modified until the update is applied.
+std::vector<uint64_t> hashClusters(const std::vector<Config::DecodedResourceRef>& resources,
+                                   Thread::ThreadFactory& thread_factory) {
+  std::vector<uint64_t> hashes(resources.size());
+  const size_t chunk_size = (resources.size() + ParallelHashThreads) / (ParallelHashThreads + 1);
+  const auto hash_chunk = [&resources, &hashes, chunk_size](size_t chunk) {
+    const size_t end = std::min(resources.size(), (chunk + 1) * chunk_size);
+    for (size_t i = chunk * chunk_size; i < end; ++i) {
+      hashes[i] = MessageUtil::hash(resources[i].get().resource());
+    }
+  };
+
+  const Thread::Options options{"cds_hash"};
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(ParallelHashThreads);
+  for (size_t chunk = 1; chunk <= ParallelHashThreads; ++chunk) {
+    threads.push_back(
+        thread_factory.createThread([&hash_chunk, chunk] { hash_chunk(chunk); }, options));
+  }
+  hash_chunk(0);
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  return hashes;
+}
+
+} // namespace
+
 std::pair<uint32_t, std::vector<std::string>>
 CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& added_resources,
                              const Protobuf::RepeatedPtrField<std::string>& removed_resources,
@@ -30,12 +71,21 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
       "{}: response indicates {} added/updated cluster(s), {} removed cluster(s); applying changes",
       name_, added_resources.size(), removed_resources.size());
 
+  // Hashing every cluster to detect unmodified ones dominates large updates that change little, so
+  // do it up front in parallel when there are many clusters.
+  std::vector<uint64_t> hashes;
+  if (api_.has_value() && added_resources.size() >= MinClustersForParallelHash &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.cds_parallel_cluster_hash")) {
+    hashes = hashClusters(added_resources, api_->threadFactory());
+  }
+
   std::vector<std::string> exception_msgs;
   absl::flat_hash_set<std::string> cluster_names(added_resources.size());
   bool any_applied = false;
   uint32_t added_or_updated = 0;
   uint32_t skipped = 0;
-  for (const auto& resource : added_resources) {
+  for (size_t i = 0; i < added_resources.size(); ++i) {
+    const Config::DecodedResourceRef& resource = added_resources[i];
     // Holds a reference to the name of the currently parsed cluster resource.
     // This is needed for the CATCH clause below.
     absl::string_view cluster_name = EMPTY_STRING;
@@ -49,7 +99,10 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
             fmt::format("{}: duplicate cluster {} found", cluster_name, cluster_name));
         continue;
       }
-      auto update_or_error = cm_.addOrUpdateCluster(cluster, resource.get().version());
+      auto update_or_error =
+          hashes.empty()
+              ? cm_.addOrUpdateCluster(cluster, resource.get().version())
+              : cm_.addOrUpdateClusterWithHash(cluster, resource.get().version(), hashes[i]);
       if (!update_or_error.status().ok()) {
         exception_msgs.push_back(
             fmt::format("{}: {}", cluster_name, update_or_error.status().message()));
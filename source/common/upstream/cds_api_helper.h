@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 
+#include "envoy/api/api.h"
+#include "envoy/common/optref.h"
 #include "envoy/config/subscription.h"
 #include "envoy/config/xds_manager.h"
 #include "envoy/upstream/cluster_manager.h"
@@ -19,8 +21,13 @@ namespace Upstream {
  */
 class CdsApiHelper : Logger::Loggable<Logger::Id::upstream> {
 public:
-  CdsApiHelper(ClusterManager& cm, Config::XdsManager& xds_manager, std::string name)
-      : cm_(cm), xds_manager_(xds_manager), name_(std::move(name)) {}
+  /**
+   * @param api if supplied, the config hashes of large updates are computed on threads created
+   * from its thread factory instead of one at a time on the main thread.
+   */
+  CdsApiHelper(ClusterManager& cm, Config::XdsManager& xds_manager, std::string name,
+               OptRef<Api::Api> api = {})
+      : cm_(cm), xds_manager_(xds_manager), name_(std::move(name)), api_(api) {}
   /**
    * onConfigUpdate handles the addition and removal of clusters by notifying the ClusterManager
    * about the cluster changes. It closely follows the onConfigUpdate API from
@@ -42,6 +49,7 @@ private:
   ClusterManager& cm_;
   Config::XdsManager& xds_manager_;
   const std::string name_;
+  const OptRef<Api::Api> api_;
   std::string system_version_info_;
 };
 
@@ -727,6 +727,15 @@ absl::StatusOr<bool>
 ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                                        const std::string& version_info,
                                        const bool avoid_cds_removal) {
+  return addOrUpdateClusterWithHash(cluster, version_info, MessageUtil::hash(cluster),
+                                    avoid_cds_removal);
+}
+
+absl::StatusOr<bool>
+ClusterManagerImpl::addOrUpdateClusterWithHash(const envoy::config::cluster::v3::Cluster& cluster,
+                                               const std::string& version_info,
+                                               const uint64_t new_hash,
+                                               const bool avoid_cds_removal) {
   // First we need to see if this new config is new or an update to an existing dynamic cluster.
   // We don't allow updates to statically configured clusters in the main configuration. We check
   // both the warming clusters and the active clusters to see if we need an update or the update
@@ -734,7 +743,6 @@ ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster
   const std::string& cluster_name = cluster.name();
   const auto existing_active_cluster = active_clusters_.find(cluster_name);
   const auto existing_warming_cluster = warming_clusters_.find(cluster_name);
-  const uint64_t new_hash = MessageUtil::hash(cluster);
   if (existing_warming_cluster != warming_clusters_.end()) {
     // If the cluster is the same as the warming cluster of the same name, block the update.
     if (existing_warming_cluster->second->blockUpdate(new_hash)) {
@@ -242,6 +242,10 @@ public:
   absl::StatusOr<bool> addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                                           const std::string& version_info,
                                           const bool avoid_cds_removal = false) override;
+  absl::StatusOr<bool>
+  addOrUpdateClusterWithHash(const envoy::config::cluster::v3::Cluster& cluster,
+                             const std::string& version_info, uint64_t config_hash,
+                             const bool avoid_cds_removal = false) override;
 
   void setPrimaryClustersInitializedCb(PrimaryClustersReadyCallback callback) override {
     init_helper_.setPrimaryClustersInitializedCb(callback);
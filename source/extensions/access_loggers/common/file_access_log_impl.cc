@@ -1,5 +1,9 @@
 #include "source/extensions/access_loggers/common/file_access_log_impl.h"
 
+#include "source/common/common/byte_order.h"
+
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace AccessLoggers {
@@ -7,8 +11,9 @@ namespace File {
 
 FileAccessLog::FileAccessLog(const Filesystem::FilePathAndType& access_log_file_info,
                              AccessLog::FilterPtr&& filter, Formatter::FormatterPtr&& formatter,
-                             AccessLog::AccessLogManager& log_manager)
-    : ImplBase(std::move(filter)), formatter_(std::move(formatter)) {
+                             AccessLog::AccessLogManager& log_manager, bool length_prefixed)
+    : ImplBase(std::move(filter)), formatter_(std::move(formatter)),
+      length_prefixed_(length_prefixed) {
   auto file_or_error = log_manager.createAccessLog(access_log_file_info);
   THROW_IF_NOT_OK_REF(file_or_error.status());
   log_file_ = file_or_error.value();
@@ -16,7 +21,15 @@ FileAccessLog::FileAccessLog(const Filesystem::FilePathAndType& access_log_file_
 
 void FileAccessLog::emitLog(const Formatter::Context& context,
                             const StreamInfo::StreamInfo& stream_info) {
-  log_file_->write(formatter_->format(context, stream_info));
+  const std::string entry = formatter_->format(context, stream_info);
+  if (!length_prefixed_) {
+    log_file_->write(entry);
+    return;
+  }
+
+  const uint32_t length = toEndianness<ByteOrder::BigEndian>(static_cast<uint32_t>(entry.size()));
+  log_file_->write(absl::StrCat(
+      absl::string_view(reinterpret_cast<const char*>(&length), sizeof(length)), entry));
 }
 
 } // namespace File
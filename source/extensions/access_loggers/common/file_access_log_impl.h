@@ -15,7 +15,7 @@ class FileAccessLog : public Common::ImplBase {
 public:
   FileAccessLog(const Filesystem::FilePathAndType& access_log_file_info,
                 AccessLog::FilterPtr&& filter, Formatter::FormatterPtr&& formatter,
-                AccessLog::AccessLogManager& log_manager);
+                AccessLog::AccessLogManager& log_manager, bool length_prefixed = false);
 
 private:
   // Common::ImplBase
@@ -24,6 +24,8 @@ private:
 
   AccessLog::AccessLogFileSharedPtr log_file_;
   Formatter::FormatterPtr formatter_;
+  // Whether each entry is preceded by its 4 byte big endian length.
+  const bool length_prefixed_;
 };
 
 } // namespace File
@@ -71,7 +71,8 @@ AccessLog::InstanceSharedPtr FileAccessLogFactory::createAccessLogInstance(
 
   Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, fal_config.path()};
   return std::make_shared<FileAccessLog>(file_info, std::move(filter), std::move(formatter),
-                                         context.serverFactoryContext().accessLogManager());
+                                         context.serverFactoryContext().accessLogManager(),
+                                         fal_config.length_prefixed());
 }
 
 ProtobufTypes::MessagePtr FileAccessLogFactory::createEmptyConfigProto() {
@@ -3,6 +3,7 @@
 #include <atomic>
 #include <functional>
 
+#include "envoy/common/platform.h"
 #include "envoy/common/pure.h"
 
 #include "source/common/common/assert.h"
@@ -43,6 +44,31 @@ public:
   virtual bool executesEvenIfCancelled() const { return false; }
 };
 
+// Implemented by actions whose file operation can be submitted to an io_uring rather than
+// performed by a blocking system call, see AsyncFileManagerIoUring.
+class AsyncFileVectoredIoAction {
+public:
+  enum class Operation { Read, Write };
+  struct VectoredIo {
+    Operation operation_;
+    int fd_;
+    const struct iovec* iovecs_;
+    unsigned iovec_count_;
+    off_t offset_;
+  };
+
+  virtual ~AsyncFileVectoredIoAction() = default;
+
+  // Returns the read or write to submit. The iovecs must remain valid until the result is passed
+  // to onVectoredIoResult.
+  virtual VectoredIo prepareVectoredIo() PURE;
+
+  // Captures the result of the submitted operation, which is the number of bytes transferred or
+  // a negated errno. Returns false if the operation is not yet complete (e.g. after a short
+  // write), in which case it is prepared and submitted again.
+  virtual bool onVectoredIoResult(int32_t result) PURE;
+};
+
 // All concrete AsyncFileActions are a subclass of AsyncFileActionWithResult.
 // The template allows for different on_complete callback signatures appropriate
 // to each specific action.
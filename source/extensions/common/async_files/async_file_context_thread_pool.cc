@@ -108,7 +108,8 @@ private:
   const int file_descriptor_;
 };
 
-class ActionReadFile : public AsyncFileActionThreadPool<absl::StatusOr<Buffer::InstancePtr>> {
+class ActionReadFile : public AsyncFileActionThreadPool<absl::StatusOr<Buffer::InstancePtr>>,
+                       public AsyncFileVectoredIoAction {
 public:
   ActionReadFile(AsyncFileHandle handle, off_t offset, size_t length,
                  absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete)
@@ -118,27 +119,64 @@ public:
 
   absl::StatusOr<Buffer::InstancePtr> executeImpl() override {
     ASSERT(fileDescriptor() != -1);
-    auto result = std::make_unique<Buffer::OwnedImpl>();
-    auto reservation = result->reserveSingleSlice(length_);
-    auto bytes_read = posix().pread(fileDescriptor(), reservation.slice().mem_, length_, offset_);
+    auto bytes_read = posix().pread(fileDescriptor(), reserve(), length_, offset_);
     if (bytes_read.return_value_ == -1) {
+      release();
       return statusAfterFileError(bytes_read);
     }
-    if (static_cast<size_t>(bytes_read.return_value_) != length_) {
-      result =
-          std::make_unique<Buffer::OwnedImpl>(reservation.slice().mem_, bytes_read.return_value_);
+    return commit(bytes_read.return_value_);
+  }
+
+  VectoredIo prepareVectoredIo() override {
+    ASSERT(fileDescriptor() != -1);
+    iovec_.iov_base = reserve();
+    iovec_.iov_len = length_;
+    return {Operation::Read, fileDescriptor(), &iovec_, 1, offset_};
+  }
+
+  bool onVectoredIoResult(int32_t result) override {
+    if (result < 0) {
+      release();
+      result_ = statusAfterFileError(-result);
     } else {
-      reservation.commit(bytes_read.return_value_);
+      result_ = commit(result);
     }
-    return result;
+    return true;
   }
 
 private:
+  void* reserve() {
+    buffer_ = std::make_unique<Buffer::OwnedImpl>();
+    reservation_.emplace(buffer_->reserveSingleSlice(length_));
+    return reservation_->slice().mem_;
+  }
+
+  Buffer::InstancePtr commit(size_t bytes_read) {
+    if (bytes_read != length_) {
+      auto result = std::make_unique<Buffer::OwnedImpl>(reservation_->slice().mem_, bytes_read);
+      release();
+      return result;
+    }
+    reservation_->commit(bytes_read);
+    reservation_.reset();
+    return std::move(buffer_);
+  }
+
+  // The reservation refers to the buffer, so must be released first.
+  void release() {
+    reservation_.reset();
+    buffer_.reset();
+  }
+
   const off_t offset_;
   const size_t length_;
+  Buffer::InstancePtr buffer_;
+  absl::optional<Buffer::ReservationSingleSlice> reservation_;
+  struct iovec iovec_;
 };
 
-class ActionWriteFile : public AsyncFileActionThreadPool<absl::StatusOr<size_t>> {
+class ActionWriteFile : public AsyncFileActionThreadPool<absl::StatusOr<size_t>>,
+                        public AsyncFileVectoredIoAction {
 public:
   ActionWriteFile(AsyncFileHandle handle, Buffer::Instance& contents, off_t offset,
                   absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete)
@@ -167,9 +205,36 @@ public:
     return total_bytes_written;
   }
 
+  // A short write drains what was written from contents_, and the remainder is submitted again.
+  VectoredIo prepareVectoredIo() override {
+    ASSERT(fileDescriptor() != -1);
+    iovecs_.clear();
+    for (const Buffer::RawSlice& slice : contents_.getRawSlices(IOV_MAX)) {
+      iovecs_.push_back({slice.mem_, slice.len_});
+    }
+    return {Operation::Write, fileDescriptor(), iovecs_.data(),
+            static_cast<unsigned>(iovecs_.size()), static_cast<off_t>(offset_ + bytes_written_)};
+  }
+
+  bool onVectoredIoResult(int32_t result) override {
+    if (result < 0) {
+      result_ = statusAfterFileError(-result);
+      return true;
+    }
+    contents_.drain(result);
+    bytes_written_ += result;
+    if (contents_.length() > 0) {
+      return false;
+    }
+    result_ = bytes_written_;
+    return true;
+  }
+
 private:
   Buffer::OwnedImpl contents_;
   const off_t offset_;
+  size_t bytes_written_{0};
+  std::vector<struct iovec> iovecs_;
 };
 
 class ActionTruncateFile : public AsyncFileActionThreadPool<absl::Status> {
@@ -7,6 +7,10 @@
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/common/async_files/async_file_manager_thread_pool.h"
 
+#if defined(ENVOY_ENABLE_IO_URING)
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+#endif
+
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 
@@ -61,6 +65,17 @@ std::shared_ptr<AsyncFileManager> AsyncFileManagerFactoryImpl::getAsyncFileManag
                             std::make_shared<AsyncFileManagerThreadPool>(config, posix), config}})
                .first;
       break;
+    case envoy::extensions::common::async_files::v3::AsyncFileManagerConfig::kIoUring:
+#if defined(ENVOY_ENABLE_IO_URING)
+      it = managers_
+               .insert({config.id(),
+                        ManagerAndConfig{std::make_shared<AsyncFileManagerIoUring>(config, posix),
+                                         config}})
+               .first;
+      break;
+#else
+      throw EnvoyException("AsyncFileManagerIoUring is not supported in this build");
+#endif
     case envoy::extensions::common::async_files::v3::AsyncFileManagerConfig::MANAGER_TYPE_NOT_SET:
       // This is theoretically unreachable due to proto validation 'required', but it's possible
       // for code to have modified the proto post-validation.
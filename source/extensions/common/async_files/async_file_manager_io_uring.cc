@@ -0,0 +1,207 @@
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/io/io_uring_impl.h"
+#include "source/extensions/common/async_files/async_file_action.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+constexpr uint32_t DefaultIoUringSize = 256;
+} // namespace
+
+class AsyncFileManagerIoUring::RingRequest : public Io::Request {
+public:
+  RingRequest(QueuedAction&& queued_action, AsyncFileVectoredIoAction& io,
+              AsyncFileVectoredIoAction::Operation operation)
+      : Io::Request(operation == AsyncFileVectoredIoAction::Operation::Read ? RequestType::Read
+                                                                            : RequestType::Write),
+        queued_action_(std::move(queued_action)), io_(io) {}
+
+  QueuedAction queued_action_;
+  // The same action as queued_action_.action_.
+  AsyncFileVectoredIoAction& io_;
+};
+
+AsyncFileManagerIoUring::AsyncFileManagerIoUring(
+    const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+    Api::OsSysCalls& posix)
+    : AsyncFileManagerThreadPool(config.id(), config.io_uring().thread_pool().thread_count(),
+                                 posix),
+      io_uring_size_(config.io_uring().io_uring_size() == 0 ? DefaultIoUringSize
+                                                            : config.io_uring().io_uring_size()) {
+  if (!Io::isIoUringSupported()) {
+    throw EnvoyException("AsyncFileManagerIoUring not supported");
+  }
+  io_uring_ = std::make_unique<Io::IoUringImpl>(io_uring_size_, false);
+  event_fd_ = io_uring_->registerEventfd();
+  ENVOY_LOG(info, fmt::format("AsyncFileManagerIoUring created with id '{}', with io_uring size {}",
+                              config.id(), io_uring_size_));
+  ring_thread_ = std::thread([this]() { ringLoop(); });
+}
+
+AsyncFileManagerIoUring::~AsyncFileManagerIoUring() ABSL_LOCKS_EXCLUDED(ring_mutex_) {
+  {
+    absl::MutexLock lock(ring_mutex_);
+    ring_terminate_ = true;
+    wakeRingThread();
+  }
+  // The ring thread exits once all queued reads and writes are complete.
+  ring_thread_.join();
+  io_uring_->unregisterEventfd();
+  ::close(event_fd_);
+}
+
+std::string AsyncFileManagerIoUring::describe() const {
+  return absl::StrCat("io_uring_size = ", io_uring_size_, ", ",
+                      AsyncFileManagerThreadPool::describe());
+}
+
+void AsyncFileManagerIoUring::waitForIdle() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(ring_mutex_) {
+    return ring_queue_.empty() && in_flight_ == 0 && !preparing_;
+  };
+  {
+    absl::MutexLock lock(ring_mutex_);
+    ring_mutex_.Await(absl::Condition(&condition));
+  }
+  AsyncFileManagerThreadPool::waitForIdle();
+}
+
+absl::AnyInvocable<void()>
+AsyncFileManagerIoUring::enqueue(Event::Dispatcher* dispatcher,
+                                 std::unique_ptr<AsyncFileAction> action) {
+  if (dynamic_cast<AsyncFileVectoredIoAction*>(action.get()) == nullptr) {
+    return AsyncFileManagerThreadPool::enqueue(dispatcher, std::move(action));
+  }
+  QueuedAction entry{std::move(action), dispatcher};
+  auto cancel_func = [dispatcher, state = entry.state_]() {
+    ASSERT(dispatcher == nullptr || dispatcher->isThreadSafe());
+    state->store(QueuedAction::State::Cancelled);
+  };
+  absl::MutexLock lock(ring_mutex_);
+  ring_queue_.push(std::move(entry));
+  wakeRingThread();
+  return cancel_func;
+}
+
+void AsyncFileManagerIoUring::wakeRingThread() {
+  if (!wake_pending_) {
+    wake_pending_ = true;
+    eventfd_write(event_fd_, 1);
+  }
+}
+
+void AsyncFileManagerIoUring::ringLoop() {
+  std::vector<QueuedAction> batch;
+  batch.reserve(io_uring_size_);
+  while (true) {
+    {
+      absl::MutexLock lock(ring_mutex_);
+      wake_pending_ = false;
+      if (ring_terminate_ && ring_queue_.empty() && in_flight_ == 0) {
+        return;
+      }
+      while (!ring_queue_.empty() && in_flight_ + batch.size() < io_uring_size_) {
+        batch.push_back(std::move(ring_queue_.front()));
+        ring_queue_.pop();
+      }
+      preparing_ = !batch.empty();
+    }
+    if (!batch.empty()) {
+      const uint32_t prepared = prepareBatch(batch);
+      batch.clear();
+      absl::MutexLock lock(ring_mutex_);
+      in_flight_ += prepared;
+      preparing_ = false;
+    }
+    // Submits the new batch together with any writes resubmitted while handling the previous
+    // completions. Busy means the completion queue is full, in which case the entries stay in the
+    // submission queue until the next pass, after the pending completions have been handled.
+    io_uring_->submit();
+
+    // Sleeps until either a submitted request completes or an action is enqueued.
+    struct pollfd event_fd_poll = {event_fd_, POLLIN, 0};
+    while (::poll(&event_fd_poll, 1, -1) == -1 && errno == EINTR) {
+    }
+    uint32_t completed = 0;
+    io_uring_->forEveryCompletion(
+        [this, &completed](Io::Request* user_data, int32_t result, uint32_t, bool) {
+          if (onCompletion(user_data, result)) {
+            completed++;
+          }
+        });
+    if (completed > 0) {
+      absl::MutexLock lock(ring_mutex_);
+      in_flight_ -= completed;
+    }
+  }
+}
+
+uint32_t AsyncFileManagerIoUring::prepareBatch(std::vector<QueuedAction>& batch) {
+  using State = QueuedAction::State;
+  uint32_t prepared = 0;
+  for (QueuedAction& queued_action : batch) {
+    State expected = State::Queued;
+    if (!queued_action.state_->compare_exchange_strong(expected, State::Executing)) {
+      // A read or write has nothing to undo if it is cancelled before it starts.
+      ASSERT(expected == State::Cancelled);
+      continue;
+    }
+    auto& io = dynamic_cast<AsyncFileVectoredIoAction&>(*queued_action.action_);
+    const AsyncFileVectoredIoAction::VectoredIo vectored_io = io.prepareVectoredIo();
+    if (vectored_io.offset_ < 0) {
+      // io_uring treats an offset of -1 as the file's current position, whereas the thread pool's
+      // pread and pwrite fail with EINVAL for any negative offset. Fail the same way here.
+      io.onVectoredIoResult(-EINVAL);
+      onActionExecuted(std::move(queued_action));
+      continue;
+    }
+    prepareRequest(*new RingRequest(std::move(queued_action), io, vectored_io.operation_),
+                   vectored_io);
+    prepared++;
+  }
+  return prepared;
+}
+
+void AsyncFileManagerIoUring::prepareRequest(RingRequest& request,
+                                             const AsyncFileVectoredIoAction::VectoredIo& io) {
+  const Io::IoUringResult result =
+      io.operation_ == AsyncFileVectoredIoAction::Operation::Read
+          ? io_uring_->prepareReadv(io.fd_, io.iovecs_, io.iovec_count_, io.offset_, &request)
+          : io_uring_->prepareWritev(io.fd_, io.iovecs_, io.iovec_count_, io.offset_, &request);
+  // The submission queue has an entry for every request allowed in flight, so it cannot be full.
+  RELEASE_ASSERT(result == Io::IoUringResult::Ok, "unable to prepare io_uring file request");
+}
+
+bool AsyncFileManagerIoUring::onCompletion(Io::Request* user_data, int32_t result) {
+  auto* request = static_cast<RingRequest*>(user_data);
+  if (!request->io_.onVectoredIoResult(result)) {
+    prepareRequest(*request, request->io_.prepareVectoredIo());
+    return false;
+  }
+  // The action is still owned by the request until here, so a cancelled read's buffer stays valid
+  // until the kernel is done with it.
+  onActionExecuted(std::move(request->queued_action_));
+  delete request;
+  return true;
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
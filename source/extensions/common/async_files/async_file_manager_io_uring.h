@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "envoy/common/io/io_uring.h"
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/extensions/common/async_files/async_file_manager_thread_pool.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+// An AsyncFileManager which submits file reads and writes to an io_uring, and performs all other
+// operations in a thread pool in the same way as AsyncFileManagerThreadPool.
+// A single ring thread takes all the reads and writes queued since it last woke, submits them to
+// the ring as one batch, and then posts the callback of each completion to the dispatcher of the
+// caller, as the thread pool does. The number of reads and writes in flight is bounded by the size
+// of the ring; further actions wait in the queue.
+class AsyncFileManagerIoUring : public AsyncFileManagerThreadPool {
+public:
+  AsyncFileManagerIoUring(
+      const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+      Api::OsSysCalls& posix);
+  ~AsyncFileManagerIoUring() ABSL_LOCKS_EXCLUDED(ring_mutex_) override;
+  std::string describe() const override;
+  void waitForIdle() ABSL_LOCKS_EXCLUDED(ring_mutex_) override;
+
+private:
+  class RingRequest;
+
+  absl::AnyInvocable<void()> enqueue(Event::Dispatcher* dispatcher,
+                                     std::unique_ptr<AsyncFileAction> action)
+      ABSL_LOCKS_EXCLUDED(ring_mutex_) override;
+  void ringLoop() ABSL_LOCKS_EXCLUDED(ring_mutex_);
+  // Prepares the reads and writes of a batch which were not cancelled while queued. Returns the
+  // number of requests prepared, which are in flight once submitted.
+  uint32_t prepareBatch(std::vector<QueuedAction>& batch);
+  void prepareRequest(RingRequest& request, const AsyncFileVectoredIoAction::VectoredIo& io);
+  // Returns true if the request is complete and its callback has been posted.
+  bool onCompletion(Io::Request* user_data, int32_t result);
+  void wakeRingThread() ABSL_EXCLUSIVE_LOCKS_REQUIRED(ring_mutex_);
+
+  const uint32_t io_uring_size_;
+  Io::IoUringPtr io_uring_;
+  os_fd_t event_fd_;
+
+  absl::Mutex ring_mutex_;
+  std::queue<QueuedAction> ring_queue_ ABSL_GUARDED_BY(ring_mutex_);
+  uint32_t in_flight_ ABSL_GUARDED_BY(ring_mutex_) = 0;
+  // True while the ring thread is preparing a batch taken from ring_queue_.
+  bool preparing_ ABSL_GUARDED_BY(ring_mutex_) = false;
+  // True if the eventfd has been signalled since the ring thread last took from ring_queue_, so
+  // that enqueueing many actions at once costs a single wakeup.
+  bool wake_pending_ ABSL_GUARDED_BY(ring_mutex_) = false;
+  bool ring_terminate_ ABSL_GUARDED_BY(ring_mutex_) = false;
+
+  std::thread ring_thread_;
+};
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
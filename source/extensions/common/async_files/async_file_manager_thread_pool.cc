@@ -18,16 +18,21 @@ namespace AsyncFiles {
 AsyncFileManagerThreadPool::AsyncFileManagerThreadPool(
     const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
     Api::OsSysCalls& posix)
+    : AsyncFileManagerThreadPool(config.id(), config.thread_pool().thread_count(), posix) {}
+
+AsyncFileManagerThreadPool::AsyncFileManagerThreadPool(absl::string_view id,
+                                                       uint32_t thread_count,
+                                                       Api::OsSysCalls& posix)
     : posix_(posix) {
   if (!posix.supportsAllPosixFileOperations()) {
     throw EnvoyException("AsyncFileManagerThreadPool not supported");
   }
-  unsigned int thread_pool_size = config.thread_pool().thread_count();
+  unsigned int thread_pool_size = thread_count;
   if (thread_pool_size == 0) {
     thread_pool_size = std::thread::hardware_concurrency();
   }
   ENVOY_LOG(info, fmt::format("AsyncFileManagerThreadPool created with id '{}', with {} threads",
-                              config.id(), thread_pool_size));
+                              id, thread_pool_size));
   thread_pool_.reserve(thread_pool_size);
   while (thread_pool_.size() < thread_pool_size) {
     thread_pool_.emplace_back([this]() { worker(); });
@@ -80,17 +85,22 @@ void AsyncFileManagerThreadPool::postCancelledActionForCleanup(
 void AsyncFileManagerThreadPool::executeAction(QueuedAction&& queued_action) {
   using State = QueuedAction::State;
   State expected = State::Queued;
-  std::shared_ptr<std::atomic<State>> state = std::move(queued_action.state_);
-  std::unique_ptr<AsyncFileAction> action = std::move(queued_action.action_);
-  if (!state->compare_exchange_strong(expected, State::Executing)) {
+  if (!queued_action.state_->compare_exchange_strong(expected, State::Executing)) {
     ASSERT(expected == State::Cancelled);
-    if (action->executesEvenIfCancelled()) {
-      action->execute();
+    if (queued_action.action_->executesEvenIfCancelled()) {
+      queued_action.action_->execute();
     }
     return;
   }
-  action->execute();
-  expected = State::Executing;
+  queued_action.action_->execute();
+  onActionExecuted(std::move(queued_action));
+}
+
+void AsyncFileManagerThreadPool::onActionExecuted(QueuedAction&& queued_action) {
+  using State = QueuedAction::State;
+  State expected = State::Executing;
+  std::shared_ptr<std::atomic<State>> state = std::move(queued_action.state_);
+  std::unique_ptr<AsyncFileAction> action = std::move(queued_action.action_);
   if (!state->compare_exchange_strong(expected, State::InCallback)) {
     ASSERT(expected == State::Cancelled);
     action->onCancelledBeforeCallback();
@@ -57,12 +57,19 @@ public:
   bool supports_o_tmpfile_;
 #endif // O_TMPFILE
 
-private:
+protected:
+  AsyncFileManagerThreadPool(absl::string_view id, uint32_t thread_count, Api::OsSysCalls& posix);
+
   absl::AnyInvocable<void()> enqueue(Event::Dispatcher* dispatcher,
                                      std::unique_ptr<AsyncFileAction> action)
       ABSL_LOCKS_EXCLUDED(queue_mutex_) override;
   void postCancelledActionForCleanup(std::unique_ptr<AsyncFileAction> action)
       ABSL_LOCKS_EXCLUDED(queue_mutex_) override;
+  // Arranges the callback of an action that has been executed, or its cleanup if the action was
+  // cancelled while executing.
+  void onActionExecuted(QueuedAction&& queued_action);
+
+private:
   void worker() ABSL_LOCKS_EXCLUDED(queue_mutex_);
 
   absl::Mutex queue_mutex_;
@@ -84,6 +84,39 @@ public:
 
   T* getFirstDictionary() { return getDictionary(true, 0); };
 
+  /**
+   * Like getFirstDictionary, but shares ownership of the dictionary, so that it stays valid after
+   * it has been replaced. Compressors reference their dictionary for the whole stream.
+   */
+  std::shared_ptr<T> getFirstDictionaryShared() {
+    auto dictionary_map = tls_slot_->get();
+    auto it = dictionary_map->begin();
+    if (it != dictionary_map->end()) {
+      return it->second;
+    }
+    return nullptr;
+  };
+
+  /**
+   * Replaces all dictionaries on all threads with one built from the given data. Must be called
+   * on the main thread.
+   * @param data the content of the new dictionary.
+   * @return the id of the new dictionary, or 0 if the data is not a legal dictionary, in which
+   *     case the dictionaries are unchanged.
+   */
+  unsigned publishDictionary(absl::string_view data) {
+    auto dictionary = DictionarySharedPtr(builder_(data.data(), data.length()));
+    const unsigned id = getDictId(dictionary.get());
+    if (id != 0) {
+      tls_slot_->runOnAllThreads([dictionary = std::move(dictionary),
+                                  id](OptRef<DictionaryThreadLocalMap> dictionary_map) {
+        dictionary_map->clear();
+        dictionary_map->emplace(id, dictionary);
+      });
+    }
+    return id;
+  }
+
 private:
   class DictionarySharedPtr : public std::shared_ptr<T> {
   public:
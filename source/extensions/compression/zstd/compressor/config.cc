@@ -6,27 +6,44 @@ namespace Compression {
 namespace Zstd {
 namespace Compressor {
 
+SINGLETON_MANAGER_REGISTRATION(zstd_dictionary_training_thread);
+
 ZstdCompressorFactory::ZstdCompressorFactory(
     const envoy::extensions::compression::zstd::compressor::v3::Zstd& zstd,
-    Event::Dispatcher& dispatcher, Api::Api& api, ThreadLocal::SlotAllocator& tls)
+    Event::Dispatcher& dispatcher, Api::Api& api, ThreadLocal::SlotAllocator& tls,
+    Singleton::Manager& singleton_manager, Stats::Scope& scope)
     : compression_level_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, compression_level, ZSTD_CLEVEL_DEFAULT)),
       enable_checksum_(zstd.enable_checksum()), strategy_(zstd.strategy()),
       chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, chunk_size, ZSTD_CStreamOutSize())) {
-  if (zstd.has_dictionary()) {
+  if (zstd.has_dictionary() || zstd.has_dictionary_training()) {
     Protobuf::RepeatedPtrField<envoy::config::core::v3::DataSource> dictionaries;
-    dictionaries.Add()->CopyFrom(zstd.dictionary());
+    if (zstd.has_dictionary()) {
+      dictionaries.Add()->CopyFrom(zstd.dictionary());
+    }
     cdict_manager_ = std::make_unique<ZstdCDictManager>(
         dictionaries, dispatcher, api, tls, true,
         [this](const void* dict_buffer, size_t dict_size) -> ZSTD_CDict* {
           return ZSTD_createCDict(dict_buffer, dict_size, compression_level_);
         });
   }
+  if (zstd.has_dictionary_training()) {
+    // Pinned, so that the thread is not joined, possibly while training, when the last
+    // configuration with training is removed.
+    auto training_thread = singleton_manager.getTyped<DictionaryTrainingThread>(
+        SINGLETON_MANAGER_REGISTERED_NAME(zstd_dictionary_training_thread),
+        [&api] { return std::make_shared<DictionaryTrainingThread>(api); }, /*pin=*/true);
+    trainer_ = std::make_unique<DictionaryTrainer>(
+        zstd.dictionary_training(), dispatcher, api, scope, std::move(training_thread),
+        [this](absl::string_view dictionary) {
+          return cdict_manager_->publishDictionary(dictionary);
+        });
+  }
 }
 
 Envoy::Compression::Compressor::CompressorPtr ZstdCompressorFactory::createCompressor() {
   return std::make_unique<ZstdCompressorImpl>(compression_level_, enable_checksum_, strategy_,
-                                              cdict_manager_, chunk_size_);
+                                              cdict_manager_, chunk_size_, trainer_.get());
 }
 
 Envoy::Compression::Compressor::CompressorFactoryPtr
@@ -36,7 +53,7 @@ ZstdCompressorLibraryFactory::createCompressorFactoryFromProtoTyped(
   auto& server_context = context.serverFactoryContext();
   return std::make_unique<ZstdCompressorFactory>(
       proto_config, server_context.mainThreadDispatcher(), server_context.api(),
-      server_context.threadLocal());
+      server_context.threadLocal(), server_context.singletonManager(), context.scope());
 }
 
 /**
@@ -3,9 +3,11 @@
 #include "envoy/compression/compressor/factory.h"
 #include "envoy/extensions/compression/zstd/compressor/v3/zstd.pb.h"
 #include "envoy/extensions/compression/zstd/compressor/v3/zstd.pb.validate.h"
+#include "envoy/singleton/manager.h"
 
 #include "source/common/http/headers.h"
 #include "source/extensions/compression/common/compressor/factory_base.h"
+#include "source/extensions/compression/zstd/compressor/dictionary_trainer.h"
 #include "source/extensions/compression/zstd/compressor/zstd_compressor_impl.h"
 
 namespace Envoy {
@@ -27,7 +29,8 @@ class ZstdCompressorFactory : public Envoy::Compression::Compressor::CompressorF
 public:
   ZstdCompressorFactory(const envoy::extensions::compression::zstd::compressor::v3::Zstd& zstd,
                         Event::Dispatcher& dispatcher, Api::Api& api,
-                        ThreadLocal::SlotAllocator& tls);
+                        ThreadLocal::SlotAllocator& tls, Singleton::Manager& singleton_manager,
+                        Stats::Scope& scope);
 
   // Envoy::Compression::Compressor::CompressorFactory
   Envoy::Compression::Compressor::CompressorPtr createCompressor() override;
@@ -42,6 +45,8 @@ private:
   const uint32_t strategy_;
   const uint32_t chunk_size_;
   ZstdCDictManagerPtr cdict_manager_{nullptr};
+  // Declared after cdict_manager_, which it publishes to, so that it is destroyed first.
+  DictionaryTrainerPtr trainer_;
 };
 
 class ZstdCompressorLibraryFactory
@@ -0,0 +1,235 @@
+#include "source/extensions/compression/zstd/compressor/dictionary_trainer.h"
+
+#include <cstdio>
+
+#include "envoy/filesystem/filesystem.h"
+
+#include "source/common/common/utility.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "zdict.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+namespace {
+constexpr uint32_t DefaultSampleBytes = 4096;
+constexpr uint32_t DefaultMaxSamples = 1000;
+constexpr uint32_t DefaultMinSamples = 100;
+constexpr uint32_t DefaultMaxDictionaryBytes = 16 * 1024;
+constexpr uint64_t DefaultTrainingIntervalMs = 10 * 60 * 1000;
+// zstd recommends training from about 100 times as many bytes as the dictionary's size; more
+// only makes the training slower.
+constexpr uint64_t TrainingBytesPerDictionaryByte = 100;
+// How long the training thread waits, at most, before checking for due trainers again.
+constexpr std::chrono::minutes MaxTrainingWait{10};
+} // namespace
+
+DictionaryTrainer::DictionaryTrainer(
+    const envoy::extensions::compression::zstd::compressor::v3::Zstd::DictionaryTraining& config,
+    Event::Dispatcher& main_dispatcher, Api::Api& api, Stats::Scope& scope,
+    DictionaryTrainingThreadSharedPtr training_thread, PublishCb publish_cb)
+    : dictionary_path_(config.dictionary_path()),
+      sample_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, sample_bytes, DefaultSampleBytes)),
+      max_samples_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_samples, DefaultMaxSamples)),
+      min_samples_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, min_samples, DefaultMinSamples)),
+      max_dictionary_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_dictionary_bytes,
+                                                            DefaultMaxDictionaryBytes)),
+      training_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, training_interval,
+                                                    DefaultTrainingIntervalMs)),
+      main_dispatcher_(main_dispatcher), api_(api), time_source_(api.timeSource()),
+      scope_(scope.getShared()), stats_(generateStats("zstd.dictionary_training.", *scope_)),
+      publish_cb_(std::move(publish_cb)), training_thread_(std::move(training_thread)) {
+  training_thread_->add(*this);
+}
+
+DictionaryTrainer::~DictionaryTrainer() {
+  *destroyed_ = true;
+  training_thread_->remove(*this);
+}
+
+void DictionaryTrainer::addSample(std::string&& sample) {
+  if (sample.empty()) {
+    return;
+  }
+  stats_.samples_.inc();
+  absl::MutexLock lock(mu_);
+  if (samples_.size() < max_samples_) {
+    samples_.push_back(std::move(sample));
+  } else {
+    samples_[next_sample_] = std::move(sample);
+    next_sample_ = (next_sample_ + 1) % max_samples_;
+  }
+  ++new_samples_;
+}
+
+void DictionaryTrainer::recordCompression(uint64_t uncompressed_bytes, uint64_t compressed_bytes,
+                                          std::chrono::nanoseconds compression_time) {
+  stats_.uncompressed_bytes_.add(uncompressed_bytes);
+  stats_.compressed_bytes_.add(compressed_bytes);
+  stats_.compression_time_ns_.add(compression_time.count());
+}
+
+DictionaryTrainer::Training DictionaryTrainer::prepareTraining() {
+  // Copied out so that compressors aren't blocked while training, which can take seconds.
+  std::string samples_buffer;
+  std::vector<size_t> sample_sizes;
+  {
+    absl::MutexLock lock(mu_);
+    if (new_samples_ < min_samples_) {
+      return nullptr;
+    }
+    new_samples_ = 0;
+    // The most recent samples first, up to the bound on the training's input.
+    const uint64_t max_bytes = TrainingBytesPerDictionaryByte * max_dictionary_bytes_;
+    for (size_t i = 0; i < samples_.size(); ++i) {
+      const std::string& sample =
+          samples_[(next_sample_ + samples_.size() - 1 - i) % samples_.size()];
+      if (samples_buffer.size() + sample.size() > max_bytes) {
+        break;
+      }
+      samples_buffer.append(sample);
+      sample_sizes.push_back(sample.size());
+    }
+  }
+
+  // The scope is held so that the stats outlive the trainer while the training runs.
+  return [this, samples_buffer = std::move(samples_buffer),
+          sample_sizes = std::move(sample_sizes), max_dictionary_bytes = max_dictionary_bytes_,
+          dictionary_path = dictionary_path_, &file_system = api_.fileSystem(),
+          &main_dispatcher = main_dispatcher_, scope = scope_, stats = stats_,
+          destroyed = destroyed_]() {
+    stats.trainings_.inc();
+    std::string dictionary(max_dictionary_bytes, '\0');
+    const size_t result =
+        ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samples_buffer.data(),
+                              sample_sizes.data(), sample_sizes.size());
+    if (ZDICT_isError(result)) {
+      ENVOY_LOG(warn, "zstd dictionary training from {} samples failed: {}", sample_sizes.size(),
+                ZDICT_getErrorName(result));
+      stats.training_failures_.inc();
+      return false;
+    }
+    dictionary.resize(result);
+
+    // The dictionary is written before it is used, so that decompressors watching the file can
+    // pick it up before responses compressed with it reach them.
+    if (!writeDictionary(file_system, dictionary_path, dictionary)) {
+      stats.training_failures_.inc();
+      return false;
+    }
+
+    // The trainer is only used once the main thread has checked that it still exists.
+    main_dispatcher.post([this, destroyed, dictionary = std::move(dictionary)]() {
+      if (*destroyed) {
+        return;
+      }
+      const unsigned id = publish_cb_(dictionary);
+      if (id == 0) {
+        stats_.training_failures_.inc();
+        return;
+      }
+      stats_.dictionary_id_.set(id);
+      stats_.dictionary_version_.inc();
+      ENVOY_LOG(info, "using trained zstd dictionary {} of {} bytes", id, dictionary.size());
+    });
+    return true;
+  };
+}
+
+bool DictionaryTrainer::writeDictionary(Filesystem::Instance& file_system,
+                                        const std::string& path, absl::string_view dictionary) {
+  static constexpr Filesystem::FlagSet WriteFlags{1 << Filesystem::File::Operation::Write |
+                                                  1 << Filesystem::File::Operation::Create};
+  // Written to a temporary file which is renamed into place, so that watchers of the file never
+  // read a partly written dictionary.
+  const std::string temp_path = absl::StrCat(path, ".tmp");
+  Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, temp_path};
+  auto file = file_system.createFile(file_info);
+  if (!file || !file->open(WriteFlags).return_value_) {
+    ENVOY_LOG(warn, "failed to open {} to write a zstd dictionary", temp_path);
+    return false;
+  }
+  const Api::IoCallSizeResult written = file->write(dictionary);
+  file->close();
+  if (written.return_value_ != static_cast<ssize_t>(dictionary.size())) {
+    ENVOY_LOG(warn, "failed to write a zstd dictionary to {}", temp_path);
+    return false;
+  }
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    ENVOY_LOG(warn, "failed to rename {} to {}: {}", temp_path, path, errorDetails(errno));
+    return false;
+  }
+  return true;
+}
+
+DictionaryTrainingThread::DictionaryTrainingThread(Api::Api& api)
+    : time_source_(api.timeSource()) {
+  thread_ = api.threadFactory().createThread([this]() { trainingLoop(); },
+                                             Thread::Options{"ZstdDictTrain"});
+}
+
+DictionaryTrainingThread::~DictionaryTrainingThread() {
+  {
+    absl::MutexLock lock(mu_);
+    terminating_ = true;
+  }
+  thread_->join();
+}
+
+void DictionaryTrainingThread::add(DictionaryTrainer& trainer) {
+  absl::MutexLock lock(mu_);
+  trainers_[&trainer] = time_source_.monotonicTime() + trainer.trainingInterval();
+  changed_ = true;
+}
+
+void DictionaryTrainingThread::remove(DictionaryTrainer& trainer) {
+  absl::MutexLock lock(mu_);
+  trainers_.erase(&trainer);
+}
+
+void DictionaryTrainingThread::trainingLoop() {
+  while (true) {
+    DictionaryTrainer::Training training;
+    {
+      absl::MutexLock lock(mu_);
+      if (terminating_) {
+        return;
+      }
+      training = nextTraining();
+    }
+    if (training != nullptr) {
+      training();
+    }
+  }
+}
+
+DictionaryTrainer::Training DictionaryTrainingThread::nextTraining() {
+  const MonotonicTime now = time_source_.monotonicTime();
+  MonotonicTime next = now + MaxTrainingWait;
+  for (auto& [trainer, due] : trainers_) {
+    if (due <= now) {
+      due = now + trainer->trainingInterval();
+      DictionaryTrainer::Training training = trainer->prepareTraining();
+      if (training != nullptr) {
+        return training;
+      }
+    }
+    next = std::min(next, due);
+  }
+  changed_ = false;
+  mu_.AwaitWithTimeout(absl::Condition(this, &DictionaryTrainingThread::wakeUp),
+                       absl::FromChrono(next - now));
+  return nullptr;
+}
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/compression/zstd/compressor/v3/zstd.pb.h"
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+
+/**
+ * All zstd dictionary training stats. @see stats_macros.h
+ */
+#define ALL_ZSTD_DICTIONARY_TRAINING_STATS(COUNTER, GAUGE)                                         \
+  COUNTER(samples)                                                                                 \
+  COUNTER(trainings)                                                                               \
+  COUNTER(training_failures)                                                                       \
+  COUNTER(uncompressed_bytes)                                                                      \
+  COUNTER(compressed_bytes)                                                                        \
+  COUNTER(compression_time_ns)                                                                     \
+  GAUGE(dictionary_id, NeverImport)                                                                \
+  GAUGE(dictionary_version, NeverImport)
+
+/**
+ * Struct definition for zstd dictionary training stats. @see stats_macros.h
+ */
+struct ZstdDictionaryTrainingStats {
+  ALL_ZSTD_DICTIONARY_TRAINING_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+class DictionaryTrainingThread;
+using DictionaryTrainingThreadSharedPtr = std::shared_ptr<DictionaryTrainingThread>;
+
+/**
+ * Trains zstd dictionaries from samples of the responses being compressed.
+ *
+ * Compressors on any thread add samples, which are kept in a ring buffer. The shared training
+ * thread periodically trains a dictionary from them, once enough new samples have arrived since
+ * the previous training, and writes it to the configured file. The dictionary is then handed to
+ * the publish callback on the main thread, so that compressors created after that use it.
+ */
+class DictionaryTrainer : public Logger::Loggable<Logger::Id::compression> {
+public:
+  // Called on the main thread with each trained dictionary. Returns the dictionary's id, or 0
+  // if it could not be used.
+  using PublishCb = std::function<unsigned(absl::string_view dictionary)>;
+  // Trains a dictionary from copied samples. Returns true if a dictionary was trained.
+  using Training = std::function<bool()>;
+
+  DictionaryTrainer(
+      const envoy::extensions::compression::zstd::compressor::v3::Zstd::DictionaryTraining& config,
+      Event::Dispatcher& main_dispatcher, Api::Api& api, Stats::Scope& scope,
+      DictionaryTrainingThreadSharedPtr training_thread, PublishCb publish_cb);
+  ~DictionaryTrainer();
+
+  /**
+   * @return the number of bytes to sample from the start of each response body.
+   */
+  uint32_t sampleBytes() const { return sample_bytes_; }
+
+  std::chrono::milliseconds trainingInterval() const { return training_interval_; }
+
+  TimeSource& timeSource() { return time_source_; }
+
+  /**
+   * Adds a sample to train the next dictionary with. Thread-safe.
+   * @param sample the start of a response body.
+   */
+  void addSample(std::string&& sample) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Records the work done compressing one response. Thread-safe.
+   */
+  void recordCompression(uint64_t uncompressed_bytes, uint64_t compressed_bytes,
+                         std::chrono::nanoseconds compression_time);
+
+  /**
+   * Copies the most recent samples, if enough new samples have arrived. Thread-safe.
+   * @return a training which trains a dictionary from the copy, writes it and posts it to the
+   *         main thread, or nullptr if there are not enough new samples. The training refers to
+   *         nothing owned by the trainer, so the trainer may be destroyed while it runs.
+   */
+  Training prepareTraining() ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Trains a dictionary on the calling thread, if enough new samples have arrived; for tests.
+   * @return true if a dictionary was trained.
+   */
+  bool train() {
+    Training training = prepareTraining();
+    return training != nullptr && training();
+  }
+
+private:
+  static ZstdDictionaryTrainingStats generateStats(const std::string& prefix,
+                                                   Stats::Scope& scope) {
+    return ZstdDictionaryTrainingStats{ALL_ZSTD_DICTIONARY_TRAINING_STATS(
+        POOL_COUNTER_PREFIX(scope, prefix), POOL_GAUGE_PREFIX(scope, prefix))};
+  }
+
+  static bool writeDictionary(Filesystem::Instance& file_system, const std::string& path,
+                              absl::string_view dictionary);
+
+  const std::string dictionary_path_;
+  const uint32_t sample_bytes_;
+  const uint32_t max_samples_;
+  const uint32_t min_samples_;
+  const uint32_t max_dictionary_bytes_;
+  const std::chrono::milliseconds training_interval_;
+  Event::Dispatcher& main_dispatcher_;
+  Api::Api& api_;
+  TimeSource& time_source_;
+  // Held so that the stats outlive the configuration which created the trainer's scope, and any
+  // training which is still running when the trainer is destroyed.
+  const Stats::ScopeSharedPtr scope_;
+  ZstdDictionaryTrainingStats stats_;
+  const PublishCb publish_cb_;
+  // Guards posted publications against the trainer being destroyed. Only used on the main thread.
+  const std::shared_ptr<bool> destroyed_{std::make_shared<bool>(false)};
+
+  absl::Mutex mu_;
+  // A ring buffer of the most recent samples; next_sample_ is the slot to overwrite next.
+  std::vector<std::string> samples_ ABSL_GUARDED_BY(mu_);
+  size_t next_sample_ ABSL_GUARDED_BY(mu_) = 0;
+  // Samples added since the last training.
+  uint32_t new_samples_ ABSL_GUARDED_BY(mu_) = 0;
+
+  const DictionaryTrainingThreadSharedPtr training_thread_;
+};
+
+/**
+ * Runs the trainings of all dictionary trainers, one at a time, on a single thread, so that each
+ * configuration with training doesn't need a thread of its own. A training runs without the
+ * thread's lock held, on its own copy of the samples, so trainers are added and removed without
+ * waiting for it.
+ */
+class DictionaryTrainingThread : public Singleton::Instance {
+public:
+  explicit DictionaryTrainingThread(Api::Api& api);
+  ~DictionaryTrainingThread() override;
+
+  /**
+   * Trains the trainer's dictionaries every training interval until it is removed.
+   */
+  void add(DictionaryTrainer& trainer) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Stops training the trainer's dictionaries. Does not wait for a training in progress.
+   */
+  void remove(DictionaryTrainer& trainer) ABSL_LOCKS_EXCLUDED(mu_);
+
+private:
+  void trainingLoop() ABSL_LOCKS_EXCLUDED(mu_);
+  // Returns the training of a trainer which is due, or waits for one to become due and returns
+  // nullptr.
+  DictionaryTrainer::Training nextTraining() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  bool wakeUp() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) { return terminating_ || changed_; }
+
+  TimeSource& time_source_;
+  absl::Mutex mu_;
+  // When each trainer is next due to train.
+  absl::flat_hash_map<DictionaryTrainer*, MonotonicTime> trainers_ ABSL_GUARDED_BY(mu_);
+  // Set when a trainer is added, so that the thread recomputes how long to wait.
+  bool changed_ ABSL_GUARDED_BY(mu_) = false;
+  bool terminating_ ABSL_GUARDED_BY(mu_) = false;
+  Thread::ThreadPtr thread_;
+};
+
+using DictionaryTrainerPtr = std::unique_ptr<DictionaryTrainer>;
+
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
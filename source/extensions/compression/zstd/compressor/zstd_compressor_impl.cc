@@ -1,5 +1,7 @@
 #include "source/extensions/compression/zstd/compressor/zstd_compressor_impl.h"
 
+#include <algorithm>
+
 namespace Envoy {
 namespace Extensions {
 namespace Compression {
@@ -8,19 +10,54 @@ namespace Compressor {
 
 ZstdCompressorImpl::ZstdCompressorImpl(uint32_t compression_level, bool enable_checksum,
                                        uint32_t strategy, const ZstdCDictManagerPtr& cdict_manager,
-                                       uint32_t chunk_size)
+                                       uint32_t chunk_size, DictionaryTrainer* trainer)
     : ZstdCompressorImplBase(compression_level, enable_checksum, strategy, chunk_size),
-      cdict_manager_(cdict_manager) {
+      cdict_manager_(cdict_manager), trainer_(trainer) {
   size_t result;
   if (cdict_manager_) {
-    ZSTD_CDict* cdict = cdict_manager_->getFirstDictionary();
-    result = ZSTD_CCtx_refCDict(cctx_.get(), cdict);
+    cdict_ = cdict_manager_->getFirstDictionaryShared();
+  }
+  // With dictionary training, there is no dictionary until the first one has been trained.
+  if (cdict_) {
+    result = ZSTD_CCtx_refCDict(cctx_.get(), cdict_.get());
   } else {
     result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_compressionLevel, compression_level_);
   }
   RELEASE_ASSERT(!ZSTD_isError(result), "");
 }
 
+void ZstdCompressorImpl::compress(Buffer::Instance& buffer,
+                                  Envoy::Compression::Compressor::State state) {
+  if (trainer_ == nullptr) {
+    ZstdCompressorImplBase::compress(buffer, state);
+    return;
+  }
+
+  const uint64_t input_length = buffer.length();
+  if (sample_.size() < trainer_->sampleBytes() && input_length > 0) {
+    const uint64_t length =
+        std::min<uint64_t>(trainer_->sampleBytes() - sample_.size(), input_length);
+    const size_t offset = sample_.size();
+    sample_.resize(offset + length);
+    buffer.copyOut(0, length, sample_.data() + offset);
+  }
+
+  const MonotonicTime start = trainer_->timeSource().monotonicTime();
+  ZstdCompressorImplBase::compress(buffer, state);
+  compression_time_ += trainer_->timeSource().monotonicTime() - start;
+  uncompressed_bytes_ += input_length;
+  compressed_bytes_ += buffer.length();
+
+  if (state == Envoy::Compression::Compressor::State::Finish) {
+    trainer_->recordCompression(uncompressed_bytes_, compressed_bytes_, compression_time_);
+    trainer_->addSample(std::move(sample_));
+    sample_.clear();
+    uncompressed_bytes_ = 0;
+    compressed_bytes_ = 0;
+    compression_time_ = std::chrono::nanoseconds(0);
+  }
+}
+
 void ZstdCompressorImpl::compressPreprocess(Buffer::Instance&,
                                             Envoy::Compression::Compressor::State) {}
 
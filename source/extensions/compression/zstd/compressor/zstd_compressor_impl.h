@@ -1,10 +1,15 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
+#include <string>
+
 #include "envoy/compression/compressor/compressor.h"
 
 #include "source/common/compression/zstd/common/base.h"
 #include "source/common/compression/zstd/compressor/zstd_compressor_impl_base.h"
 #include "source/extensions/compression/zstd/common/dictionary_manager.h"
+#include "source/extensions/compression/zstd/compressor/dictionary_trainer.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -21,8 +26,14 @@ using ZstdCDictManagerPtr = std::unique_ptr<ZstdCDictManager>;
  */
 class ZstdCompressorImpl : public Envoy::Compression::Zstd::Compressor::ZstdCompressorImplBase {
 public:
+  // If trainer is not null, the start of the input is sampled for it, and the compression work
+  // is recorded with it.
   ZstdCompressorImpl(uint32_t compression_level, bool enable_checksum, uint32_t strategy,
-                     const ZstdCDictManagerPtr& cdict_manager, uint32_t chunk_size);
+                     const ZstdCDictManagerPtr& cdict_manager, uint32_t chunk_size,
+                     DictionaryTrainer* trainer = nullptr);
+
+  // Compression::Compressor::Compressor
+  void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
 
 private:
   void compressPreprocess(Buffer::Instance& buffer,
@@ -34,6 +45,13 @@ private:
   void compressPostprocess(Buffer::Instance& accumulation_buffer) override;
 
   const ZstdCDictManagerPtr& cdict_manager_;
+  // Held so that the dictionary outlives its replacement while this stream uses it.
+  std::shared_ptr<ZSTD_CDict> cdict_;
+  DictionaryTrainer* const trainer_;
+  std::string sample_;
+  uint64_t uncompressed_bytes_{0};
+  uint64_t compressed_bytes_{0};
+  std::chrono::nanoseconds compression_time_{0};
 };
 
 } // namespace Compressor
@@ -76,7 +76,11 @@ std::string FilesystemSubscriptionImpl::refreshInternal(ProtobufTypes::MessagePt
       THROW_OR_RETURN_VALUE(DecodedResourcesWrapper::create(*resource_decoder_, message.resources(),
                                                             message.version_info()),
                             std::unique_ptr<DecodedResourcesWrapper>);
+  const MonotonicTime start = api_.timeSource().monotonicTime();
   THROW_IF_NOT_OK(callbacks_.onConfigUpdate(decoded_resources->refvec_, message.version_info()));
+  stats_.update_duration_.recordValue(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                          api_.timeSource().monotonicTime() - start)
+                                          .count());
   return message.version_info();
 }
 
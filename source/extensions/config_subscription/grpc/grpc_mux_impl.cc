@@ -409,6 +409,7 @@ void GrpcMuxImpl::onDiscoveryResponse(
   TRY_ASSERT_MAIN_THREAD {
     std::vector<DecodedResourcePtr> resources;
     OpaqueResourceDecoder& resource_decoder = *api_state.watches_.front()->resource_decoder_;
+    const DecodeArenaSharedPtr arena = createDecodeArena();
 
     for (const auto& resource : message->resources()) {
       // TODO(snowp): Check the underlying type when the resource is a Resource.
@@ -420,7 +421,8 @@ void GrpcMuxImpl::onDiscoveryResponse(
       }
 
       auto decoded_resource = THROW_OR_RETURN_VALUE(
-          DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info()),
+          DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info(),
+                                            arena),
           DecodedResourceImplPtr);
 
       if (!isHeartbeatResource(type_url, *decoded_resource)) {
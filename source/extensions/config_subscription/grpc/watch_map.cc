@@ -207,10 +207,12 @@ void WatchMap::onConfigUpdate(const Protobuf::RepeatedPtrField<Protobuf::Any>& r
 
   std::vector<DecodedResourcePtr> decoded_resources;
   decoded_resources.reserve(resources.size());
+  const DecodeArenaSharedPtr arena = createDecodeArena();
   for (const auto& r : resources) {
-    decoded_resources.emplace_back(THROW_OR_RETURN_VALUE(
-        DecodedResourceImpl::fromResource((*watches_.begin())->resource_decoder_, r, version_info),
-        DecodedResourceImplPtr));
+    decoded_resources.emplace_back(
+        THROW_OR_RETURN_VALUE(DecodedResourceImpl::fromResource(
+                                  (*watches_.begin())->resource_decoder_, r, version_info, arena),
+                              DecodedResourceImplPtr));
   }
 
   onConfigUpdate(decoded_resources, version_info);
@@ -233,6 +235,7 @@ void WatchMap::onConfigUpdate(
   // resources the watch map is interested in. Reserve the correct amount of
   // space for the vector for the good case.
   decoded_resources.reserve(added_resources.size());
+  const DecodeArenaSharedPtr arena = createDecodeArena();
   for (const auto* r : added_resources) {
     const absl::flat_hash_set<Watch*>& interested_in_r = watchesInterestedIn(r->name());
     // If there are no watches, then we don't need to decode. If there are watches, they should all
@@ -241,7 +244,7 @@ void WatchMap::onConfigUpdate(
       continue;
     }
     decoded_resources.emplace_back(
-        new DecodedResourceImpl((*interested_in_r.begin())->resource_decoder_, *r));
+        new DecodedResourceImpl((*interested_in_r.begin())->resource_decoder_, *r, arena));
     for (const auto& interested_watch : interested_in_r) {
       per_watch_added[interested_watch].emplace_back(*decoded_resources.back());
     }
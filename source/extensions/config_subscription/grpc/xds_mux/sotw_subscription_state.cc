@@ -49,6 +49,7 @@ void SotwSubscriptionState::handleGoodResponse(
 
   {
     const auto scoped_update = ttl_.scopedTtlUpdate();
+    const DecodeArenaSharedPtr arena = createDecodeArena();
     for (const auto& any : message.resources()) {
       if (!any.Is<envoy::service::discovery::v3::Resource>() &&
           any.type_url() != message.type_url()) {
@@ -59,7 +60,7 @@ void SotwSubscriptionState::handleGoodResponse(
       }
 
       auto decoded_resource = THROW_OR_RETURN_VALUE(
-          DecodedResourceImpl::fromResource(*resource_decoder_, any, message.version_info()),
+          DecodedResourceImpl::fromResource(*resource_decoder_, any, message.version_info(), arena),
           DecodedResourceImplPtr);
       setResourceTtl(*decoded_resource);
       if (isHeartbeatResource(*decoded_resource, message.version_info())) {
@@ -94,7 +94,11 @@ void HttpSubscriptionImpl::parseResponse(const Http::ResponseMessage& response)
         THROW_OR_RETURN_VALUE(DecodedResourcesWrapper::create(
                                   *resource_decoder_, message.resources(), message.version_info()),
                               std::unique_ptr<DecodedResourcesWrapper>);
+    const MonotonicTime start = dispatcher_.timeSource().monotonicTime();
     THROW_IF_NOT_OK(callbacks_.onConfigUpdate(decoded_resources->refvec_, message.version_info()));
+    stats_.update_duration_.recordValue(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                            dispatcher_.timeSource().monotonicTime() - start)
+                                            .count());
     request_.set_version_info(message.version_info());
     stats_.update_time_.set(DateUtil::nowToMilliseconds(dispatcher_.timeSource()));
     stats_.version_.set(HashUtil::xxHash64(request_.version_info()));
@@ -1,5 +1,6 @@
 #include "source/extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <memory>
@@ -76,24 +77,90 @@ ShareProviderManagerSharedPtr ShareProviderManager::singleton(Event::Dispatcher&
 
 RateLimitTokenBucket::RateLimitTokenBucket(uint64_t max_tokens, uint64_t tokens_per_fill,
                                            std::chrono::milliseconds fill_interval,
-                                           TimeSource& time_source, bool shadow_mode)
+                                           TimeSource& time_source, bool shadow_mode,
+                                           uint32_t token_lease_size)
     : token_bucket_(max_tokens, time_source,
                     // Calculate the fill rate in tokens per second.
                     tokens_per_fill / std::chrono::duration<double>(fill_interval).count()),
-      fill_interval_(fill_interval), shadow_mode_(shadow_mode) {}
+      fill_interval_(fill_interval), shadow_mode_(shadow_mode),
+      token_lease_size_(token_lease_size) {
+  if (token_lease_size > 0) {
+    lease_slots_ = std::make_unique<LeaseSlot[]>(NumLeaseSlots);
+  }
+}
+
 bool RateLimitTokenBucket::consume(double factor, uint64_t to_consume) {
   ASSERT(!(factor <= 0.0 || factor > 1.0));
-  auto cb = [tokens = to_consume / factor](double total) { return total < tokens ? 0.0 : tokens; };
+  const double tokens = to_consume / factor;
+  if (lease_slots_ != nullptr) {
+    return consumeFromLease(tokens);
+  }
+  auto cb = [tokens](double total) { return total < tokens ? 0.0 : tokens; };
   return token_bucket_.consume(cb) != 0.0;
 }
 
+bool RateLimitTokenBucket::consumeFromLease(double tokens) {
+  // The slot of a thread is picked the first time it uses any leasing bucket, so workers are
+  // spread evenly over the slots.
+  static std::atomic<uint32_t> next_slot{0};
+  thread_local const uint32_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+  std::atomic<double>& leased = lease_slots_[slot % NumLeaseSlots].tokens_;
+
+  double current = leased.load(std::memory_order_relaxed);
+  while (current >= tokens) {
+    if (leased.compare_exchange_weak(current, current - tokens, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+
+  // Denied requests don't queue up on the borrow lock while the shared bucket is empty.
+  if (token_bucket_.remainingTokens() < tokens) {
+    return false;
+  }
+
+  // The lease can't cover the request: borrow a new batch from the shared bucket, serve the request
+  // from it and keep the rest. Once the shared bucket holds less than a full batch, only the tokens
+  // of the request itself are taken, so that no tokens are stranded in leases near the limit.
+  absl::MutexLock lock(borrow_mutex_);
+  // Tokens held in leases count against the capacity of the shared bucket, so that a bucket which
+  // refilled while batches were outstanding doesn't admit more than max tokens at once. Leases only
+  // grow while the lock is held, so the sum is an upper bound of what they hold.
+  double outstanding = 0;
+  for (uint32_t i = 0; i < NumLeaseSlots; ++i) {
+    outstanding += lease_slots_[i].tokens_.load(std::memory_order_relaxed);
+  }
+  const double capacity = token_bucket_.maxTokens() - outstanding;
+  double granted = 0;
+  auto cb = [tokens, batch = std::max(tokens, token_lease_size_), capacity,
+             &granted](double total) {
+    // Tokens above the capacity would have overflowed the bucket and are dropped.
+    const double available = std::min(total, capacity);
+    if (available >= batch) {
+      granted = batch;
+    } else if (available >= tokens) {
+      granted = tokens;
+    } else {
+      return 0.0;
+    }
+    return total - available + granted;
+  };
+  if (token_bucket_.consume(cb) == 0.0) {
+    return false;
+  }
+  current = leased.load(std::memory_order_relaxed);
+  while (!leased.compare_exchange_weak(current, current + granted - tokens,
+                                       std::memory_order_relaxed)) {
+  }
+  return true;
+}
+
 LocalRateLimiterImpl::LocalRateLimiterImpl(
     const std::chrono::milliseconds fill_interval, const uint64_t max_tokens,
     const uint64_t tokens_per_fill, Event::Dispatcher& dispatcher,
     const Protobuf::RepeatedPtrField<
         envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
     bool always_consume_default_token_bucket, ShareProviderSharedPtr shared_provider,
-    uint32_t lru_size)
+    uint32_t lru_size, uint32_t token_lease_size)
     : time_source_(dispatcher.timeSource()), share_provider_(std::move(shared_provider)),
       always_consume_default_token_bucket_(always_consume_default_token_bucket) {
   // Ignore the default token bucket if fill_interval is 0 because 0 fill_interval means nothing
@@ -103,7 +170,7 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
       throw EnvoyException("local rate limit token bucket fill timer must be >= 50ms");
     }
     default_token_bucket_ = std::make_shared<RateLimitTokenBucket>(
-        max_tokens, tokens_per_fill, fill_interval, time_source_, false);
+        max_tokens, tokens_per_fill, fill_interval, time_source_, false, token_lease_size);
   }
 
   for (const auto& descriptor : descriptors) {
@@ -133,14 +200,14 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     if (wildcard_found) {
       DynamicDescriptorSharedPtr dynamic_descriptor = std::make_shared<DynamicDescriptor>(
           per_descriptor_max_tokens, per_descriptor_tokens_per_fill, per_descriptor_fill_interval,
-          lru_size, dispatcher.timeSource(), shadow_mode);
+          lru_size, dispatcher.timeSource(), shadow_mode, token_lease_size);
       dynamic_descriptors_.addDescriptor(std::move(new_descriptor), std::move(dynamic_descriptor));
       continue;
     }
     RateLimitTokenBucketSharedPtr per_descriptor_token_bucket =
         std::make_shared<RateLimitTokenBucket>(
             per_descriptor_max_tokens, per_descriptor_tokens_per_fill, per_descriptor_fill_interval,
-            time_source_, shadow_mode);
+            time_source_, shadow_mode, token_lease_size);
     auto result =
         descriptors_.emplace(std::move(new_descriptor), std::move(per_descriptor_token_bucket));
     if (!result.second) {
@@ -293,10 +360,11 @@ DynamicDescriptorMap::getBucket(const RateLimit::Descriptor request_descriptor)
 DynamicDescriptor::DynamicDescriptor(uint64_t per_descriptor_max_tokens,
                                      uint64_t per_descriptor_tokens_per_fill,
                                      std::chrono::milliseconds per_descriptor_fill_interval,
-                                     uint32_t lru_size, TimeSource& time_source, bool shadow_mode)
+                                     uint32_t lru_size, TimeSource& time_source, bool shadow_mode,
+                                     uint32_t token_lease_size)
     : max_tokens_(per_descriptor_max_tokens), tokens_per_fill_(per_descriptor_tokens_per_fill),
       fill_interval_(per_descriptor_fill_interval), lru_size_(lru_size), time_source_(time_source),
-      shadow_mode_(shadow_mode) {}
+      shadow_mode_(shadow_mode), token_lease_size_(token_lease_size) {}
 
 RateLimitTokenBucketSharedPtr
 DynamicDescriptor::addOrGetDescriptor(const RateLimit::Descriptor& request_descriptor) {
@@ -314,7 +382,7 @@ DynamicDescriptor::addOrGetDescriptor(const RateLimit::Descriptor& request_descr
   ENVOY_LOG(trace, "max_tokens: {}, tokens_per_fill: {}, fill_interval: {}", max_tokens_,
             tokens_per_fill_, std::chrono::duration<double>(fill_interval_).count());
   per_descriptor_token_bucket = std::make_shared<RateLimitTokenBucket>(
-      max_tokens_, tokens_per_fill_, fill_interval_, time_source_, shadow_mode_);
+      max_tokens_, tokens_per_fill_, fill_interval_, time_source_, shadow_mode_, token_lease_size_);
 
   ENVOY_LOG(trace, "DynamicDescriptor::addorGetDescriptor: adding dynamic descriptor: {}",
             request_descriptor.toString());
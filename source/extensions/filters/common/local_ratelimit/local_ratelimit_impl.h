@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <ratio>
 
@@ -15,6 +16,8 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/extensions/filters/common/local_ratelimit/local_ratelimit.h"
 
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -30,7 +33,7 @@ class DynamicDescriptor : public Logger::Loggable<Logger::Id::rate_limit_quota>
 public:
   DynamicDescriptor(uint64_t max_tokens, uint64_t tokens_per_fill,
                     std::chrono::milliseconds fill_interval, uint32_t lru_size,
-                    TimeSource& time_source, bool shadow_mode);
+                    TimeSource& time_source, bool shadow_mode, uint32_t token_lease_size = 0);
   // add a new user configured descriptor to the set.
   RateLimitTokenBucketSharedPtr addOrGetDescriptor(const RateLimit::Descriptor& request_descriptor);
 
@@ -48,6 +51,7 @@ private:
   uint32_t lru_size_;
   TimeSource& time_source_;
   const bool shadow_mode_{false};
+  const uint32_t token_lease_size_{};
 };
 
 using DynamicDescriptorSharedPtr = std::shared_ptr<DynamicDescriptor>;
@@ -105,9 +109,16 @@ using ShareProviderManagerSharedPtr = std::shared_ptr<ShareProviderManager>;
 class RateLimitTokenBucket : public TokenBucketContext,
                              public Logger::Loggable<Logger::Id::local_rate_limit> {
 public:
+  /**
+   * @param token_lease_size if non-zero, threads borrow tokens from the shared bucket in batches of
+   * this size and serve requests from their batch without touching the shared bucket. Tokens held
+   * in batches count against the capacity of the shared bucket, so that at most max_tokens are
+   * available at once, but up to NumLeaseSlots * token_lease_size of them may be held by idle
+   * threads.
+   */
   RateLimitTokenBucket(uint64_t max_tokens, uint64_t tokens_per_fill,
                        std::chrono::milliseconds fill_interval, TimeSource& time_source,
-                       bool shadow_mode);
+                       bool shadow_mode, uint32_t token_lease_size = 0);
 
   // RateLimitTokenBucket
   bool consume(double factor = 1.0, uint64_t tokens = 1);
@@ -123,10 +134,26 @@ public:
     return static_cast<uint64_t>(std::ceil(token_bucket_.nextTokenAvailable().count() / 1000));
   }
 
+  // Number of lease slots. Threads are spread over the slots round robin, so this bounds the
+  // number of batches that can be outstanding at once.
+  static constexpr uint32_t NumLeaseSlots = 16;
+
 private:
+  // Tokens borrowed from the shared bucket by the threads mapped to this slot. Each slot has its
+  // own cache line so that threads consuming from their own batch do not contend with each other.
+  struct alignas(64) LeaseSlot {
+    std::atomic<double> tokens_{0};
+  };
+
+  bool consumeFromLease(double tokens);
+
   AtomicTokenBucketImpl token_bucket_;
   const std::chrono::milliseconds fill_interval_;
   const bool shadow_mode_{false};
+  const double token_lease_size_{};
+  std::unique_ptr<LeaseSlot[]> lease_slots_;
+  // Serializes borrowing batches, so that the tokens held in leases are known while borrowing.
+  absl::Mutex borrow_mutex_;
 };
 using RateLimitTokenBucketSharedPtr = std::shared_ptr<RateLimitTokenBucket>;
 
@@ -139,7 +166,8 @@ public:
       const Protobuf::RepeatedPtrField<
           envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
       bool always_consume_default_token_bucket = true,
-      ShareProviderSharedPtr shared_provider = nullptr, const uint32_t lru_size = 20);
+      ShareProviderSharedPtr shared_provider = nullptr, const uint32_t lru_size = 20,
+      const uint32_t token_lease_size = 0);
   ~LocalRateLimiterImpl() override;
 
   LocalRateLimiter::Result
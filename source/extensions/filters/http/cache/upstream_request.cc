@@ -226,6 +226,12 @@ void UpstreamRequest::onHeaders(Http::ResponseHeaderMapPtr&& headers, bool end_s
     }
   } else {
     setInsertStatus(InsertStatus::NoInsertResponseNotCacheable);
+    if (lookup_) {
+      // Nothing will be inserted, so release the lookup now rather than when the response ends;
+      // a cache may have other lookups waiting on this one's insert.
+      lookup_->onDestroy();
+      lookup_ = nullptr;
+    }
   }
   setFilterState(FilterState::NotServingFromCache);
   if (filter_) {
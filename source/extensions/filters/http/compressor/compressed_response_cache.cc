@@ -0,0 +1,82 @@
+#include "source/extensions/filters/http/compressor/compressed_response_cache.h"
+
+#include <iterator>
+
+#include "source/common/common/hash.h"
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+namespace {
+constexpr uint64_t DefaultMaxBodyBytes = 256 * 1024;
+// Bounds the memory used to remember keys which have been seen only once.
+constexpr size_t MaxSightings = 64 * 1024;
+} // namespace
+
+CompressedResponseCache::CompressedResponseCache(
+    const envoy::extensions::filters::http::compressor::v3::Compressor::CompressedResponseCache&
+        config,
+    const std::string& stats_prefix, Stats::Scope& scope)
+    : max_size_bytes_(config.max_size_bytes()),
+      max_body_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_body_bytes, DefaultMaxBodyBytes)),
+      cache_by_body_digest_(config.cache_by_body_digest()),
+      stats_(generateStats(stats_prefix, scope)) {}
+
+CompressedResponseCache::BodySharedPtr CompressedResponseCache::lookup(const std::string& key) {
+  absl::MutexLock lock(mu_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    stats_.response_cache_miss_.inc();
+    return nullptr;
+  }
+  stats_.response_cache_hit_.inc();
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->body_;
+}
+
+bool CompressedResponseCache::recordSighting(const std::string& key) {
+  const uint64_t hash = HashUtil::xxHash64(key);
+  absl::MutexLock lock(mu_);
+  if (sightings_.size() >= MaxSightings) {
+    sightings_.clear();
+  }
+  return !sightings_.insert(hash).second;
+}
+
+void CompressedResponseCache::insert(const std::string& key, std::string&& compressed_body) {
+  const uint64_t size = key.size() + compressed_body.size();
+  if (size > max_size_bytes_) {
+    return;
+  }
+  auto body = std::make_shared<const std::string>(std::move(compressed_body));
+  absl::MutexLock lock(mu_);
+  auto existing = index_.find(key);
+  if (existing != index_.end()) {
+    removeNode(existing->second);
+  }
+  lru_.push_front(Node{key, std::move(body), size});
+  // The index refers to the key held by the node.
+  index_.emplace(lru_.front().key_, lru_.begin());
+  size_bytes_ += size;
+  while (size_bytes_ > max_size_bytes_) {
+    removeNode(std::prev(lru_.end()));
+    stats_.response_cache_eviction_.inc();
+  }
+  stats_.response_cache_size_bytes_.set(size_bytes_);
+  stats_.response_cache_entries_.set(lru_.size());
+}
+
+void CompressedResponseCache::removeNode(Lru::iterator it) {
+  size_bytes_ -= it->size_;
+  index_.erase(it->key_);
+  // Responses which are still sending the body keep it alive until they are done with it.
+  lru_.erase(it);
+}
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+/**
+ * Compressed response cache stats. @see stats_macros.h
+ */
+#define COMPRESSED_RESPONSE_CACHE_STATS(COUNTER, GAUGE)                                            \
+  COUNTER(response_cache_hit)                                                                      \
+  COUNTER(response_cache_miss)                                                                     \
+  COUNTER(response_cache_eviction)                                                                 \
+  GAUGE(response_cache_size_bytes, NeverImport)                                                    \
+  GAUGE(response_cache_entries, NeverImport)
+
+/**
+ * Struct definition for compressed response cache stats. @see stats_macros.h
+ */
+struct CompressedResponseCacheStats {
+  COMPRESSED_RESPONSE_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * A bounded cache of compressed response bodies, dropping the least recently used bodies first.
+ * The keys are chosen by the caller, and must identify both the uncompressed body and how it
+ * was compressed. Callers only cache a body once recordSighting() shows that its key repeats,
+ * so that unique responses are compressed once and never copied into the cache.
+ *
+ * All functions are thread-safe.
+ */
+class CompressedResponseCache {
+public:
+  using BodySharedPtr = std::shared_ptr<const std::string>;
+
+  CompressedResponseCache(const envoy::extensions::filters::http::compressor::v3::Compressor::
+                              CompressedResponseCache& config,
+                          const std::string& stats_prefix, Stats::Scope& scope);
+
+  /**
+   * @return the size of the largest uncompressed body which should be cached.
+   */
+  uint64_t maxBodyBytes() const { return max_body_bytes_; }
+
+  /**
+   * @return whether responses without a strong ETag should be identified by a digest of the body.
+   */
+  bool cacheByBodyDigest() const { return cache_by_body_digest_; }
+
+  /**
+   * @param key the key of the response.
+   * @return the compressed body, or nullptr if it is not cached.
+   */
+  BodySharedPtr lookup(const std::string& key) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Records that a response with the given key is being compressed, for admission to the cache.
+   * @param key the key of the response.
+   * @return whether the key was seen before, in which case the response is worth caching.
+   */
+  bool recordSighting(const std::string& key) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Caches a compressed body, dropping least recently used bodies to make room for it.
+   * @param key the key of the response.
+   * @param compressed_body the complete compressed body.
+   */
+  void insert(const std::string& key, std::string&& compressed_body) ABSL_LOCKS_EXCLUDED(mu_);
+
+private:
+  struct Node {
+    std::string key_;
+    BodySharedPtr body_;
+    uint64_t size_;
+  };
+  using Lru = std::list<Node>;
+
+  static CompressedResponseCacheStats generateStats(const std::string& prefix,
+                                                    Stats::Scope& scope) {
+    return CompressedResponseCacheStats{COMPRESSED_RESPONSE_CACHE_STATS(
+        POOL_COUNTER_PREFIX(scope, prefix), POOL_GAUGE_PREFIX(scope, prefix))};
+  }
+
+  void removeNode(Lru::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const uint64_t max_size_bytes_;
+  const uint64_t max_body_bytes_;
+  const bool cache_by_body_digest_;
+  CompressedResponseCacheStats stats_;
+
+  absl::Mutex mu_;
+  // Most recently used first.
+  Lru lru_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<absl::string_view, Lru::iterator> index_ ABSL_GUARDED_BY(mu_);
+  uint64_t size_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  // Hashes of the keys passed to recordSighting(), forgotten all at once when there are too many.
+  absl::flat_hash_set<uint64_t> sightings_ ABSL_GUARDED_BY(mu_);
+};
+
+using CompressedResponseCachePtr = std::unique_ptr<CompressedResponseCache>;
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
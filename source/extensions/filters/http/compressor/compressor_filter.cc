@@ -6,12 +6,17 @@
 #include "envoy/registry/registry.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/hex.h"
 #include "source/common/config/utility.h"
+#include "source/common/crypto/utility.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/utility.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/common/protobuf/utility.h"
+#include "source/server/generic_factory_context.h"
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/match.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -82,6 +87,19 @@ void compressAndUpdateStats(const Compression::Compressor::CompressorPtr& compre
 
 } // namespace
 
+Compression::Compressor::CompressorFactoryPtr createCompressorFactory(
+    Compression::Compressor::NamedCompressorLibraryConfigFactory& config_factory,
+    const Protobuf::Message& config, const std::string& library_name,
+    const std::string& stats_prefix, Server::Configuration::GenericFactoryContext& context) {
+  // Libraries which keep statistics hold on to the scope for as long as they need it.
+  Stats::ScopeSharedPtr scope =
+      context.scope().createScope(fmt::format("{}compressor.{}.", stats_prefix, library_name));
+  Server::GenericFactoryContextImpl library_context(context.serverFactoryContext(), *scope,
+                                                    context.messageValidationVisitor(),
+                                                    &context.initManager());
+  return config_factory.createCompressorFactoryFromProto(config, library_context);
+}
+
 CompressorFilterConfig::DirectionConfig::DirectionConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor::CommonDirectionConfig&
         proto_config,
@@ -146,7 +164,13 @@ CompressorFilterConfig::ResponseDirectionConfig::ResponseDirectionConfig(
       status_header_enabled_(proto_config.response_direction_config().status_header_enabled()),
       uncompressible_response_codes_(uncompressibleResponseCodesSet(
           proto_config.response_direction_config().uncompressible_response_codes())),
-      response_stats_{generateResponseStats(stats_prefix, scope)} {}
+      response_stats_{generateResponseStats(stats_prefix, scope)},
+      compressed_response_cache_(
+          proto_config.response_direction_config().has_compressed_response_cache()
+              ? std::make_unique<CompressedResponseCache>(
+                    proto_config.response_direction_config().compressed_response_cache(),
+                    stats_prefix + "response.", scope)
+              : nullptr) {}
 
 const envoy::extensions::filters::http::compressor::v3::Compressor::CommonDirectionConfig
 CompressorFilterConfig::ResponseDirectionConfig::commonConfig(
@@ -224,7 +248,13 @@ CompressorPerRouteFilterConfig::CompressorPerRouteFilterConfig(
       ProtobufTypes::MessagePtr message = Config::Utility::translateAnyToFactoryConfig(
           config.overrides().compressor_library().typed_config(),
           context.messageValidationVisitor(), *config_factory);
-      compressor_factory_ = config_factory->createCompressorFactoryFromProto(*message, context);
+      // Per-route libraries have no filter stats prefix, so their statistics are told apart by
+      // a hash of their configuration instead.
+      compressor_factory_ = createCompressorFactory(
+          *config_factory, *message, config.overrides().compressor_library().name(),
+          fmt::format("per_route.{:x}.",
+                      MessageUtil::hash(config.overrides().compressor_library())),
+          context);
     }
     break;
   case CompressorPerRoute::OVERRIDE_NOT_SET:
@@ -253,6 +283,10 @@ Http::FilterHeadersStatus CompressorFilter::decodeHeaders(Http::RequestHeaderMap
       removeAcceptEncodingHeader(response_config, per_route_config_)) {
     headers.removeInline(accept_encoding_handle.handle());
   }
+  if (response_config.compressedResponseCache() != nullptr) {
+    request_host_and_path_ =
+        std::make_unique<std::string>(absl::StrCat(headers.getHostValue(), headers.getPathValue()));
+  }
 
   const auto& request_config = config_->requestDirectionConfig();
 
@@ -353,12 +387,15 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
       isResponseCodeCompressible(headers, config);
   if (!end_stream && isAcceptEncodingAllowed(isEnabledAndContentLengthBigEnough, headers) &&
       isCompressible && isTransferEncodingAllowed(headers)) {
+    initResponseCache(headers);
     sanitizeEtagHeader(headers);
     headers.removeContentLength();
     headers.setInline(response_content_encoding_handle.handle(), getContentEncoding());
     config.stats().compressed_.inc();
-    // Finally instantiate the compressor.
-    response_compressor_ = getCompressorFactory().createCompressor();
+    // Finally instantiate the compressor, unless that waits on the response cache.
+    if (response_cache_state_ == nullptr) {
+      response_compressor_ = getCompressorFactory().createCompressor();
+    }
   } else {
     config.stats().not_compressed_.inc();
   }
@@ -438,13 +475,16 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeadersWithStatusHeader(
     return Http::FilterHeadersStatus::Continue;
   }
 
+  initResponseCache(headers);
   sanitizeEtagHeader(headers);
   std::string content_length = std::string(headers.getContentLengthValue());
   headers.removeContentLength();
   headers.setInline(response_content_encoding_handle.handle(), getContentEncoding());
   config.stats().compressed_.inc();
-  // Finally instantiate the compressor.
-  response_compressor_ = config_->makeCompressor();
+  // Finally instantiate the compressor, unless that waits on the response cache.
+  if (response_cache_state_ == nullptr) {
+    response_compressor_ = config_->makeCompressor();
+  }
   insertEnvoyCompressionStatusHeader(headers, getContentEncoding(),
                                      Http::Headers::get().EnvoyCompressionStatusValues.Compressed,
                                      content_length);
@@ -452,6 +492,9 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeadersWithStatusHeader(
 }
 
 Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (response_cache_state_ != nullptr) {
+    return encodeDataWithResponseCache(data, end_stream);
+  }
   if (response_compressor_ != nullptr) {
     compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(), data,
                            end_stream);
@@ -460,18 +503,130 @@ Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool
 }
 
 Http::FilterTrailersStatus CompressorFilter::encodeTrailers(Http::ResponseTrailerMap&) {
-  if (response_compressor_ != nullptr) {
+  if (response_cache_state_ != nullptr || response_compressor_ != nullptr) {
     Buffer::OwnedImpl empty_buffer;
     // The presence of trailers means the stream is ended, but encodeData()
     // is never called with end_stream=true, thus let the compression library know
     // that the stream is ended.
-    compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(),
-                           empty_buffer, true);
+    if (response_cache_state_ != nullptr) {
+      encodeDataWithResponseCache(empty_buffer, true);
+    } else {
+      compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(),
+                             empty_buffer, true);
+    }
     encoder_callbacks_->addEncodedData(empty_buffer, true);
   }
   return Http::FilterTrailersStatus::Continue;
 }
 
+void CompressorFilter::initResponseCache(const Http::ResponseHeaderMap& headers) {
+  CompressedResponseCache* cache = config_->responseDirectionConfig().compressedResponseCache();
+  // The cache holds bodies compressed by the filter's compressor library only.
+  if (cache == nullptr || (per_route_config_ && per_route_config_->compressorFactory())) {
+    return;
+  }
+  uint64_t content_length = 0;
+  const bool has_content_length =
+      absl::SimpleAtoi(headers.getContentLengthValue(), &content_length);
+  if (has_content_length && content_length > cache->maxBodyBytes()) {
+    return;
+  }
+  // Other responses are likely to be errors or to vary from one request to the next.
+  if (Http::Utility::getResponseStatusOrNullopt(headers) != 200) {
+    return;
+  }
+  const Http::HeaderEntry* etag = headers.getInline(etag_handle.handle());
+  const absl::string_view etag_value = etag != nullptr ? etag->value().getStringView() : "";
+  // A strong ETag identifies the exact bytes of the full response, so a 200 response's ETag and
+  // URL identify its body. Weak ETags and other responses need a digest of the body.
+  const bool strong_etag = etag_value.length() > 2 && !absl::StartsWithIgnoreCase(etag_value, "W/");
+  if (strong_etag && request_host_and_path_ != nullptr) {
+    std::string key = absl::StrCat("etag:", etag_value, ":", headers.getContentLengthValue(), ":",
+                                   *request_host_and_path_);
+    CompressedResponseCache::BodySharedPtr hit = cache->lookup(key);
+    // A body is only copied into the cache the second time it is compressed.
+    if (hit == nullptr && !cache->recordSighting(key)) {
+      return;
+    }
+    response_cache_state_ = std::make_unique<ResponseCacheState>();
+    response_cache_state_->by_etag_ = true;
+    response_cache_state_->key_ = std::move(key);
+    response_cache_state_->hit_ = std::move(hit);
+  } else if (has_content_length && cache->cacheByBodyDigest()) {
+    response_cache_state_ = std::make_unique<ResponseCacheState>();
+  }
+}
+
+Http::FilterDataStatus CompressorFilter::encodeDataWithResponseCache(Buffer::Instance& data,
+                                                                      bool end_stream) {
+  const CompressorStats& stats = config_->responseDirectionConfig().stats();
+  CompressedResponseCache& cache = *config_->responseDirectionConfig().compressedResponseCache();
+  ResponseCacheState& state = *response_cache_state_;
+
+  if (state.hit_ != nullptr) {
+    // The upstream's body is discarded in favor of the cached compressed one.
+    stats.total_uncompressed_bytes_.add(data.length());
+    data.drain(data.length());
+    if (end_stream) {
+      data.add(*state.hit_);
+      stats.total_compressed_bytes_.add(data.length());
+    }
+    return Http::FilterDataStatus::Continue;
+  }
+
+  if (state.by_etag_) {
+    compressResponseData(data, end_stream);
+    if (state.body_.length() + data.length() > cache.maxBodyBytes()) {
+      // Larger than announced, or without a Content-Length; the rest is compressed uncached.
+      response_cache_state_.reset();
+      return Http::FilterDataStatus::Continue;
+    }
+    state.body_.add(data);
+    if (end_stream) {
+      cache.insert(state.key_, state.body_.toString());
+    }
+    return Http::FilterDataStatus::Continue;
+  }
+
+  state.body_.move(data);
+  if (state.body_.length() > cache.maxBodyBytes()) {
+    // More than the Content-Length announced; the body is compressed uncached after all.
+    data.move(state.body_);
+    response_cache_state_.reset();
+    compressResponseData(data, end_stream);
+    return Http::FilterDataStatus::Continue;
+  }
+  if (!end_stream) {
+    return Http::FilterDataStatus::StopIterationNoBuffer;
+  }
+  const std::vector<uint8_t> digest =
+      Common::Crypto::UtilitySingleton::get().getSha256Digest(state.body_);
+  state.key_ = absl::StrCat("sha256:", Hex::encode(digest));
+  CompressedResponseCache::BodySharedPtr cached = cache.lookup(state.key_);
+  if (cached != nullptr) {
+    stats.total_uncompressed_bytes_.add(state.body_.length());
+    state.body_.drain(state.body_.length());
+    data.add(*cached);
+    stats.total_compressed_bytes_.add(data.length());
+  } else {
+    data.move(state.body_);
+    compressResponseData(data, true);
+    // A body is only copied into the cache the second time it is compressed.
+    if (cache.recordSighting(state.key_)) {
+      cache.insert(state.key_, data.toString());
+    }
+  }
+  return Http::FilterDataStatus::Continue;
+}
+
+void CompressorFilter::compressResponseData(Buffer::Instance& data, bool end_stream) {
+  if (response_compressor_ == nullptr) {
+    response_compressor_ = config_->makeCompressor();
+  }
+  compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(), data,
+                         end_stream);
+}
+
 bool CompressorFilter::hasCacheControlNoTransform(Http::ResponseHeaderMap& headers) const {
   const Http::HeaderEntry* cache_control = headers.getInline(cache_control_handle.handle());
   if (cache_control) {
@@ -1,14 +1,17 @@
 #pragma once
 
+#include "envoy/compression/compressor/config.h"
 #include "envoy/compression/compressor/factory.h"
 #include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
 #include "envoy/server/factory_context.h"
 #include "envoy/stats/stats_macros.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/logger.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/runtime/runtime_protos.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
+#include "source/extensions/filters/http/compressor/compressed_response_cache.h"
 
 #include "absl/types/optional.h"
 
@@ -61,6 +64,16 @@ struct ResponseCompressorStats {
   RESPONSE_COMPRESSOR_STATS(GENERATE_COUNTER_STRUCT)
 };
 
+/**
+ * Creates the compressor factory of a compressor library. The library's own statistics are rooted
+ * at <stats_prefix>compressor.<library_name>., next to the filter's, so that each configuration
+ * of the filter has its own.
+ */
+Compression::Compressor::CompressorFactoryPtr createCompressorFactory(
+    Compression::Compressor::NamedCompressorLibraryConfigFactory& config_factory,
+    const Protobuf::Message& config, const std::string& library_name,
+    const std::string& stats_prefix, Server::Configuration::GenericFactoryContext& context);
+
 /**
  * Configuration for the compressor filter.
  */
@@ -126,6 +139,10 @@ public:
     bool statusHeaderEnabled() const { return status_header_enabled_; }
     bool areAllResponseCodesCompressible() const;
     bool isResponseCodeCompressible(uint32_t response_code) const;
+    // Returns nullptr if compressed responses are not cached.
+    CompressedResponseCache* compressedResponseCache() const {
+      return compressed_response_cache_.get();
+    }
 
   private:
     static ResponseCompressorStats generateResponseStats(const std::string& prefix,
@@ -143,6 +160,7 @@ public:
     const bool status_header_enabled_;
     const absl::flat_hash_set<uint32_t> uncompressible_response_codes_;
     const ResponseCompressorStats response_stats_;
+    const CompressedResponseCachePtr compressed_response_cache_;
   };
 
   CompressorFilterConfig() = delete;
@@ -231,6 +249,10 @@ private:
   // the route is refreshed mid-stream.
   void initPerRouteConfig();
 
+  void initResponseCache(const Http::ResponseHeaderMap& headers);
+  Http::FilterDataStatus encodeDataWithResponseCache(Buffer::Instance& data, bool end_stream);
+  void compressResponseData(Buffer::Instance& data, bool end_stream);
+
   Http::FilterHeadersStatus
   encodeHeadersWithStatusHeader(Http::ResponseHeaderMap& headers, bool end_stream,
                                 const CompressorFilterConfig::ResponseDirectionConfig& config,
@@ -284,10 +306,24 @@ private:
   // Returns the appropriate content encoding for the current route.
   std::string getContentEncoding() const;
 
+  // The progress of a response which is served from, or added to, the compressed response cache.
+  struct ResponseCacheState {
+    std::string key_;
+    // Whether key_ is based on the response's ETag, rather than computed from its body.
+    bool by_etag_{};
+    // The cached compressed body, when the key was found in the cache.
+    CompressedResponseCache::BodySharedPtr hit_;
+    // Keyed by ETag, the compressed body so far; otherwise, the uncompressed body so far.
+    Buffer::OwnedImpl body_;
+  };
+
   Envoy::Compression::Compressor::CompressorPtr response_compressor_;
   Envoy::Compression::Compressor::CompressorPtr request_compressor_;
   const CompressorFilterConfigSharedPtr config_;
   std::unique_ptr<std::string> accept_encoding_;
+  // The request's host and path, captured only if compressed responses are cached.
+  std::unique_ptr<std::string> request_host_and_path_;
+  std::unique_ptr<ResponseCacheState> response_cache_state_;
   // Cached per-route configuration pointer, initialized once per stream.
   const CompressorPerRouteFilterConfig* per_route_config_{};
 };
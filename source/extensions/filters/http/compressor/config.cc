@@ -31,7 +31,8 @@ absl::StatusOr<Http::FilterFactoryCb> CompressorFilterFactory::createFilterFacto
       proto_config.compressor_library().typed_config(), context.messageValidationVisitor(),
       *config_factory);
   Compression::Compressor::CompressorFactoryPtr compressor_factory =
-      config_factory->createCompressorFactoryFromProto(*message, context);
+      createCompressorFactory(*config_factory, *message, proto_config.compressor_library().name(),
+                              stats_prefix, context);
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
       proto_config, stats_prefix, context.scope(), context.serverFactoryContext().runtime(),
       std::move(compressor_factory));
@@ -114,7 +114,8 @@ FilterConfig::FilterConfig(
 
   rate_limiter_ = std::make_unique<Filters::Common::LocalRateLimit::LocalRateLimiterImpl>(
       fill_interval_, max_tokens_, tokens_per_fill_, dispatcher_, descriptors_,
-      always_consume_default_token_bucket_, std::move(share_provider), max_dynamic_descriptors_);
+      always_consume_default_token_bucket_, std::move(share_provider), max_dynamic_descriptors_,
+      config.token_lease_size());
 }
 
 Filters::Common::LocalRateLimit::LocalRateLimiter::Result
@@ -150,6 +150,15 @@ UdpProxyFilterConfigImpl::UdpProxyFilterConfigImpl(
     tunneling_config_ = std::make_unique<TunnelingConfigImpl>(config.tunneling_config(), context);
   }
 
+  if (config.has_upstream_packet_writer_config()) {
+    auto& factory_factory = Config::Utility::getAndCheckFactory<
+        Network::UdpPacketWriterFactoryFactory>(config.upstream_packet_writer_config());
+    // This may be null if the writer is not supported in this build, in which case datagrams are
+    // written directly to the socket.
+    upstream_packet_writer_factory_ =
+        factory_factory.createUdpPacketWriterFactory(config.upstream_packet_writer_config());
+  }
+
   if (config.has_access_log_options()) {
     flush_access_log_on_tunnel_connected_ =
         config.access_log_options().flush_access_log_on_tunnel_connected();
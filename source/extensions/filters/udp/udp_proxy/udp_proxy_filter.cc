@@ -3,6 +3,7 @@
 #include "envoy/network/listener.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/io_socket_error_impl.h"
 #include "source/common/network/socket_option_factory.h"
 
 namespace Envoy {
@@ -343,6 +344,13 @@ UdpProxyFilter::UdpActiveSession::UdpActiveSession(
     : ActiveSession(filter, std::move(addresses), std::move(host)),
       use_original_src_ip_(filter_.config_->usingOriginalSrcIp()) {}
 
+UdpProxyFilter::UdpActiveSession::~UdpActiveSession() {
+  // Send anything still buffered by a batching writer before the socket is closed.
+  if (upstream_writer_ != nullptr) {
+    upstream_writer_->flush();
+  }
+}
+
 UdpProxyFilter::ActiveSession::~ActiveSession() {
   ENVOY_BUG(on_session_complete_called_, "onSessionComplete() not called");
 }
@@ -462,6 +470,13 @@ void UdpProxyFilter::UdpActiveSession::onReadReady() {
   filter_.read_callbacks_->udpListener().flush();
 }
 
+void UdpProxyFilter::UdpActiveSession::onWriteReady() {
+  ASSERT(upstream_writer_ != nullptr);
+  udp_socket_->ioHandle().enableFileEvents(Event::FileReadyType::Read);
+  upstream_writer_->setWritable();
+  flushUpstreamWriter();
+}
+
 bool UdpProxyFilter::ActiveSession::onNewSession() {
   if (filter_.config_->accessLogFlushInterval().has_value() &&
       !filter_.config_->sessionAccessLogs().empty()) {
@@ -560,8 +575,11 @@ void UdpProxyFilter::UdpActiveSession::writeUpstream(Network::UdpRecvData& data)
             host_->address()->asStringView());
 
   const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
-  Api::IoCallUint64Result rc = Network::Utility::writeToSocket(
-      udp_socket_->ioHandle(), *data.buffer_, local_ip, *host_->address());
+  Api::IoCallUint64Result rc =
+      upstream_writer_ != nullptr
+          ? writeToUpstreamWriter(*data.buffer_, local_ip)
+          : Network::Utility::writeToSocket(udp_socket_->ioHandle(), *data.buffer_, local_ip,
+                                            *host_->address());
 
   if (!rc.ok()) {
     cluster_->cluster_stats_.sess_tx_errors_.inc();
@@ -571,6 +589,45 @@ void UdpProxyFilter::UdpActiveSession::writeUpstream(Network::UdpRecvData& data)
   }
 }
 
+Api::IoCallUint64Result
+UdpProxyFilter::UdpActiveSession::writeToUpstreamWriter(Buffer::Instance& buffer,
+                                                        const Network::Address::Ip* local_ip) {
+  if (upstream_writer_->isWriteBlocked()) {
+    return {/*rc=*/0, Network::IoSocketError::getIoSocketEagainError()};
+  }
+  if (buffer.length() == 0) {
+    // Batching writers cannot represent an empty datagram, so send any buffered datagrams first
+    // to preserve ordering and then write this one directly.
+    flushUpstreamWriter();
+    return Network::Utility::writeToSocket(udp_socket_->ioHandle(), buffer, local_ip,
+                                           *host_->address());
+  }
+
+  // Writers expect each datagram in a single slice, which is normally already the case for
+  // datagrams read from the downstream socket.
+  buffer.linearize(buffer.length());
+  const Api::IoCallUint64Result rc =
+      upstream_writer_->writePacket(buffer, local_ip, *host_->address());
+  if (upstream_writer_->isWriteBlocked()) {
+    udp_socket_->ioHandle().enableFileEvents(Event::FileReadyType::Read |
+                                             Event::FileReadyType::Write);
+  } else if (upstream_flush_cb_ != nullptr && !upstream_flush_cb_->enabled()) {
+    upstream_flush_cb_->scheduleCallbackCurrentIteration();
+  }
+  return rc;
+}
+
+void UdpProxyFilter::UdpActiveSession::flushUpstreamWriter() {
+  const Api::IoCallUint64Result rc = upstream_writer_->flush();
+  if (upstream_writer_->isWriteBlocked()) {
+    // The remaining datagrams are sent once the socket becomes writable.
+    udp_socket_->ioHandle().enableFileEvents(Event::FileReadyType::Read |
+                                             Event::FileReadyType::Write);
+  } else if (!rc.ok()) {
+    cluster_->cluster_stats_.sess_tx_errors_.inc();
+  }
+}
+
 bool UdpProxyFilter::ActiveSession::onContinueFilterChain(ActiveReadFilter* filter) {
   ASSERT(filter != nullptr);
 
@@ -641,12 +698,30 @@ void UdpProxyFilter::UdpActiveSession::createUdpSocket(const Upstream::HostConst
   udp_socket_ = filter_.createUdpSocket(host);
   udp_socket_->ioHandle().initializeFileEvent(
       filter_.read_callbacks_->udpListener().dispatcher(),
-      [this](uint32_t) {
-        onReadReady();
+      [this](uint32_t events) {
+        // Write events are only enabled while an upstream packet writer is blocked.
+        if (events & Event::FileReadyType::Write) {
+          onWriteReady();
+        }
+        if (events & Event::FileReadyType::Read) {
+          onReadReady();
+        }
         return absl::OkStatus();
       },
       Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
 
+  Network::UdpPacketWriterFactory* writer_factory = filter_.config_->upstreamPacketWriterFactory();
+  if (writer_factory != nullptr) {
+    upstream_writer_ = writer_factory->createUdpPacketWriter(
+        udp_socket_->ioHandle(), cluster_->cluster_info_->statsScope(),
+        filter_.read_callbacks_->udpListener().dispatcher(), []() {});
+    if (upstream_writer_->isBatchMode()) {
+      upstream_flush_cb_ =
+          filter_.read_callbacks_->udpListener().dispatcher().createSchedulableCallback(
+              [this]() { flushUpstreamWriter(); });
+    }
+  }
+
   ENVOY_LOG(debug, "creating new session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host->address()->asStringView());
@@ -9,6 +9,7 @@
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
 #include "envoy/http/header_evaluator.h"
 #include "envoy/network/filter.h"
+#include "envoy/network/udp_packet_writer_handler.h"
 #include "envoy/stream_info/stream_info.h"
 #include "envoy/stream_info/uint32_accessor.h"
 #include "envoy/upstream/cluster_manager.h"
@@ -140,6 +141,9 @@ public:
   virtual bool flushAccessLogOnTunnelConnected() const PURE;
   virtual const absl::optional<std::chrono::milliseconds>& accessLogFlushInterval() const PURE;
   virtual Random::RandomGenerator& randomGenerator() const PURE;
+  // Returns the factory for upstream socket packet writers, or nullptr to write each datagram
+  // directly to the socket.
+  virtual Network::UdpPacketWriterFactory* upstreamPacketWriterFactory() const PURE;
 };
 
 using UdpProxyFilterConfigSharedPtr = std::shared_ptr<const UdpProxyFilterConfig>;
@@ -689,7 +693,7 @@ protected:
   public:
     UdpActiveSession(UdpProxyFilter& filter, Network::UdpRecvData::LocalPeerAddresses&& addresses,
                      const Upstream::HostConstSharedPtr& host);
-    ~UdpActiveSession() override = default;
+    ~UdpActiveSession() override;
 
     // ActiveSession
     bool shouldCreateUpstream() override;
@@ -725,12 +729,22 @@ protected:
 
   private:
     void onReadReady();
+    void onWriteReady();
     void createUdpSocket(const Upstream::HostConstSharedPtr& host);
+    Api::IoCallUint64Result writeToUpstreamWriter(Buffer::Instance& buffer,
+                                                  const Network::Address::Ip* local_ip);
+    void flushUpstreamWriter();
 
     // The socket is used for writing packets to the selected upstream host as well as receiving
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
     // write to the upstream host.
     Network::SocketPtr udp_socket_;
+    // Writes to udp_socket_ when an upstream packet writer is configured. Declared after
+    // udp_socket_ as it refers to the socket's IO handle.
+    Network::UdpPacketWriterPtr upstream_writer_;
+    // For batching writers, flushes the datagrams buffered by upstream_writer_ at the end of the
+    // event loop iteration in which they were written.
+    Event::SchedulableCallbackPtr upstream_flush_cb_;
     // The socket has been connected to avoid port exhaustion.
     bool connected_{};
     const bool use_original_src_ip_;
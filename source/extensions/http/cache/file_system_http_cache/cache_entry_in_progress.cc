@@ -0,0 +1,285 @@
+#include "source/extensions/http/cache/file_system_http_cache/cache_entry_in_progress.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "source/common/http/header_map_impl.h"
+
+#include "absl/strings/numbers.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+CacheEntryInProgress::Follower::~Follower() {
+  *destroyed_ = true;
+  PostedCallbacks posted;
+  {
+    absl::MutexLock lock(entry_->mu_);
+    entry_->followers_.erase(this);
+    entry_->releaseReadBody(posted);
+  }
+  post(posted);
+}
+
+void CacheEntryInProgress::Follower::getHeaders(HeadersCallback&& cb) {
+  ASSERT(dispatcher_.isThreadSafe());
+  PostedCallbacks posted;
+  {
+    absl::MutexLock lock(entry_->mu_);
+    ASSERT(!headers_callback_);
+    headers_callback_ = std::move(cb);
+    entry_->serveHeaders(*this, posted);
+  }
+  post(posted);
+}
+
+void CacheEntryInProgress::Follower::getBody(const AdjustedByteRange& range, BodyCallback&& cb) {
+  ASSERT(dispatcher_.isThreadSafe());
+  PostedCallbacks posted;
+  {
+    absl::MutexLock lock(entry_->mu_);
+    ASSERT(!body_callback_);
+    body_callback_ = std::move(cb);
+    body_range_ = range;
+    entry_->serveBody(*this, posted);
+    entry_->releaseReadBody(posted);
+  }
+  post(posted);
+}
+
+void CacheEntryInProgress::Follower::getTrailers(LookupTrailersCallback&& cb) {
+  ASSERT(dispatcher_.isThreadSafe());
+  PostedCallbacks posted;
+  {
+    absl::MutexLock lock(entry_->mu_);
+    ASSERT(!trailers_callback_);
+    trailers_callback_ = std::move(cb);
+    entry_->serveTrailers(*this, posted);
+  }
+  post(posted);
+}
+
+CacheEntryInProgress::FollowerPtr CacheEntryInProgress::join(Event::Dispatcher& dispatcher) {
+  absl::MutexLock lock(mu_);
+  if (!accepting_followers_) {
+    return nullptr;
+  }
+  // Follower's constructor is private, so make_unique can't be used.
+  FollowerPtr follower{new Follower(shared_from_this(), dispatcher)};
+  followers_.insert(follower.get());
+  return follower;
+}
+
+void CacheEntryInProgress::publishHeaders(const Key& key, const Http::ResponseHeaderMap& headers,
+                                          const ResponseMetadata& metadata, bool end_stream) {
+  PostedCallbacks posted;
+  {
+    absl::MutexLock lock(mu_);
+    ASSERT(!headers_.has_value());
+    headers_ = Headers{key, Http::createHeaderMap<Http::ResponseHeaderMapImpl>(headers), metadata,
+                       end_stream};
+    uint64_t content_length;
+    if (absl::SimpleAtoi(headers.getContentLengthValue(), &content_length) &&
+        content_length > max_buffered_body_bytes_) {
+      too_large_ = true;
+      accepting_followers_ = false;
+    }
+    complete_ = end_stream;
+    serveAll(posted);
+  }
+  post(posted);
+}
+
+void CacheEntryInProgress::publishBody(const Buffer::Instance& chunk, bool end_stream) {
+  PostedCallbacks posted;
+  {
+    absl::MutexLock lock(mu_);
+    ASSERT(headers_.has_value() && !complete_);
+    if (!accepting_followers_ && followers_.empty()) {
+      // Nobody can read this chunk, so there's no need to buffer it.
+      body_offset_ += chunk.length();
+    } else {
+      body_.add(chunk);
+    }
+    complete_ = end_stream;
+    serveAll(posted);
+  }
+  post(posted);
+}
+
+void CacheEntryInProgress::publishTrailers(const Http::ResponseTrailerMap& trailers) {
+  PostedCallbacks posted;
+  {
+    absl::MutexLock lock(mu_);
+    ASSERT(headers_.has_value() && !complete_);
+    trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(trailers);
+    complete_ = true;
+    serveAll(posted);
+  }
+  post(posted);
+}
+
+void CacheEntryInProgress::abandon() {
+  PostedCallbacks posted;
+  {
+    absl::MutexLock lock(mu_);
+    if (complete_ || failed_) {
+      return;
+    }
+    failed_ = true;
+    accepting_followers_ = false;
+    serveAll(posted);
+  }
+  post(posted);
+}
+
+void CacheEntryInProgress::serveHeaders(Follower& follower, PostedCallbacks& posted) {
+  if (!follower.headers_callback_) {
+    return;
+  }
+  absl::StatusOr<Headers> result;
+  if (failed_) {
+    result = absl::UnavailableError("cache insert in progress was abandoned");
+  } else if (too_large_) {
+    result = absl::ResourceExhaustedError("response is too large to share");
+  } else if (headers_.has_value()) {
+    result = Headers{headers_->key_,
+                     Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*headers_->headers_),
+                     headers_->metadata_, headers_->end_stream_};
+  } else {
+    return;
+  }
+  posted.emplace_back(&follower.dispatcher_,
+                      [destroyed = follower.destroyed_, cb = std::move(follower.headers_callback_),
+                       result = std::move(result)]() mutable {
+                        if (!*destroyed) {
+                          cb(std::move(result));
+                        }
+                      });
+  follower.headers_callback_ = nullptr;
+}
+
+void CacheEntryInProgress::serveBody(Follower& follower, PostedCallbacks& posted) {
+  if (!follower.body_callback_) {
+    return;
+  }
+  const AdjustedByteRange& range = follower.body_range_.value();
+  const uint64_t published = publishedBodySize();
+  absl::StatusOr<Buffer::InstancePtr> result;
+  bool end_stream = false;
+  if (follower.lagged_) {
+    result = absl::UnavailableError("follower fell too far behind the cache insert in progress");
+  } else if (range.begin() < published) {
+    ASSERT(range.begin() >= body_offset_, "followers never read body that has been released");
+    const uint64_t length = std::min(range.end(), published) - range.begin();
+    auto chunk = std::make_unique<Buffer::OwnedImpl>();
+    Buffer::ReservationSingleSlice reservation = chunk->reserveSingleSlice(length);
+    body_.copyOut(range.begin() - body_offset_, length, reservation.slice().mem_);
+    reservation.commit(length);
+    follower.read_offset_ = range.begin() + length;
+    end_stream = complete_ && trailers_ == nullptr && follower.read_offset_ == published;
+    result = std::move(chunk);
+  } else if (failed_) {
+    result = absl::UnavailableError("cache insert in progress was abandoned");
+  } else if (complete_) {
+    if (trailers_ != nullptr && range.end() == std::numeric_limits<uint64_t>::max()) {
+      // The body is over; the filter asks for trailers next.
+      result = Buffer::InstancePtr{};
+    } else {
+      result = std::make_unique<Buffer::OwnedImpl>();
+      end_stream = true;
+    }
+  } else {
+    return;
+  }
+  posted.emplace_back(&follower.dispatcher_,
+                      [destroyed = follower.destroyed_, cb = std::move(follower.body_callback_),
+                       result = std::move(result), end_stream]() mutable {
+                        if (!*destroyed) {
+                          cb(std::move(result), end_stream);
+                        }
+                      });
+  follower.body_callback_ = nullptr;
+}
+
+void CacheEntryInProgress::serveTrailers(Follower& follower, PostedCallbacks& posted) {
+  if (!follower.trailers_callback_) {
+    return;
+  }
+  Http::ResponseTrailerMapPtr trailers;
+  if (trailers_ != nullptr) {
+    trailers = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*trailers_);
+  } else if (complete_ || failed_ || follower.lagged_) {
+    // As with a failed read from a cache file, there is no failure response for trailers.
+    trailers = Http::ResponseTrailerMapImpl::create();
+  } else {
+    return;
+  }
+  posted.emplace_back(&follower.dispatcher_,
+                      [destroyed = follower.destroyed_, cb = std::move(follower.trailers_callback_),
+                       trailers = std::move(trailers)]() mutable {
+                        if (!*destroyed) {
+                          cb(std::move(trailers));
+                        }
+                      });
+  follower.trailers_callback_ = nullptr;
+}
+
+void CacheEntryInProgress::serveAll(PostedCallbacks& posted) {
+  for (Follower* follower : followers_) {
+    serveHeaders(*follower, posted);
+    serveBody(*follower, posted);
+    serveTrailers(*follower, posted);
+  }
+  releaseReadBody(posted);
+}
+
+void CacheEntryInProgress::releaseReadBody(PostedCallbacks& posted) {
+  const uint64_t published = publishedBodySize();
+  if (accepting_followers_ && published > max_buffered_body_bytes_) {
+    accepting_followers_ = false;
+  }
+  if (accepting_followers_) {
+    // A new follower reads from the start of the body.
+    return;
+  }
+  if (published - body_offset_ > max_buffered_body_bytes_) {
+    // Content-length doesn't bound a chunked response, so followers which lag this far behind
+    // are dropped rather than letting the buffer grow with the leader.
+    const uint64_t keep_from = published - max_buffered_body_bytes_;
+    for (auto it = followers_.begin(); it != followers_.end();) {
+      Follower& follower = **it;
+      if (follower.read_offset_ >= keep_from) {
+        ++it;
+        continue;
+      }
+      follower.lagged_ = true;
+      serveBody(follower, posted);
+      serveTrailers(follower, posted);
+      followers_.erase(it++);
+    }
+  }
+  uint64_t read_by_all = published;
+  for (const Follower* follower : followers_) {
+    read_by_all = std::min(read_by_all, follower->read_offset_);
+  }
+  if (read_by_all > body_offset_) {
+    body_.drain(read_by_all - body_offset_);
+    body_offset_ = read_by_all;
+  }
+}
+
+void CacheEntryInProgress::post(PostedCallbacks& posted) {
+  for (auto& [dispatcher, cb] : posted) {
+    dispatcher->post(std::move(cb));
+  }
+}
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
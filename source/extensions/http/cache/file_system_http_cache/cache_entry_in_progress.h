@@ -0,0 +1,161 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/header_map.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+/**
+ * The response for a cache entry which is being inserted, shared between the stream which is
+ * inserting it (the leader) and concurrent lookups for the same key (followers), so that the
+ * followers stream the response as the leader receives it rather than all going upstream.
+ *
+ * The body is buffered in memory. Once the published body exceeds max_buffered_body_bytes, no
+ * new followers may join, and the part of the body which every follower has already read is
+ * released. Followers which fall more than max_buffered_body_bytes behind the leader are failed,
+ * as if the leader had failed, so that a stalled follower can't hold the rest of the body in
+ * memory.
+ *
+ * All functions are thread-safe. Follower callbacks are posted to the follower's dispatcher, and
+ * are not called once the Follower has been destroyed.
+ */
+class CacheEntryInProgress : public std::enable_shared_from_this<CacheEntryInProgress> {
+public:
+  struct Headers {
+    // The key the response is inserted under, which includes any vary identifier.
+    Key key_;
+    Http::ResponseHeaderMapPtr headers_;
+    ResponseMetadata metadata_;
+    bool end_stream_;
+  };
+
+  // Called with Unavailable if the leader failed before publishing headers, or with
+  // ResourceExhausted if the response is too large to be buffered for followers.
+  using HeadersCallback = absl::AnyInvocable<void(absl::StatusOr<Headers>&&)>;
+  // Called with a nullptr body if the body ended before the requested range and trailers
+  // follow, or with an error if the leader failed before the requested range was published.
+  using BodyCallback = absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>&&, bool)>;
+
+  /**
+   * A lookup which streams the response from a CacheEntryInProgress. Each function must be
+   * called on the follower's thread, and its callback is posted to the follower's dispatcher.
+   * At most one request may be outstanding at a time, as with LookupContext.
+   */
+  class Follower {
+  public:
+    ~Follower();
+    void getHeaders(HeadersCallback&& cb);
+    void getBody(const AdjustedByteRange& range, BodyCallback&& cb);
+    void getTrailers(LookupTrailersCallback&& cb);
+
+  private:
+    friend class CacheEntryInProgress;
+    Follower(std::shared_ptr<CacheEntryInProgress> entry, Event::Dispatcher& dispatcher)
+        : entry_(std::move(entry)), dispatcher_(dispatcher) {}
+
+    const std::shared_ptr<CacheEntryInProgress> entry_;
+    Event::Dispatcher& dispatcher_;
+    // Shared with callbacks which have been posted but not yet run, so that they can tell
+    // whether the follower was destroyed in the meantime.
+    const std::shared_ptr<bool> destroyed_ = std::make_shared<bool>(false);
+    // The rest is guarded by entry_->mu_.
+    // The offset up to which this follower has read the body.
+    uint64_t read_offset_ = 0;
+    // Set once the follower fell too far behind, and the body it had yet to read was released.
+    bool lagged_ = false;
+    HeadersCallback headers_callback_;
+    BodyCallback body_callback_;
+    absl::optional<AdjustedByteRange> body_range_;
+    LookupTrailersCallback trailers_callback_;
+  };
+  using FollowerPtr = std::unique_ptr<Follower>;
+
+  /**
+   * @param key the key of the lookup which missed and is leading the insert.
+   * @param max_buffered_body_bytes the body size beyond which no new followers may join, and the
+   *     most body which is buffered for followers which have yet to read it.
+   */
+  CacheEntryInProgress(const Key& key, uint64_t max_buffered_body_bytes)
+      : key_(key), max_buffered_body_bytes_(max_buffered_body_bytes) {}
+
+  const Key& key() const { return key_; }
+
+  /**
+   * Adds a follower to the entry.
+   * @param dispatcher the dispatcher of the follower's thread.
+   * @return the follower, or nullptr if the entry no longer accepts followers.
+   */
+  FollowerPtr join(Event::Dispatcher& dispatcher) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // The functions below are called by the leader as the response arrives.
+  void publishHeaders(const Key& key, const Http::ResponseHeaderMap& headers,
+                      const ResponseMetadata& metadata, bool end_stream) ABSL_LOCKS_EXCLUDED(mu_);
+  void publishBody(const Buffer::Instance& chunk, bool end_stream) ABSL_LOCKS_EXCLUDED(mu_);
+  void publishTrailers(const Http::ResponseTrailerMap& trailers) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Marks the insert as failed, unless the whole response has already been published.
+   * Followers which have not yet received headers are told to fall back, and followers which
+   * are part way through the body are failed.
+   */
+  void abandon() ABSL_LOCKS_EXCLUDED(mu_);
+
+private:
+  using PostedCallbacks = std::vector<std::pair<Event::Dispatcher*, Event::PostCb>>;
+
+  void serveHeaders(Follower& follower, PostedCallbacks& posted)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void serveBody(Follower& follower, PostedCallbacks& posted) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void serveTrailers(Follower& follower, PostedCallbacks& posted)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void serveAll(PostedCallbacks& posted) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Stops accepting followers if the body has outgrown the buffer, fails the followers which have
+  // fallen too far behind, and then releases the part of the body every remaining follower has
+  // read.
+  void releaseReadBody(PostedCallbacks& posted) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  uint64_t publishedBodySize() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return body_offset_ + body_.length();
+  }
+  // Posts the callbacks collected while holding mu_, which must be released first since a
+  // dispatcher may run the callback immediately.
+  static void post(PostedCallbacks& posted);
+
+  const Key key_;
+  const uint64_t max_buffered_body_bytes_;
+
+  absl::Mutex mu_;
+  absl::flat_hash_set<Follower*> followers_ ABSL_GUARDED_BY(mu_);
+  bool accepting_followers_ ABSL_GUARDED_BY(mu_) = true;
+  absl::optional<Headers> headers_ ABSL_GUARDED_BY(mu_);
+  bool too_large_ ABSL_GUARDED_BY(mu_) = false;
+  // The body from body_offset_ onwards; anything before it has been read by every follower.
+  Buffer::OwnedImpl body_ ABSL_GUARDED_BY(mu_);
+  uint64_t body_offset_ ABSL_GUARDED_BY(mu_) = 0;
+  Http::ResponseTrailerMapPtr trailers_ ABSL_GUARDED_BY(mu_);
+  // True once the whole response has been published.
+  bool complete_ ABSL_GUARDED_BY(mu_) = false;
+  bool failed_ ABSL_GUARDED_BY(mu_) = false;
+};
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
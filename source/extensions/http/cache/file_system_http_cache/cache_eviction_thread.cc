@@ -8,6 +8,9 @@
 #include "source/common/filesystem/directory.h"
 #include "source/extensions/http/cache/file_system_http_cache/file_system_http_cache.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/strip.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -154,6 +157,11 @@ void CacheShared::evict() {
       // and the eviction thread will be churning, trying and failing to remove a file, which would
       // be worth logging a warning, versus if the file is already gone then there's no problem.
       trackFileRemoved(it->size_);
+      size_t key_hash;
+      // The name is as given by FileSystemHttpCache::generateFilename.
+      if (memory_tier_ && absl::SimpleAtoi(absl::StripPrefix(it->name_, "cache-"), &key_hash)) {
+        memory_tier_->removeHash(key_hash);
+      }
     }
     ++it;
   }
@@ -4,6 +4,7 @@
 
 #include "source/common/filesystem/directory.h"
 #include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_eviction_thread.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_fixed_block.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_header_proto_util.h"
@@ -22,8 +23,13 @@ namespace FileSystemHttpCache {
 // not worthwhile to carefully tune this.
 const size_t FileSystemHttpCache::max_update_headers_copy_chunk_size_ = 128 * 1024;
 
+namespace {
+constexpr uint64_t DefaultCoalescingMaxBufferedBodyBytes = 1024 * 1024;
+} // namespace
+
 const CacheStats& FileSystemHttpCache::stats() const { return shared_->stats_; }
 const ConfigProto& FileSystemHttpCache::config() const { return shared_->config_; }
+MemoryTier* FileSystemHttpCache::memoryTier() const { return shared_->memory_tier_.get(); }
 
 void FileSystemHttpCache::writeVaryNodeToDisk(Event::Dispatcher& dispatcher, const Key& key,
                                               const Http::ResponseHeaderMap& response_headers,
@@ -89,7 +95,10 @@ FileSystemHttpCache::FileSystemHttpCache(
 
 CacheShared::CacheShared(ConfigProto config, Stats::Scope& stats_scope)
     : config_(config), stat_names_(stats_scope.symbolTable()),
-      stats_(generateStats(stat_names_, stats_scope, cachePath())) {}
+      stats_(generateStats(stat_names_, stats_scope, cachePath())),
+      memory_tier_(config_.has_memory_tier()
+                       ? std::make_unique<MemoryTier>(config_.memory_tier(), stats_)
+                       : nullptr) {}
 
 FileSystemHttpCache::~FileSystemHttpCache() { cache_eviction_thread_.removeCache(shared_); }
 
@@ -117,7 +126,7 @@ FileSystemHttpCache::makeVaryKey(const Key& base, const VaryAllowList& vary_allo
 
 LookupContextPtr FileSystemHttpCache::makeLookupContext(LookupRequest&& lookup,
                                                         Http::StreamFilterCallbacks& callbacks) {
-  return std::make_unique<FileLookupContext>(callbacks.dispatcher(), *this, std::move(lookup));
+  return std::make_unique<FileLookupContext>(callbacks, *this, std::move(lookup));
 }
 
 // Helper class to reduce the lambda depth of updateHeaders.
@@ -313,6 +322,11 @@ void FileSystemHttpCache::updateHeaders(const LookupContext& base_lookup_context
   if (!cleanup) {
     return;
   }
+  if (shared_->memory_tier_) {
+    // Lookups don't promote entries while they are being written, so it won't come back with
+    // the old headers.
+    shared_->memory_tier_->remove(key);
+  }
   auto ctx =
       std::make_shared<HeaderUpdateContext>(*lookup_context.dispatcher(), *this, key, cleanup,
                                             response_headers, metadata, std::move(on_complete));
@@ -337,6 +351,29 @@ std::shared_ptr<Cleanup> FileSystemHttpCache::maybeStartWritingEntry(const Key&
   });
 }
 
+std::pair<std::shared_ptr<CacheEntryInProgress>, bool>
+FileSystemHttpCache::leadOrFollowInsert(const Key& key) {
+  if (!config().has_coalescing()) {
+    return {nullptr, false};
+  }
+  absl::MutexLock lock(cache_mu_);
+  auto [it, inserted] = entries_in_progress_.try_emplace(key);
+  if (inserted) {
+    it->second = std::make_shared<CacheEntryInProgress>(
+        key, PROTOBUF_GET_WRAPPED_OR_DEFAULT(config().coalescing(), max_buffered_body_bytes,
+                                             DefaultCoalescingMaxBufferedBodyBytes));
+  }
+  return {it->second, inserted};
+}
+
+void FileSystemHttpCache::endInsertInProgress(const CacheEntryInProgress& entry) {
+  absl::MutexLock lock(cache_mu_);
+  auto it = entries_in_progress_.find(entry.key());
+  if (it != entries_in_progress_.end() && it->second.get() == &entry) {
+    entries_in_progress_.erase(it);
+  }
+}
+
 std::shared_ptr<Cleanup>
 FileSystemHttpCache::setCacheEntryToVary(Event::Dispatcher& dispatcher, const Key& key,
                                          const Http::ResponseHeaderMap& response_headers,
@@ -7,6 +7,8 @@
 #include "source/common/common/logger.h"
 #include "source/extensions/common/async_files/async_file_manager.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_entry_in_progress.h"
+#include "source/extensions/http/cache/file_system_http_cache/memory_tier.h"
 #include "source/extensions/http/cache/file_system_http_cache/stats.h"
 
 #include "absl/base/thread_annotations.h"
@@ -108,6 +110,23 @@ public:
   ABSL_MUST_USE_RESULT std::shared_ptr<Cleanup> maybeStartWritingEntry(const Key& key)
       ABSL_LOCKS_EXCLUDED(cache_mu_);
 
+  /**
+   * If coalescing is configured, returns the insert in progress for the key, registering a new
+   * one if there is none. The caller that registers it leads the insert, and must eventually
+   * call endInsertInProgress with it; any other caller may follow it.
+   * @param key the key of a lookup which did not find a cache entry.
+   * @return the insert in progress for the key and true if the caller leads it, or nullptr if
+   *     coalescing is not configured.
+   */
+  std::pair<std::shared_ptr<CacheEntryInProgress>, bool> leadOrFollowInsert(const Key& key)
+      ABSL_LOCKS_EXCLUDED(cache_mu_);
+
+  /**
+   * Unregisters an insert in progress, so that later lookups for its key no longer follow it.
+   * @param entry the insert in progress returned to its leader by leadOrFollowInsert.
+   */
+  void endInsertInProgress(const CacheEntryInProgress& entry) ABSL_LOCKS_EXCLUDED(cache_mu_);
+
   /**
    * Returns a key of the base key plus vary_identifier, if a vary_identifier can be
    * generated from the inputs. Otherwise returns nullopt.
@@ -167,6 +186,12 @@ public:
     return async_file_manager_;
   }
 
+  /**
+   * Returns the in-memory tier in front of the cache files, if configured.
+   * @return the memory tier, or nullptr if it is not configured.
+   */
+  MemoryTier* memoryTier() const;
+
   /**
    * Updates stats to reflect that a file has been added to the cache.
    * @param file_size The size in bytes of the file that was added.
@@ -218,6 +243,10 @@ private:
   // inherently low contention.)
   absl::flat_hash_set<Key, MessageUtil, MessageUtil>
       entries_being_written_ ABSL_GUARDED_BY(cache_mu_);
+  // When coalescing is configured, the inserts in progress keyed by the lookup key which missed,
+  // so that concurrent lookups for the same key can stream the inserting response.
+  absl::flat_hash_map<Key, std::shared_ptr<CacheEntryInProgress>, MessageUtil, MessageUtil>
+      entries_in_progress_ ABSL_GUARDED_BY(cache_mu_);
 
   std::shared_ptr<Common::AsyncFiles::AsyncFileManager> async_file_manager_;
 
@@ -241,6 +270,10 @@ struct CacheShared {
   const ConfigProto config_;
   CacheStatNames stat_names_;
   CacheStats stats_;
+  // nullptr if the memory tier is not configured. Held here rather than by FileSystemHttpCache
+  // so that the eviction thread can drop the entries of the files it removes.
+  // Must be declared after stats_, which it updates.
+  const std::unique_ptr<MemoryTier> memory_tier_;
   // These are part of stats, but we have to track them separately because there is
   // potential to go "less than zero" due to not having sole control of the file cache;
   // gauge values don't have fine enough control to prevent that, and aren't allowed to
@@ -26,7 +26,7 @@ std::string writeFailureMessage(absl::string_view kind, absl::StatusOr<size_t> r
 FileInsertContext::FileInsertContext(std::shared_ptr<FileSystemHttpCache> cache,
                                      std::unique_ptr<FileLookupContext> lookup_context)
     : lookup_context_(std::move(lookup_context)), key_(lookup_context_->lookup().key()),
-      cache_(std::move(cache)) {}
+      cache_(std::move(cache)), entry_in_progress_(lookup_context_->takeEntryInProgress()) {}
 
 void FileInsertContext::insertHeaders(const Http::ResponseHeaderMap& response_headers,
                                       const ResponseMetadata& metadata,
@@ -57,6 +57,9 @@ void FileInsertContext::insertHeaders(const Http::ResponseHeaderMap& response_he
     cancelInsert();
     return;
   }
+  if (entry_in_progress_) {
+    entry_in_progress_->publishHeaders(key_, response_headers, metadata, end_stream);
+  }
   cache_file_header_proto_ = makeCacheFileHeaderProto(key_, response_headers, metadata);
   end_stream_after_headers_ = end_stream;
   createFile();
@@ -142,6 +145,9 @@ void FileInsertContext::insertBody(const Buffer::Instance& fragment,
     std::move(ready_for_next_fragment)(false);
     return;
   }
+  if (entry_in_progress_) {
+    entry_in_progress_->publishBody(fragment, end_stream);
+  }
   callback_in_flight_ = std::move(ready_for_next_fragment);
   size_t sz = fragment.length();
   Buffer::OwnedImpl consumable_fragment(fragment);
@@ -174,6 +180,9 @@ void FileInsertContext::insertTrailers(const Http::ResponseTrailerMap& trailers,
     std::move(insert_complete)(false);
     return;
   }
+  if (entry_in_progress_) {
+    entry_in_progress_->publishTrailers(trailers);
+  }
   callback_in_flight_ = std::move(insert_complete);
   CacheFileTrailer file_trailer = makeCacheFileTrailerProto(trailers);
   Buffer::OwnedImpl consumable_buffer = bufferFromProto(file_trailer);
@@ -262,6 +271,16 @@ void FileInsertContext::commitCreateHardLink() {
           return;
         }
         ENVOY_LOG(debug, "created cache file {}", cache_->generateFilename(key_));
+        if (entry_in_progress_) {
+          // New lookups can read the cache file from here on.
+          cache_->endInsertInProgress(*entry_in_progress_);
+          entry_in_progress_ = nullptr;
+        }
+        if (cache_->memoryTier() != nullptr) {
+          // The entry replaces whatever was at the lookup key, which may now be a vary node.
+          cache_->memoryTier()->remove(lookup_context_->lookup().key());
+          cache_->memoryTier()->remove(key_);
+        }
         succeedCurrentAction();
         uint64_t file_size = header_block_.offsetToTrailers() + header_block_.trailerSize();
         cache_->trackFileAdded(file_size);
@@ -281,6 +300,13 @@ void FileInsertContext::cancelInsert(absl::string_view error) {
     callback_in_flight_(false);
     callback_in_flight_ = nullptr;
   }
+  if (entry_in_progress_) {
+    // Does nothing to the lookups following this insert if the whole response was already
+    // published, e.g. if only the commit failed.
+    entry_in_progress_->abandon();
+    cache_->endInsertInProgress(*entry_in_progress_);
+    entry_in_progress_ = nullptr;
+  }
   if (cleanup_) {
     cleanup_ = nullptr;
     if (!error.empty()) {
@@ -4,6 +4,7 @@
 
 #include "source/extensions/common/async_files/async_file_handle.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_entry_in_progress.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_fixed_block.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_header.pb.h"
 
@@ -96,6 +97,9 @@ private:
   Key key_;
   std::shared_ptr<FileSystemHttpCache> cache_;
   std::shared_ptr<Cleanup> cleanup_;
+  // If coalescing is configured, the lookups waiting on this insert stream the response from
+  // here as it is inserted.
+  std::shared_ptr<CacheEntryInProgress> entry_in_progress_;
   AsyncFileHandle file_handle_;
   absl::AnyInvocable<void(bool)> callback_in_flight_;
   CancelFunction cancel_action_in_flight_;
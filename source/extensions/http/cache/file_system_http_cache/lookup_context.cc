@@ -1,5 +1,7 @@
 #include "source/extensions/http/cache/file_system_http_cache/lookup_context.h"
 
+#include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_fixed_block.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_header.pb.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_header_proto_util.h"
@@ -19,16 +21,77 @@ bool FileLookupContext::workInProgress() const { return cache_.workInProgress(ke
 
 void FileLookupContext::getHeaders(LookupHeadersCallback&& cb) {
   lookup_headers_callback_ = std::move(cb);
+  if (cache_.memoryTier() != nullptr) {
+    memory_entry_ = cache_.memoryTier()->lookup(key_);
+    if (memory_entry_) {
+      return getHeadersFromMemory();
+    }
+  }
   tryOpenCacheFile();
 }
 
+void FileLookupContext::getHeadersFromMemory() {
+  cache_.stats().cache_hit_.inc();
+  cache_.stats().cache_hit_memory_.inc();
+  postFromMemory([this]() {
+    std::move(lookup_headers_callback_)(
+        lookup().makeLookupResult(
+            Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*memory_entry_->headers_),
+            ResponseMetadata(memory_entry_->metadata_), memory_entry_->body_.size()),
+        /* end_stream = */ memory_entry_->body_.empty() && memory_entry_->trailers_ == nullptr);
+  });
+}
+
+void FileLookupContext::postFromMemory(absl::AnyInvocable<void()> cb) {
+  ASSERT(!cancel_action_in_flight_);
+  auto cancelled = std::make_shared<bool>(false);
+  cancel_action_in_flight_ = [cancelled]() { *cancelled = true; };
+  dispatcher_.post([this, cancelled, cb = std::move(cb)]() mutable {
+    if (*cancelled) {
+      return;
+    }
+    cancel_action_in_flight_ = nullptr;
+    std::move(cb)();
+  });
+}
+
+void FileLookupContext::maybeStartPromotion(const Http::ResponseHeaderMap& headers,
+                                            const ResponseMetadata& metadata) {
+  MemoryTier* memory_tier = cache_.memoryTier();
+  // A response with vary is stored under a key which includes the vary identifier, which is only
+  // known once the vary node has been read from its file, so such entries aren't held in memory.
+  // An entry which is being written may be about to change, so it is left until it settles.
+  if (memory_tier == nullptr || VaryHeaderUtils::hasVary(headers)) {
+    return;
+  }
+  absl::optional<uint64_t> generation = memory_tier->recordFileRead(key_, header_block_.bodySize());
+  if (!generation.has_value() || cache_.workInProgress(key_)) {
+    return;
+  }
+  promotion_generation_ = generation.value();
+  promotion_ = std::make_unique<MemoryTier::Entry>();
+  promotion_->headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(headers);
+  promotion_->metadata_ = metadata;
+  promotion_->body_.reserve(header_block_.bodySize());
+  maybeFinishPromotion();
+}
+
+void FileLookupContext::maybeFinishPromotion() {
+  if (promotion_->body_.size() < header_block_.bodySize() ||
+      (header_block_.trailerSize() > 0 && promotion_->trailers_ == nullptr)) {
+    return;
+  }
+  cache_.memoryTier()->insert(key_, std::move(*promotion_), promotion_generation_);
+  promotion_ = nullptr;
+}
+
 void FileLookupContext::tryOpenCacheFile() {
   cancel_action_in_flight_ = cache_.asyncFileManager()->openExistingFile(
       dispatcher(), filepath(), Common::AsyncFiles::AsyncFileManager::Mode::ReadOnly,
       [this](absl::StatusOr<AsyncFileHandle> open_result) {
         cancel_action_in_flight_ = nullptr;
         if (!open_result.ok()) {
-          return doCacheMiss();
+          return leadOrFollowInsert();
         }
         ASSERT(!file_handle_);
         file_handle_ = std::move(open_result.value());
@@ -36,6 +99,66 @@ void FileLookupContext::tryOpenCacheFile() {
       });
 }
 
+void FileLookupContext::leadOrFollowInsert() {
+  auto [entry, is_leader] = cache_.leadOrFollowInsert(key_);
+  if (is_leader) {
+    entry_in_progress_ = std::move(entry);
+    return doCacheMiss();
+  }
+  if (entry != nullptr) {
+    follower_ = entry->join(dispatcher_);
+  }
+  if (follower_ == nullptr) {
+    // Either coalescing is not configured, or the insert in progress is too far along to join.
+    return doCacheMiss();
+  }
+  follower_->getHeaders([this](absl::StatusOr<CacheEntryInProgress::Headers>&& headers) {
+    ASSERT(dispatcher()->isThreadSafe());
+    onHeadersInProgress(std::move(headers));
+  });
+}
+
+void FileLookupContext::onHeadersInProgress(
+    absl::StatusOr<CacheEntryInProgress::Headers>&& headers) {
+  if (!headers.ok()) {
+    return doCoalescingFallback(absl::IsUnavailable(headers.status()));
+  }
+  // The response is inserted under a key which includes the vary identifier of the leading
+  // request, so it only answers this request if its vary identifier is the same.
+  absl::optional<Key> expected_key = lookup().key();
+  if (VaryHeaderUtils::hasVary(*headers->headers_)) {
+    expected_key = cache_.makeVaryKey(lookup().key(), lookup().varyAllowList(),
+                                      VaryHeaderUtils::getVaryValues(*headers->headers_),
+                                      lookup().requestHeaders());
+  }
+  if (!expected_key.has_value() ||
+      !Protobuf::util::MessageDifferencer::Equals(expected_key.value(), headers->key_)) {
+    return doCoalescingFallback(/* leader_failed = */ false);
+  }
+  key_ = headers->key_;
+  cache_.stats().cache_coalesced_.inc();
+  const bool end_stream = headers->end_stream_;
+  std::move(lookup_headers_callback_)(lookup().makeLookupResult(std::move(headers->headers_),
+                                                                std::move(headers->metadata_),
+                                                                absl::nullopt),
+                                      end_stream);
+  lookup_headers_callback_ = nullptr;
+}
+
+void FileLookupContext::doCoalescingFallback(bool leader_failed) {
+  follower_ = nullptr;
+  cache_.stats().coalescing_fallbacks_.inc();
+  if (leader_failed && cache_.config().coalescing().leader_failure_action() ==
+                           ConfigProto::Coalescing::BYPASS_CACHE) {
+    LookupResult result;
+    result.cache_entry_status_ = CacheEntryStatus::LookupError;
+    std::move(lookup_headers_callback_)(std::move(result), /* end_stream (ignored) = */ false);
+    lookup_headers_callback_ = nullptr;
+    return;
+  }
+  doCacheMiss();
+}
+
 void FileLookupContext::doCacheMiss() {
   cache_.stats().cache_miss_.inc();
   std::move(lookup_headers_callback_)(LookupResult{}, /* end_stream (ignored) = */ false);
@@ -89,9 +212,12 @@ void FileLookupContext::getHeadersFromFile() {
           return closeFileAndGetHeadersAgainWithNewVaryKey();
         }
         cache_.stats().cache_hit_.inc();
+        cache_.stats().cache_hit_file_.inc();
+        auto headers = headersFromHeaderProto(header_proto);
+        ResponseMetadata metadata = metadataFromHeaderProto(header_proto);
+        maybeStartPromotion(*headers, metadata);
         std::move(lookup_headers_callback_)(
-            lookup().makeLookupResult(headersFromHeaderProto(header_proto),
-                                      metadataFromHeaderProto(header_proto),
+            lookup().makeLookupResult(std::move(headers), std::move(metadata),
                                       header_block_.bodySize()),
             /* end_stream = */ header_block_.trailerSize() == 0 && header_block_.bodySize() == 0);
       });
@@ -113,6 +239,10 @@ void FileLookupContext::closeFileAndGetHeadersAgainWithNewVaryKey() {
 
 void FileLookupContext::invalidateCacheEntry() {
   ASSERT(dispatcher()->isThreadSafe());
+  promotion_ = nullptr;
+  if (cache_.memoryTier() != nullptr) {
+    cache_.memoryTier()->remove(key_);
+  }
   // We don't capture the cancel action here because we want these operations to continue even
   // if the filter was destroyed in the meantime. For the same reason, we must not capture 'this'.
   cache_.asyncFileManager()->stat(
@@ -136,6 +266,30 @@ void FileLookupContext::invalidateCacheEntry() {
 void FileLookupContext::getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) {
   ASSERT(dispatcher()->isThreadSafe());
   ASSERT(cb);
+  if (follower_) {
+    follower_->getBody(range, [this, cb = std::move(cb)](
+                                  absl::StatusOr<Buffer::InstancePtr>&& body_result,
+                                  bool end_stream) mutable {
+      ASSERT(dispatcher()->isThreadSafe());
+      if (!body_result.ok()) {
+        // The insert failed part way through the body, so the response can't be completed.
+        callbacks_.resetStream();
+        return;
+      }
+      std::move(cb)(std::move(body_result.value()), end_stream);
+    });
+    return;
+  }
+  if (memory_entry_) {
+    ASSERT(range.end() <= memory_entry_->body_.size(), "Attempt to read past end of body.");
+    postFromMemory([this, cb = std::move(cb), range]() mutable {
+      std::move(cb)(std::make_unique<Buffer::OwnedImpl>(absl::string_view(memory_entry_->body_)
+                                                            .substr(range.begin(), range.length())),
+                    /* end_stream = */ range.end() == memory_entry_->body_.size() &&
+                        memory_entry_->trailers_ == nullptr);
+    });
+    return;
+  }
   ASSERT(!cancel_action_in_flight_);
   ASSERT(file_handle_);
   auto queued = file_handle_->read(
@@ -149,6 +303,12 @@ void FileLookupContext::getBody(const AdjustedByteRange& range, LookupBodyCallba
           std::move(cb)(nullptr, /* end_stream (ignored) = */ false);
           return;
         }
+        if (promotion_ && range.begin() == promotion_->body_.size()) {
+          promotion_->body_.append(read_result.value()->toString());
+          maybeFinishPromotion();
+        } else {
+          promotion_ = nullptr;
+        }
         std::move(cb)(std::move(read_result.value()),
                       /* end_stream = */ range.end() == header_block_.bodySize() &&
                           header_block_.trailerSize() == 0);
@@ -160,6 +320,17 @@ void FileLookupContext::getBody(const AdjustedByteRange& range, LookupBodyCallba
 void FileLookupContext::getTrailers(LookupTrailersCallback&& cb) {
   ASSERT(dispatcher()->isThreadSafe());
   ASSERT(cb);
+  if (follower_) {
+    follower_->getTrailers(std::move(cb));
+    return;
+  }
+  if (memory_entry_) {
+    ASSERT(memory_entry_->trailers_);
+    postFromMemory([this, cb = std::move(cb)]() mutable {
+      std::move(cb)(Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*memory_entry_->trailers_));
+    });
+    return;
+  }
   ASSERT(!cancel_action_in_flight_);
   ASSERT(file_handle_);
   auto queued = file_handle_->read(
@@ -176,13 +347,27 @@ void FileLookupContext::getTrailers(LookupTrailersCallback&& cb) {
         }
         CacheFileTrailer trailer;
         trailer.ParseFromString(read_result.value()->toString());
-        std::move(cb)(trailersFromTrailerProto(trailer));
+        auto trailers = trailersFromTrailerProto(trailer);
+        if (promotion_ && promotion_->body_.size() == header_block_.bodySize()) {
+          promotion_->trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*trailers);
+          maybeFinishPromotion();
+        }
+        std::move(cb)(std::move(trailers));
       });
   ASSERT(queued.ok(), queued.status().ToString());
   cancel_action_in_flight_ = std::move(queued.value());
 }
 
 void FileLookupContext::onDestroy() {
+  follower_ = nullptr;
+  promotion_ = nullptr;
+  if (entry_in_progress_) {
+    // This lookup never handed its insert over to an InsertContext, e.g. because the response
+    // was not cacheable, so the lookups following it must fall back.
+    entry_in_progress_->abandon();
+    cache_.endInsertInProgress(*entry_in_progress_);
+    entry_in_progress_ = nullptr;
+  }
   if (cancel_action_in_flight_) {
     std::move(cancel_action_in_flight_)();
     cancel_action_in_flight_ = nullptr;
@@ -4,7 +4,9 @@
 
 #include "source/extensions/common/async_files/async_file_handle.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_entry_in_progress.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_fixed_block.h"
+#include "source/extensions/http/cache/file_system_http_cache/memory_tier.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -19,9 +21,10 @@ using Envoy::Extensions::Common::AsyncFiles::CancelFunction;
 
 class FileLookupContext : public LookupContext {
 public:
-  FileLookupContext(Event::Dispatcher& dispatcher, FileSystemHttpCache& cache,
+  FileLookupContext(Http::StreamFilterCallbacks& callbacks, FileSystemHttpCache& cache,
                     LookupRequest&& lookup)
-      : dispatcher_(dispatcher), cache_(cache), key_(lookup.key()), lookup_(std::move(lookup)) {}
+      : dispatcher_(callbacks.dispatcher()), callbacks_(callbacks), cache_(cache),
+        key_(lookup.key()), lookup_(std::move(lookup)) {}
 
   // From LookupContext
   void getHeaders(LookupHeadersCallback&& cb) final;
@@ -37,10 +40,36 @@ public:
   bool workInProgress() const;
   Event::Dispatcher* dispatcher() const { return &dispatcher_; }
 
+  /**
+   * Hands over the insert in progress this lookup registered when it missed, if any, to the
+   * InsertContext which will perform the insert.
+   * @return the insert in progress led by this lookup, or nullptr.
+   */
+  std::shared_ptr<CacheEntryInProgress> takeEntryInProgress() {
+    return std::move(entry_in_progress_);
+  }
+
 private:
   void tryOpenCacheFile();
+  // Called when there is no cache file for key_. If coalescing is configured, either leads
+  // the insert for key_, or follows an insert already in progress for it.
+  void leadOrFollowInsert();
+  void onHeadersInProgress(absl::StatusOr<CacheEntryInProgress::Headers>&& headers);
+  // Gives up on following an insert in progress; leader_failed is false if the insert is still
+  // going but can't be shared with this lookup.
+  void doCoalescingFallback(bool leader_failed);
   void doCacheMiss();
   void doCacheEntryInvalid();
+  void getHeadersFromMemory();
+  // Runs cb on the dispatcher, as callbacks from a lookup must not be called directly, unless
+  // the lookup is destroyed first.
+  void postFromMemory(absl::AnyInvocable<void()> cb);
+  // Starts collecting the entry as it is read from the file, if it is to be promoted to the
+  // memory tier.
+  void maybeStartPromotion(const Http::ResponseHeaderMap& headers,
+                           const ResponseMetadata& metadata);
+  // Promotes the entry once it has all been read.
+  void maybeFinishPromotion();
   void getHeaderBlockFromFile();
   void getHeadersFromFile();
   void closeFileAndGetHeadersAgainWithNewVaryKey();
@@ -52,6 +81,10 @@ private:
   std::string filepath();
 
   Event::Dispatcher& dispatcher_;
+  // Only used to reset the stream when a followed insert fails part way through the body. This
+  // happens during a getBody call from the filter, which is therefore still alive; a lookup
+  // which leads an insert may outlive the filter, but never uses this.
+  Http::StreamFilterCallbacks& callbacks_;
 
   // We can safely use a reference here, because the shared_ptr to a cache is guaranteed to outlive
   // all filters that use it.
@@ -64,32 +97,24 @@ private:
 
   LookupHeadersCallback lookup_headers_callback_;
   const LookupRequest lookup_;
+
+  // Set if this lookup missed and leads the insert for its key, until it is handed over to the
+  // InsertContext.
+  std::shared_ptr<CacheEntryInProgress> entry_in_progress_;
+  // Set if this lookup is streaming the response of another stream's insert.
+  CacheEntryInProgress::FollowerPtr follower_;
+  // Set if the entry was found in the memory tier, in which case the file is never opened.
+  MemoryTier::EntrySharedPtr memory_entry_;
+  // Set while an entry being read from the file is collected for the memory tier. Dropped if
+  // the body is not read from start to end.
+  std::unique_ptr<MemoryTier::Entry> promotion_;
+  // The generation of key_ in the memory tier when promotion_ was started.
+  uint64_t promotion_generation_ = 0;
 };
 
-// TODO(ravenblack): A CacheEntryInProgressReader should be implemented to prevent
-// "thundering herd" problem.
-//
-// First the insert needs to be performed not by using the existing request but by
-// issuing its own request[s], otherwise the first client to request a resource could
-// provoke failure for any other clients sharing that data-stream, by closing its
-// request before the cache population is completed.
-//
-// The plan is to make the entire cache insert happen "out of band", and to populate
-// the cache with a CacheEntryInProgress object, allowing clients to stream from it in
-// parallel.
-//
-// This may require intercepting at the initialization of LookupContext to trigger
-// immediate "InProgress" cache insertion for any resource compatible with cache
-// insertion, and the beginning of that out-of-band download - this way the original
-// requester can be a sibling of any subsequent requester, whereas if we waited for
-// the cache filter's insert path to be reached then the process would potentially be
-// much more confusing (because we will never want a stream to be doing the inserting
-// if we have an external task for that, and because there would be a race where two
-// clients could get past the lookup before either creates an InsertContext).
-//
-// The current, early implementation simply allows requests to bypass the cache when
-// the cache entry is in the process of being populated. It is therefore subject to
-// the "thundering herd" problem.
+// TODO(ravenblack): coalescing lookups stream from the stream performing the insert, so if
+// that stream is closed before the response is complete, the lookups following it fail too.
+// Making the insert happen "out of band", issuing its own upstream request, would avoid that.
 
 } // namespace FileSystemHttpCache
 } // namespace Cache
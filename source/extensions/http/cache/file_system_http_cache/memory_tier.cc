@@ -0,0 +1,136 @@
+#include "source/extensions/http/cache/file_system_http_cache/memory_tier.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+namespace {
+constexpr uint64_t DefaultMaxEntryBodyBytes = 64 * 1024;
+constexpr uint32_t DefaultPromotionThreshold = 2;
+// The file read counts are forgotten when this many keys are being counted, which both bounds
+// the memory used and ages out keys which were read a few times long ago.
+constexpr size_t MaxCountedFileReads = 16 * 1024;
+} // namespace
+
+MemoryTier::MemoryTier(const envoy::extensions::http::cache::file_system_http_cache::v3::
+                           FileSystemHttpCacheConfig::MemoryTier& config,
+                       CacheStats& stats)
+    : max_size_bytes_(config.max_size_bytes()),
+      max_entry_body_bytes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entry_body_bytes, DefaultMaxEntryBodyBytes)),
+      promotion_threshold_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, promotion_threshold, DefaultPromotionThreshold)),
+      stats_(stats) {}
+
+MemoryTier::EntrySharedPtr MemoryTier::lookup(const Key& key) {
+  absl::ReaderMutexLock lock(mu_);
+  auto it = index_.find(stableHashKey(key));
+  if (it == index_.end() || !Protobuf::util::MessageDifferencer::Equals(it->second->key_, key)) {
+    return nullptr;
+  }
+  it->second->referenced_.store(true, std::memory_order_relaxed);
+  return it->second->entry_;
+}
+
+absl::optional<uint64_t> MemoryTier::recordFileRead(const Key& key, uint64_t body_size) {
+  if (body_size > max_entry_body_bytes_) {
+    return absl::nullopt;
+  }
+  const size_t hash = stableHashKey(key);
+  absl::MutexLock lock(mu_);
+  if (index_.contains(hash)) {
+    // Another lookup promoted it after this one missed in memory.
+    return absl::nullopt;
+  }
+  if (file_reads_.size() >= MaxCountedFileReads) {
+    file_reads_.clear();
+  }
+  if (++file_reads_[hash] < promotion_threshold_) {
+    return absl::nullopt;
+  }
+  file_reads_.erase(hash);
+  return generationOf(hash);
+}
+
+void MemoryTier::insert(const Key& key, Entry&& entry, uint64_t generation) {
+  const uint64_t size = key.ByteSizeLong() + entry.headers_->byteSize() + entry.body_.size() +
+                        (entry.trailers_ ? entry.trailers_->byteSize() : 0);
+  if (size > max_size_bytes_) {
+    return;
+  }
+  const size_t hash = stableHashKey(key);
+  absl::MutexLock lock(mu_);
+  if (generationOf(hash) != generation) {
+    // The entry was replaced or invalidated while the caller was reading it from the file.
+    return;
+  }
+  auto existing = index_.find(hash);
+  if (existing != index_.end()) {
+    removeNode(existing->second);
+  }
+  // Terminates as the entry fits in an empty tier, and each lap clears every referenced bit.
+  while (size_bytes_ + size > max_size_bytes_) {
+    if (hand_ == ring_.end()) {
+      hand_ = ring_.begin();
+    }
+    if (hand_->referenced_.exchange(false, std::memory_order_relaxed)) {
+      ++hand_;
+      continue;
+    }
+    removeNode(hand_);
+    stats_.memory_tier_evictions_.inc();
+  }
+  // Just behind the hand, so that it is the last entry the hand reaches.
+  index_.emplace(hash, ring_.emplace(hand_, key, hash,
+                                     std::make_shared<const Entry>(std::move(entry)), size));
+  size_bytes_ += size;
+  stats_.memory_tier_promotions_.inc();
+  updateGauges();
+}
+
+void MemoryTier::remove(const Key& key) { removeHash(stableHashKey(key)); }
+
+void MemoryTier::removeHash(size_t key_hash) {
+  absl::MutexLock lock(mu_);
+  if (generations_.size() >= MaxCountedFileReads) {
+    // Forgetting the generations of removed keys must not make any of them look unchanged, so
+    // all keys move on to a new generation.
+    generations_.clear();
+    base_generation_ = ++last_generation_;
+  }
+  generations_[key_hash] = ++last_generation_;
+  auto it = index_.find(key_hash);
+  if (it == index_.end()) {
+    return;
+  }
+  removeNode(it->second);
+  updateGauges();
+}
+
+void MemoryTier::removeNode(Ring::iterator it) {
+  size_bytes_ -= it->size_;
+  index_.erase(it->hash_);
+  if (hand_ == it) {
+    ++hand_;
+  }
+  // Lookups which already hold the entry keep it alive until they are done with it.
+  ring_.erase(it);
+}
+
+uint64_t MemoryTier::generationOf(size_t hash) const {
+  auto it = generations_.find(hash);
+  return it == generations_.end() ? base_generation_ : it->second;
+}
+
+void MemoryTier::updateGauges() {
+  stats_.memory_tier_size_bytes_.set(size_bytes_);
+  stats_.memory_tier_size_count_.set(ring_.size());
+}
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
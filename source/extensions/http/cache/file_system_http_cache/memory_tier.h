@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/http/cache/file_system_http_cache/v3/file_system_http_cache.pb.h"
+#include "envoy/http/header_map.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/file_system_http_cache/stats.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+/**
+ * An in-memory copy of small, frequently read cache entries, consulted before the cache files.
+ *
+ * An entry is promoted once it has been read from its cache file promotion_threshold times;
+ * reads are counted per key in a table which is reset when it grows too large, so that keys
+ * which are only read occasionally don't accumulate. When the total size exceeds max_size_bytes,
+ * entries are dropped in CLOCK order: a hit only sets the entry's referenced bit, so lookups share
+ * a reader lock, and the eviction hand skips (and clears) referenced entries once before dropping
+ * them.
+ *
+ * The cache files remain the source of truth. Callers must remove an entry whenever its cache
+ * file is replaced, updated, invalidated or evicted.
+ *
+ * All functions are thread-safe.
+ */
+class MemoryTier {
+public:
+  struct Entry {
+    Http::ResponseHeaderMapPtr headers_;
+    ResponseMetadata metadata_;
+    std::string body_;
+    // nullptr if the response has no trailers.
+    Http::ResponseTrailerMapPtr trailers_;
+  };
+  using EntrySharedPtr = std::shared_ptr<const Entry>;
+
+  MemoryTier(const envoy::extensions::http::cache::file_system_http_cache::v3::
+                 FileSystemHttpCacheConfig::MemoryTier& config,
+             CacheStats& stats);
+
+  /**
+   * @param key the key of the cache entry.
+   * @return the entry, or nullptr if it is not held in memory.
+   */
+  EntrySharedPtr lookup(const Key& key) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Counts a read of a cache entry from its file.
+   * @param key the key of the cache entry.
+   * @param body_size the size of the body of the cache entry.
+   * @return the generation of the key if the entry should be promoted, i.e. the caller should
+   *     collect the whole entry as it reads it and pass it to insert with the generation;
+   *     nullopt otherwise.
+   */
+  absl::optional<uint64_t> recordFileRead(const Key& key, uint64_t body_size)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Holds an entry in memory, dropping unreferenced entries to make room for it.
+   * @param key the key of the cache entry.
+   * @param entry the complete cache entry.
+   * @param generation the generation returned by recordFileRead. If the key has been removed
+   *     since, the entry may have been read from a file which has since been replaced, so it is
+   *     not inserted.
+   */
+  void insert(const Key& key, Entry&& entry, uint64_t generation) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Drops an entry from memory, if present, and stops any promotion of it which is in progress.
+   * @param key the key of the cache entry.
+   */
+  void remove(const Key& key) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * As remove, for the entry whose cache file has been removed, e.g. by the eviction thread,
+   * which only knows the entry by its file name.
+   * @param key_hash the stableHashKey of the key of the cache entry.
+   */
+  void removeHash(size_t key_hash) ABSL_LOCKS_EXCLUDED(mu_);
+
+private:
+  struct Node {
+    Node(const Key& key, size_t hash, EntrySharedPtr entry, uint64_t size)
+        : key_(key), hash_(hash), entry_(std::move(entry)), size_(size) {}
+    const Key key_;
+    const size_t hash_;
+    const EntrySharedPtr entry_;
+    const uint64_t size_;
+    // Set by lookups, which only hold a reader lock; cleared as the eviction hand passes.
+    std::atomic<bool> referenced_{false};
+  };
+  using Ring = std::list<Node>;
+
+  void removeNode(Ring::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void updateGauges() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  uint64_t generationOf(size_t hash) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const uint64_t max_size_bytes_;
+  const uint64_t max_entry_body_bytes_;
+  const uint32_t promotion_threshold_;
+  CacheStats& stats_;
+
+  absl::Mutex mu_;
+  // Entries in the order the eviction hand visits them; new entries go just behind the hand.
+  Ring ring_ ABSL_GUARDED_BY(mu_);
+  Ring::iterator hand_ ABSL_GUARDED_BY(mu_) = ring_.end();
+  // Keyed by stableHashKey, which also names the cache file, so keys which share a hash share an
+  // entry just as they share a file.
+  absl::flat_hash_map<size_t, Ring::iterator> index_ ABSL_GUARDED_BY(mu_);
+  uint64_t size_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  // File reads of entries not yet in memory, keyed by stableHashKey.
+  absl::flat_hash_map<size_t, uint32_t> file_reads_ ABSL_GUARDED_BY(mu_);
+  // The generation of each removed key, keyed by stableHashKey. A removal gives the key a
+  // generation no earlier one had, so a promotion which started before it can be recognized.
+  absl::flat_hash_map<size_t, uint64_t> generations_ ABSL_GUARDED_BY(mu_);
+  // The generation of keys which are not in generations_; raised when generations_ is reset.
+  uint64_t base_generation_ ABSL_GUARDED_BY(mu_) = 0;
+  uint64_t last_generation_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
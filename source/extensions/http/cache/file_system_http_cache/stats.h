@@ -19,22 +19,39 @@ namespace FileSystemHttpCache {
  *
  * Drift will eventually be reconciled at the next pre-cache-purge measurement.
  *
- * There are also cache_hit_ and cache_miss_, defined separately to accommodate extra tags;
- * these two both go into the stat with key `event`, and with tag `event_type=(hit|miss)`
+ * There are also cache_hit_, cache_miss_ and cache_coalesced_, defined separately to
+ * accommodate extra tags; these all go into the stat with key `event`, and with tag
+ * `event_type=(hit|miss|coalesced)`. A coalesced lookup is one which streamed the response
+ * of an insert already in progress, rather than going upstream.
+ *
+ * cache_hit_memory_ and cache_hit_file_ count the hits served by the memory tier and by cache
+ * files respectively, as the stat with key `tier_hit` and tag `tier=(memory|file)`; every hit
+ * is also counted in cache_hit_. Unlike size_bytes and size_count, the memory_tier_size_*
+ * gauges are exact, since the memory tier is private to this process.
  **/
 
 #define ALL_CACHE_STATS(COUNTER, GAUGE, HISTOGRAM, TEXT_READOUT, STATNAME)                         \
+  COUNTER(coalescing_fallbacks)                                                                    \
   COUNTER(eviction_runs)                                                                           \
+  COUNTER(memory_tier_evictions)                                                                   \
+  COUNTER(memory_tier_promotions)                                                                  \
+  GAUGE(memory_tier_size_bytes, NeverImport)                                                       \
+  GAUGE(memory_tier_size_count, NeverImport)                                                       \
   GAUGE(size_bytes, NeverImport)                                                                   \
   GAUGE(size_count, NeverImport)                                                                   \
   GAUGE(size_limit_bytes, NeverImport)                                                             \
   GAUGE(size_limit_count, NeverImport)                                                             \
   STATNAME(cache)                                                                                  \
   STATNAME(cache_path)                                                                             \
+  STATNAME(coalesced)                                                                              \
   STATNAME(event)                                                                                  \
   STATNAME(event_type)                                                                             \
+  STATNAME(file)                                                                                   \
   STATNAME(hit)                                                                                    \
-  STATNAME(miss)
+  STATNAME(memory)                                                                                 \
+  STATNAME(miss)                                                                                   \
+  STATNAME(tier)                                                                                   \
+  STATNAME(tier_hit)
 // TODO(ravenblack): Add other stats from DESIGN.md
 
 #define COUNTER_HELPER_(NAME)                                                                      \
@@ -55,13 +72,24 @@ struct CacheStats {
         tags_hit_(
             {{stat_names_.cache_path_, cache_path_}, {stat_names_.event_type_, stat_names_.hit_}}),
         tags_miss_(
-            {{stat_names_.cache_path_, cache_path_}, {stat_names_.event_type_, stat_names_.miss_}})
+            {{stat_names_.cache_path_, cache_path_}, {stat_names_.event_type_, stat_names_.miss_}}),
+        tags_coalesced_({{stat_names_.cache_path_, cache_path_},
+                         {stat_names_.event_type_, stat_names_.coalesced_}}),
+        tags_memory_(
+            {{stat_names_.cache_path_, cache_path_}, {stat_names_.tier_, stat_names_.memory_}}),
+        tags_file_({{stat_names_.cache_path_, cache_path_}, {stat_names_.tier_, stat_names_.file_}})
             ALL_CACHE_STATS(COUNTER_HELPER_, GAUGE_HELPER_, HISTOGRAM_HELPER_, TEXT_READOUT_HELPER_,
                             STATNAME_HELPER_),
         cache_hit_(Envoy::Stats::Utility::counterFromStatNames(scope, {prefix_, stat_names.event_},
                                                                tags_hit_)),
         cache_miss_(Envoy::Stats::Utility::counterFromStatNames(scope, {prefix_, stat_names.event_},
-                                                                tags_miss_)) {}
+                                                                tags_miss_)),
+        cache_coalesced_(Envoy::Stats::Utility::counterFromStatNames(
+            scope, {prefix_, stat_names.event_}, tags_coalesced_)),
+        cache_hit_memory_(Envoy::Stats::Utility::counterFromStatNames(
+            scope, {prefix_, stat_names.tier_hit_}, tags_memory_)),
+        cache_hit_file_(Envoy::Stats::Utility::counterFromStatNames(
+            scope, {prefix_, stat_names.tier_hit_}, tags_file_)) {}
 
 private:
   const CacheStatNames& stat_names_;
@@ -70,12 +98,18 @@ private:
   Stats::StatNameTagVector tags_;
   Stats::StatNameTagVector tags_hit_;
   Stats::StatNameTagVector tags_miss_;
+  Stats::StatNameTagVector tags_coalesced_;
+  Stats::StatNameTagVector tags_memory_;
+  Stats::StatNameTagVector tags_file_;
 
 public:
   ALL_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT,
                   GENERATE_TEXT_READOUT_STRUCT, GENERATE_STATNAME_STRUCT);
   Stats::Counter& cache_hit_;
   Stats::Counter& cache_miss_;
+  Stats::Counter& cache_coalesced_;
+  Stats::Counter& cache_hit_memory_;
+  Stats::Counter& cache_hit_file_;
 };
 
 CacheStats generateStats(CacheStatNames& stat_names, Stats::Scope& scope,
@@ -1,5 +1,7 @@
 #include "source/extensions/http/cache/simple_http_cache/simple_http_cache.h"
 
+#include <algorithm>
+
 #include "envoy/extensions/http/cache/simple_http_cache/v3/config.pb.h"
 #include "envoy/registry/registry.h"
 
@@ -31,6 +33,10 @@ absl::optional<Key> variedRequestKey(const LookupRequest& request,
   return varied_request_key;
 }
 
+uint32_t shardCount(const SimpleHttpCache::ConfigProto& config) {
+  return config.shard_count() == 0 ? SimpleHttpCache::DefaultShardCount : config.shard_count();
+}
+
 class SimpleLookupContext : public LookupContext {
 public:
   SimpleLookupContext(Event::Dispatcher& dispatcher, SimpleHttpCache& cache,
@@ -167,6 +173,152 @@ private:
 };
 } // namespace
 
+SimpleHttpCache::SimpleHttpCache()
+    : isolated_store_(std::make_unique<Stats::IsolatedStoreImpl>()),
+      stats_(generateStats(*isolated_store_->rootScope())), shard_max_size_bytes_(0) {
+  for (uint32_t i = 0; i < DefaultShardCount; i++) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+SimpleHttpCache::SimpleHttpCache(const ConfigProto& config, Stats::Scope& scope,
+                                 std::shared_ptr<Singleton::Instance> owner)
+    : owner_(std::move(owner)), config_(config), stats_(generateStats(scope)),
+      shard_max_size_bytes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_size_bytes, 0) == 0
+              ? 0
+              : std::max<uint64_t>(1, config.max_size_bytes().value() / shardCount(config))) {
+  for (uint32_t i = 0; i < shardCount(config); i++) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+SimpleHttpCache::~SimpleHttpCache() {
+  // The gauges are shared with the other caches in the same scope, so only remove what this
+  // cache added.
+  for (auto& shard : shards_) {
+    absl::MutexLock lock(shard->mutex_);
+    stats_.entries_.sub(shard->map_.size());
+    stats_.size_bytes_.sub(shard->size_bytes_);
+  }
+}
+
+SimpleHttpCacheStats SimpleHttpCache::generateStats(Stats::Scope& scope) {
+  const std::string prefix = "cache.simple_http_cache.";
+  return {ALL_SIMPLE_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                      POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+SimpleHttpCache::Shard& SimpleHttpCache::shardFor(const Key& key) {
+  // Use the high bits of the hash, as the shard maps hash the same key and rely on the low bits.
+  return *shards_[(MessageUtil::hash(key) >> 32) % shards_.size()];
+}
+
+void SimpleHttpCache::touch(Shard& shard, ShardEntry& entry) {
+  if (entry.segment_ == Segment::Protected) {
+    shard.protected_.splice(shard.protected_.begin(), shard.protected_, entry.lru_position_);
+    return;
+  }
+
+  // A hit on a probationary entry promotes it to the protected segment.
+  shard.protected_.splice(shard.protected_.begin(), shard.probation_, entry.lru_position_);
+  entry.segment_ = Segment::Protected;
+  shard.protected_size_bytes_ += entry.size_bytes_;
+
+  // Demote the least recently used protected entries back to probation once the protected
+  // segment is over its share of the budget. They get another chance before being evicted.
+  const uint64_t protected_max_size_bytes =
+      static_cast<uint64_t>(shard_max_size_bytes_ * ProtectedSegmentRatio);
+  while (shard_max_size_bytes_ != 0 && shard.protected_size_bytes_ > protected_max_size_bytes &&
+         shard.protected_.size() > 1) {
+    ShardEntry& demoted = shard.protected_.back()->second;
+    demoted.segment_ = Segment::Probation;
+    shard.protected_size_bytes_ -= demoted.size_bytes_;
+    shard.probation_.splice(shard.probation_.begin(), shard.protected_,
+                            std::prev(shard.protected_.end()));
+  }
+}
+
+void SimpleHttpCache::erase(Shard& shard, EntryMap::iterator it) {
+  ShardEntry& entry = it->second;
+  if (entry.segment_ == Segment::Protected) {
+    shard.protected_.erase(entry.lru_position_);
+    shard.protected_size_bytes_ -= entry.size_bytes_;
+  } else {
+    shard.probation_.erase(entry.lru_position_);
+  }
+  shard.size_bytes_ -= entry.size_bytes_;
+  stats_.size_bytes_.sub(entry.size_bytes_);
+  stats_.entries_.dec();
+  shard.map_.erase(it);
+}
+
+void SimpleHttpCache::evict(Shard& shard) {
+  // Evict from the probationary segment first. The most recently inserted entry is at its front
+  // and is only evicted if nothing else is left.
+  const Key& victim = (shard.probation_.size() > 1 || shard.protected_.empty())
+                          ? shard.probation_.back()->first
+                          : shard.protected_.back()->first;
+  erase(shard, shard.map_.find(victim));
+  stats_.eviction_.inc();
+}
+
+SimpleHttpCache::Entry SimpleHttpCache::lookupEntry(const Key& key) {
+  Shard& shard = shardFor(key);
+  absl::MutexLock lock(shard.mutex_);
+  auto iter = shard.map_.find(key);
+  if (iter == shard.map_.end()) {
+    return Entry{};
+  }
+  touch(shard, iter->second);
+
+  const Entry& entry = iter->second.entry_;
+  ASSERT(entry.response_headers_);
+  Http::ResponseTrailerMapPtr trailers_map;
+  if (entry.trailers_) {
+    trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*entry.trailers_);
+  }
+  return SimpleHttpCache::Entry{
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry.response_headers_),
+      entry.metadata_, entry.body_, std::move(trailers_map)};
+}
+
+bool SimpleHttpCache::insertEntry(const Key& key, Entry&& entry) {
+  const uint64_t size_bytes = key.ByteSizeLong() + entry.response_headers_->byteSize() +
+                              entry.body_.size() +
+                              (entry.trailers_ ? entry.trailers_->byteSize() : 0) +
+                              sizeof(ShardEntry);
+  Shard& shard = shardFor(key);
+  absl::MutexLock lock(shard.mutex_);
+  auto existing = shard.map_.find(key);
+  if (existing != shard.map_.end()) {
+    erase(shard, existing);
+  }
+
+  if (shard_max_size_bytes_ != 0 && size_bytes > shard_max_size_bytes_) {
+    // Admitting the entry would flush the whole shard.
+    stats_.insert_rejected_.inc();
+    return false;
+  }
+
+  auto iter = shard.map_.try_emplace(key).first;
+  ShardEntry& shard_entry = iter->second;
+  shard_entry.entry_ = std::move(entry);
+  shard_entry.size_bytes_ = size_bytes;
+  shard_entry.segment_ = Segment::Probation;
+  shard.probation_.push_front(&*iter);
+  shard_entry.lru_position_ = shard.probation_.begin();
+  shard.size_bytes_ += size_bytes;
+  stats_.size_bytes_.add(size_bytes);
+  stats_.entries_.inc();
+  stats_.insert_.inc();
+
+  while (shard_max_size_bytes_ != 0 && shard.size_bytes_ > shard_max_size_bytes_) {
+    evict(shard);
+  }
+  return true;
+}
+
 LookupContextPtr SimpleHttpCache::makeLookupContext(LookupRequest&& request,
                                                     Http::StreamFilterCallbacks& callbacks) {
   return std::make_unique<SimpleLookupContext>(callbacks.dispatcher(), *this, std::move(request));
@@ -177,104 +329,72 @@ void SimpleHttpCache::updateHeaders(const LookupContext& lookup_context,
                                     const ResponseMetadata& metadata,
                                     UpdateHeadersCallback on_complete) {
   const auto& simple_lookup_context = static_cast<const SimpleLookupContext&>(lookup_context);
-  const Key& key = simple_lookup_context.request().key();
-  absl::WriterMutexLock lock(mutex_);
-  auto iter = map_.find(key);
   auto post_complete = [on_complete = std::move(on_complete),
                         &dispatcher = simple_lookup_context.dispatcher()](bool result) mutable {
     dispatcher.post([on_complete = std::move(on_complete), result]() mutable {
       std::move(on_complete)(result);
     });
   };
-  if (iter == map_.end() || !iter->second.response_headers_) {
-    std::move(post_complete)(false);
-    return;
-  }
-  if (VaryHeaderUtils::hasVary(*iter->second.response_headers_)) {
-    absl::optional<Key> varied_key =
-        variedRequestKey(simple_lookup_context.request(), *iter->second.response_headers_);
-    if (!varied_key.has_value()) {
-      std::move(post_complete)(false);
-      return;
+
+  // Applies the update to the entry for the key. Returns the varied key to update instead if the
+  // entry only flags that the response varies.
+  enum class UpdateResult { NotFound, Updated, Varied };
+  const auto update_entry = [&](const Key& key, absl::optional<Key>& varied_key) {
+    Shard& shard = shardFor(key);
+    absl::MutexLock lock(shard.mutex_);
+    auto iter = shard.map_.find(key);
+    if (iter == shard.map_.end() || !iter->second.entry_.response_headers_) {
+      return UpdateResult::NotFound;
     }
-    iter = map_.find(varied_key.value());
-    if (iter == map_.end() || !iter->second.response_headers_) {
-      std::move(post_complete)(false);
-      return;
+    Entry& entry = iter->second.entry_;
+    if (!varied_key.has_value() && VaryHeaderUtils::hasVary(*entry.response_headers_)) {
+      varied_key = variedRequestKey(simple_lookup_context.request(), *entry.response_headers_);
+      return varied_key.has_value() ? UpdateResult::Varied : UpdateResult::NotFound;
     }
-  }
-  Entry& entry = iter->second;
+    // The size estimate of the entry is not adjusted; header updates are assumed to be small.
+    applyHeaderUpdate(response_headers, *entry.response_headers_);
+    entry.metadata_ = metadata;
+    return UpdateResult::Updated;
+  };
 
-  applyHeaderUpdate(response_headers, *entry.response_headers_);
-  entry.metadata_ = metadata;
-  std::move(post_complete)(true);
+  absl::optional<Key> varied_key;
+  UpdateResult result = update_entry(simple_lookup_context.request().key(), varied_key);
+  if (result == UpdateResult::Varied) {
+    result = update_entry(varied_key.value(), varied_key);
+  }
+  std::move(post_complete)(result == UpdateResult::Updated);
 }
 
 SimpleHttpCache::Entry SimpleHttpCache::lookup(const LookupRequest& request) {
-  absl::ReaderMutexLock lock(mutex_);
-  auto iter = map_.find(request.key());
-  if (iter == map_.end()) {
-    return Entry{};
+  Entry entry = lookupEntry(request.key());
+  if (entry.response_headers_ && VaryHeaderUtils::hasVary(*entry.response_headers_)) {
+    // The entry only flags that the response varies; look up the varied response.
+    const absl::optional<Key> varied_key = variedRequestKey(request, *entry.response_headers_);
+    entry = varied_key.has_value() ? lookupEntry(varied_key.value()) : Entry{};
   }
-  ASSERT(iter->second.response_headers_);
-
-  if (VaryHeaderUtils::hasVary(*iter->second.response_headers_)) {
-    return varyLookup(request, iter->second.response_headers_);
+  if (entry.response_headers_) {
+    stats_.hit_.inc();
   } else {
-    Http::ResponseTrailerMapPtr trailers_map;
-    if (iter->second.trailers_) {
-      trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*iter->second.trailers_);
-    }
-    return SimpleHttpCache::Entry{
-        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-        iter->second.metadata_, iter->second.body_, std::move(trailers_map)};
+    stats_.miss_.inc();
   }
+  return entry;
 }
 
 bool SimpleHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
                              ResponseMetadata&& metadata, std::string&& body,
                              Http::ResponseTrailerMapPtr&& trailers) {
-  absl::WriterMutexLock lock(mutex_);
-  map_[key] = SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
-                                     std::move(body), std::move(trailers)};
+  insertEntry(key, SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
+                                          std::move(body), std::move(trailers)});
+  // A response that isn't admitted is not an insert failure; it is simply not cached.
   return true;
 }
 
-SimpleHttpCache::Entry
-SimpleHttpCache::varyLookup(const LookupRequest& request,
-                            const Http::ResponseHeaderMapPtr& response_headers) {
-  // This method should be called from lookup, which holds the mutex for reading.
-  mutex_.AssertReaderHeld();
-
-  absl::optional<Key> varied_key = variedRequestKey(request, *response_headers);
-  if (!varied_key.has_value()) {
-    return SimpleHttpCache::Entry{};
-  }
-  Key& varied_request_key = varied_key.value();
-
-  auto iter = map_.find(varied_request_key);
-  if (iter == map_.end()) {
-    return SimpleHttpCache::Entry{};
-  }
-  ASSERT(iter->second.response_headers_);
-  Http::ResponseTrailerMapPtr trailers_map;
-  if (iter->second.trailers_) {
-    trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*iter->second.trailers_);
-  }
-
-  return SimpleHttpCache::Entry{
-      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-      iter->second.metadata_, iter->second.body_, std::move(trailers_map)};
-}
-
 bool SimpleHttpCache::varyInsert(const Key& request_key,
                                  Http::ResponseHeaderMapPtr&& response_headers,
                                  ResponseMetadata&& metadata, std::string&& body,
                                  const Http::RequestHeaderMap& request_headers,
                                  const VaryAllowList& vary_allow_list,
                                  Http::ResponseTrailerMapPtr&& trailers) {
-  absl::WriterMutexLock lock(mutex_);
-
   absl::btree_set<absl::string_view> vary_header_values =
       VaryHeaderUtils::getVaryValues(*response_headers);
   ASSERT(!vary_header_values.empty());
@@ -287,26 +407,32 @@ bool SimpleHttpCache::varyInsert(const Key& request_key,
     // Skip the insert if we are unable to create a vary key.
     return false;
   }
+  // The vary values point into the response headers, which are moved into the cache below.
+  const std::string vary_value = absl::StrJoin(vary_header_values, ",");
 
   varied_request_key.add_custom_fields(vary_identifier.value());
-  map_[varied_request_key] = SimpleHttpCache::Entry{
-      std::move(response_headers), std::move(metadata), std::move(body), std::move(trailers)};
+  insertEntry(varied_request_key,
+              SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
+                                     std::move(body), std::move(trailers)});
 
   // Add a special entry to flag that this request generates varied responses.
-  auto iter = map_.find(request_key);
-  if (iter == map_.end()) {
-    Envoy::Http::ResponseHeaderMapPtr vary_only_map =
-        Envoy::Http::createHeaderMap<Envoy::Http::ResponseHeaderMapImpl>({});
-    vary_only_map->setCopy(Envoy::Http::CustomHeaders::get().Vary,
-                           absl::StrJoin(vary_header_values, ","));
-    // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
-    // we have inserted as the body for this first lookup. This way, we would know which keys we
-    // have inserted for that resource. For the first entry simply use vary_identifier as the
-    // entry_list; for future entries append vary_identifier to existing list.
-    std::string entry_list;
-    map_[request_key] =
-        SimpleHttpCache::Entry{std::move(vary_only_map), {}, std::move(entry_list), {}};
+  {
+    Shard& shard = shardFor(request_key);
+    absl::MutexLock lock(shard.mutex_);
+    if (shard.map_.contains(request_key)) {
+      return true;
+    }
   }
+  Envoy::Http::ResponseHeaderMapPtr vary_only_map =
+      Envoy::Http::createHeaderMap<Envoy::Http::ResponseHeaderMapImpl>({});
+  vary_only_map->setCopy(Envoy::Http::CustomHeaders::get().Vary, vary_value);
+  // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
+  // we have inserted as the body for this first lookup. This way, we would know which keys we
+  // have inserted for that resource. For the first entry simply use vary_identifier as the
+  // entry_list; for future entries append vary_identifier to existing list.
+  std::string entry_list;
+  insertEntry(request_key,
+              SimpleHttpCache::Entry{std::move(vary_only_map), {}, std::move(entry_list), {}});
   return true;
 }
 
@@ -327,6 +453,35 @@ CacheInfo SimpleHttpCache::cacheInfo() const {
   return cache_info;
 }
 
+/**
+ * A singleton handing out SimpleHttpCaches. Equivalent configs share one cache instance, while
+ * different configs get separate caches.
+ */
+class SimpleHttpCacheSingleton : public Singleton::Instance {
+public:
+  std::shared_ptr<SimpleHttpCache> get(std::shared_ptr<SimpleHttpCacheSingleton> singleton,
+                                       const SimpleHttpCache::ConfigProto& config,
+                                       Stats::Scope& scope) {
+    const uint64_t key = MessageUtil::hash(config);
+    absl::MutexLock lock(mu_);
+    std::shared_ptr<SimpleHttpCache> cache;
+    auto it = caches_.find(key);
+    if (it != caches_.end()) {
+      cache = it->second.lock();
+    }
+    if (cache == nullptr || !Protobuf::util::MessageDifferencer::Equals(cache->config(), config)) {
+      cache = std::make_shared<SimpleHttpCache>(config, scope, std::move(singleton));
+      caches_[key] = cache;
+    }
+    return cache;
+  }
+
+private:
+  absl::Mutex mu_;
+  // The caches keep the singleton alive, so it is only held weakly here.
+  absl::flat_hash_map<uint64_t, std::weak_ptr<SimpleHttpCache>> caches_ ABSL_GUARDED_BY(mu_);
+};
+
 SINGLETON_MANAGER_REGISTRATION(simple_http_cache_singleton);
 
 class SimpleHttpCacheFactory : public HttpCacheFactory {
@@ -335,20 +490,20 @@ public:
   std::string name() const override { return std::string(Name); }
   // From TypedFactory
   ProtobufTypes::MessagePtr createEmptyConfigProto() override {
-    return std::make_unique<
-        envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig>();
+    return std::make_unique<SimpleHttpCache::ConfigProto>();
   }
   // From HttpCacheFactory
   std::shared_ptr<HttpCache>
-  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig&,
+  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig& filter_config,
            Server::Configuration::FactoryContext& context) override {
-    return context.serverFactoryContext().singletonManager().getTyped<SimpleHttpCache>(
-        SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton), &createCache);
-  }
-
-private:
-  static std::shared_ptr<Singleton::Instance> createCache() {
-    return std::make_shared<SimpleHttpCache>();
+    SimpleHttpCache::ConfigProto config;
+    THROW_IF_NOT_OK(MessageUtil::unpackTo(filter_config.typed_config(), config));
+    std::shared_ptr<SimpleHttpCacheSingleton> caches =
+        context.serverFactoryContext().singletonManager().getTyped<SimpleHttpCacheSingleton>(
+            SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton),
+            [] { return std::make_shared<SimpleHttpCacheSingleton>(); });
+    // The cache is shared across listeners, so its stats live in the server scope.
+    return caches->get(caches, config, context.serverFactoryContext().scope());
   }
 };
 
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <list>
+
+#include "envoy/extensions/http/cache/simple_http_cache/v3/config.pb.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/stats/stats_macros.h"
+
 #include "source/common/protobuf/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/synchronization/mutex.h"
 
 namespace Envoy {
@@ -12,8 +20,28 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Cache {
 
-// Example cache backend that never evicts. Not suitable for production use.
-class SimpleHttpCache : public HttpCache, public Singleton::Instance {
+/**
+ * All simple http cache stats. @see stats_macros.h
+ */
+#define ALL_SIMPLE_HTTP_CACHE_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(eviction)                                                                                \
+  COUNTER(hit)                                                                                     \
+  COUNTER(insert)                                                                                  \
+  COUNTER(insert_rejected)                                                                         \
+  COUNTER(miss)                                                                                    \
+  GAUGE(entries, NeverImport)                                                                      \
+  GAUGE(size_bytes, NeverImport)
+
+/**
+ * Struct definition for all simple http cache stats. @see stats_macros.h
+ */
+struct SimpleHttpCacheStats {
+  ALL_SIMPLE_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+// In-memory cache backend. Entries are spread over lock-striped shards, each of which evicts
+// with a segmented LRU policy once the configured byte budget is exceeded.
+class SimpleHttpCache : public HttpCache {
 private:
   struct Entry {
     Http::ResponseHeaderMapPtr response_headers_;
@@ -22,9 +50,40 @@ private:
     Http::ResponseTrailerMapPtr trailers_;
   };
 
-  // Looks for a response that has been varied. Only called from lookup.
-  Entry varyLookup(const LookupRequest& request,
-                   const Http::ResponseHeaderMapPtr& response_headers);
+  // Segments of the segmented LRU. New entries are admitted to the probationary segment and
+  // promoted to the protected segment when they are hit again.
+  enum class Segment : uint8_t { Probation, Protected };
+  struct ShardEntry;
+  // The LRU lists point at the map nodes, which node_hash_map keeps at stable addresses.
+  using LruList = std::list<std::pair<const Key, ShardEntry>*>;
+
+  struct ShardEntry {
+    Entry entry_;
+    uint64_t size_bytes_{};
+    Segment segment_{Segment::Probation};
+    LruList::iterator lru_position_;
+  };
+
+  using EntryMap = absl::node_hash_map<Key, ShardEntry, MessageUtil, MessageUtil>;
+
+  struct Shard {
+    absl::Mutex mutex_;
+    EntryMap map_ ABSL_GUARDED_BY(mutex_);
+    // Most recently used entries are at the front.
+    LruList probation_ ABSL_GUARDED_BY(mutex_);
+    LruList protected_ ABSL_GUARDED_BY(mutex_);
+    uint64_t size_bytes_ ABSL_GUARDED_BY(mutex_){};
+    uint64_t protected_size_bytes_ ABSL_GUARDED_BY(mutex_){};
+  };
+
+  Shard& shardFor(const Key& key);
+  // Copies the entry for the key, marking it as used. Returns an empty entry if not found.
+  Entry lookupEntry(const Key& key);
+  // Returns true if the entry was admitted.
+  bool insertEntry(const Key& key, Entry&& entry);
+  void touch(Shard& shard, ShardEntry& entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+  void erase(Shard& shard, EntryMap::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+  void evict(Shard& shard) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
 
   // A list of headers that we do not want to update upon validation
   // We skip these headers because either it's updated by other application logic
@@ -33,6 +92,22 @@ private:
   static const absl::flat_hash_set<Http::LowerCaseString> headersNotToUpdate();
 
 public:
+  using ConfigProto = envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig;
+
+  static constexpr uint32_t DefaultShardCount = 16;
+  // Share of a shard's byte budget that may be used by the protected segment.
+  static constexpr double ProtectedSegmentRatio = 0.8;
+
+  // Creates an unbounded cache with the default shard count, recording stats in an isolated
+  // store.
+  SimpleHttpCache();
+  // @param owner keeps the singleton that hands out caches alive while the cache is in use.
+  SimpleHttpCache(const ConfigProto& config, Stats::Scope& scope,
+                  std::shared_ptr<Singleton::Instance> owner = nullptr);
+  ~SimpleHttpCache() override;
+
+  static SimpleHttpCacheStats generateStats(Stats::Scope& scope);
+
   // HttpCache
   LookupContextPtr makeLookupContext(LookupRequest&& request,
                                      Http::StreamFilterCallbacks& callbacks) override;
@@ -54,8 +129,18 @@ public:
                   const Http::RequestHeaderMap& request_headers,
                   const VaryAllowList& vary_allow_list, Http::ResponseTrailerMapPtr&& trailers);
 
-  absl::Mutex mutex_;
-  absl::flat_hash_map<Key, Entry, MessageUtil, MessageUtil> map_ ABSL_GUARDED_BY(mutex_);
+  const ConfigProto& config() const { return config_; }
+  const SimpleHttpCacheStats& stats() const { return stats_; }
+
+private:
+  const std::shared_ptr<Singleton::Instance> owner_;
+  const ConfigProto config_;
+  // Only set when constructed without a scope.
+  std::unique_ptr<Stats::IsolatedStoreImpl> isolated_store_;
+  SimpleHttpCacheStats stats_;
+  // Byte budget of each shard; 0 if the cache never evicts.
+  const uint64_t shard_max_size_bytes_;
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 } // namespace Cache
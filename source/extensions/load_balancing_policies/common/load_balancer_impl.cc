@@ -19,6 +19,7 @@
 #include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/fixed_array.h"
+#include "absl/hash/hash.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -44,6 +45,20 @@ bool hostWeightsAreEqual(const HostVector& hosts) {
   return true;
 }
 
+// Hashes the identity, order and weight of each host in a single pass, also reporting whether all
+// weights are equal so that callers do not need a second pass over the hosts.
+uint64_t hashHostsAndWeights(const HostVector& hosts, bool& weights_are_equal) {
+  weights_are_equal = true;
+  const uint32_t first_weight = hosts.empty() ? 0 : hosts[0]->weight();
+  uint64_t hash = absl::HashOf(hosts.size());
+  for (const auto& host : hosts) {
+    const uint32_t weight = host->weight();
+    weights_are_equal = weights_are_equal && weight == first_weight;
+    hash = absl::HashOf(hash, host.get(), weight);
+  }
+  return hash;
+}
+
 } // namespace
 
 std::pair<int32_t, size_t> distributeLoad(PriorityLoad& per_priority_load,
@@ -967,12 +982,15 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
                                          ? PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(
                                                slow_start_config.value(), min_weight_percent, 10) /
                                                100.0
-                                         : 0.1) {
+                                         : 0.1),
+      incremental_refresh_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.incremental_lb_host_source_refresh")) {
   // We fully recompute the schedulers for a given host set here on membership change, which is
   // consistent with what other LB implementations do (e.g. thread aware).
   // The downside of a full recompute is that time complexity is O(n * log n),
   // so we will need to do better at delta tracking to scale (see
-  // https://github.com/envoyproxy/envoy/issues/2874).
+  // https://github.com/envoyproxy/envoy/issues/2874). With incremental refresh enabled, only
+  // host sources whose hosts or weights changed are recomputed.
 
   if (Runtime::runtimeFeatureEnabled(
           "envoy.reloadable_features.coalesce_lb_rebuilds_on_batch_update")) {
@@ -1038,8 +1056,24 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
     return;
   }
   const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
+    // Slow start weights change over time, so those schedulers are always rebuilt.
+    absl::optional<uint64_t> hosts_hash;
+    bool weights_are_equal;
+    if (incremental_refresh_ && !isSlowStartEnabled()) {
+      hosts_hash = hashHostsAndWeights(hosts, weights_are_equal);
+      auto it = scheduler_.find(source);
+      if (it != scheduler_.end() && it->second.hosts_hash_ == hosts_hash) {
+        // Same hosts in the same order with the same weights: keep the existing schedule.
+        refreshHostSource(source);
+        return;
+      }
+    } else {
+      weights_are_equal = hostWeightsAreEqual(hosts);
+    }
+
     // Nuke existing scheduler if it exists.
     auto& scheduler = scheduler_[source] = Scheduler{};
+    scheduler.hosts_hash_ = hosts_hash;
     refreshHostSource(source);
     if (isSlowStartEnabled()) {
       recalculateHostsInSlowStart(hosts);
@@ -1049,7 +1083,7 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
     // case EDF creation is skipped. When all original weights are equal and no hosts are in slow
     // start mode we can rely on unweighted host pick to do optimal round robin and least-loaded
     // host selection with lower memory and CPU overhead.
-    if (hostWeightsAreEqual(hosts) && noHostsAreInSlowStart()) {
+    if (weights_are_equal && noHostsAreInSlowStart()) {
       // Skip edf creation.
       return;
     }
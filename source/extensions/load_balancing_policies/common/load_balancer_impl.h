@@ -532,6 +532,9 @@ protected:
     // host weights of 2 or more hosts differ. When not present, the
     // implementation of chooseHostOnce falls back to unweightedHostPick.
     std::unique_ptr<EdfScheduler<Host>> edf_;
+    // Hash of the hosts and their weights at the last rebuild. Only tracked when incremental
+    // refresh is enabled, so that host sources an update did not touch keep their schedule.
+    absl::optional<uint64_t> hosts_hash_;
   };
 
   void initialize();
@@ -566,6 +569,7 @@ private:
   Common::CallbackHandlePtr priority_update_cb_;
   Common::CallbackHandlePtr member_update_cb_;
   absl::flat_hash_set<uint32_t> dirty_priorities_;
+  const bool incremental_refresh_;
 
 protected:
   // Slow start related config
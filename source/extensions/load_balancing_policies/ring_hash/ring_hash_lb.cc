@@ -1,5 +1,6 @@
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <string>
@@ -62,7 +63,8 @@ RingHashLoadBalancer::RingHashLoadBalancer(const PrioritySet& priority_set, Clus
       hash_balance_factor_(config.has_consistent_hashing_lb_config()
                                ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(
                                      config.consistent_hashing_lb_config(), hash_balance_factor, 0)
-                               : PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, hash_balance_factor, 0)) {
+                               : PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, hash_balance_factor, 0)),
+      use_lookup_index_(config.use_lookup_index()) {
   // It's important to do any config validation here, rather than deferring to Ring's ctor,
   // because any exceptions thrown here will be caught and handled properly.
   if (min_ring_size_ > max_ring_size_) {
@@ -80,6 +82,19 @@ HostSelectionResponse RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_
     return {nullptr};
   }
 
+  uint64_t midp = bucket_start_.empty() ? binarySearch(h) : indexedSearch(h);
+
+  // If a retry host predicate is being applied, behave as if this host was not in the ring.
+  // Note that this does not guarantee a different host: e.g., attempt == ring_.size() or
+  // when the offset causes us to select the same host at another location in the ring.
+  if (attempt > 0) {
+    midp = (midp + attempt) % ring_.size();
+  }
+
+  return ring_[midp].host_;
+}
+
+uint64_t RingHashLoadBalancer::Ring::binarySearch(uint64_t h) const {
   // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c (ketama_get_server)
   // I've generally kept the variable names to make the code easier to compare.
   // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
@@ -114,21 +129,51 @@ HostSelectionResponse RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_
     }
   }
 
-  // If a retry host predicate is being applied, behave as if this host was not in the ring.
-  // Note that this does not guarantee a different host: e.g., attempt == ring_.size() or
-  // when the offset causes us to select the same host at another location in the ring.
-  if (attempt > 0) {
-    midp = (midp + attempt) % ring_.size();
+  return midp;
+}
+
+uint64_t RingHashLoadBalancer::Ring::indexedSearch(uint64_t h) const {
+  // The bucket table is sized so that buckets hold about one entry on average, which keeps this
+  // search to one or two cache lines of hashes_. When h is greater than every hash in its bucket,
+  // the search ends on bucket_start_[bucket + 1], which is the first entry of the next non-empty
+  // bucket or the end of the ring.
+  const uint64_t bucket = h >> bucket_shift_;
+  const auto begin = hashes_.begin() + bucket_start_[bucket];
+  const auto end = hashes_.begin() + bucket_start_[bucket + 1];
+  const uint64_t pos = std::lower_bound(begin, end, h) - hashes_.begin();
+  return pos == hashes_.size() ? 0 : pos;
+}
+
+void RingHashLoadBalancer::Ring::buildLookupIndex() {
+  uint32_t bits = 1;
+  while ((uint64_t(1) << bits) < ring_.size()) {
+    ++bits;
   }
+  bucket_shift_ = 64 - bits;
 
-  return ring_[midp].host_;
+  hashes_.reserve(ring_.size());
+  for (const auto& entry : ring_) {
+    hashes_.push_back(entry.hash_);
+  }
+
+  const uint64_t num_buckets = uint64_t(1) << bits;
+  bucket_start_.resize(num_buckets + 1);
+  uint64_t pos = 0;
+  for (uint64_t bucket = 0; bucket < num_buckets; ++bucket) {
+    while (pos < hashes_.size() && (hashes_[pos] >> bucket_shift_) < bucket) {
+      ++pos;
+    }
+    bucket_start_[bucket] = pos;
+  }
+  bucket_start_[num_buckets] = hashes_.size();
 }
 
 using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
 RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_host_weights,
                                  double min_normalized_weight, uint64_t min_ring_size,
                                  uint64_t max_ring_size, HashFunction hash_function,
-                                 bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats)
+                                 bool use_hostname_for_hashing, bool use_lookup_index,
+                                 RingHashLoadBalancerStats& stats)
     : stats_(stats) {
   ENVOY_LOG(trace, "ring hash: building ring");
 
@@ -217,6 +262,10 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     }
   }
 
+  if (use_lookup_index) {
+    buildLookupIndex();
+  }
+
   stats_.size_.set(ring_size);
   stats_.min_hashes_per_host_.set(min_hashes_per_host);
   stats_.max_hashes_per_host_.set(max_hashes_per_host);
@@ -79,13 +79,26 @@ private:
   struct Ring : public HashingLoadBalancer {
     Ring(const NormalizedHostWeightVector& normalized_host_weights, double min_normalized_weight,
          uint64_t min_ring_size, uint64_t max_ring_size, HashFunction hash_function,
-         bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats);
+         bool use_hostname_for_hashing, bool use_lookup_index, RingHashLoadBalancerStats& stats);
 
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostSelectionResponse chooseHost(uint64_t hash, uint32_t attempt) const override;
 
+    // Returns the position of the first ring entry whose hash is >= h, or 0 if there is none.
+    uint64_t binarySearch(uint64_t h) const;
+    uint64_t indexedSearch(uint64_t h) const;
+    void buildLookupIndex();
+
     std::vector<RingEntry> ring_;
 
+    // Optional lookup index. hashes_ is a flat copy of the sorted ring hashes, and
+    // bucket_start_[b] is the position of the first hash whose top bits are >= b, so the entry
+    // for a hash in bucket b is found in [bucket_start_[b], bucket_start_[b + 1]]. Both are
+    // empty when the index is disabled.
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> bucket_start_;
+    uint32_t bucket_shift_{64};
+
     RingHashLoadBalancerStats& stats_;
   };
   using RingConstSharedPtr = std::shared_ptr<const Ring>;
@@ -96,7 +109,8 @@ private:
                      double min_normalized_weight, double /* max_normalized_weight */) override {
     HashingLoadBalancerSharedPtr ring_hash_lb =
         std::make_shared<Ring>(normalized_host_weights, min_normalized_weight, min_ring_size_,
-                               max_ring_size_, hash_function_, use_hostname_for_hashing_, stats_);
+                               max_ring_size_, hash_function_, use_hostname_for_hashing_,
+                               use_lookup_index_, stats_);
     if (hash_balance_factor_ == 0) {
       return ring_hash_lb;
     }
@@ -117,6 +131,7 @@ private:
   const HashFunction hash_function_;
   const bool use_hostname_for_hashing_;
   const uint32_t hash_balance_factor_;
+  const bool use_lookup_index_;
 };
 
 } // namespace Upstream
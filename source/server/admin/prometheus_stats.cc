@@ -1,6 +1,7 @@
 #include "source/server/admin/prometheus_stats.h"
 
 #include <cmath>
+#include <limits>
 #include <map>
 #include <set>
 
@@ -121,15 +122,41 @@ public:
     // TextReadout stats are returned in gauge format, so "gauge" type is set intentionally.
     generateTypeOutput(output, "gauge", prefixed_tag_extracted_name);
 
+    std::string storage;
     for (const auto* text_readout : text_readouts) {
-      auto tags = text_readout->tags();
-      tags.push_back(Stats::Tag{"text_value", text_readout->value()});
-      const std::string formattedTags = PrometheusStatsFormatter::formattedTags(tags);
-      output.add(fmt::format("{0}{{{1}}} 0\n", prefixed_tag_extracted_name, formattedTags));
+      const absl::string_view tags = formattedTags(*text_readout, storage);
+      output.addFragments({prefixed_tag_extracted_name, "{", tags, tags.empty() ? "" : ",",
+                           "text_value=\"", sanitizeValue(text_readout->value()), "\"} 0\n"});
+    }
+  }
+
+  void setLabelCache(PrometheusLabelCache* label_cache) override {
+    label_cache_ = label_cache;
+    if (label_cache_ != nullptr) {
+      scrape_ = label_cache_->beginScrape();
+    }
+  }
+
+  void endScrape() override {
+    if (label_cache_ != nullptr) {
+      label_cache_->endScrape(scrape_);
     }
   }
 
 private:
+  // Returns the formatted tags of the metric, from the label cache when one is set. The view is
+  // only valid until the next call, and may refer to storage.
+  template <class StatType>
+  absl::string_view formattedTags(const StatType& metric, std::string& storage) const {
+    if constexpr (std::is_base_of_v<Stats::Metric, StatType>) {
+      if (label_cache_ != nullptr) {
+        return label_cache_->formattedTags(metric, scrape_);
+      }
+    }
+    storage = PrometheusStatsFormatter::formattedTags(metric.tags());
+    return storage;
+  }
+
   void generateTypeOutput(Buffer::Instance& output, absl::string_view type,
                           const std::string& prefixed_tag_extracted_name) const {
     output.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name, type));
@@ -150,10 +177,12 @@ private:
     }
 
     generateTypeOutput(output, type, prefixed_tag_extracted_name);
+    std::string storage;
     for (const auto* metric : metrics) {
-      const std::string formatted_tags = PrometheusStatsFormatter::formattedTags(metric->tags());
-      output.add(fmt::format("{0}{{{1}}} {2}\n", prefixed_tag_extracted_name, formatted_tags,
-                             metric->value()));
+      const absl::string_view formatted_tags = formattedTags(*metric, storage);
+      const absl::AlphaNum value(metric->value());
+      output.addFragments(
+          {prefixed_tag_extracted_name, "{", formatted_tags, "} ", value.Piece(), "\n"});
     }
   }
 
@@ -168,8 +197,9 @@ private:
     generateTypeOutput(output, "histogram", prefixed_tag_extracted_name);
 
     for (const auto* histogram : histograms) {
-      const std::string tags = PrometheusStatsFormatter::formattedTags(histogram->tags());
-      const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
+      std::string storage;
+      const std::string tags(formattedTags(*histogram, storage));
+      const std::string hist_tags = tags.empty() ? EMPTY_STRING : (tags + ",");
 
       const Stats::HistogramStatistics& stats = histogram->cumulativeStatistics();
       Stats::ConstSupportedBuckets& supported_buckets = stats.supportedBuckets();
@@ -206,8 +236,9 @@ private:
     generateTypeOutput(output, "summary", prefixed_tag_extracted_name);
 
     for (const auto* histogram : histograms) {
-      const std::string tags = PrometheusStatsFormatter::formattedTags(histogram->tags());
-      const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
+      std::string storage;
+      const std::string tags(formattedTags(*histogram, storage));
+      const std::string hist_tags = tags.empty() ? EMPTY_STRING : (tags + ",");
 
       const Stats::HistogramStatistics& stats = histogram->intervalStatistics();
       Stats::ConstSupportedBuckets& supported_quantiles = stats.supportedQuantiles();
@@ -225,6 +256,9 @@ private:
                              stats.sampleCount()));
     }
   }
+
+  PrometheusLabelCache* label_cache_{nullptr};
+  uint64_t scrape_{0};
 };
 
 class ProtobufFormat : public PrometheusStatsFormatter::OutputFormat {
@@ -634,142 +668,29 @@ private:
   uint32_t native_histogram_max_buckets_{kDefaultMaxNativeHistogramBuckets};
 };
 
-/**
- * Processes a stat type (counter, gauge, histogram) by generating all output lines, sorting
- * them by tag-extracted metric name, and then outputting them in the correct sorted order into
- * response.
- *
- * @param response The buffer to put the output into.
- * @param used_only Whether to only output stats that are used.
- * @param regex A filter on which stats to output.
- * @param metrics The metrics to output stats for. This must contain all stats of the given type
- *        to be included in the same output.
- * @param generate_output A function which returns the output text for this metric.
- * @param type The name of the prometheus metric type for used in TYPE annotations.
- */
-template <class StatType>
-uint64_t outputStatType(Buffer::Instance& response, const StatsParams& params,
-                        const std::vector<Stats::RefcountPtr<StatType>>& metrics,
-                        const PrometheusStatsFormatter::OutputFormat& output_format,
-                        const Stats::CustomStatNamespaces& custom_namespaces) {
-
-  /*
-   * From
-   * https://github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
-   *
-   * All lines for a given metric must be provided as one single group, with the optional HELP and
-   * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
-   * expositions is preferred but not required, i.e. do not sort if the computational cost is
-   * prohibitive.
-   */
-
-  // This is an unsorted collection of dumb-pointers (no need to increment then decrement every
-  // refcount; ownership is held throughout by `metrics`). It is unsorted for efficiency, but will
-  // be sorted before producing the final output to satisfy the "preferred" ordering from the
-  // prometheus spec: metrics will be sorted by their tags' textual representation, which will be
-  // consistent across calls.
-  using StatTypeUnsortedCollection = std::vector<const StatType*>;
-
-  // Return early to avoid crashing when getting the symbol table from the first metric.
-  if (metrics.empty()) {
-    return 0;
-  }
-
-  // There should only be one symbol table for all of the stats in the admin
-  // interface. If this assumption changes, the name comparisons in this function
-  // will have to change to compare to convert all StatNames to strings before
-  // comparison.
-  const Stats::SymbolTable& global_symbol_table = metrics.front()->constSymbolTable();
-
-  // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
-  // of the exposition format.
-  std::map<Stats::StatName, StatTypeUnsortedCollection, Stats::StatNameLessThan> groups(
-      global_symbol_table);
-
-  for (const auto& metric : metrics) {
-    ASSERT(&global_symbol_table == &metric->constSymbolTable());
-    if (!params.shouldShowMetric(*metric)) {
-      continue;
-    }
-    groups[metric->tagExtractedStatName()].push_back(metric.get());
-  }
-
-  auto result = groups.size();
-  for (auto& group : groups) {
-    const absl::optional<std::string> prefixed_tag_extracted_name =
-        PrometheusStatsFormatter::metricName(global_symbol_table.toString(group.first),
-                                             custom_namespaces);
-    if (!prefixed_tag_extracted_name.has_value()) {
-      --result;
-      continue;
-    }
-
-    // Sort before producing the final output to satisfy the "preferred" ordering from the
-    // prometheus spec: metrics will be sorted by their tags' textual representation, which will
-    // be consistent across calls.
-    std::sort(group.second.begin(), group.second.end(), MetricLessThan());
-
-    output_format.generateOutput(response, group.second, prefixed_tag_extracted_name.value());
-  }
-  return result;
-}
-
-template <class StatType, class OutputFormat>
-uint64_t outputPrimitiveStatType(Buffer::Instance& response, const StatsParams& params,
-                                 const std::vector<StatType>& metrics,
-                                 const OutputFormat& output_format,
-                                 const Stats::CustomStatNamespaces& custom_namespaces) {
-
-  /*
-   * From
-   * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
-   *
-   * All lines for a given metric must be provided as one single group, with the optional HELP and
-   * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
-   * expositions is preferred but not required, i.e. do not sort if the computational cost is
-   * prohibitive.
-   */
-
-  // This is an unsorted collection of dumb-pointers (no need to increment then decrement every
-  // refcount; ownership is held throughout by `metrics`). It is unsorted for efficiency, but will
-  // be sorted before producing the final output to satisfy the "preferred" ordering from the
-  // prometheus spec: metrics will be sorted by their tags' textual representation, which will be
-  // consistent across calls.
-  using StatTypeUnsortedCollection = std::vector<const StatType*>;
-
-  // Return early to avoid crashing when getting the symbol table from the first metric.
-  if (metrics.empty()) {
-    return 0;
-  }
+constexpr absl::string_view ProtobufContentType =
+    "application/vnd.google.protobuf; proto=io.prometheus.client.MetricFamily; encoding=delimited";
 
-  // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
-  // of the exposition format.
-  std::map<std::string, StatTypeUnsortedCollection> groups;
+PrometheusStatsFormatter::OutputFormat::HistogramType histogramType(const StatsParams& params) {
+  using HistogramType = PrometheusStatsFormatter::OutputFormat::HistogramType;
 
-  for (const auto& metric : metrics) {
-    if (!params.shouldShowMetric(metric)) {
-      continue;
-    }
-    groups[metric.tagExtractedName()].push_back(&metric);
-  }
-
-  auto result = groups.size();
-  for (auto& group : groups) {
-    const absl::optional<std::string> prefixed_tag_extracted_name =
-        PrometheusStatsFormatter::metricName(group.first, custom_namespaces);
-    if (!prefixed_tag_extracted_name.has_value()) {
-      --result;
-      continue;
-    }
-
-    // Sort before producing the final output to satisfy the "preferred" ordering from the
-    // prometheus spec: metrics will be sorted by their tags' textual representation, which will
-    // be consistent across calls.
-    std::sort(group.second.begin(), group.second.end(), PrimitiveMetricSnapshotLessThan());
-
-    output_format.generateOutput(response, group.second, prefixed_tag_extracted_name.value());
+  // Validation of bucket modes is handled separately.
+  switch (params.histogram_buckets_mode_) {
+  case Utility::HistogramBucketsMode::Summary:
+    return HistogramType::Summary;
+  case Utility::HistogramBucketsMode::Unset:
+  case Utility::HistogramBucketsMode::Cumulative:
+    return HistogramType::ClassicHistogram;
+  case Utility::HistogramBucketsMode::PrometheusNative:
+    return HistogramType::NativeHistogram;
+  // "Detailed" and "Disjoint" don't make sense for prometheus histogram semantics. These types were
+  // have been filtered out in validateParams().
+  case Utility::HistogramBucketsMode::Detailed:
+  case Utility::HistogramBucketsMode::Disjoint:
+    IS_ENVOY_BUG("unsupported prometheus histogram bucket mode");
+    break;
   }
-  return result;
+  return HistogramType::ClassicHistogram;
 }
 
 // Determine the format based on Accept header, using first-match priority.
@@ -887,63 +808,29 @@ uint64_t PrometheusStatsFormatter::generateWithOutputFormat(
     const Upstream::ClusterManager& cluster_manager, Buffer::Instance& response,
     const StatsParams& params, const Stats::CustomStatNamespaces& custom_namespaces,
     OutputFormat& output_format) {
+  output_format.setHistogramType(histogramType(params));
 
-  OutputFormat::HistogramType hist_type;
+  PrometheusStatsRenderer renderer(counters, gauges, histograms, text_readouts, cluster_manager,
+                                   params, custom_namespaces, output_format);
+  renderer.nextChunk(response, std::numeric_limits<uint64_t>::max());
+  return renderer.metricNameCount();
+}
 
-  // Validation of bucket modes is handled separately.
-  switch (params.histogram_buckets_mode_) {
-  case Utility::HistogramBucketsMode::Summary:
-    hist_type = OutputFormat::HistogramType::Summary;
-    break;
-  case Utility::HistogramBucketsMode::Unset:
-  case Utility::HistogramBucketsMode::Cumulative:
-    hist_type = OutputFormat::HistogramType::ClassicHistogram;
-    break;
-  case Utility::HistogramBucketsMode::PrometheusNative:
-    hist_type = OutputFormat::HistogramType::NativeHistogram;
-    break;
-  // "Detailed" and "Disjoint" don't make sense for prometheus histogram semantics. These types were
-  // have been filtered out in validateParams().
-  case Utility::HistogramBucketsMode::Detailed:
-  case Utility::HistogramBucketsMode::Disjoint:
-    hist_type = OutputFormat::HistogramType::ClassicHistogram;
-    IS_ENVOY_BUG("unsupported prometheus histogram bucket mode");
-    break;
+PrometheusStatsFormatter::OutputFormatPtr
+PrometheusStatsFormatter::makeOutputFormat(const StatsParams& params,
+                                           const Http::RequestHeaderMap& request_headers,
+                                           Http::ResponseHeaderMap& response_headers,
+                                           PrometheusLabelCache* label_cache) {
+  OutputFormatPtr output_format;
+  if (useProtobufFormat(params, request_headers)) {
+    response_headers.setReferenceContentType(ProtobufContentType);
+    output_format = std::make_unique<ProtobufFormat>(params.native_histogram_max_buckets_);
+  } else {
+    output_format = std::make_unique<TextFormat>();
   }
-
-  output_format.setHistogramType(hist_type);
-
-  uint64_t metric_name_count = 0;
-  metric_name_count +=
-      outputStatType<Stats::Counter>(response, params, counters, output_format, custom_namespaces);
-
-  metric_name_count +=
-      outputStatType<Stats::Gauge>(response, params, gauges, output_format, custom_namespaces);
-
-  metric_name_count += outputStatType<Stats::TextReadout>(response, params, text_readouts,
-                                                          output_format, custom_namespaces);
-
-  metric_name_count += outputStatType<Stats::ParentHistogram>(response, params, histograms,
-                                                              output_format, custom_namespaces);
-
-  // Note: This assumes that there is no overlap in stat name between per-endpoint stats and all
-  // other stats. If this is not true, then the counters/gauges for per-endpoint need to be combined
-  // with the above counter/gauge calls so that stats can be properly grouped.
-  std::vector<Stats::PrimitiveCounterSnapshot> host_counters;
-  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges;
-  Upstream::HostUtility::forEachHostMetric(
-      cluster_manager,
-      [&](Stats::PrimitiveCounterSnapshot&& metric) {
-        host_counters.emplace_back(std::move(metric));
-      },
-      [&](Stats::PrimitiveGaugeSnapshot&& metric) { host_gauges.emplace_back(std::move(metric)); });
-
-  metric_name_count +=
-      outputPrimitiveStatType(response, params, host_counters, output_format, custom_namespaces);
-  metric_name_count +=
-      outputPrimitiveStatType(response, params, host_gauges, output_format, custom_namespaces);
-
-  return metric_name_count;
+  output_format->setHistogramType(histogramType(params));
+  output_format->setLabelCache(label_cache);
+  return output_format;
 }
 
 uint64_t PrometheusStatsFormatter::statsAsPrometheusText(
@@ -968,9 +855,7 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheusProtobuf(
     Buffer::Instance& response, const StatsParams& params,
     const Stats::CustomStatNamespaces& custom_namespaces) {
 
-  response_headers.setReferenceContentType(
-      "application/vnd.google.protobuf; "
-      "proto=io.prometheus.client.MetricFamily; encoding=delimited");
+  response_headers.setReferenceContentType(ProtobufContentType);
 
   ProtobufFormat output_format(params.native_histogram_max_buckets_);
   return generateWithOutputFormat(counters, gauges, histograms, text_readouts, cluster_manager,
@@ -994,5 +879,232 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
                                      response, params, custom_namespaces);
 }
 
+PrometheusLabelCache::PrometheusLabelCache(Stats::SymbolTable& symbol_table)
+    : symbol_table_(symbol_table) {}
+
+PrometheusLabelCache::~PrometheusLabelCache() {
+  for (auto& entry : entries_) {
+    entry.second.name_.free(symbol_table_);
+  }
+}
+
+absl::string_view PrometheusLabelCache::formattedTags(const Stats::Metric& metric,
+                                                      uint64_t scrape) {
+  ASSERT(&metric.constSymbolTable() == &symbol_table_);
+  auto it = entries_.find(metric.statName());
+  if (it == entries_.end()) {
+    Stats::StatNameStorage name(metric.statName(), symbol_table_);
+    const Stats::StatName key = name.statName();
+    it = entries_
+             .try_emplace(key, std::move(name),
+                          PrometheusStatsFormatter::formattedTags(metric.tags()), scrape)
+             .first;
+  } else {
+    // An older scrape which is still rendering must not hide a newer one's use.
+    it->second.last_scrape_ = std::max(it->second.last_scrape_, scrape);
+  }
+  return it->second.formatted_tags_;
+}
+
+void PrometheusLabelCache::endScrape(uint64_t scrape) {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.last_scrape_ >= scrape) {
+      ++it;
+    } else {
+      it->second.name_.free(symbol_table_);
+      entries_.erase(it++);
+    }
+  }
+}
+
+PrometheusStatsRenderer::PrometheusStatsRenderer(
+    const std::vector<Stats::CounterSharedPtr>& counters,
+    const std::vector<Stats::GaugeSharedPtr>& gauges,
+    const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
+    const std::vector<Stats::TextReadoutSharedPtr>& text_readouts,
+    const Upstream::ClusterManager& cluster_manager, const StatsParams& params,
+    const Stats::CustomStatNamespaces& custom_namespaces,
+    PrometheusStatsFormatter::OutputFormat& output_format)
+    : counters_(counters), gauges_(gauges), histograms_(histograms),
+      text_readouts_(text_readouts), cluster_manager_(cluster_manager), params_(params),
+      custom_namespaces_(custom_namespaces), output_format_(output_format) {}
+
+bool PrometheusStatsRenderer::nextChunk(Buffer::Instance& response, uint64_t chunk_size) {
+  // Like StatsRequest::nextChunk(), this may add somewhat more than chunk_size bytes, as each
+  // metric group is rendered as a whole.
+  const uint64_t starting_response_length = response.length();
+  while (response.length() - starting_response_length < chunk_size) {
+    if (next_group_ < groups_.size()) {
+      groups_[next_group_++](response);
+    } else if (phase_ == Phase::Done) {
+      return false;
+    } else {
+      loadNextPhase();
+    }
+  }
+  return true;
+}
+
+void PrometheusStatsRenderer::loadNextPhase() {
+  groups_.clear();
+  next_group_ = 0;
+  switch (phase_) {
+  case Phase::Counters:
+    addGroups(counters_);
+    phase_ = Phase::Gauges;
+    break;
+  case Phase::Gauges:
+    addGroups(gauges_);
+    phase_ = Phase::TextReadouts;
+    break;
+  case Phase::TextReadouts:
+    addGroups(text_readouts_);
+    phase_ = Phase::Histograms;
+    break;
+  case Phase::Histograms:
+    addGroups(histograms_);
+    phase_ = Phase::HostCounters;
+    break;
+  case Phase::HostCounters:
+    // Note: This assumes that there is no overlap in stat name between per-endpoint stats and all
+    // other stats. If this is not true, then the counters/gauges for per-endpoint need to be
+    // combined with the above counter/gauge groups so that stats can be properly grouped.
+    Upstream::HostUtility::forEachHostMetric(
+        cluster_manager_,
+        [this](Stats::PrimitiveCounterSnapshot&& metric) {
+          host_counters_.emplace_back(std::move(metric));
+        },
+        [this](Stats::PrimitiveGaugeSnapshot&& metric) {
+          host_gauges_.emplace_back(std::move(metric));
+        });
+    addPrimitiveGroups(host_counters_);
+    phase_ = Phase::HostGauges;
+    break;
+  case Phase::HostGauges:
+    addPrimitiveGroups(host_gauges_);
+    phase_ = Phase::Done;
+    // All the stats that can have cached labels have been rendered by now. Only a scrape which
+    // rendered every metric shows which cached labels are no longer needed.
+    if (params_.re2_filter_ == nullptr && !params_.used_only_ &&
+        params_.hidden_ != HiddenFlag::ShowOnly) {
+      output_format_.endScrape();
+    }
+    break;
+  case Phase::Done:
+    break;
+  }
+}
+
+/**
+ * Groups a stat type (counter, gauge, text readout, histogram) by tag-extracted metric name, and
+ * queues the groups for rendering in sorted order.
+ *
+ * @param metrics The metrics to output stats for. This must contain all stats of the given type
+ *        to be included in the same output.
+ */
+template <class StatType>
+void PrometheusStatsRenderer::addGroups(const std::vector<Stats::RefcountPtr<StatType>>& metrics) {
+
+  /*
+   * From
+   * https://github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
+   *
+   * All lines for a given metric must be provided as one single group, with the optional HELP and
+   * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
+   * expositions is preferred but not required, i.e. do not sort if the computational cost is
+   * prohibitive.
+   */
+
+  // This is an unsorted collection of dumb-pointers (no need to increment then decrement every
+  // refcount; ownership is held throughout by `metrics`). It is unsorted for efficiency, but will
+  // be sorted before producing the final output to satisfy the "preferred" ordering from the
+  // prometheus spec: metrics will be sorted by their tags' textual representation, which will be
+  // consistent across calls.
+  using StatTypeUnsortedCollection = std::vector<const StatType*>;
+
+  // Return early to avoid crashing when getting the symbol table from the first metric.
+  if (metrics.empty()) {
+    return;
+  }
+
+  // There should only be one symbol table for all of the stats in the admin
+  // interface. If this assumption changes, the name comparisons in this function
+  // will have to change to compare to convert all StatNames to strings before
+  // comparison.
+  const Stats::SymbolTable& global_symbol_table = metrics.front()->constSymbolTable();
+
+  // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
+  // of the exposition format.
+  std::map<Stats::StatName, StatTypeUnsortedCollection, Stats::StatNameLessThan> groups(
+      global_symbol_table);
+
+  for (const auto& metric : metrics) {
+    ASSERT(&global_symbol_table == &metric->constSymbolTable());
+    if (!params_.shouldShowMetric(*metric)) {
+      continue;
+    }
+    groups[metric->tagExtractedStatName()].push_back(metric.get());
+  }
+
+  groups_.reserve(groups.size());
+  for (auto& group : groups) {
+    absl::optional<std::string> prefixed_tag_extracted_name =
+        PrometheusStatsFormatter::metricName(global_symbol_table.toString(group.first),
+                                             custom_namespaces_);
+    if (!prefixed_tag_extracted_name.has_value()) {
+      continue;
+    }
+    ++metric_name_count_;
+
+    // Sort before producing the final output to satisfy the "preferred" ordering from the
+    // prometheus spec: metrics will be sorted by their tags' textual representation, which will
+    // be consistent across calls.
+    std::sort(group.second.begin(), group.second.end(), MetricLessThan());
+
+    groups_.push_back([this, name = std::move(prefixed_tag_extracted_name.value()),
+                       group_metrics = std::move(group.second)](Buffer::Instance& response) {
+      output_format_.generateOutput(response, group_metrics, name);
+    });
+  }
+}
+
+template <class StatType>
+void PrometheusStatsRenderer::addPrimitiveGroups(const std::vector<StatType>& metrics) {
+  // See addGroups() for the grouping and sorting requirements.
+  using StatTypeUnsortedCollection = std::vector<const StatType*>;
+
+  if (metrics.empty()) {
+    return;
+  }
+
+  // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
+  // of the exposition format.
+  std::map<std::string, StatTypeUnsortedCollection> groups;
+
+  for (const auto& metric : metrics) {
+    if (!params_.shouldShowMetric(metric)) {
+      continue;
+    }
+    groups[metric.tagExtractedName()].push_back(&metric);
+  }
+
+  groups_.reserve(groups.size());
+  for (auto& group : groups) {
+    absl::optional<std::string> prefixed_tag_extracted_name =
+        PrometheusStatsFormatter::metricName(group.first, custom_namespaces_);
+    if (!prefixed_tag_extracted_name.has_value()) {
+      continue;
+    }
+    ++metric_name_count_;
+
+    std::sort(group.second.begin(), group.second.end(), PrimitiveMetricSnapshotLessThan());
+
+    groups_.push_back([this, name = std::move(prefixed_tag_extracted_name.value()),
+                       group_metrics = std::move(group.second)](Buffer::Instance& response) {
+      output_format_.generateOutput(response, group_metrics, name);
+    });
+  }
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -1,16 +1,72 @@
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
 #include "envoy/stats/custom_stat_namespaces.h"
 #include "envoy/stats/histogram.h"
+#include "envoy/stats/primitive_stats.h"
 #include "envoy/stats/stats.h"
 
+#include "source/common/stats/symbol_table.h"
 #include "source/server/admin/stats_params.h"
 
 namespace Envoy {
 namespace Server {
+
+/**
+ * Caches the rendered Prometheus labels of each metric across scrapes, so that a steady-state
+ * scrape does not rebuild and sanitize the tags of every metric. Entries are keyed by the full
+ * stat name of the metric, which determines its tags. Stats created since the previous scrape are
+ * added when first rendered. The entries of stats that a scrape of all metrics did not render,
+ * such as deleted ones, are dropped at its end; filtered scrapes only add entries. Scrapes may
+ * overlap. Must only be used from the main thread.
+ */
+class PrometheusLabelCache {
+public:
+  explicit PrometheusLabelCache(Stats::SymbolTable& symbol_table);
+  ~PrometheusLabelCache();
+
+  /**
+   * @return the id of a new scrape, to be passed to formattedTags() and endScrape().
+   */
+  uint64_t beginScrape() { return ++last_scrape_; }
+
+  /**
+   * @return the tags of the metric formatted as by PrometheusStatsFormatter::formattedTags(). The
+   *         view is only valid until the next call.
+   */
+  absl::string_view formattedTags(const Stats::Metric& metric, uint64_t scrape);
+
+  /**
+   * Drops the entries of metrics that have not been rendered since the scrape began.
+   * @param scrape the id of a scrape which rendered all metrics.
+   */
+  void endScrape(uint64_t scrape);
+
+  uint64_t size() const { return entries_.size(); }
+
+private:
+  struct Entry {
+    Entry(Stats::StatNameStorage&& name, std::string&& formatted_tags, uint64_t scrape)
+        : name_(std::move(name)), formatted_tags_(std::move(formatted_tags)),
+          last_scrape_(scrape) {}
+
+    Stats::StatNameStorage name_;
+    std::string formatted_tags_;
+    // The latest scrape which rendered the metric.
+    uint64_t last_scrape_;
+  };
+
+  Stats::SymbolTable& symbol_table_;
+  // Keys refer to the name_ storage of their entry, which also keeps the symbols referenced.
+  Stats::StatNameHashMap<Entry> entries_;
+  uint64_t last_scrape_{0};
+};
+
 /**
  * Formatter for metric/labels exported to Prometheus.
  *
@@ -34,6 +90,12 @@ public:
 
     HistogramType histogramType() const { return histogram_type_; }
 
+    // Renders metric labels through the given cache, for formats that support it.
+    virtual void setLabelCache(PrometheusLabelCache*) {}
+
+    // Called at the end of a scrape which rendered all metrics.
+    virtual void endScrape() {}
+
     // Return the prometheus output for a group of Counters.
     virtual void generateOutput(Buffer::Instance& output,
                                 const std::vector<const Stats::Counter*>& counters,
@@ -68,6 +130,18 @@ public:
     HistogramType histogram_type_;
   };
 
+  using OutputFormatPtr = std::unique_ptr<OutputFormat>;
+
+  /**
+   * Creates the output format selected by the request headers and params, setting the content
+   * type of the response for the protobuf format.
+   * @param label_cache if non-null, used by the text format to render metric labels.
+   */
+  static OutputFormatPtr makeOutputFormat(const StatsParams& params,
+                                          const Http::RequestHeaderMap& request_headers,
+                                          Http::ResponseHeaderMap& response_headers,
+                                          PrometheusLabelCache* label_cache);
+
   /**
    * Extracts counters and gauges and relevant tags, appending them to
    * the response buffer after sanitizing the metric / label names.
@@ -136,5 +210,60 @@ public:
              const Stats::CustomStatNamespaces& custom_namespace_factory);
 };
 
+/**
+ * Renders stats in a Prometheus exposition format one metric group at a time, so that a scrape
+ * can be streamed in chunks rather than rendered into a single buffer. The stat vectors, cluster
+ * manager, params, namespaces and output format must outlive the renderer.
+ */
+class PrometheusStatsRenderer {
+public:
+  PrometheusStatsRenderer(const std::vector<Stats::CounterSharedPtr>& counters,
+                          const std::vector<Stats::GaugeSharedPtr>& gauges,
+                          const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
+                          const std::vector<Stats::TextReadoutSharedPtr>& text_readouts,
+                          const Upstream::ClusterManager& cluster_manager,
+                          const StatsParams& params,
+                          const Stats::CustomStatNamespaces& custom_namespaces,
+                          PrometheusStatsFormatter::OutputFormat& output_format);
+
+  /**
+   * Renders whole metric groups into response until at least chunk_size bytes have been added or
+   * all stats have been rendered.
+   * @return true if there is more to render.
+   */
+  bool nextChunk(Buffer::Instance& response, uint64_t chunk_size);
+
+  /**
+   * @return the number of metric groups rendered or queued for rendering so far.
+   */
+  uint64_t metricNameCount() const { return metric_name_count_; }
+
+private:
+  // The next type of stats to group for rendering.
+  enum class Phase { Counters, Gauges, TextReadouts, Histograms, HostCounters, HostGauges, Done };
+  using GroupRenderer = std::function<void(Buffer::Instance&)>;
+
+  void loadNextPhase();
+  template <class StatType>
+  void addGroups(const std::vector<Stats::RefcountPtr<StatType>>& metrics);
+  template <class StatType> void addPrimitiveGroups(const std::vector<StatType>& metrics);
+
+  const std::vector<Stats::CounterSharedPtr>& counters_;
+  const std::vector<Stats::GaugeSharedPtr>& gauges_;
+  const std::vector<Stats::ParentHistogramSharedPtr>& histograms_;
+  const std::vector<Stats::TextReadoutSharedPtr>& text_readouts_;
+  const Upstream::ClusterManager& cluster_manager_;
+  const StatsParams& params_;
+  const Stats::CustomStatNamespaces& custom_namespaces_;
+  PrometheusStatsFormatter::OutputFormat& output_format_;
+  std::vector<Stats::PrimitiveCounterSnapshot> host_counters_;
+  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges_;
+  // Groups of the current phase, rendered in order.
+  std::vector<GroupRenderer> groups_;
+  size_t next_group_{0};
+  Phase phase_{Phase::Counters};
+  uint64_t metric_name_count_{0};
+};
+
 } // namespace Server
 } // namespace Envoy
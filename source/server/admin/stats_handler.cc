@@ -1,6 +1,7 @@
 #include "source/server/admin/stats_handler.h"
 
 #include <functional>
+#include <limits>
 #include <vector>
 
 #include "envoy/admin/v3/mutex_stats.pb.h"
@@ -21,34 +22,75 @@ namespace Server {
 const uint64_t RecentLookupsCapacity = 100;
 
 namespace {
-// Implements a chunked request for Prometheus stats.
+// Implements a chunked request for Prometheus stats, rendering a chunk's worth of metric groups
+// at a time.
 class PrometheusRequest : public Admin::Request {
 public:
-  PrometheusRequest(StatsHandler& handler, const StatsParams& params, AdminStream& admin_stream)
-      : handler_(handler), params_(params), admin_stream_(admin_stream) {}
+  PrometheusRequest(Server::Instance& server, const StatsParams& params, AdminStream& admin_stream,
+                    PrometheusLabelCache& label_cache)
+      : server_(server), params_(params), admin_stream_(admin_stream), label_cache_(label_cache) {}
 
   Http::Code start(Http::ResponseHeaderMap& response_headers) override {
-    code_ = handler_.prometheusFlushAndRender(params_, admin_stream_.getRequestHeaders(),
-                                              response_headers, response_);
-    return code_;
+    const Http::RequestHeaderMap& request_headers = admin_stream_.getRequestHeaders();
+    absl::Status paramsStatus = PrometheusStatsFormatter::validateParams(params_, request_headers);
+    if (!paramsStatus.ok()) {
+      response_.add(paramsStatus.message());
+      return Http::Code::BadRequest;
+    }
+    if (server_.statsConfig().flushOnAdmin()) {
+      server_.flushStats();
+    }
+
+    // Hold references to the stats for the duration of the request, as the renderer only keeps
+    // pointers to them.
+    Stats::Store& stats = server_.stats();
+    counters_ = stats.counters();
+    gauges_ = stats.gauges();
+    histograms_ = stats.histograms();
+    if (params_.prometheus_text_readouts_) {
+      text_readouts_ = stats.textReadouts();
+    }
+    output_format_ = PrometheusStatsFormatter::makeOutputFormat(params_, request_headers,
+                                                                response_headers, &label_cache_);
+    renderer_ = std::make_unique<PrometheusStatsRenderer>(
+        counters_, gauges_, histograms_, text_readouts_, server_.clusterManager(), params_,
+        server_.api().customStatNamespaces(), *output_format_);
+    return Http::Code::OK;
   }
 
   bool nextChunk(Buffer::Instance& response) override {
-    response.move(response_);
-    return false;
+    if (renderer_ == nullptr) {
+      response.move(response_);
+      return false;
+    }
+    return renderer_->nextChunk(response, StatsRequest::DefaultChunkSize);
   }
 
 private:
-  StatsHandler& handler_;
+  Server::Instance& server_;
   const StatsParams params_;
   AdminStream& admin_stream_;
+  PrometheusLabelCache& label_cache_;
   Buffer::OwnedImpl response_;
-  Http::Code code_{Http::Code::OK};
+  std::vector<Stats::CounterSharedPtr> counters_;
+  std::vector<Stats::GaugeSharedPtr> gauges_;
+  std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+  std::vector<Stats::TextReadoutSharedPtr> text_readouts_;
+  PrometheusStatsFormatter::OutputFormatPtr output_format_;
+  std::unique_ptr<PrometheusStatsRenderer> renderer_;
 };
 } // namespace
 
 StatsHandler::StatsHandler(Server::Instance& server) : HandlerContextBase(server) {}
 
+PrometheusLabelCache& StatsHandler::prometheusLabelCache() {
+  if (prometheus_label_cache_ == nullptr) {
+    prometheus_label_cache_ =
+        std::make_unique<PrometheusLabelCache>(server_.stats().symbolTable());
+  }
+  return *prometheus_label_cache_;
+}
+
 Http::Code StatsHandler::handlerResetCounters(Http::ResponseHeaderMap&, Buffer::Instance& response,
                                               AdminStream&) {
   for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
@@ -107,14 +149,8 @@ Admin::RequestPtr StatsHandler::makeRequest(AdminStream& admin_stream) {
   }
 
   if (params.format_ == StatsFormat::Prometheus) {
-    // TODO(#16139): modify streaming algorithm to cover Prometheus.
-    //
-    // This may be easiest to accomplish by populating the set
-    // with tagExtractedName(), and allowing for vectors of
-    // stats as multiples will have the same tag-extracted names.
-    // Ideally we'd find a way to do this without slowing down
-    // the non-Prometheus implementations.
-    return std::make_unique<PrometheusRequest>(*this, params, admin_stream);
+    return std::make_unique<PrometheusRequest>(server_, params, admin_stream,
+                                               prometheusLabelCache());
   }
 
   if (params.histogram_buckets_mode_ == Utility::HistogramBucketsMode::PrometheusNative) {
@@ -174,7 +210,7 @@ Http::Code StatsHandler::prometheusFlushAndRender(const StatsParams& params,
     server_.flushStats();
   }
   prometheusRender(server_.stats(), server_.api().customStatNamespaces(), server_.clusterManager(),
-                   params, request_headers, response_headers, response);
+                   params, request_headers, response_headers, response, &prometheusLabelCache());
   return Http::Code::OK;
 }
 
@@ -184,13 +220,20 @@ void StatsHandler::prometheusRender(Stats::Store& stats,
                                     const StatsParams& params,
                                     const Http::RequestHeaderMap& request_headers,
                                     Http::ResponseHeaderMap& response_headers,
-                                    Buffer::Instance& response) {
+                                    Buffer::Instance& response,
+                                    PrometheusLabelCache* label_cache) {
   const std::vector<Stats::TextReadoutSharedPtr>& text_readouts_vec =
       params.prometheus_text_readouts_ ? stats.textReadouts()
                                        : std::vector<Stats::TextReadoutSharedPtr>();
-  PrometheusStatsFormatter::statsAsPrometheus(
-      stats.counters(), stats.gauges(), stats.histograms(), text_readouts_vec, cluster_manager,
-      request_headers, response_headers, response, params, custom_namespaces);
+  const std::vector<Stats::CounterSharedPtr> counters = stats.counters();
+  const std::vector<Stats::GaugeSharedPtr> gauges = stats.gauges();
+  const std::vector<Stats::ParentHistogramSharedPtr> histograms = stats.histograms();
+  PrometheusStatsFormatter::OutputFormatPtr output_format =
+      PrometheusStatsFormatter::makeOutputFormat(params, request_headers, response_headers,
+                                                 label_cache);
+  PrometheusStatsRenderer renderer(counters, gauges, histograms, text_readouts_vec,
+                                   cluster_manager, params, custom_namespaces, *output_format);
+  renderer.nextChunk(response, std::numeric_limits<uint64_t>::max());
 }
 
 Http::Code StatsHandler::handlerContention(Http::ResponseHeaderMap& response_headers,
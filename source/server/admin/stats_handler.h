@@ -10,6 +10,7 @@
 #include "envoy/server/instance.h"
 
 #include "source/server/admin/handler_ctx.h"
+#include "source/server/admin/prometheus_stats.h"
 #include "source/server/admin/stats_request.h"
 #include "source/server/admin/utils.h"
 
@@ -68,12 +69,14 @@ public:
    * @param custom_namespaces namespace mappings used for prometheus
    * @params params the already-parsed parameters.
    * @param response buffer into which to write response
+   * @param label_cache if non-null, caches the rendered labels of metrics across calls
    */
   static void
   prometheusRender(Stats::Store& stats, const Stats::CustomStatNamespaces& custom_namespaces,
                    const Upstream::ClusterManager& cluster_manager, const StatsParams& params,
                    const Http::RequestHeaderMap& request_headers,
-                   Http::ResponseHeaderMap& response_headers, Buffer::Instance& response);
+                   Http::ResponseHeaderMap& response_headers, Buffer::Instance& response,
+                   PrometheusLabelCache* label_cache = nullptr);
 
   Http::Code handlerContention(Http::ResponseHeaderMap& response_headers,
                                Buffer::Instance& response, AdminStream&);
@@ -96,6 +99,12 @@ public:
                                        const Upstream::ClusterManager& cm,
                                        StatsRequest::UrlHandlerFn url_handler_fn = nullptr);
   Admin::RequestPtr makeRequest(AdminStream&);
+
+private:
+  // Created on first use, so that servers which are never scraped do not hold rendered labels.
+  PrometheusLabelCache& prometheusLabelCache();
+
+  std::unique_ptr<PrometheusLabelCache> prometheus_label_cache_;
 };
 
 } // namespace Server
@@ -550,6 +550,11 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
       bootstrap_.stats_config(), stats_store_.symbolTable(), server_contexts_));
   stats_store_.setHistogramSettings(
       std::make_unique<Stats::HistogramSettingsImpl>(bootstrap_.stats_config(), server_contexts_));
+  if (bootstrap_.stats_config().has_sharded_counters_matcher()) {
+    stats_store_.setShardedCounterMatcher(std::make_unique<Stats::StatsMatcherImpl>(
+        bootstrap_.stats_config().sharded_counters_matcher(), stats_store_.symbolTable(),
+        server_contexts_));
+  }
 
   const std::string server_stats_prefix = "server.";
   const std::string server_compilation_settings_stats_prefix = "server.compilation_settings";
@@ -1,5 +1,7 @@
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "source/common/access_log/access_log_manager_impl.h"
 #include "source/common/filesystem/file_shared_impl.h"
@@ -12,6 +14,9 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -171,8 +176,8 @@ TEST_F(AccessLogManagerImplTest, FlushToLogFileOnDemand) {
   EXPECT_EQ(0UL, store_.counter("filesystem.flushed_by_timer").value());
 
   // The first write to a given file will start the flush thread. Because AccessManagerImpl::write
-  // holds the write_lock_ when the thread is started, the thread will flush on its first loop, once
-  // it obtains the write_lock_. Perform a write to get all that out of the way.
+  // starts the thread after buffering the data, the thread will flush on its first loop. Perform a
+  // write to get all that out of the way.
   EXPECT_CALL(*file_, write_(_))
       .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
         return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
@@ -445,6 +450,61 @@ TEST_F(AccessLogManagerImplTest, BigDataChunkShouldBeFlushedWithoutTimer) {
   EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+// Entries written concurrently from several threads are all flushed, and the entries of each
+// thread keep their order.
+TEST_F(AccessLogManagerImplTest, WritesFromMultipleThreads) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file =
+      access_log_manager_
+          .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+          .value();
+
+  // write_() is called with file_->mutex_ held.
+  std::string written;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&written](absl::string_view data) -> Api::IoCallSizeResult {
+        written.append(data.data(), data.size());
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  constexpr uint32_t num_threads = 4;
+  constexpr uint32_t entries_per_thread = 1000;
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t t = 0; t < num_threads; t++) {
+    threads.push_back(thread_factory_.createThread([&log_file, t]() {
+      for (uint32_t i = 0; i < entries_per_thread; i++) {
+        log_file->write(absl::StrCat(t, " ", i, "\n"));
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  log_file->flush();
+
+  std::vector<uint32_t> next_entry(num_threads, 0);
+  {
+    absl::MutexLock lock(file_->mutex_);
+    for (absl::string_view line : absl::StrSplit(written, '\n', absl::SkipEmpty())) {
+      std::vector<absl::string_view> parts = absl::StrSplit(line, ' ');
+      ASSERT_EQ(2, parts.size());
+      uint32_t t, i;
+      ASSERT_TRUE(absl::SimpleAtoi(parts[0], &t));
+      ASSERT_TRUE(absl::SimpleAtoi(parts[1], &i));
+      ASSERT_LT(t, num_threads);
+      EXPECT_EQ(next_entry[t], i);
+      next_entry[t] = i + 1;
+    }
+  }
+  for (uint32_t t = 0; t < num_threads; t++) {
+    EXPECT_EQ(entries_per_thread, next_entry[t]);
+  }
+  EXPECT_EQ(num_threads * entries_per_thread, store_.counter("filesystem.write_buffered").value());
+  EXPECT_TRUE(waitForGaugeEq("filesystem.write_total_buffered", 0));
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
   EXPECT_CALL(dispatcher_, createTimer_(_)).WillRepeatedly(ReturnNew<NiceMock<Event::MockTimer>>());
 
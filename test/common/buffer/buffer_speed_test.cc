@@ -320,6 +320,44 @@ BENCHMARK(bufferReserveCommit)
     ->Arg(64 * 1024)
     ->Arg(128 * 1024);
 
+// Test the read/drain cycle of a connection buffer, where each iteration reads into newly
+// allocated slices and then drains them. This is the allocation pattern of a proxied connection,
+// and measures the cost of recycling default sized slice storage via the SliceStoragePool.
+static void bufferReadDrainCycle(benchmark::State& state) {
+  Buffer::SliceStoragePool::clearForTest();
+  Buffer::OwnedImpl buffer;
+  const uint64_t size = state.range(0);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Buffer::Reservation reservation = buffer.reserveForReadWithLengthForTest(size);
+    reservation.commit(reservation.length());
+    buffer.drain(buffer.length());
+  }
+  const Buffer::SliceStoragePool::Stats stats = Buffer::SliceStoragePool::statsForThisThread();
+  state.counters["pool_hits"] = stats.hits_;
+  state.counters["pool_misses"] = stats.misses_;
+  benchmark::DoNotOptimize(buffer.length());
+}
+BENCHMARK(bufferReadDrainCycle)->Arg(16 * 1024)->Arg(64 * 1024)->Arg(128 * 1024);
+
+// Baseline for bufferReadDrainCycle: allocate and free the same amount of slice storage directly
+// from the global allocator.
+static void bufferReadDrainCycleGlobalAllocator(benchmark::State& state) {
+  const uint64_t num_slices = state.range(0) / Buffer::Slice::default_slice_size_;
+  std::vector<Buffer::Slice::StoragePtr> storages(num_slices);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (auto& storage : storages) {
+      storage.reset(new uint8_t[Buffer::Slice::default_slice_size_]);
+      benchmark::DoNotOptimize(storage.get());
+    }
+    for (auto& storage : storages) {
+      storage.reset();
+    }
+  }
+}
+BENCHMARK(bufferReadDrainCycleGlobalAllocator)->Arg(16 * 1024)->Arg(64 * 1024)->Arg(128 * 1024);
+
 // Test the reserve+commit cycle, for the common case where the reserved space is
 // only partially used (and therefore the commit size is smaller than the reservation size).
 static void bufferReserveCommitPartial(benchmark::State& state) {
@@ -10,6 +10,7 @@
 #include "test/common/buffer/utility.h"
 #include "test/mocks/api/mocks.h"
 #include "test/test_common/logging.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
@@ -912,16 +913,18 @@ TEST_F(OwnedImplTest, SliceFreeList) {
     EXPECT_EQ(slices[1], b2.getRawSlices()[0].mem_);
   }
 
+  // Draining the last byte of b1 releases its slice, which returns the storage to the freelist.
   b1.drain(1);
   EXPECT_EQ(0, b1.getRawSlices().size());
   {
     auto r = b2.reserveForRead();
     // slices()[0] is the partially used slice that is already part of this buffer.
-    EXPECT_EQ(slices[2], r.slices()[1].mem_);
+    EXPECT_EQ(slices[0], r.slices()[1].mem_);
+    EXPECT_EQ(slices[2], r.slices()[2].mem_);
   }
   {
     auto r = b1.reserveForRead();
-    EXPECT_EQ(slices[2], r.slices()[0].mem_);
+    EXPECT_EQ(slices[0], r.slices()[0].mem_);
   }
   {
     // This causes an underflow in the `freelist` on creation, and overflows it on deletion.
@@ -938,6 +941,77 @@ TEST_F(OwnedImplTest, SliceFreeList) {
   }
 }
 
+// Test that default sized slice storage is recycled through the per-thread pool.
+TEST_F(OwnedImplTest, SliceStoragePoolHitsAndMisses) {
+  SliceStoragePool::clearForTest();
+  {
+    Buffer::OwnedImpl buffer;
+    auto r = buffer.reserveForRead();
+    EXPECT_EQ(Reservation::MAX_SLICES_, r.numSlices());
+    // Commit two full slices. The remaining storages are returned to the pool.
+    r.commit(2 * Slice::default_slice_size_);
+    EXPECT_EQ(Reservation::MAX_SLICES_ - 2, SliceStoragePool::cachedForThisThread());
+  }
+  // Destroying the buffer returns the storage of its two slices.
+  EXPECT_EQ(Reservation::MAX_SLICES_, SliceStoragePool::cachedForThisThread());
+
+  SliceStoragePool::Stats stats = SliceStoragePool::statsForThisThread();
+  EXPECT_EQ(0, stats.hits_);
+  EXPECT_EQ(Reservation::MAX_SLICES_, stats.misses_);
+  EXPECT_EQ(Reservation::MAX_SLICES_, stats.recycled_);
+  EXPECT_EQ(0, stats.released_);
+
+  {
+    // Slices created by add() with default sized storage also draw from the pool, while other
+    // sizes bypass it.
+    Buffer::OwnedImpl buffer;
+    buffer.appendSliceForTest(std::string(Slice::default_slice_size_, 'a'));
+    buffer.appendSliceForTest(std::string(10, 'b'));
+    EXPECT_EQ(Reservation::MAX_SLICES_ - 1, SliceStoragePool::cachedForThisThread());
+  }
+  stats = SliceStoragePool::statsForThisThread();
+  EXPECT_EQ(1, stats.hits_);
+  EXPECT_EQ(Reservation::MAX_SLICES_, stats.misses_);
+  EXPECT_EQ(Reservation::MAX_SLICES_ + 1, stats.recycled_);
+  SliceStoragePool::clearForTest();
+}
+
+// Test that the per-thread pool is bounded, and that excess storage is freed.
+TEST_F(OwnedImplTest, SliceStoragePoolBounded) {
+  SliceStoragePool::clearForTest();
+  constexpr uint32_t num_blocks = SliceStoragePool::MaxCachedPerThread + 4;
+  std::vector<uint8_t*> blocks;
+  for (uint32_t i = 0; i < num_blocks; ++i) {
+    blocks.push_back(SliceStoragePool::allocate());
+  }
+  for (uint8_t* block : blocks) {
+    SliceStoragePool::release(block);
+  }
+  EXPECT_EQ(SliceStoragePool::MaxCachedPerThread, SliceStoragePool::cachedForThisThread());
+  const SliceStoragePool::Stats stats = SliceStoragePool::statsForThisThread();
+  EXPECT_EQ(num_blocks, stats.misses_);
+  EXPECT_EQ(SliceStoragePool::MaxCachedPerThread, stats.recycled_);
+  EXPECT_EQ(4, stats.released_);
+  SliceStoragePool::clearForTest();
+  EXPECT_EQ(0, SliceStoragePool::cachedForThisThread());
+}
+
+// Test that storage released on a thread other than the one that allocated it is cached by the
+// releasing thread.
+TEST_F(OwnedImplTest, SliceStoragePoolCrossThreadRelease) {
+  SliceStoragePool::clearForTest();
+  auto buffer = std::make_unique<Buffer::OwnedImpl>();
+  buffer->appendSliceForTest(std::string(Slice::default_slice_size_, 'a'));
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread([&buffer]() {
+    buffer.reset();
+    EXPECT_EQ(1, SliceStoragePool::cachedForThisThread());
+    EXPECT_EQ(1, SliceStoragePool::statsForThisThread().recycled_);
+  });
+  thread->join();
+  EXPECT_EQ(0, SliceStoragePool::cachedForThisThread());
+  EXPECT_EQ(0, SliceStoragePool::statsForThisThread().recycled_);
+}
+
 TEST_F(OwnedImplTest, Search) {
   // Populate a buffer with a string split across many small slices, to
   // exercise edge cases in the search implementation.
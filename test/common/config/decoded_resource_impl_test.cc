@@ -1,6 +1,11 @@
+#include "envoy/config/endpoint/v3/endpoint.pb.h"
+
 #include "source/common/config/decoded_resource_impl.h"
+#include "source/common/config/opaque_resource_decoder_impl.h"
+#include "source/common/protobuf/message_validator_impl.h"
 
 #include "test/mocks/config/mocks.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -150,6 +155,59 @@ TEST(DecodedResourceImplTest, All) {
   }
 }
 
+// Resources decoded with an arena live on it, and keep it alive after the caller's reference to
+// the arena is gone.
+TEST(DecodedResourceImplTest, DecodeOnArena) {
+  OpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment> resource_decoder(
+      ProtobufMessage::getStrictValidationVisitor(), "cluster_name");
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  Protobuf::Any resource;
+  resource.PackFrom(cluster_load_assignment);
+  envoy::service::discovery::v3::Resource resource_wrapper;
+  resource_wrapper.set_name("real_name");
+  resource_wrapper.mutable_resource()->PackFrom(cluster_load_assignment);
+  Protobuf::Any wrapped_resource;
+  wrapped_resource.PackFrom(resource_wrapper);
+
+  DecodeArenaSharedPtr arena = createDecodeArena();
+  ASSERT_NE(nullptr, arena);
+  DecodedResourceImplPtr decoded_resource =
+      *DecodedResourceImpl::fromResource(resource_decoder, resource, "1", arena);
+  DecodedResourceImplPtr decoded_wrapped_resource =
+      *DecodedResourceImpl::fromResource(resource_decoder, wrapped_resource, "1", arena);
+  EXPECT_EQ(arena.get(), decoded_resource->resource().GetArena());
+  EXPECT_EQ(arena.get(), decoded_wrapped_resource->resource().GetArena());
+  arena.reset();
+
+  EXPECT_EQ("fare", decoded_resource->name());
+  EXPECT_EQ("real_name", decoded_wrapped_resource->name());
+  EXPECT_THAT(decoded_resource->resource(), ProtoEq(cluster_load_assignment));
+  EXPECT_THAT(decoded_wrapped_resource->resource(), ProtoEq(cluster_load_assignment));
+}
+
+// Decoders that do not support arenas fall back to heap allocated messages.
+TEST(DecodedResourceImplTest, DecodeOnArenaUnsupported) {
+  MockOpaqueResourceDecoder resource_decoder;
+  Protobuf::Any some_opaque_resource;
+  some_opaque_resource.set_type_url("some_type_url");
+  EXPECT_CALL(resource_decoder, decodeResource(ProtoEq(some_opaque_resource)))
+      .WillOnce(InvokeWithoutArgs(
+          []() -> ProtobufTypes::MessagePtr { return std::make_unique<Protobuf::Empty>(); }));
+  EXPECT_CALL(resource_decoder, resourceName(ProtoEq(Protobuf::Empty())))
+      .WillOnce(Return("some_name"));
+  auto decoded_resource = *DecodedResourceImpl::fromResource(
+      resource_decoder, some_opaque_resource, "foo", createDecodeArena());
+  EXPECT_EQ("some_name", decoded_resource->name());
+  EXPECT_EQ(nullptr, decoded_resource->resource().GetArena());
+}
+
+TEST(DecodedResourceImplTest, DecodeOnArenaDisabled) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.xds_decode_on_arena", "false"}});
+  EXPECT_EQ(nullptr, createDecodeArena());
+}
+
 } // namespace
 } // namespace Config
 } // namespace Envoy
@@ -0,0 +1,63 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/config/endpoint/v3/endpoint.pb.h"
+
+#include "source/common/config/decoded_resource_impl.h"
+#include "source/common/config/opaque_resource_decoder_impl.h"
+#include "source/common/protobuf/message_validator_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/test_runtime.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Config {
+
+// Builds the resources of a SotW EDS push with the given number of ClusterLoadAssignments, each
+// with a handful of endpoints.
+static Protobuf::RepeatedPtrField<Protobuf::Any> edsPush(uint32_t num_resources) {
+  Protobuf::RepeatedPtrField<Protobuf::Any> resources;
+  for (uint32_t i = 0; i < num_resources; ++i) {
+    envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+    cluster_load_assignment.set_cluster_name(absl::StrCat("cluster_", i));
+    auto* endpoints = cluster_load_assignment.add_endpoints();
+    endpoints->mutable_locality()->set_region("region");
+    endpoints->mutable_locality()->set_zone("zone");
+    for (uint32_t j = 0; j < 8; ++j) {
+      auto* socket_address = endpoints->add_lb_endpoints()
+                                 ->mutable_endpoint()
+                                 ->mutable_address()
+                                 ->mutable_socket_address();
+      socket_address->set_address(absl::StrCat("10.", i % 256, ".", j, ".1"));
+      socket_address->set_port_value(8000 + j);
+    }
+    resources.Add()->PackFrom(cluster_load_assignment);
+  }
+  return resources;
+}
+
+// Decodes a push of state.range(0) resources, with arena decoding enabled when state.range(1)
+// is set.
+static void bmDecodePush(::benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.xds_decode_on_arena", state.range(1) ? "true" : "false"}});
+  const uint32_t num_resources =
+      Envoy::benchmark::skipExpensiveBenchmarks() ? 10 : state.range(0);
+  const Protobuf::RepeatedPtrField<Protobuf::Any> resources = edsPush(num_resources);
+  OpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment> resource_decoder(
+      ProtobufMessage::getNullValidationVisitor(), "cluster_name");
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    auto decoded = *DecodedResourcesWrapper::create(resource_decoder, resources, "1");
+    ::benchmark::DoNotOptimize(decoded->refvec_.size());
+  }
+}
+BENCHMARK(bmDecodePush)
+    ->ArgsProduct({{1000, 50000}, {false, true}})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace Config
+} // namespace Envoy
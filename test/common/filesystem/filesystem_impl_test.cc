@@ -373,6 +373,57 @@ TEST_F(FileSystemImplTest, PwriteWritesTheSpecifiedRange) {
   EXPECT_EQ(contents, "01BOOPS789");
 }
 
+TEST_F(FileSystemImplTest, WritevWritesAllBuffersInOrder) {
+  const std::string file_path =
+      TestEnvironment::writeStringToFileForTest("test_envoy", "0123");
+  {
+    FilePathAndType file_info{Filesystem::DestinationType::File, file_path};
+    FilePtr file = file_system_.createFile(file_info);
+    const Api::IoCallBoolResult open_result = file->open(FlagSet{
+        (1 << Filesystem::File::Operation::Write) | (1 << Filesystem::File::Operation::Append)});
+    EXPECT_TRUE(open_result.return_value_) << open_result.err_->getErrorDetails();
+    const std::vector<absl::string_view> buffers{"abc", "", "defg", "h"};
+    const Api::IoCallSizeResult write_result = file->writev(buffers);
+    EXPECT_EQ(write_result.return_value_, 8) << write_result.err_->getErrorDetails();
+    EXPECT_THAT(write_result.err_, ::testing::IsNull());
+  }
+  auto contents = TestEnvironment::readFileToStringForTest(file_path);
+  EXPECT_EQ(contents, "0123abcdefgh");
+}
+
+// A file which accepts at most a fixed number of bytes per write() call.
+class ShortWriteFile : public FileSharedImpl {
+public:
+  explicit ShortWriteFile(size_t max_write_size)
+      : FileSharedImpl({DestinationType::File, "short_write"}), max_write_size_(max_write_size) {}
+
+  Api::IoCallBoolResult open(FlagSet) override { return resultSuccess(true); }
+  Api::IoCallSizeResult write(absl::string_view buffer) override {
+    const absl::string_view written = buffer.substr(0, max_write_size_);
+    data_.append(written);
+    return resultSuccess<ssize_t>(written.size());
+  }
+  Api::IoCallBoolResult close() override { return resultSuccess(true); }
+  Api::IoCallSizeResult pread(void*, uint64_t, uint64_t) override { PANIC("not implemented"); }
+  Api::IoCallSizeResult pwrite(const void*, uint64_t, uint64_t) override {
+    PANIC("not implemented");
+  }
+  Api::IoCallResult<FileInfo> info() override { PANIC("not implemented"); }
+
+  const size_t max_write_size_;
+  std::string data_;
+};
+
+TEST(FileSharedImplTest, WritevStopsAtShortWrite) {
+  ShortWriteFile file(3);
+  const std::vector<absl::string_view> buffers{"ab", "cdef", "gh"};
+  const Api::IoCallSizeResult result = file.writev(buffers);
+  EXPECT_TRUE(result.ok());
+  // "ef" was not written, so "gh" must not be either.
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ("abcde", file.data_);
+}
+
 TEST_F(FileSystemImplTest, StatOnDirectoryReturnsDirectoryType) {
   const std::string new_dir_path = TestEnvironment::temporaryPath("envoy_test_dir");
   TestEnvironment::createPath(new_dir_path);
@@ -77,6 +77,36 @@ static void BM_AccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_AccessLogFormatter);
 
+// Reference for BM_AccessLogFormatter: walks the parsed providers and appends each value the
+// way the formatter did before templates were compiled.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_AccessLogFormatterProviderLoop(benchmark::State& state) {
+  testing::NiceMock<MockTimeSystem> time_system;
+
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo(time_system);
+  static const char* LogFormat =
+      "%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT% %START_TIME(%Y/%m/%dT%H:%M:%S%z %s)% "
+      "%REQ(:METHOD)% "
+      "%REQ(X-FORWARDED-PROTO)%://%REQ(:AUTHORITY)%%REQ(X-ENVOY-ORIGINAL-PATH?:PATH)% %PROTOCOL% "
+      "s%RESPONSE_CODE% %BYTES_SENT% %DURATION% %REQ(REFERER)% \"%REQ(USER-AGENT)%\" - - -\n";
+
+  const std::vector<Formatter::FormatterProviderPtr> providers =
+      *Formatter::SubstitutionFormatParser::parse(LogFormat);
+
+  size_t output_bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    std::string log_line;
+    log_line.reserve(256);
+    for (const auto& provider : providers) {
+      const absl::optional<std::string> bit = provider->format({}, *stream_info);
+      log_line += bit.has_value() ? bit.value() : Formatter::DefaultUnspecifiedValueStringView;
+    }
+    output_bytes += log_line.length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_AccessLogFormatterProviderLoop);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_AccessLogFormatterTextMockJson(benchmark::State& state) {
   testing::NiceMock<MockTimeSystem> time_system;
@@ -125,6 +155,36 @@ static void BM_JsonAccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_JsonAccessLogFormatter);
 
+// Measures a JSON format dominated by constant values and templates mixing literals that need
+// escaping with substitution commands. The literals are fused and sanitized at load time.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_JsonAccessLogFormatterLiteralHeavy(benchmark::State& state) {
+  testing::NiceMock<MockTimeSystem> time_system;
+
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo(time_system);
+  Protobuf::Struct struct_format;
+  const std::string format_yaml = R"EOF(
+    service: 'frontend'
+    environment: 'production'
+    version: 3
+    sampled: true
+    tags: ['edge', 'http', 'v1']
+    rate: '100%%'
+    summary: '"%REQ(:METHOD)% %REQ(:PATH)%" -> %RESPONSE_CODE% in %DURATION%ms'
+    peer: 'addr=%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT%\tproto=%PROTOCOL%'
+    response_code: '%RESPONSE_CODE%'
+  )EOF";
+  TestUtility::loadFromYaml(format_yaml, struct_format);
+  Envoy::Formatter::JsonFormatterImpl json_formatter(struct_format, false);
+
+  size_t output_bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes += json_formatter.format({}, *stream_info).length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_JsonAccessLogFormatterLiteralHeavy);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_FormatterCommandParsing(benchmark::State& state) {
   const std::string token = "Listener:namespace:key";
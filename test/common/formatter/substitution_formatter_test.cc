@@ -261,6 +261,47 @@ TEST(SubstitutionFormatterTest, plainNumberFormatter) {
   EXPECT_THAT(formatter.formatValue({}, stream_info), ProtoEq(ValueUtil::numberValue(400)));
 }
 
+TEST(SubstitutionFormatterTest, CompiledFormatFusesLiterals) {
+  StreamInfo::MockStreamInfo stream_info;
+  absl::optional<Http::Protocol> protocol = Http::Protocol::Http11;
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(protocol));
+
+  std::vector<FormatterProviderPtr> providers;
+  providers.push_back(std::make_unique<PlainStringFormatter>("a\""));
+  providers.push_back(std::make_unique<PlainStringFormatter>("b"));
+  providers.push_back(std::move(SubstitutionFormatParser::parse("%PROTOCOL%")->front()));
+  providers.push_back(std::make_unique<PlainStringFormatter>(""));
+  providers.push_back(std::make_unique<PlainStringFormatter>("c"));
+
+  {
+    CompiledFormat compiled(std::move(providers), true);
+    EXPECT_FALSE(compiled.literalOnly());
+    EXPECT_EQ(nullptr, compiled.singleProvider());
+    EXPECT_EQ(1, compiled.providerCount());
+    // The literal segments are fused and sanitized once at compile time.
+    EXPECT_EQ("a\\\"bc", compiled.literals());
+
+    std::string sanitize_buffer;
+    std::string output;
+    compiled.formatToString({}, stream_info, false, sanitize_buffer, output);
+    EXPECT_EQ("a\\\"bHTTP/1.1c", output);
+  }
+
+  {
+    CompiledFormat compiled(std::move(*SubstitutionFormatParser::parse("%PROTOCOL%")), false);
+    EXPECT_NE(nullptr, compiled.singleProvider());
+  }
+
+  {
+    CompiledFormat compiled(std::move(*SubstitutionFormatParser::parse("")), false);
+    EXPECT_TRUE(compiled.literalOnly());
+    std::string sanitize_buffer;
+    std::string output;
+    compiled.formatToString({}, stream_info, false, sanitize_buffer, output);
+    EXPECT_EQ("", output);
+  }
+}
+
 TEST(SubstitutionFormatterTest, inFlightDuration) {
   Event::SimulatedTimeSystem time_system;
   time_system.setSystemTime(std::chrono::milliseconds(0));
@@ -4410,6 +4451,28 @@ TEST(SubstitutionFormatterTest, JsonFormatterSingleOperatorTest) {
                      expected_json_map);
 }
 
+TEST(SubstitutionFormatterTest, JsonFormatterLiteralOnlyTemplateTest) {
+  StreamInfo::MockStreamInfo stream_info;
+  absl::optional<Http::Protocol> protocol = Http::Protocol::Http11;
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(protocol));
+
+  Protobuf::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    a_percent: '100%%'
+    b_protocol: '%PROTOCOL%'
+    c_quoted: '"%PROTOCOL%" %%'
+  )EOF",
+                            key_mapping);
+  JsonFormatterImpl formatter(key_mapping, false);
+
+  // Repeated formatting exercises the adaptive output size estimate.
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ("{\"a_percent\":\"100%\",\"b_protocol\":\"HTTP/1.1\","
+              "\"c_quoted\":\"\\\"HTTP/1.1\\\" %\"}\n",
+              formatter.format({}, stream_info));
+  }
+}
+
 TEST(SubstitutionFormatterTest, EmptyJsonFormatterTest) {
   StreamInfo::MockStreamInfo stream_info;
 
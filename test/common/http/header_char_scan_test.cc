@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <string>
+
+#include "source/common/http/character_set_validation.h"
+#include "source/common/http/header_char_scan.h"
+
+#include "absl/strings/ascii.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class HeaderCharScanTest : public testing::TestWithParam<HeaderCharScan::Kernel> {
+protected:
+  // Lengths around the 16 and 32 byte block sizes of the vector kernels.
+  static constexpr size_t kLengths[] = {0, 1, 7, 15, 16, 17, 31, 32, 33, 47, 63, 64, 65, 100};
+
+  static std::string makeToken(size_t length) {
+    static constexpr absl::string_view kTokenChars =
+        "!#$%&'*+-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ^_`abcdefghijklmnopqrstuvwxyz|~";
+    std::string token;
+    for (size_t i = 0; i < length; ++i) {
+      token.push_back(kTokenChars[i % kTokenChars.size()]);
+    }
+    return token;
+  }
+
+  std::string toLower(std::string value) {
+    HeaderCharScan::toLowerInPlace(value.data(), value.size(), GetParam());
+    return value;
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(Kernels, HeaderCharScanTest,
+                         testing::ValuesIn(HeaderCharScan::supportedKernels()),
+                         [](const testing::TestParamInfo<HeaderCharScan::Kernel>& info) {
+                           std::string name(HeaderCharScan::kernelName(info.param));
+                           name.erase(std::remove(name.begin(), name.end(), '.'), name.end());
+                           return name;
+                         });
+
+TEST_P(HeaderCharScanTest, TokenValidMatchesCharTableForEveryByte) {
+  for (size_t length : kLengths) {
+    if (length == 0) {
+      continue;
+    }
+    for (size_t position : {size_t(0), length / 2, length - 1}) {
+      for (int c = 0; c < 256; ++c) {
+        std::string token = makeToken(length);
+        token[position] = static_cast<char>(c);
+        EXPECT_EQ(testCharInTable(kGenericHeaderNameCharTable, static_cast<char>(c)),
+                  HeaderCharScan::isTokenValid(token, GetParam()))
+            << "length " << length << " position " << position << " char " << c;
+      }
+    }
+  }
+}
+
+TEST_P(HeaderCharScanTest, TokenValid) {
+  for (size_t length : kLengths) {
+    EXPECT_TRUE(HeaderCharScan::isTokenValid(makeToken(length), GetParam()));
+  }
+  EXPECT_TRUE(HeaderCharScan::isTokenValid("x-forwarded-for", GetParam()));
+  EXPECT_FALSE(HeaderCharScan::isTokenValid("x-forwarded for", GetParam()));
+  EXPECT_FALSE(HeaderCharScan::isTokenValid("host:", GetParam()));
+  EXPECT_FALSE(HeaderCharScan::isTokenValid("content-type\r", GetParam()));
+  EXPECT_FALSE(HeaderCharScan::isTokenValid(std::string("a\0b", 3), GetParam()));
+}
+
+TEST_P(HeaderCharScanTest, ToLowerInPlace) {
+  for (size_t length : kLengths) {
+    std::string value;
+    for (size_t i = 0; i < length; ++i) {
+      value.push_back(static_cast<char>(i * 37));
+    }
+    EXPECT_EQ(absl::AsciiStrToLower(value), toLower(value)) << "length " << length;
+  }
+  EXPECT_EQ("x-request-id", toLower("X-Request-ID"));
+  EXPECT_EQ("@[`{", toLower("@[`{"));
+  // Bytes above 0x7f must not be folded.
+  EXPECT_EQ("\xc1\xda", toLower("\xc1\xda"));
+}
+
+TEST_P(HeaderCharScanTest, ToLowerDoesNotWritePastEnd) {
+  for (size_t length : kLengths) {
+    std::string value(length + 1, 'Q');
+    HeaderCharScan::toLowerInPlace(value.data(), length, GetParam());
+    EXPECT_EQ(std::string(length, 'q') + "Q", value);
+  }
+}
+
+TEST_P(HeaderCharScanTest, ContainsCrOrLf) {
+  for (size_t length : kLengths) {
+    const std::string value(length, 'v');
+    EXPECT_FALSE(HeaderCharScan::containsCrOrLf(value, GetParam()));
+    for (size_t position = 0; position < length; ++position) {
+      for (char c : {'\r', '\n'}) {
+        std::string with_crlf = value;
+        with_crlf[position] = c;
+        EXPECT_TRUE(HeaderCharScan::containsCrOrLf(with_crlf, GetParam()))
+            << "length " << length << " position " << position;
+      }
+    }
+  }
+  // Neighbouring control characters are not CR or LF.
+  EXPECT_FALSE(HeaderCharScan::containsCrOrLf("\t\x0b\x0c\x0e", GetParam()));
+}
+
+TEST(HeaderCharScanKernelTest, ActiveKernelIsSupported) {
+  const auto kernels = HeaderCharScan::supportedKernels();
+  EXPECT_NE(std::find(kernels.begin(), kernels.end(), HeaderCharScan::activeKernel()),
+            kernels.end());
+  EXPECT_EQ(HeaderCharScan::Kernel::Scalar, kernels.front());
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -297,6 +297,36 @@ static void headerMapImplRemovePrefix(benchmark::State& state) {
 }
 BENCHMARK(headerMapImplRemovePrefix)->Arg(0)->Arg(1)->Arg(5)->Arg(10)->Arg(50);
 
+/**
+ * Measure the full lifecycle of a stream's header map: creating it, adding a varying number
+ * of headers, iterating over them, removing every other header and destroying the map. This
+ * covers the allocation and locality of the header entry storage.
+ */
+static void headerMapImplAddIterateRemove(benchmark::State& state) {
+  std::vector<LowerCaseString> keys;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    keys.emplace_back("dummy-key-" + std::to_string(i));
+  }
+  const std::string value("01234567890123456789");
+  size_t total_len = 0;
+  for (auto _ : state) { // NOLINT
+    auto headers = Http::RequestHeaderMapImpl::create();
+    for (const LowerCaseString& key : keys) {
+      headers->addReference(key, value);
+    }
+    headers->iterate([&total_len](const HeaderEntry& header) -> HeaderMap::Iterate {
+      total_len += header.key().size() + header.value().size();
+      return HeaderMap::Iterate::Continue;
+    });
+    for (size_t i = 0; i < keys.size(); i += 2) {
+      headers->remove(keys[i]);
+    }
+    benchmark::DoNotOptimize(headers->size());
+  }
+  benchmark::DoNotOptimize(total_len);
+}
+BENCHMARK(headerMapImplAddIterateRemove)->Arg(0)->Arg(1)->Arg(5)->Arg(10)->Arg(40)->Arg(80);
+
 class StaticLookupBenchmarker {
 public:
   explicit StaticLookupBenchmarker(std::unique_ptr<HeaderMapImpl> impl)
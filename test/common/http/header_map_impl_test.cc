@@ -233,6 +233,48 @@ TEST(HeaderMapImplTest, Remove) {
   EXPECT_EQ(0UL, headers.remove(Headers::get().ContentLength));
 }
 
+// Entries are carved out of per map slabs and recycled on removal. Verify that order, inline
+// header pointers and values survive repeated growth, removal and reuse of that storage.
+TEST(HeaderMapImplTest, RemoveAndReinsertReusesStorage) {
+  TestRequestHeaderMapImpl headers;
+
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < 40; i++) {
+      headers.addCopy(LowerCaseString(absl::StrCat("key-", i)), absl::StrCat(round, "-", i));
+    }
+    headers.setContentLength(round);
+    headers.setMethod("GET");
+    EXPECT_EQ(42UL, headers.size());
+
+    // Remove every even key, then add them back at the end of the list.
+    for (int i = 0; i < 40; i += 2) {
+      EXPECT_EQ(1UL, headers.remove(LowerCaseString(absl::StrCat("key-", i))));
+    }
+    for (int i = 0; i < 40; i += 2) {
+      headers.addCopy(LowerCaseString(absl::StrCat("key-", i)), absl::StrCat(round, "-", i));
+    }
+
+    std::vector<std::string> keys;
+    headers.iterate([&keys](const HeaderEntry& header) -> HeaderMap::Iterate {
+      keys.emplace_back(header.key().getStringView());
+      return HeaderMap::Iterate::Continue;
+    });
+    ASSERT_EQ(42UL, keys.size());
+    // The pseudo header stays in front of the list.
+    EXPECT_EQ(":method", keys[0]);
+    EXPECT_EQ("key-1", keys[1]);
+    EXPECT_EQ("key-0", keys[22]);
+    EXPECT_EQ("GET", headers.getMethodValue());
+    EXPECT_EQ(absl::StrCat(round), headers.getContentLengthValue());
+    EXPECT_EQ(absl::StrCat(round, "-7"),
+              headers.get(LowerCaseString("key-7"))[0]->value().getStringView());
+
+    headers.clear();
+    EXPECT_TRUE(headers.empty());
+    EXPECT_EQ(nullptr, headers.Method());
+  }
+}
+
 TEST(HeaderMapImplTest, RemoveHost) {
   TestRequestHeaderMapImpl headers;
   headers.setHost("foo");
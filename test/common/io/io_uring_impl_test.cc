@@ -1,5 +1,6 @@
 #include <functional>
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/io/io_uring_impl.h"
 #include "source/common/network/address_impl.h"
 
@@ -102,7 +103,7 @@ TEST_P(IoUringImplParamTest, InvalidParams) {
   auto file_event = dispatcher->createFileEvent(
       event_fd,
       [this, &completions_nr](uint32_t) {
-        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, bool) {
+        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, uint32_t, bool) {
           EXPECT_TRUE(res < 0);
           completions_nr++;
         });
@@ -139,7 +140,7 @@ TEST_F(IoUringImplTest, InjectCompletion) {
       event_fd,
       [this, &completions_nr](uint32_t) {
         io_uring_->forEveryCompletion(
-            [&completions_nr](Request* user_data, int32_t res, bool injected) {
+            [&completions_nr](Request* user_data, int32_t res, uint32_t, bool injected) {
               EXPECT_TRUE(injected);
               EXPECT_EQ(1, dynamic_cast<TestRequest*>(user_data)->data_);
               EXPECT_EQ(-11, res);
@@ -172,20 +173,21 @@ TEST_F(IoUringImplTest, NestInjectCompletion) {
   auto file_event = dispatcher->createFileEvent(
       event_fd,
       [this, &fd2, &completions_nr, &request2](uint32_t) {
-        io_uring_->forEveryCompletion([this, &fd2, &completions_nr,
-                                       &request2](Request* user_data, int32_t res, bool injected) {
-          EXPECT_TRUE(injected);
-          if (completions_nr == 0) {
-            EXPECT_EQ(1, dynamic_cast<TestRequest*>(user_data)->data_);
-            EXPECT_EQ(-11, res);
-            io_uring_->injectCompletion(fd2, &request2, -22);
-          } else {
-            EXPECT_EQ(2, dynamic_cast<TestRequest*>(user_data)->data_);
-            EXPECT_EQ(-22, res);
-          }
+        io_uring_->forEveryCompletion(
+            [this, &fd2, &completions_nr, &request2](Request* user_data, int32_t res, uint32_t,
+                                                      bool injected) {
+              EXPECT_TRUE(injected);
+              if (completions_nr == 0) {
+                EXPECT_EQ(1, dynamic_cast<TestRequest*>(user_data)->data_);
+                EXPECT_EQ(-11, res);
+                io_uring_->injectCompletion(fd2, &request2, -22);
+              } else {
+                EXPECT_EQ(2, dynamic_cast<TestRequest*>(user_data)->data_);
+                EXPECT_EQ(-22, res);
+              }
 
-          completions_nr++;
-        });
+              completions_nr++;
+            });
         return absl::OkStatus();
       },
       trigger, Event::FileReadyType::Read);
@@ -214,7 +216,7 @@ TEST_F(IoUringImplTest, RemoveInjectCompletion) {
       event_fd,
       [this, &completions_nr](uint32_t) {
         io_uring_->forEveryCompletion(
-            [&completions_nr](Request* user_data, int32_t res, bool injected) {
+            [&completions_nr](Request* user_data, int32_t res, uint32_t, bool injected) {
               EXPECT_TRUE(injected);
               EXPECT_EQ(1, dynamic_cast<TestRequest*>(user_data)->data_);
               EXPECT_EQ(-11, res);
@@ -250,7 +252,8 @@ TEST_F(IoUringImplTest, NestRemoveInjectCompletion) {
       event_fd,
       [this, &fd2, &completions_nr, &data2](uint32_t) {
         io_uring_->forEveryCompletion(
-            [this, &fd2, &completions_nr, &data2](Request* user_data, int32_t res, bool injected) {
+            [this, &fd2, &completions_nr, &data2](Request* user_data, int32_t res, uint32_t,
+                                                   bool injected) {
               EXPECT_TRUE(injected);
               if (completions_nr == 0) {
                 EXPECT_EQ(1, dynamic_cast<TestRequest*>(user_data)->data_);
@@ -302,7 +305,7 @@ TEST_F(IoUringImplTest, PrepareReadvAllDataFitsOneChunk) {
   auto file_event = dispatcher->createFileEvent(
       event_fd,
       [this, &completions_nr, d = dispatcher.get()](uint32_t) {
-        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, bool) {
+        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, uint32_t, bool) {
           completions_nr++;
           EXPECT_EQ(res, strlen("test text"));
         });
@@ -348,15 +351,16 @@ TEST_F(IoUringImplTest, PrepareReadvQueueOverflow) {
   auto file_event = dispatcher->createFileEvent(
       event_fd,
       [this, &completions_nr](uint32_t) {
-        io_uring_->forEveryCompletion([&completions_nr](Request* user_data, int32_t res, bool) {
-          EXPECT_TRUE(user_data != nullptr);
-          EXPECT_EQ(res, 2);
-          completions_nr++;
-          // Note: generally events are not guaranteed to complete in the same order
-          // we submit them, but for this case of reading from a single file it's ok
-          // to expect the same order.
-          EXPECT_EQ(dynamic_cast<TestRequest*>(user_data)->data_, completions_nr);
-        });
+        io_uring_->forEveryCompletion(
+            [&completions_nr](Request* user_data, int32_t res, uint32_t, bool) {
+              EXPECT_TRUE(user_data != nullptr);
+              EXPECT_EQ(res, 2);
+              completions_nr++;
+              // Note: generally events are not guaranteed to complete in the same order
+              // we submit them, but for this case of reading from a single file it's ok
+              // to expect the same order.
+              EXPECT_EQ(dynamic_cast<TestRequest*>(user_data)->data_, completions_nr);
+            });
         return absl::OkStatus();
       },
       trigger, Event::FileReadyType::Read);
@@ -401,6 +405,64 @@ TEST_F(IoUringImplTest, PrepareReadvQueueOverflow) {
   EXPECT_EQ(static_cast<char*>(iov3.iov_base)[1], 'f');
 }
 
+TEST_F(IoUringImplTest, RecvMultishotWithProvidedBuffers) {
+  if (io_uring_->registerProvidedBuffers(3, 16) != IoUringResult::Ok) {
+    GTEST_SKIP() << "provided buffer rings are not supported by the kernel";
+  }
+  // The number of buffers is rounded up to a power of 2.
+  EXPECT_EQ(4, io_uring_->availableProvidedBuffers());
+
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+  auto dispatcher = api_->allocateDispatcher("test_thread");
+  os_fd_t event_fd = io_uring_->registerEventfd();
+
+  Buffer::OwnedImpl read_buf;
+  int32_t completions_nr = 0;
+  bool more = true;
+  auto file_event = dispatcher->createFileEvent(
+      event_fd,
+      [this, &completions_nr, &more, &read_buf](uint32_t) {
+        io_uring_->forEveryCompletion(
+            [this, &completions_nr, &more, &read_buf](Request*, int32_t res, uint32_t flags,
+                                                       bool) {
+              completions_nr++;
+              more = (flags & IORING_CQE_F_MORE) != 0;
+              if (res > 0) {
+                ASSERT_TRUE(flags & IORING_CQE_F_BUFFER);
+                read_buf.addBufferFragment(*io_uring_->takeProvidedBuffer(
+                    static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT), res));
+              }
+            });
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  int data = 0;
+  TestRequest request(data);
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareRecvMultishot(fds[0], &request));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->submit());
+
+  // A single request receives every write.
+  EXPECT_EQ(5, write(fds[1], "hello", 5));
+  waitForCondition(*dispatcher, [&completions_nr]() { return completions_nr == 1; });
+  EXPECT_EQ(5, write(fds[1], "world", 5));
+  waitForCondition(*dispatcher, [&completions_nr]() { return completions_nr == 2; });
+  EXPECT_TRUE(more);
+  EXPECT_EQ("helloworld", read_buf.toString());
+  EXPECT_EQ(2, io_uring_->availableProvidedBuffers());
+
+  // Draining the data hands the buffers back to the kernel.
+  read_buf.drain(read_buf.length());
+  EXPECT_EQ(4, io_uring_->availableProvidedBuffers());
+
+  // The request terminates when the peer closes the connection.
+  close(fds[1]);
+  waitForCondition(*dispatcher, [&completions_nr]() { return completions_nr == 3; });
+  EXPECT_FALSE(more);
+  close(fds[0]);
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
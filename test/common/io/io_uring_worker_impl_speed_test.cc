@@ -0,0 +1,134 @@
+// Compares reading from many small connections through the epoll based dispatcher, io_uring
+// single shot reads, and io_uring multishot recv into provided buffers.
+
+#include <sys/socket.h>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/io/io_uring_worker_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Io {
+namespace {
+
+enum class ReadMode { Epoll, IoUringReadv, IoUringRecvMultishot };
+
+class ReadBenchmark {
+public:
+  ReadBenchmark(ReadMode mode, uint32_t num_connections)
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {
+    if (mode != ReadMode::Epoll) {
+      worker_ = std::make_unique<IoUringWorkerImpl>(
+          std::make_unique<IoUringImpl>(4 * num_connections, false), 8192, 1000, *dispatcher_,
+          mode == ReadMode::IoUringRecvMultishot ? 256 : 0);
+      multishot_supported_ = worker_->multishotRecvEnabled();
+    }
+
+    for (uint32_t i = 0; i < num_connections; ++i) {
+      int fds[2];
+      RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+      client_fds_.push_back(fds[1]);
+      if (mode == ReadMode::Epoll) {
+        server_fds_.push_back(fds[0]);
+        file_events_.push_back(dispatcher_->createFileEvent(
+            fds[0],
+            [this, fd = fds[0]](uint32_t) {
+              Buffer::OwnedImpl buffer;
+              Buffer::Reservation reservation = buffer.reserveForRead();
+              const Api::SysCallSizeResult result = Api::OsSysCallsSingleton::get().readv(
+                  fd, reinterpret_cast<const iovec*>(reservation.slices()),
+                  reservation.numSlices());
+              if (result.return_value_ > 0) {
+                reservation.commit(result.return_value_);
+                bytes_read_ += buffer.length();
+              }
+              return absl::OkStatus();
+            },
+            Event::PlatformDefaultTriggerType, Event::FileReadyType::Read));
+      } else {
+        const size_t index = sockets_.size();
+        sockets_.push_back(&worker_->addServerSocket(
+            fds[0],
+            [this, index](uint32_t events) {
+              ASSERT(events == Event::FileReadyType::Read);
+              Buffer::Instance& buf = sockets_[index]->getReadParam()->buf_;
+              bytes_read_ += buf.length();
+              buf.drain(buf.length());
+              return absl::OkStatus();
+            },
+            false));
+      }
+    }
+  }
+
+  ~ReadBenchmark() {
+    // The io_uring worker closes the server sockets on destruction.
+    worker_.reset();
+    file_events_.clear();
+    for (os_fd_t fd : server_fds_) {
+      Api::OsSysCallsSingleton::get().close(fd);
+    }
+    for (os_fd_t fd : client_fds_) {
+      Api::OsSysCallsSingleton::get().close(fd);
+    }
+  }
+
+  void writeAndRead(const std::string& message) {
+    for (os_fd_t fd : client_fds_) {
+      Api::OsSysCallsSingleton::get().write(fd, message.data(), message.size());
+    }
+    const uint64_t expected = bytes_read_ + message.size() * client_fds_.size();
+    while (bytes_read_ < expected) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  bool multishotSupported() const { return multishot_supported_; }
+
+private:
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  std::unique_ptr<IoUringWorkerImpl> worker_;
+  bool multishot_supported_{false};
+  std::vector<os_fd_t> client_fds_;
+  std::vector<os_fd_t> server_fds_;
+  std::vector<Event::FileEventPtr> file_events_;
+  std::vector<IoUringSocket*> sockets_;
+  uint64_t bytes_read_{};
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ReadManyConnections(benchmark::State& state) {
+  const ReadMode mode = static_cast<ReadMode>(state.range(0));
+  if (mode != ReadMode::Epoll && !isIoUringSupported()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  ReadBenchmark bench(mode, state.range(1));
+  if (mode == ReadMode::IoUringRecvMultishot && !bench.multishotSupported()) {
+    state.SkipWithError("provided buffer rings are not supported");
+    return;
+  }
+
+  const std::string message(state.range(2), 'a');
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    bench.writeAndRead(message);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(1) * state.range(2));
+}
+BENCHMARK(BM_ReadManyConnections)
+    ->ArgsProduct({{static_cast<int64_t>(ReadMode::Epoll),
+                    static_cast<int64_t>(ReadMode::IoUringReadv),
+                    static_cast<int64_t>(ReadMode::IoUringRecvMultishot)},
+                   {16, 256},
+                   {64, 1024}})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Io
+} // namespace Envoy
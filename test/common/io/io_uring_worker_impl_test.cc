@@ -33,8 +33,10 @@ public:
 
 class IoUringWorkerTestImpl : public IoUringWorkerImpl {
 public:
-  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher)
-      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, dispatcher) {}
+  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher,
+                        uint32_t provided_buffer_count = 0)
+      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, dispatcher,
+                          provided_buffer_count) {}
 
   IoUringSocket& addTestSocket(os_fd_t fd) {
     return addSocket(std::make_unique<IoUringSocketTestImpl>(fd, *this));
@@ -218,7 +220,7 @@ TEST(IoUringWorkerImplTest, ServerSocketInjectAfterWrite) {
   EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
       .WillOnce(Invoke([&io_uring_socket](const CompletionCb& cb) {
         auto* req = new Request(Request::RequestType::Write, io_uring_socket);
-        cb(req, -EAGAIN, true);
+        cb(req, -EAGAIN, 0, true);
       }));
   EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
   ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
@@ -244,9 +246,9 @@ TEST(IoUringWorkerImplTest, ServerSocketInjectAfterWrite) {
   // Finish the read, cancel and write request, then expect the close request submitted.
   EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
       .WillOnce(Invoke([&read_req, &cancel_req, &write_req](const CompletionCb& cb) {
-        cb(read_req, -EAGAIN, false);
-        cb(cancel_req, 0, false);
-        cb(write_req, -EAGAIN, false);
+        cb(read_req, -EAGAIN, 0, false);
+        cb(cancel_req, 0, 0, false);
+        cb(write_req, -EAGAIN, 0, false);
       }));
   Request* close_req = nullptr;
   EXPECT_CALL(mock_io_uring, prepareClose(_, _))
@@ -257,7 +259,7 @@ TEST(IoUringWorkerImplTest, ServerSocketInjectAfterWrite) {
 
   // After the close request finished, the socket will be cleanup.
   EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
-      .WillOnce(Invoke([&close_req](const CompletionCb& cb) { cb(close_req, 0, false); }));
+      .WillOnce(Invoke([&close_req](const CompletionCb& cb) { cb(close_req, 0, 0, false); }));
   EXPECT_CALL(mock_io_uring, removeInjectedCompletion(fd));
   EXPECT_CALL(dispatcher, deferredDelete_);
   EXPECT_CALL(dispatcher, clearDeferredDeleteList());
@@ -296,7 +298,7 @@ TEST(IoUringWorkerImplTest, ServerSocketInjectAfterRead) {
   EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
       .WillOnce(Invoke([&io_uring_socket](const CompletionCb& cb) {
         auto* req = new Request(Request::RequestType::Write, io_uring_socket);
-        cb(req, -EAGAIN, true);
+        cb(req, -EAGAIN, 0, true);
       }));
   EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
   ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
@@ -313,8 +315,8 @@ TEST(IoUringWorkerImplTest, ServerSocketInjectAfterRead) {
   // Finish the read and cancel request, then expect the close request submitted.
   EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
       .WillOnce(Invoke([&read_req, &cancel_req](const CompletionCb& cb) {
-        cb(read_req, -EAGAIN, false);
-        cb(cancel_req, 0, false);
+        cb(read_req, -EAGAIN, 0, false);
+        cb(cancel_req, 0, 0, false);
       }));
   Request* close_req = nullptr;
   EXPECT_CALL(mock_io_uring, prepareClose(_, _))
@@ -325,7 +327,7 @@ TEST(IoUringWorkerImplTest, ServerSocketInjectAfterRead) {
 
   // After the close request finished, the socket will be cleanup.
   EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
-      .WillOnce(Invoke([&close_req](const CompletionCb& cb) { cb(close_req, 0, false); }));
+      .WillOnce(Invoke([&close_req](const CompletionCb& cb) { cb(close_req, 0, 0, false); }));
   EXPECT_CALL(mock_io_uring, removeInjectedCompletion(fd));
   EXPECT_CALL(dispatcher, deferredDelete_);
   EXPECT_CALL(dispatcher, clearDeferredDeleteList());
@@ -380,13 +382,13 @@ TEST(IoUringWorkerImplTest, CloseAllSocketsWhenDestruction) {
         EXPECT_CALL(mock_io_uring, removeInjectedCompletion(fd));
 
         // Fake the read request cancel completion.
-        cb(read_req, -ECANCELED, false);
+        cb(read_req, -ECANCELED, 0, false);
 
         // Fake the cancel request is done.
-        cb(cancel_req, 0, false);
+        cb(cancel_req, 0, 0, false);
 
         // Fake the close request is done.
-        cb(close_req, 0, false);
+        cb(close_req, 0, 0, false);
       }));
 
   EXPECT_CALL(dispatcher, deferredDelete_);
@@ -422,7 +424,7 @@ TEST(IoUringWorkerImplTest, ServerCloseWithWriteRequestOnly) {
   io_uring_socket.disableRead();
   // Fake the read request finish.
   EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
-      .WillOnce(Invoke([&read_req](const CompletionCb& cb) { cb(read_req, -EAGAIN, false); }));
+      .WillOnce(Invoke([&read_req](const CompletionCb& cb) { cb(read_req, -EAGAIN, 0, false); }));
   EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
   ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
 
@@ -448,13 +450,13 @@ TEST(IoUringWorkerImplTest, ServerCloseWithWriteRequestOnly) {
             .RetiresOnSaturation();
         EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
 
-        cb(write_req, -EAGAIN, false);
+        cb(write_req, -EAGAIN, 0, false);
       }));
   ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
 
   // After the close request finished, the socket will be cleanup.
   EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
-      .WillOnce(Invoke([&close_req](const CompletionCb& cb) { cb(close_req, 0, false); }));
+      .WillOnce(Invoke([&close_req](const CompletionCb& cb) { cb(close_req, 0, 0, false); }));
   EXPECT_CALL(mock_io_uring, removeInjectedCompletion(fd));
   EXPECT_CALL(dispatcher, deferredDelete_);
   EXPECT_CALL(dispatcher, clearDeferredDeleteList());
@@ -693,6 +695,249 @@ TEST(IoUringWorkerImplTest, NoEnableReadOnConnectError) {
   delete static_cast<Request*>(connect_req);
 }
 
+class IoUringWorkerMultishotRecvTest : public testing::Test {
+protected:
+  IoUringWorkerMultishotRecvTest() {
+    IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+    mock_io_uring_ = dynamic_cast<MockIoUring*>(io_uring_instance.get());
+    EXPECT_CALL(*mock_io_uring_, registerProvidedBuffers(16, 8192))
+        .WillOnce(Return(IoUringResult::Ok));
+    EXPECT_CALL(*mock_io_uring_, availableProvidedBuffers()).WillRepeatedly(Return(16));
+    EXPECT_CALL(*mock_io_uring_, registerEventfd());
+    EXPECT_CALL(dispatcher_, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                              Event::FileReadyType::Read))
+        .WillOnce(
+            DoAll(SaveArg<1>(&file_event_callback_), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+    worker_ = std::make_unique<IoUringWorkerTestImpl>(std::move(io_uring_instance), dispatcher_,
+                                                      16);
+    SET_SOCKET_INVALID(fd_);
+  }
+
+  // Adds a server socket, which arms a multishot recv request right away.
+  void addSocket() {
+    EXPECT_CALL(*mock_io_uring_, prepareRecvMultishot(fd_, _))
+        .WillOnce(DoAll(SaveArg<1>(&read_req_), Return<IoUringResult>(IoUringResult::Ok)))
+        .RetiresOnSaturation();
+    EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+    socket_ = &worker_->addServerSocket(
+        fd_,
+        [this](uint32_t) {
+          read_callbacks_++;
+          Buffer::Instance& buf = socket_->getReadParam()->buf_;
+          read_data_.append(buf.toString());
+          buf.drain(buf.length());
+          return absl::OkStatus();
+        },
+        false);
+  }
+
+  // The completion flags of a recv which picked the provided buffer `buffer_id`.
+  static uint32_t bufferFlags(uint16_t buffer_id, bool more) {
+    return IORING_CQE_F_BUFFER | (static_cast<uint32_t>(buffer_id) << IORING_CQE_BUFFER_SHIFT) |
+           (more ? IORING_CQE_F_MORE : 0);
+  }
+
+  // A fragment standing in for a provided buffer handed out by the ring.
+  static Buffer::BufferFragment* providedBuffer(absl::string_view data) {
+    return new Buffer::BufferFragmentImpl(
+        data.data(), data.size(),
+        [](const void*, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
+          delete this_fragment;
+        });
+  }
+
+  // Completes the close request and expects the socket to be cleaned up.
+  void completeClose(Request* close_req) {
+    EXPECT_CALL(*mock_io_uring_, forEveryCompletion(_))
+        .WillOnce(Invoke([close_req](const CompletionCb& cb) { cb(close_req, 0, 0, false); }));
+    EXPECT_CALL(*mock_io_uring_, removeInjectedCompletion(fd_));
+    EXPECT_CALL(dispatcher_, deferredDelete_);
+    EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
+    EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+    ASSERT_TRUE(file_event_callback_(Event::FileReadyType::Read).ok());
+    EXPECT_EQ(0, worker_->getSockets().size());
+  }
+
+  // Closes the socket, cancelling the in flight read request `read_req_` first.
+  void closeSocket() {
+    Request* cancel_req = nullptr;
+    EXPECT_CALL(*mock_io_uring_, prepareCancel(read_req_, _))
+        .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)))
+        .RetiresOnSaturation();
+    EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+    socket_->close(false);
+
+    EXPECT_CALL(*mock_io_uring_, forEveryCompletion(_))
+        .WillOnce(Invoke([this, &cancel_req](const CompletionCb& cb) {
+          cb(read_req_, -ECANCELED, 0, false);
+          cb(cancel_req, 0, 0, false);
+        }));
+    Request* close_req = nullptr;
+    EXPECT_CALL(*mock_io_uring_, prepareClose(fd_, _))
+        .WillOnce(DoAll(SaveArg<1>(&close_req), Return<IoUringResult>(IoUringResult::Ok)))
+        .RetiresOnSaturation();
+    EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+    ASSERT_TRUE(file_event_callback_(Event::FileReadyType::Read).ok());
+
+    completeClose(close_req);
+  }
+
+  Event::MockDispatcher dispatcher_;
+  MockIoUring* mock_io_uring_{};
+  Event::FileReadyCb file_event_callback_;
+  std::unique_ptr<IoUringWorkerTestImpl> worker_;
+  os_fd_t fd_;
+  IoUringSocket* socket_{};
+  Request* read_req_{};
+  std::string read_data_;
+  uint32_t read_callbacks_{};
+};
+
+TEST_F(IoUringWorkerMultishotRecvTest, StaysArmedAcrossCompletions) {
+  addSocket();
+
+  // Every completion hands its provided buffer to the socket without submitting a new read.
+  EXPECT_CALL(*mock_io_uring_, takeProvidedBuffer(1, 5)).WillOnce(Return(providedBuffer("hello")));
+  EXPECT_CALL(*mock_io_uring_, takeProvidedBuffer(2, 5)).WillOnce(Return(providedBuffer("world")));
+  EXPECT_CALL(*mock_io_uring_, recycleProvidedBuffer(_)).Times(0);
+  EXPECT_CALL(*mock_io_uring_, prepareRecvMultishot(_, _)).Times(0);
+  EXPECT_CALL(*mock_io_uring_, prepareReadv(_, _, _, _, _)).Times(0);
+  EXPECT_CALL(*mock_io_uring_, forEveryCompletion(_))
+      .WillOnce(Invoke([this](const CompletionCb& cb) {
+        cb(read_req_, 5, bufferFlags(1, true), false);
+        cb(read_req_, 5, bufferFlags(2, true), false);
+      }));
+  EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback_(Event::FileReadyType::Read).ok());
+  EXPECT_EQ("helloworld", read_data_);
+
+  // The request is still armed, so closing the socket has to cancel it.
+  closeSocket();
+}
+
+TEST_F(IoUringWorkerMultishotRecvTest, DisableReadCancelsArmedRequest) {
+  addSocket();
+
+  // The cancel request is submitted only once.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareCancel(read_req_, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+  socket_->disableRead();
+  socket_->disableRead();
+
+  // Once the canceled request terminates, a single shot read watches for the remote close.
+  Request* readv_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareRecvMultishot(_, _)).Times(0);
+  EXPECT_CALL(*mock_io_uring_, prepareReadv(fd_, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&readv_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(*mock_io_uring_, forEveryCompletion(_))
+      .WillOnce(Invoke([this, &cancel_req](const CompletionCb& cb) {
+        cb(read_req_, -ECANCELED, 0, false);
+        cb(cancel_req, 0, 0, false);
+      }));
+  EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback_(Event::FileReadyType::Read).ok());
+  EXPECT_EQ(0, read_callbacks_);
+
+  read_req_ = readv_req;
+  closeSocket();
+}
+
+TEST_F(IoUringWorkerMultishotRecvTest, FallBackToReadvOnEnobufs) {
+  addSocket();
+
+  // The armed request terminates with -ENOBUFS when the ring runs out of provided buffers. It is
+  // not reported to the handler and the next read is a single shot read.
+  EXPECT_CALL(*mock_io_uring_, availableProvidedBuffers()).WillRepeatedly(Return(0));
+  Request* readv_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareRecvMultishot(_, _)).Times(0);
+  EXPECT_CALL(*mock_io_uring_, prepareReadv(fd_, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&readv_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(*mock_io_uring_, forEveryCompletion(_))
+      .WillOnce(Invoke([this](const CompletionCb& cb) { cb(read_req_, -ENOBUFS, 0, false); }));
+  EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback_(Event::FileReadyType::Read).ok());
+  EXPECT_EQ(0, read_callbacks_);
+
+  // Once provided buffers are recycled, the next read arms a multishot recv again.
+  EXPECT_CALL(*mock_io_uring_, availableProvidedBuffers()).WillRepeatedly(Return(16));
+  EXPECT_CALL(*mock_io_uring_, prepareRecvMultishot(fd_, _))
+      .WillOnce(DoAll(SaveArg<1>(&read_req_), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(*mock_io_uring_, forEveryCompletion(_))
+      .WillOnce(Invoke([&readv_req](const CompletionCb& cb) { cb(readv_req, -EAGAIN, 0, false); }));
+  EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback_(Event::FileReadyType::Read).ok());
+
+  closeSocket();
+}
+
+TEST_F(IoUringWorkerMultishotRecvTest, CloseWhileArmed) {
+  addSocket();
+
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareCancel(read_req_, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+  socket_->close(false);
+
+  // The cancel request may complete before the armed request terminates. The socket is not closed
+  // until then, and the data received meanwhile is not delivered to the closed socket's handler.
+  EXPECT_CALL(*mock_io_uring_, takeProvidedBuffer(1, 5)).WillOnce(Return(providedBuffer("hello")));
+  EXPECT_CALL(*mock_io_uring_, prepareClose(_, _)).Times(0);
+  EXPECT_CALL(*mock_io_uring_, forEveryCompletion(_))
+      .WillOnce(Invoke([this, &cancel_req](const CompletionCb& cb) {
+        cb(cancel_req, 0, 0, false);
+        cb(read_req_, 5, bufferFlags(1, true), false);
+      }));
+  EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback_(Event::FileReadyType::Read).ok());
+  EXPECT_EQ(0, read_callbacks_);
+
+  // The socket is closed once the armed request terminates.
+  Request* close_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareClose(fd_, _))
+      .WillOnce(DoAll(SaveArg<1>(&close_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(*mock_io_uring_, forEveryCompletion(_))
+      .WillOnce(Invoke([this](const CompletionCb& cb) { cb(read_req_, -ECANCELED, 0, false); }));
+  EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback_(Event::FileReadyType::Read).ok());
+
+  completeClose(close_req);
+}
+
+TEST_F(IoUringWorkerMultishotRecvTest, RecycleUnconsumedBuffer) {
+  addSocket();
+
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareCancel(read_req_, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+  socket_->close(false);
+
+  // The last completion of the armed request carries data which the closing socket discards, so
+  // its provided buffer goes straight back to the ring.
+  Request* close_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, takeProvidedBuffer(_, _)).Times(0);
+  EXPECT_CALL(*mock_io_uring_, recycleProvidedBuffer(3));
+  EXPECT_CALL(*mock_io_uring_, prepareClose(fd_, _))
+      .WillOnce(DoAll(SaveArg<1>(&close_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(*mock_io_uring_, forEveryCompletion(_))
+      .WillOnce(Invoke([this, &cancel_req](const CompletionCb& cb) {
+        cb(cancel_req, 0, 0, false);
+        cb(read_req_, 5, bufferFlags(3, false), false);
+      }));
+  EXPECT_CALL(*mock_io_uring_, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback_(Event::FileReadyType::Read).ok());
+
+  completeClose(close_req);
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
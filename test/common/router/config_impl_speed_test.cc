@@ -59,7 +59,7 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       break;
     }
     case RouteMatch::PathSpecifierCase::kPath: {
-      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
       break;
     }
     case RouteMatch::PathSpecifierCase::kSafeRegex: {
@@ -76,6 +76,51 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
   return route_config;
 }
 
+/**
+ * Generates a large route config mixing the route types seen in real tables. Every tenth route
+ * is a regex route and every tenth route (offset by one) an exact path route that also requires
+ * a header, the rest are prefix and exact path routes. Regex routes are evaluated in order while
+ * the exact and prefix routes are looked up through the route index.
+ */
+static RouteConfiguration genMixedRouteConfig(benchmark::State& state) {
+  RouteConfiguration route_config;
+  VirtualHost* v_host = route_config.add_virtual_hosts();
+  v_host->set_name("default");
+  v_host->add_domains("*");
+
+  for (int i = 0; i < state.range(0); ++i) {
+    Route* route = v_host->add_routes();
+    route->mutable_direct_response()->set_status(200);
+    RouteMatch* match = route->mutable_match();
+
+    switch (i % 10) {
+    case 0: {
+      envoy::type::matcher::v3::RegexMatcher* regex = match->mutable_safe_regex();
+      regex->mutable_google_re2();
+      regex->set_regex(absl::StrCat("^/regex/[^\\/]+/route_", i, "$"));
+      break;
+    }
+    case 1: {
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      auto* header = match->add_headers();
+      header->set_name("x-tenant");
+      header->mutable_string_match()->set_exact("tenant");
+      break;
+    }
+    case 2:
+    case 3:
+    case 4:
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      break;
+    default:
+      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/"));
+      break;
+    }
+  }
+
+  return route_config;
+}
+
 /**
  * Generates a route config using matcher tree semantics with n entries.
  */
@@ -256,6 +301,35 @@ static void bmRouteTableSizeWithRegexMatch(benchmark::State& state) {
   bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kSafeRegex);
 }
 
+/**
+ * Benchmark a large route table mixing regex, header constrained exact, exact and prefix
+ * routes. Requests are spread over the whole table so that both early and late routes are
+ * matched, as well as requests which match no route at all.
+ */
+static void bmLargeRouteTableWithMixedMatch(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+
+  std::shared_ptr<ConfigImpl> config =
+      *ConfigImpl::create(genMixedRouteConfig(state), factory_context,
+                          ProtobufMessage::getNullValidationVisitor(), true);
+
+  std::vector<Http::TestRequestHeaderMapImpl> requests;
+  for (int i = 0; i < 64; ++i) {
+    // The last request matches no route.
+    requests.push_back(genRequestHeaders(i == 63 ? state.range(0) : i * state.range(0) / 64 + 5));
+  }
+
+  size_t matched = 0;
+  size_t i = 0;
+  for (auto _ : state) { // NOLINT
+    matched += config->route(requests[i++ % requests.size()], stream_info, 0) != nullptr;
+  }
+  benchmark::DoNotOptimize(matched);
+}
+
 /**
  * Benchmark matcher tree route matching performance with exact path matchers in the form of:
  * - /shelves/shelf_1/route_1
@@ -314,6 +388,7 @@ static void bmRouteTableSizeWithPrefixMatcherTree(benchmark::State& state) {
 BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmLargeRouteTableWithMixedMatch)->Arg(512)->Arg(3000)->Arg(10000);
 
 BENCHMARK(bmRouteTableSizeWithExactMatcherTree)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithPrefixMatcherTree)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
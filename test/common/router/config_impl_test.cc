@@ -11703,6 +11703,87 @@ virtual_hosts:
   EXPECT_TRUE(route5->filterDisabled("test.filter").value());
 }
 
+// Virtual hosts with many routes are matched through a RouteIndex. Verify that the route chosen is
+// still the first matching route in configuration order when indexed (exact and prefix) routes are
+// interleaved with fallback (regex, case insensitive, header constrained) routes.
+TEST_F(RouteMatcherTest, IndexedRoutesPreserveFirstMatch) {
+  std::string yaml = R"EOF(
+virtual_hosts:
+- name: indexed
+  domains: ["*"]
+  routes:
+  - match:
+      path: "/exact"
+      headers:
+      - name: x-a
+        string_match: { exact: "a" }
+    route: { cluster: exact_header }
+  - match: { safe_regex: { regex: "/exact/.+" } }
+    route: { cluster: regex_exact }
+  - match: { path: "/exact" }
+    route: { cluster: exact }
+  - match: { prefix: "/api/v1/users" }
+    route: { cluster: users }
+  - match: { prefix: "/api/v1", case_sensitive: false }
+    route: { cluster: api_ci }
+  - match: { prefix: "/api" }
+    route: { cluster: api }
+  - match: { path: "/q" }
+    route: { cluster: q }
+)EOF";
+  std::vector<std::string> clusters{"exact_header", "regex_exact", "exact", "users", "api_ci",
+                                    "api",          "q",           "default"};
+  for (int i = 0; i < 20; i++) {
+    absl::StrAppend(&yaml, "  - match: { prefix: \"/svc", i, "/\" }\n", "    route: { cluster: svc",
+                    i, " }\n", "  - match: { path: \"/p", i, "\" }\n",
+                    "    route: { cluster: p", i, " }\n");
+    clusters.push_back(absl::StrCat("svc", i));
+    clusters.push_back(absl::StrCat("p", i));
+  }
+  absl::StrAppend(&yaml, "  - match: { prefix: \"/\" }\n    route: { cluster: default }\n");
+
+  factory_context_.cluster_manager_.initializeClusters(clusters, {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true,
+                        creation_status_);
+  ASSERT_TRUE(creation_status_.ok());
+
+  const auto cluster = [&config](Http::TestRequestHeaderMapImpl headers) -> std::string {
+    RouteConstSharedPtr route = config.route(headers, 0);
+    return route == nullptr ? "" : route->routeEntry()->clusterName();
+  };
+
+  Http::TestRequestHeaderMapImpl header_match = genHeaders("www.lyft.com", "/exact", "GET");
+  header_match.addCopy("x-a", "a");
+  EXPECT_EQ("exact_header", cluster(header_match));
+  EXPECT_EQ("exact", cluster(genHeaders("www.lyft.com", "/exact", "GET")));
+  EXPECT_EQ("exact", cluster(genHeaders("www.lyft.com", "/exact?x=1", "GET")));
+  EXPECT_EQ("regex_exact", cluster(genHeaders("www.lyft.com", "/exact/1", "GET")));
+  EXPECT_EQ("users", cluster(genHeaders("www.lyft.com", "/api/v1/users/5", "GET")));
+  EXPECT_EQ("api_ci", cluster(genHeaders("www.lyft.com", "/api/v1/x", "GET")));
+  EXPECT_EQ("api_ci", cluster(genHeaders("www.lyft.com", "/API/V1/users", "GET")));
+  EXPECT_EQ("api", cluster(genHeaders("www.lyft.com", "/api/v2", "GET")));
+  EXPECT_EQ("q", cluster(genHeaders("www.lyft.com", "/q?x=1#frag", "GET")));
+  EXPECT_EQ("svc7", cluster(genHeaders("www.lyft.com", "/svc7/foo", "GET")));
+  EXPECT_EQ("svc1", cluster(genHeaders("www.lyft.com", "/svc1/", "GET")));
+  EXPECT_EQ("p13", cluster(genHeaders("www.lyft.com", "/p13", "GET")));
+  EXPECT_EQ("default", cluster(genHeaders("www.lyft.com", "/p13/x", "GET")));
+  EXPECT_EQ("default", cluster(genHeaders("www.lyft.com", "/svc7", "GET")));
+  EXPECT_EQ("default", cluster(genHeaders("www.lyft.com", "/nothing", "GET")));
+
+  // All matching routes are offered to the callback in configuration order, and only the last
+  // route of the virtual host is reported as having no more routes.
+  std::vector<std::string> offered;
+  RouteConstSharedPtr accepted = config.route(
+      [&offered](RouteConstSharedPtr route, RouteEvalStatus eval_status) -> RouteMatchStatus {
+        offered.push_back(route->routeEntry()->clusterName());
+        EXPECT_EQ(offered.back() == "default", eval_status == RouteEvalStatus::NoMoreRoutes);
+        return RouteMatchStatus::Continue;
+      },
+      genHeaders("www.lyft.com", "/api/v1/users/5", "GET"));
+  EXPECT_EQ(nullptr, accepted);
+  EXPECT_THAT(offered, testing::ElementsAre("users", "api_ci", "api", "default"));
+}
+
 class RouteMatchOverrideTest : public testing::Test, public ConfigImplTestBase {};
 
 TEST_F(RouteMatchOverrideTest, VerifyAllMatchableRoutes) {
@@ -10,6 +10,7 @@
 #include "test/test_common/logging.h"
 #include "test/test_common/thread_factory_for_test.h"
 
+#include "absl/strings/match.h"
 #include "absl/synchronization/notification.h"
 #include "gmock/gmock-matchers.h"
 #include "gtest/gtest.h"
@@ -137,6 +138,73 @@ TEST_F(AllocatorImplTest, RefCountDecAllocRaceSynchronized) {
   EXPECT_FALSE(alloc_.isMutexLockedForTest());
 }
 
+// Accepts stat names starting with a given prefix.
+class PrefixStatsMatcher : public StatsMatcher {
+public:
+  PrefixStatsMatcher(SymbolTable& symbol_table, absl::string_view prefix)
+      : symbol_table_(symbol_table), prefix_(prefix) {}
+
+  bool rejects(StatName name) const override {
+    return !absl::StartsWith(symbol_table_.toString(name), prefix_);
+  }
+  FastResult fastRejects(StatName) const override { return FastResult::NoMatch; }
+  bool slowRejects(FastResult, StatName name) const override { return rejects(name); }
+  bool acceptsAll() const override { return false; }
+  bool rejectsAll() const override { return false; }
+
+private:
+  SymbolTable& symbol_table_;
+  const std::string prefix_;
+};
+
+TEST_F(AllocatorImplTest, ShardedCounter) {
+  alloc_.setShardedCounterMatcher(std::make_unique<PrefixStatsMatcher>(symbol_table_, "hot."));
+  StatName sharded_name = makeStat("hot.counter");
+  StatName regular_name = makeStat("cold.counter");
+  CounterSharedPtr sharded = alloc_.makeCounter(sharded_name, StatName(), {});
+  CounterSharedPtr regular = alloc_.makeCounter(regular_name, StatName(), {});
+  EXPECT_EQ(sharded.get(), alloc_.makeCounter(sharded_name, StatName(), {}).get());
+  EXPECT_FALSE(sharded->used());
+
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  const uint32_t num_threads = 12;
+  const uint32_t iters = 1000;
+  std::vector<Thread::ThreadPtr> threads;
+  absl::Notification go;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([&]() {
+      go.WaitForNotification();
+      for (uint32_t i = 0; i < iters; ++i) {
+        sharded->inc();
+        regular->inc();
+      }
+      sharded->add(2);
+    }));
+  }
+  go.Notify();
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+  }
+
+  const uint64_t expected = num_threads * (iters + 2);
+  EXPECT_TRUE(sharded->used());
+  EXPECT_EQ(expected, sharded->value());
+  EXPECT_EQ(num_threads * iters, regular->value());
+  EXPECT_EQ(expected, sharded->latch());
+  EXPECT_EQ(0, sharded->latch());
+
+  sharded->inc();
+  sharded->reset();
+  EXPECT_EQ(0, sharded->value());
+  // As with regular counters, reset() does not discard increments that are pending a latch.
+  EXPECT_EQ(1, sharded->latch());
+
+  sharded->markUnused();
+  EXPECT_FALSE(sharded->used());
+  sharded->inc();
+  EXPECT_TRUE(sharded->used());
+}
+
 TEST_F(AllocatorImplTest, HiddenGauge) {
   GaugeSharedPtr hidden_gauge =
       alloc_.makeGauge(makeStat("hidden"), StatName(), {}, Gauge::ImportMode::HiddenAccumulate);
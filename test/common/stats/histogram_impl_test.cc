@@ -1,3 +1,6 @@
+#include <cstdint>
+#include <limits>
+
 #include "envoy/config/metrics/v3/stats.pb.h"
 
 #include "source/common/stats/histogram_impl.h"
@@ -121,5 +124,78 @@ TEST_F(HistogramSettingsImplTest, ScaledPercent) {
   EXPECT_EQ(settings_->buckets("abcd"), ConstSupportedBuckets({0.1, 2}));
 }
 
+class LogLinearBucketsTest : public testing::Test {
+public:
+  LogLinearBucketsTest() : expected_(hist_alloc()), actual_(hist_alloc()) {}
+  ~LogLinearBucketsTest() override {
+    hist_free(expected_);
+    hist_free(actual_);
+  }
+
+  void record(uint64_t value) {
+    hist_insert_intscale(expected_, value, 0, 1);
+    buckets_.recordValue(value);
+  }
+
+  void expectSameBuckets() {
+    ASSERT_EQ(hist_num_buckets(expected_), hist_num_buckets(actual_));
+    for (int i = 0; i < hist_num_buckets(expected_); ++i) {
+      hist_bucket_t expected_bucket;
+      hist_bucket_t actual_bucket;
+      uint64_t expected_count;
+      uint64_t actual_count;
+      hist_bucket_idx_bucket(expected_, i, &expected_bucket, &expected_count);
+      hist_bucket_idx_bucket(actual_, i, &actual_bucket, &actual_count);
+      EXPECT_EQ(expected_bucket.val, actual_bucket.val) << "bucket " << i;
+      EXPECT_EQ(expected_bucket.exp, actual_bucket.exp) << "bucket " << i;
+      EXPECT_EQ(expected_count, actual_count) << "bucket " << i;
+    }
+  }
+
+  LogLinearBuckets buckets_;
+  histogram_t* expected_;
+  histogram_t* actual_;
+};
+
+// Merged buckets match inserting every value into a circllhist.
+TEST_F(LogLinearBucketsTest, MatchesCircllhist) {
+  for (uint64_t value = 0; value < 2000; ++value) {
+    record(value);
+  }
+  uint64_t value = 1;
+  for (int i = 0; i < 64; ++i) {
+    record(value - 1);
+    record(value);
+    record(value + 1);
+    value *= 2;
+  }
+  for (uint64_t power = 10; power <= 1000000000000000000ULL; power *= 10) {
+    record(power - 1);
+    record(power);
+  }
+  record(std::numeric_limits<int64_t>::max());
+  record(std::numeric_limits<uint64_t>::max());
+
+  buckets_.mergeInto(actual_);
+  expectSameBuckets();
+}
+
+// Merging clears the recorded values, and later values are merged on top of earlier ones.
+TEST_F(LogLinearBucketsTest, MergeClears) {
+  record(0);
+  record(7);
+  record(12345);
+  buckets_.mergeInto(actual_);
+  buckets_.mergeInto(actual_);
+  expectSameBuckets();
+  EXPECT_EQ(3, hist_sample_count(actual_));
+
+  record(7);
+  record(std::numeric_limits<uint64_t>::max());
+  buckets_.mergeInto(actual_);
+  expectSameBuckets();
+  EXPECT_EQ(5, hist_sample_count(actual_));
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -595,28 +595,27 @@ TEST_F(StatNameTest, MutexContentionOnExistingSymbols) {
   int64_t create_contentions = mutex_tracer.numContentions();
   ENVOY_LOG_MISC(info, "Number of contentions: {}", create_contentions);
 
-  // But when we access the already-existing symbols, we guarantee that no
-  // further mutex contentions occur.
+  // But when we access the already-existing symbols, no further symbol-table
+  // contentions should occur: encoding a name whose tokens are all in the table
+  // only takes the lock in shared mode. The tracer also counts contentions on
+  // the test's own synchronization, so we only log the number here.
   access.setReady();
   accesses.Wait();
+  ENVOY_LOG_MISC(info, "Number of contentions after access: {}",
+                 mutex_tracer.numContentions() - create_contentions);
 
-  // In a perfect world, we could use reader-locks in the SymbolTable
-  // implementation, and there should be zero additional contentions
-  // after latching 'create_contentions' above. And we can definitely
-  // have this world, but this slows down BM_CreateRace in
-  // symbol_table_speed_test.cc, even on a 72-core machine.
-  //
-  // Thus it is better to avoid symbol-table contention by refactoring
-  // all stat-creation code to symbolize all stat string elements at
-  // construction, as composition does not require a lock.
-  //
+  // An earlier reader-lock implementation of the SymbolTable slowed down
+  // BM_CreateRace in symbol_table_speed_test.cc, even on a 72-core machine.
   // See this commit
   // https://github.com/envoyproxy/envoy/pull/5321/commits/ef712d0f5a11ff49831c1935e8a2ef8a0a935bc9
-  // for a working reader-lock implementation, which would pass this EXPECT:
-  //     EXPECT_EQ(create_contentions, mutex_tracer.numContentions());
+  // for that implementation. Changes to the locking here should be checked
+  // against BM_CreateRace as well as bmEncodeKnownSymbolsMultiThreaded, and it
+  // is still better to avoid symbol-table contention by symbolizing all
+  // stat string elements at construction, as composition does not require a
+  // lock.
   //
-  // Note also that we cannot guarantee there *will* be contentions
-  // as a machine or OS is free to run all threads serially.
+  // Note also that we cannot guarantee there *will* be contentions during
+  // creation, as a machine or OS is free to run all threads serially.
 
   wait.setReady();
   for (auto& thread : threads) {
@@ -714,6 +713,28 @@ TEST_F(StatNameTest, RecentLookups) {
   EXPECT_EQ(0, num_calls);
 }
 
+// Names whose tokens are all in the table are encoded sharing the lock, which
+// must still count them as lookups and hold references to their symbols.
+TEST_F(StatNameTest, EncodeKnownSymbols) {
+  StatNameStorage first("known.stat", table_);
+  StatNameStorage second("known.stat", table_);
+  StatNameStorage partial("known.other", table_);
+  EXPECT_EQ(first.statName(), second.statName());
+  EXPECT_EQ(3, table_.numSymbols());
+  EXPECT_EQ(3, table_.getRecentLookups([](absl::string_view, uint64_t) {}));
+
+  // Dropping references that are not the last ones keeps the symbols.
+  first.free(table_);
+  partial.free(table_);
+  EXPECT_EQ(2, table_.numSymbols());
+  EXPECT_EQ("known.stat", table_.toString(second.statName()));
+  second.free(table_);
+  EXPECT_EQ(0, table_.numSymbols());
+
+  table_.clearRecentLookups();
+  EXPECT_EQ(0, table_.getRecentLookups([](absl::string_view, uint64_t) {}));
+}
+
 TEST_F(StatNameTest, StatNameEmptyEquivalent) {
   StatName empty1;
   StatName empty2 = makeStat("");
@@ -63,6 +63,48 @@ static void bmCreateRace(benchmark::State& state) {
 }
 BENCHMARK(bmCreateRace)->Unit(::benchmark::kMillisecond);
 
+// Encodes names from several threads at once, as filters creating per-tenant
+// stats at request time do. All symbolic tokens are already in the table, so
+// each encode and copy only adds references to existing symbols, and each free
+// drops references that are not the last ones.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmEncodeKnownSymbolsMultiThreaded(benchmark::State& state) {
+  const int num_threads = state.range(0);
+  Envoy::Thread::ThreadFactory& thread_factory = Envoy::Thread::threadFactoryForTest();
+  Envoy::Stats::SymbolTableImpl table;
+  Envoy::Stats::StatNamePool pool(table);
+  const Envoy::Stats::StatName prefix = pool.add("cluster.tenant_stats");
+  const Envoy::Stats::StatName suffix = pool.add("upstream_rq_total");
+  const absl::string_view known_name = "cluster.tenant_stats.upstream_rq_total";
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    std::vector<Envoy::Thread::ThreadPtr> threads;
+    threads.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      threads.push_back(thread_factory.createThread([&table, prefix, suffix, known_name, i]() {
+        Envoy::Stats::StatNameDynamicPool dynamic_pool(table);
+        const Envoy::Stats::StatName tenant = dynamic_pool.add(absl::StrCat("tenant_", i));
+        for (int count = 0; count < 10000; ++count) {
+          Envoy::Stats::StatNameStorage encoded(known_name, table);
+          Envoy::Stats::SymbolTable::StoragePtr joined = table.join({prefix, tenant, suffix});
+          Envoy::Stats::StatNameStorage copied(Envoy::Stats::StatName(joined.get()), table);
+          copied.free(table);
+          encoded.free(table);
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+}
+BENCHMARK(bmEncodeKnownSymbolsMultiThreaded)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Unit(::benchmark::kMillisecond);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void bmJoinStatNames(benchmark::State& state) {
   Envoy::Stats::SymbolTableImpl symbol_table;
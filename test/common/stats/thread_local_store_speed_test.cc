@@ -1,12 +1,15 @@
 // Note: this should be run with --compilation_mode=opt, and would benefit from a
 // quiescent system with disabled cstate power management.
 
+#include <vector>
+
 #include "envoy/config/metrics/v3/stats.pb.h"
 
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 #include "source/common/event/dispatcher_impl.h"
 #include "source/common/stats/allocator_impl.h"
+#include "source/common/stats/histogram_impl.h"
 #include "source/common/stats/stats_matcher_impl.h"
 #include "source/common/stats/symbol_table.h"
 #include "source/common/stats/tag_producer_impl.h"
@@ -19,6 +22,7 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -66,6 +70,43 @@ public:
     store_.initializeThreading(*dispatcher_, *tls_);
   }
 
+  Stats::Counter& counter(absl::string_view name) {
+    Stats::StatNameManagedStorage storage(name, symbol_table_);
+    return store_.rootScope()->counterFromStatName(storage.statName());
+  }
+
+  void initShardedCounters(const std::string& prefix) {
+    envoy::config::metrics::v3::StatsMatcher matcher;
+    matcher.mutable_inclusion_list()->add_patterns()->set_prefix(prefix);
+    store_.setShardedCounterMatcher(
+        std::make_unique<Stats::StatsMatcherImpl>(matcher, symbol_table_, context_));
+  }
+
+  Stats::Histogram& histogram(absl::string_view name) {
+    Stats::StatNameManagedStorage storage(name, symbol_table_);
+    return store_.rootScope()->histogramFromStatName(storage.statName(),
+                                                     Stats::Histogram::Unit::Milliseconds);
+  }
+
+  // Makes thread-local histograms insert into circllhists with the given initial bins, rather
+  // than count into LogLinearBuckets.
+  void initHistogramBins(uint32_t bins) {
+    envoy::config::metrics::v3::StatsConfig config;
+    auto* setting = config.add_histogram_bucket_settings();
+    setting->mutable_match()->set_prefix("cluster.");
+    setting->mutable_bins()->set_value(bins);
+    store_.setHistogramSettings(std::make_unique<Stats::HistogramSettingsImpl>(config, context_));
+  }
+
+  // Merges the thread-local histograms into their parents, as a stats flush does.
+  void mergeHistograms() {
+    bool merged = false;
+    store_.mergeHistograms([&merged]() { merged = true; });
+    while (!merged) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
   void initPrefixRejections(const std::string& prefix) {
     stats_config_.mutable_stats_matcher()->mutable_exclusion_list()->add_patterns()->set_prefix(
         prefix);
@@ -138,5 +179,91 @@ static void BM_StatsWithTlsAndRejectionsWithoutDot(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTlsAndRejectionsWithoutDot);
 
+// Increments one counter from every benchmark thread, as workers do for
+// cluster-level counters such as upstream_rq_total. The argument selects
+// whether the counter is sharded.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CounterIncMultiThreaded(benchmark::State& state) {
+  static std::unique_ptr<Envoy::ThreadLocalStorePerf> context;
+  static Envoy::Stats::Counter* counter;
+  if (state.thread_index() == 0) {
+    context = std::make_unique<Envoy::ThreadLocalStorePerf>();
+    if (state.range(0) != 0) {
+      context->initShardedCounters("cluster.");
+    }
+    counter = &context->counter("cluster.hot.upstream_rq_total");
+  }
+
+  // Threads wait for each other before the first iteration, so counter is set by now.
+  for (auto _ : state) { // NOLINT
+    counter->inc();
+  }
+
+  if (state.thread_index() == 0) {
+    counter = nullptr;
+    context.reset();
+  }
+}
+BENCHMARK(BM_CounterIncMultiThreaded)->Arg(0)->Arg(1)->ThreadRange(1, 32)->UseRealTime();
+
+// Latency-like samples in milliseconds, spread over several decimal exponents.
+static std::vector<uint64_t> histogramSamples() {
+  std::vector<uint64_t> samples;
+  samples.reserve(1024);
+  uint64_t x = 1;
+  for (uint32_t i = 0; i < 1024; ++i) {
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    samples.push_back((x >> 33) % (i % 8 == 0 ? 10000 : 200));
+  }
+  return samples;
+}
+
+// Records samples into one thread-local histogram. The argument is the number of circllhist bins
+// configured for the histogram, or 0 to use the default bucket arrays.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HistogramRecord(benchmark::State& state) {
+  Envoy::ThreadLocalStorePerf context;
+  if (state.range(0) != 0) {
+    context.initHistogramBins(state.range(0));
+  }
+  context.initThreading();
+  Envoy::Stats::Histogram& histogram = context.histogram("cluster.hot.upstream_rq_time");
+  const std::vector<uint64_t> samples = histogramSamples();
+
+  size_t i = 0;
+  for (auto _ : state) { // NOLINT
+    histogram.recordValue(samples[i++ % samples.size()]);
+  }
+}
+BENCHMARK(BM_HistogramRecord)->Arg(0)->Arg(100);
+
+// Merges 100 thread-local histograms that each recorded 1000 samples since the previous merge.
+// The argument is as for BM_HistogramRecord.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HistogramMerge(benchmark::State& state) {
+  Envoy::ThreadLocalStorePerf context;
+  if (state.range(0) != 0) {
+    context.initHistogramBins(state.range(0));
+  }
+  context.initThreading();
+  std::vector<Envoy::Stats::Histogram*> histograms;
+  for (uint32_t i = 0; i < 100; ++i) {
+    histograms.push_back(&context.histogram(absl::StrCat("cluster.c", i, ".upstream_rq_time")));
+  }
+  const std::vector<uint64_t> samples = histogramSamples();
+
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    for (Envoy::Stats::Histogram* histogram : histograms) {
+      for (uint32_t i = 0; i < 1000; ++i) {
+        histogram->recordValue(samples[i % samples.size()]);
+      }
+    }
+    state.ResumeTiming();
+    context.mergeHistograms();
+  }
+}
+BENCHMARK(BM_HistogramMerge)->Arg(0)->Arg(100);
+
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
@@ -1857,6 +1857,28 @@ TEST_F(HistogramTest, BasicSingleHistogramMerge) {
   EXPECT_EQ(1, validateMerge());
 }
 
+// Histograms with configured bins record into circllhists rather than bucket arrays, and merge
+// to the same result.
+TEST_F(HistogramTest, BasicSingleHistogramMergeWithBins) {
+  envoy::config::metrics::v3::StatsConfig config;
+  auto* setting = config.add_histogram_bucket_settings();
+  setting->mutable_match()->set_prefix("h1");
+  setting->mutable_bins()->set_value(4);
+  store_->setHistogramSettings(std::make_unique<HistogramSettingsImpl>(config, context_));
+
+  Histogram& h1 = scope_.histogramFromString("h1", Histogram::Unit::Unspecified);
+  expectCallAndAccumulate(h1, 0);
+  expectCallAndAccumulate(h1, 43);
+  expectCallAndAccumulate(h1, 41);
+  expectCallAndAccumulate(h1, 415);
+  expectCallAndAccumulate(h1, 2201);
+  expectCallAndAccumulate(h1, 3201);
+  expectCallAndAccumulate(h1, 125);
+  expectCallAndAccumulate(h1, 13);
+
+  EXPECT_EQ(1, validateMerge());
+}
+
 TEST_F(HistogramTest, BasicMultiHistogramMerge) {
   Histogram& h1 = scope_.histogramFromString("h1", Histogram::Unit::Unspecified);
   Histogram& h2 = scope_.histogramFromString("h2", Histogram::Unit::Unspecified);
@@ -1003,6 +1003,22 @@ TEST_F(SslServerContextImplTicketTest, TicketKeyNone) {
   EXPECT_NO_THROW(loadConfigV2(cfg));
 }
 
+TEST_F(SslServerContextImplTicketTest, SessionCache) {
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext cfg;
+  cfg.mutable_session_cache()->mutable_max_size_bytes()->set_value(1024 * 1024);
+  cfg.mutable_session_cache()->set_shard_count(2);
+  EXPECT_NO_THROW(loadConfigV2(cfg));
+}
+
+TEST_F(SslServerContextImplTicketTest, SessionCacheWithStatefulResumptionDisabled) {
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext cfg;
+  cfg.mutable_session_cache();
+  cfg.set_disable_stateful_session_resumption(true);
+  EXPECT_THROW_WITH_MESSAGE(
+      loadConfigV2(cfg), EnvoyException,
+      "session_cache cannot be set when disable_stateful_session_resumption is true");
+}
+
 TEST_F(SslServerContextImplTicketTest, TicketKeyInlineBytesSuccess) {
   envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext cfg;
   cfg.mutable_session_ticket_keys()->add_keys()->set_inline_bytes(std::string(80, '\0'));
@@ -0,0 +1,175 @@
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/tls/session_cache.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class SessionCacheTest : public testing::Test {
+protected:
+  SessionCacheTest()
+      : server_ctx_(SSL_CTX_new(TLS_method())), client_ctx_(SSL_CTX_new(TLS_method())) {
+    EXPECT_EQ(1, SSL_CTX_use_certificate_chain_file(
+                     server_ctx_.get(),
+                     TestEnvironment::substitute(
+                         "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem")
+                         .c_str()));
+    EXPECT_EQ(1, SSL_CTX_use_PrivateKey_file(
+                     server_ctx_.get(),
+                     TestEnvironment::substitute(
+                         "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem")
+                         .c_str(),
+                     SSL_FILETYPE_PEM));
+    // Stateful resumption only applies to TLSv1.2 without tickets.
+    SSL_CTX_set_max_proto_version(server_ctx_.get(), TLS1_2_VERSION);
+    SSL_CTX_set_options(server_ctx_.get(), SSL_OP_NO_TICKET);
+  }
+
+  // Runs a handshake in memory and returns the client's copy of the session, which carries the
+  // session ID assigned by the server.
+  bssl::UniquePtr<SSL_SESSION> newSession() {
+    bssl::UniquePtr<SSL> client(SSL_new(client_ctx_.get()));
+    bssl::UniquePtr<SSL> server(SSL_new(server_ctx_.get()));
+    BIO* client_bio;
+    BIO* server_bio;
+    EXPECT_EQ(1, BIO_new_bio_pair(&client_bio, 0, &server_bio, 0));
+    SSL_set_bio(client.get(), client_bio, client_bio);
+    SSL_set_bio(server.get(), server_bio, server_bio);
+    SSL_set_connect_state(client.get());
+    SSL_set_accept_state(server.get());
+
+    bool client_done = false;
+    bool server_done = false;
+    while (!client_done || !server_done) {
+      const int client_rc = SSL_do_handshake(client.get());
+      const int server_rc = SSL_do_handshake(server.get());
+      client_done = client_rc == 1;
+      server_done = server_rc == 1;
+      EXPECT_TRUE(client_done || SSL_get_error(client.get(), client_rc) == SSL_ERROR_WANT_READ);
+      EXPECT_TRUE(server_done || SSL_get_error(server.get(), server_rc) == SSL_ERROR_WANT_READ);
+      if (testing::Test::HasFailure()) {
+        return nullptr;
+      }
+    }
+    return bssl::UniquePtr<SSL_SESSION>(SSL_get1_session(client.get()));
+  }
+
+  static absl::Span<const uint8_t> sessionId(SSL_SESSION* session) {
+    unsigned int length = 0;
+    const uint8_t* id = SSL_SESSION_get_id(session, &length);
+    return {id, length};
+  }
+
+  Ssl::ServerContextConfig::SessionCacheConfig config_{1024 * 1024, 4};
+  Stats::IsolatedStoreImpl store_;
+  Event::SimulatedTimeSystem time_system_;
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+};
+
+TEST_F(SessionCacheTest, InsertAndLookup) {
+  SessionCache cache(config_, *store_.rootScope(), time_system_);
+  bssl::UniquePtr<SSL_SESSION> session = newSession();
+  ASSERT_NE(nullptr, session);
+  ASSERT_FALSE(sessionId(session.get()).empty());
+
+  EXPECT_EQ(nullptr, cache.lookup(sessionId(session.get()), server_ctx_.get()));
+  EXPECT_TRUE(cache.insert(session.get()));
+
+  bssl::UniquePtr<SSL_SESSION> found = cache.lookup(sessionId(session.get()), server_ctx_.get());
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(sessionId(session.get()), sessionId(found.get()));
+
+  EXPECT_EQ(1, cache.stats().insert_.value());
+  EXPECT_EQ(1, cache.stats().hit_.value());
+  EXPECT_EQ(1, cache.stats().miss_.value());
+  EXPECT_EQ(1, cache.stats().entries_.value());
+  EXPECT_EQ(1, store_.counterFromString("ssl.session_cache.hit").value());
+}
+
+TEST_F(SessionCacheTest, SessionsExpire) {
+  SessionCache cache(config_, *store_.rootScope(), time_system_);
+  bssl::UniquePtr<SSL_SESSION> session = newSession();
+  ASSERT_NE(nullptr, session);
+  SSL_SESSION_set_timeout(session.get(), 10);
+  EXPECT_TRUE(cache.insert(session.get()));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(5));
+  EXPECT_NE(nullptr, cache.lookup(sessionId(session.get()), server_ctx_.get()));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(5));
+  EXPECT_EQ(nullptr, cache.lookup(sessionId(session.get()), server_ctx_.get()));
+  EXPECT_EQ(1, cache.stats().expired_.value());
+  EXPECT_EQ(0, cache.stats().entries_.value());
+}
+
+TEST_F(SessionCacheTest, EvictsLeastRecentlyUsed) {
+  bssl::UniquePtr<SSL_SESSION> first = newSession();
+  bssl::UniquePtr<SSL_SESSION> second = newSession();
+  bssl::UniquePtr<SSL_SESSION> third = newSession();
+  ASSERT_NE(nullptr, third);
+
+  // Size a single shard to hold two of these sessions.
+  uint64_t entry_size;
+  {
+    Stats::IsolatedStoreImpl probe_store;
+    SessionCache probe(config_, *probe_store.rootScope(), time_system_);
+    EXPECT_TRUE(probe.insert(first.get()));
+    entry_size = probe.stats().size_bytes_.value();
+  }
+  SessionCache cache({entry_size * 5 / 2, 1}, *store_.rootScope(), time_system_);
+
+  EXPECT_TRUE(cache.insert(first.get()));
+  EXPECT_TRUE(cache.insert(second.get()));
+  // Using the first session makes the second the least recently used.
+  EXPECT_NE(nullptr, cache.lookup(sessionId(first.get()), server_ctx_.get()));
+  EXPECT_TRUE(cache.insert(third.get()));
+
+  EXPECT_EQ(1, cache.stats().eviction_.value());
+  EXPECT_EQ(2, cache.stats().entries_.value());
+  EXPECT_NE(nullptr, cache.lookup(sessionId(first.get()), server_ctx_.get()));
+  EXPECT_EQ(nullptr, cache.lookup(sessionId(second.get()), server_ctx_.get()));
+  EXPECT_NE(nullptr, cache.lookup(sessionId(third.get()), server_ctx_.get()));
+}
+
+TEST_F(SessionCacheTest, RejectsSessionsLargerThanShard) {
+  SessionCache cache({64, 1}, *store_.rootScope(), time_system_);
+  bssl::UniquePtr<SSL_SESSION> session = newSession();
+  ASSERT_NE(nullptr, session);
+  EXPECT_FALSE(cache.insert(session.get()));
+  EXPECT_EQ(1, cache.stats().insert_rejected_.value());
+  EXPECT_EQ(0, cache.stats().entries_.value());
+}
+
+TEST_F(SessionCacheTest, DestructionReleasesGauges) {
+  bssl::UniquePtr<SSL_SESSION> session = newSession();
+  ASSERT_NE(nullptr, session);
+  {
+    SessionCache cache(config_, *store_.rootScope(), time_system_);
+    EXPECT_TRUE(cache.insert(session.get()));
+  }
+  EXPECT_EQ(0, store_.gaugeFromString("ssl.session_cache.entries",
+                                      Stats::Gauge::ImportMode::Accumulate)
+                   .value());
+  EXPECT_EQ(0, store_.gaugeFromString("ssl.session_cache.size_bytes",
+                                      Stats::Gauge::ImportMode::Accumulate)
+                   .value());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
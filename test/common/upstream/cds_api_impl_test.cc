@@ -18,6 +18,8 @@
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/cluster_priority_set.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -26,6 +28,7 @@
 using testing::_;
 using testing::InSequence;
 using testing::Return;
+using testing::ReturnRef;
 using testing::StrEq;
 using testing::Throw;
 
@@ -233,6 +236,70 @@ TEST_F(CdsApiImplTest, DeltaConfigUpdate) {
   }
 }
 
+// Builds a SotW response with the given number of minimal clusters.
+envoy::service::discovery::v3::DiscoveryResponse makeClustersResponse(uint32_t num_clusters) {
+  envoy::service::discovery::v3::DiscoveryResponse response;
+  response.set_version_info("0");
+  for (uint32_t i = 0; i < num_clusters; ++i) {
+    envoy::config::cluster::v3::Cluster cluster;
+    cluster.set_name(absl::StrCat("cluster_", i));
+    cluster.mutable_connect_timeout()->set_seconds(i + 1);
+    response.add_resources()->PackFrom(cluster);
+  }
+  return response;
+}
+
+// Large updates are hashed off the main thread and applied with the precomputed hashes.
+TEST_F(CdsApiImplTest, LargeUpdateHashesClustersInParallel) {
+  ON_CALL(server_factory_context_.api_, threadFactory())
+      .WillByDefault(ReturnRef(Thread::threadFactoryForTest()));
+  setup();
+
+  const auto response = makeClustersResponse(1000);
+  const auto decoded_resources =
+      TestUtility::decodeResources<envoy::config::cluster::v3::Cluster>(response);
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({})));
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, _, _)).Times(0);
+  for (const auto& resource : decoded_resources.refvec_) {
+    const auto& cluster =
+        dynamic_cast<const envoy::config::cluster::v3::Cluster&>(resource.get().resource());
+    EXPECT_CALL(cm_, addOrUpdateClusterWithHash(WithName(cluster.name()), "0",
+                                                MessageUtil::hash(cluster), false))
+        .WillOnce(Return(true));
+  }
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_TRUE(
+      cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, response.version_info()).ok());
+}
+
+// Small updates, and large ones with the runtime guard disabled, are hashed on the main thread.
+TEST_F(CdsApiImplTest, UpdateHashesClustersOnMainThread) {
+  EXPECT_CALL(server_factory_context_.api_, threadFactory()).Times(0);
+  setup();
+
+  {
+    const auto response = makeClustersResponse(10);
+    const auto decoded_resources =
+        TestUtility::decodeResources<envoy::config::cluster::v3::Cluster>(response);
+    EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({})));
+    EXPECT_CALL(cm_, addOrUpdateCluster(_, "0", false)).Times(10).WillRepeatedly(Return(true));
+    EXPECT_CALL(initialized_, ready());
+    EXPECT_TRUE(
+        cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, response.version_info()).ok());
+  }
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.cds_parallel_cluster_hash", "false"}});
+  const auto response = makeClustersResponse(1000);
+  const auto decoded_resources =
+      TestUtility::decodeResources<envoy::config::cluster::v3::Cluster>(response);
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({})));
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, "0", false)).Times(1000).WillRepeatedly(Return(true));
+  EXPECT_CALL(cm_, addOrUpdateClusterWithHash(_, _, _, _)).Times(0);
+  EXPECT_TRUE(
+      cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, response.version_info()).ok());
+}
+
 TEST_F(CdsApiImplTest, ConfigUpdateAddsSecondClusterEvenIfFirstThrows) {
   {
     InSequence s;
@@ -171,6 +171,18 @@ TEST_F(FileAccessLogTest, LogFormatText) {
       "plain_text - /bar/foo - 200", false);
 }
 
+TEST_F(FileAccessLogTest, LogFormatTextLengthPrefixed) {
+  runTest(
+      R"(
+  path: "/foo"
+  length_prefixed: true
+  log_format:
+    text_format_source:
+      inline_string: "plain_text - %REQ(:path)% - %RESPONSE_CODE%\n"
+)",
+      absl::StrCat(absl::string_view("\0\0\0\x1c", 4), "plain_text - /bar/foo - 200\n"), false);
+}
+
 TEST_F(FileAccessLogTest, LogFormatJson) {
   runTest(
       R"(
@@ -17,6 +17,7 @@
 #include "source/extensions/config_subscription/grpc/grpc_mux_impl.h"
 #include "source/extensions/config_subscription/grpc/grpc_subscription_impl.h"
 #include "source/extensions/config_subscription/grpc/xds_mux/grpc_mux_impl.h"
+#include "source/extensions/load_balancing_policies/round_robin/round_robin_lb.h"
 #include "source/server/transport_socket_config_impl.h"
 
 #include "test/benchmark/main.h"
@@ -167,6 +168,79 @@ public:
            num_hosts);
   }
 
+  // Sends an update at priority 0 with num_hosts weighted hosts spread over num_localities
+  // localities. If churned_locality is a valid locality, all of its hosts are replaced with new
+  // ones; the other localities keep their hosts.
+  void localityChurnHelper(size_t num_hosts, size_t num_localities, size_t churned_locality) {
+    state_.PauseTiming();
+    locality_generations_.resize(num_localities);
+    if (churned_locality < num_localities) {
+      ++locality_generations_[churned_locality];
+    }
+
+    envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+    cluster_load_assignment.set_cluster_name("fare");
+    const size_t hosts_per_locality = std::max<size_t>(num_hosts / num_localities, 1);
+    for (size_t l = 0; l < num_localities; ++l) {
+      auto* endpoints = cluster_load_assignment.add_endpoints();
+      endpoints->mutable_locality()->set_region("region");
+      endpoints->mutable_locality()->set_zone(absl::StrCat("zone", l));
+      endpoints->mutable_load_balancing_weight()->set_value(1);
+      for (size_t i = 0; i < hosts_per_locality; ++i) {
+        auto* lb_endpoint = endpoints->add_lb_endpoints();
+        lb_endpoint->set_health_status(envoy::config::core::v3::HEALTHY);
+        lb_endpoint->mutable_load_balancing_weight()->set_value(1 + i % 3);
+        auto* socket_address =
+            lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+        socket_address->set_address(
+            absl::StrCat("10.", l % 256, ".", locality_generations_[l] % 256, ".1"));
+        socket_address->set_port_value(1000 + i);
+      }
+    }
+
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url_);
+    response->set_version_info(fmt::format("version-{}", version_++));
+    response->mutable_resources()->Add()->PackFrom(cluster_load_assignment);
+    dynamic_cast<Config::GrpcMuxImpl&>(*grpc_mux_).grpcStreamForTest().onReceiveMessage(
+        std::move(response));
+    state_.ResumeTiming();
+  }
+
+  // Mirrors the membership updates of the cluster onto a worker priority set with a round robin
+  // load balancer, the way ThreadLocalClusterManagerImpl does, so that the cost of applying an
+  // update on a worker can be measured on its own.
+  void addWorker() {
+    worker_priority_set_.getOrCreateHostSet(0);
+    worker_lb_ = std::make_unique<RoundRobinLoadBalancer>(
+        worker_priority_set_, nullptr, cluster_->info()->lbStats(),
+        server_context_.runtime_loader_, random_, 50,
+        envoy::extensions::load_balancing_policies::round_robin::v3::RoundRobin(),
+        server_context_.timeSource());
+    worker_update_cb_ = cluster_->prioritySet().addPriorityUpdateCb(
+        [this](uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed) {
+          pending_worker_updates_.push_back({priority, hosts_added, hosts_removed});
+        });
+  }
+
+  void applyWorkerUpdates() {
+    for (const auto& update : pending_worker_updates_) {
+      const HostSet& host_set = *cluster_->prioritySet().hostSetsPerPriority()[update.priority_];
+      worker_priority_set_.updateHosts(
+          update.priority_, HostSetImpl::updateHostsParams(host_set), host_set.localityWeights(),
+          update.hosts_added_, update.hosts_removed_, host_set.weightedPriorityHealth(),
+          host_set.overprovisioningFactor(), cluster_->prioritySet().crossPriorityHostMap());
+    }
+    pending_worker_updates_.clear();
+    ASSERT(worker_lb_->chooseHost(nullptr).host != nullptr);
+  }
+
+  struct WorkerUpdate {
+    uint32_t priority_;
+    HostVector hosts_added_;
+    HostVector hosts_removed_;
+  };
+
   NiceMock<Server::Configuration::MockServerFactoryContext> server_context_;
   Stats::TestUtil::TestStore& stats_ = server_context_.store_;
 
@@ -192,6 +266,11 @@ public:
   Config::GrpcMuxSharedPtr grpc_mux_;
   Config::GrpcSubscriptionImplPtr subscription_;
   NiceMock<AccessLog::MockAccessLogManager> access_log_manager_;
+  std::vector<uint32_t> locality_generations_;
+  PrioritySetImpl worker_priority_set_;
+  std::unique_ptr<RoundRobinLoadBalancer> worker_lb_;
+  Common::CallbackHandlePtr worker_update_cb_;
+  std::vector<WorkerUpdate> pending_worker_updates_;
 };
 
 } // namespace Upstream
@@ -244,3 +323,33 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
+
+// Measures only the worker side of an EDS update that replaces the hosts of one locality, with
+// and without incremental load balancer refresh.
+static void workerLocalityChurnUpdate(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  Envoy::TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.incremental_lb_host_source_refresh",
+                               state.range(2) ? "true" : "false"}});
+  Envoy::Upstream::EdsSpeedTest speed_test(state, false);
+  const uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  const uint32_t localities = state.range(1);
+
+  state.PauseTiming();
+  speed_test.addWorker();
+  speed_test.localityChurnHelper(endpoints, localities, localities);
+  speed_test.applyWorkerUpdates();
+  state.ResumeTiming();
+
+  uint32_t update = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    speed_test.localityChurnHelper(endpoints, localities, update++ % localities);
+    speed_test.applyWorkerUpdates();
+  }
+}
+
+BENCHMARK(workerLocalityChurnUpdate)
+    ->ArgsProduct({{2000, 20000}, {10}, {false, true}})
+    ->Unit(benchmark::kMicrosecond);
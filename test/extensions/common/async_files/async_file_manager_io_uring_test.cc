@@ -0,0 +1,240 @@
+#include <climits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+#include "source/extensions/common/async_files/async_file_manager_factory.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/status_utility.h"
+
+#include "absl/status/statusor.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+using StatusHelpers::IsOkAndHolds;
+using StatusHelpers::StatusIs;
+
+class AsyncFileManagerIoUringTest : public testing::Test {
+public:
+  void SetUp() override {
+    if (!Io::isIoUringSupported()) {
+      GTEST_SKIP() << "io_uring is not supported";
+    }
+    envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+    config.mutable_io_uring()->mutable_thread_pool()->set_thread_count(1);
+    config.mutable_io_uring()->set_io_uring_size(4);
+    manager_ = factory_->getAsyncFileManager(config);
+  }
+
+  void resolveFileActions() {
+    manager_->waitForIdle();
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+  AsyncFileHandle createAnonymousFile() {
+    AsyncFileHandle create_result;
+    manager_->createAnonymousFile(
+        dispatcher_.get(), tmpdir_,
+        [&](absl::StatusOr<AsyncFileHandle> result) { create_result = result.value(); });
+    resolveFileActions();
+    return create_result;
+  }
+  void close(AsyncFileHandle& handle) {
+    absl::Status close_result;
+    EXPECT_OK(
+        handle->close(dispatcher_.get(), [&](absl::Status status) { close_result = status; }));
+    resolveFileActions();
+    EXPECT_OK(close_result);
+  }
+
+  const char* test_tmpdir = std::getenv("TEST_TMPDIR");
+  std::string tmpdir_ = test_tmpdir ? test_tmpdir : "/tmp";
+
+  std::unique_ptr<Singleton::ManagerImpl> singleton_manager_ =
+      std::make_unique<Singleton::ManagerImpl>();
+  std::shared_ptr<AsyncFileManagerFactory> factory_ =
+      AsyncFileManagerFactory::singleton(singleton_manager_.get());
+  std::shared_ptr<AsyncFileManager> manager_;
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+};
+
+TEST_F(AsyncFileManagerIoUringTest, Describe) {
+  EXPECT_EQ("io_uring_size = 4, thread_pool_size = 1", manager_->describe());
+}
+
+TEST_F(AsyncFileManagerIoUringTest, WriteReadClose) {
+  auto handle = createAnonymousFile();
+  ASSERT_NE(nullptr, handle);
+  absl::StatusOr<size_t> write_status;
+  absl::StatusOr<Buffer::InstancePtr> read_status, short_read_status;
+  Buffer::OwnedImpl hello("hello");
+  ASSERT_OK(handle->write(dispatcher_.get(), hello, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, IsOkAndHolds(5U));
+  ASSERT_OK(handle->read(dispatcher_.get(), 1, 3, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    read_status = std::move(status);
+  }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual("ell"));
+  // Reading past the end of the file returns only the bytes that were there.
+  ASSERT_OK(handle->read(dispatcher_.get(), 2, 10, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    short_read_status = std::move(status);
+  }));
+  resolveFileActions();
+  ASSERT_OK(short_read_status);
+  EXPECT_THAT(*short_read_status.value(), BufferStringEqual("llo"));
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, WritesBufferWithManySlices) {
+  auto handle = createAnonymousFile();
+  ASSERT_NE(nullptr, handle);
+  Buffer::OwnedImpl contents;
+  std::string expected;
+  for (int i = 0; i < 100; i++) {
+    const std::string fragment(1000 + i, static_cast<char>('a' + i % 26));
+    contents.appendSliceForTest(fragment);
+    expected += fragment;
+  }
+  absl::StatusOr<size_t> write_status;
+  absl::StatusOr<Buffer::InstancePtr> read_status;
+  ASSERT_OK(handle->write(dispatcher_.get(), contents, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, IsOkAndHolds(expected.size()));
+  ASSERT_OK(handle->read(dispatcher_.get(), 0, expected.size(),
+                         [&](absl::StatusOr<Buffer::InstancePtr> status) {
+                           read_status = std::move(status);
+                         }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  EXPECT_EQ(expected, read_status.value()->toString());
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, MoreRequestsThanRingEntriesAllComplete) {
+  // Four times as many files as the ring has entries, each with a write in flight.
+  std::vector<AsyncFileHandle> handles;
+  for (int i = 0; i < 16; i++) {
+    handles.push_back(createAnonymousFile());
+    ASSERT_NE(nullptr, handles.back());
+  }
+  std::vector<absl::StatusOr<size_t>> write_statuses(handles.size());
+  for (size_t i = 0; i < handles.size(); i++) {
+    Buffer::OwnedImpl data(std::string(i + 1, 'x'));
+    ASSERT_OK(handles[i]->write(dispatcher_.get(), data, 0, [&, i](absl::StatusOr<size_t> status) {
+      write_statuses[i] = std::move(status);
+    }));
+  }
+  resolveFileActions();
+  for (size_t i = 0; i < handles.size(); i++) {
+    EXPECT_THAT(write_statuses[i], IsOkAndHolds(i + 1));
+    close(handles[i]);
+  }
+}
+
+TEST_F(AsyncFileManagerIoUringTest, WriteOfMoreThanIovMaxSlicesIsResubmitted) {
+  auto handle = createAnonymousFile();
+  ASSERT_NE(nullptr, handle);
+  // Only IOV_MAX slices are submitted at a time, so the first write completes short and the rest
+  // of the buffer is resubmitted at the offset following the bytes already written.
+  Buffer::OwnedImpl contents;
+  std::string expected;
+  for (int i = 0; i < IOV_MAX + 10; i++) {
+    const std::string fragment(3, static_cast<char>('a' + i % 26));
+    contents.appendSliceForTest(fragment);
+    expected += fragment;
+  }
+  absl::StatusOr<size_t> write_status;
+  absl::StatusOr<Buffer::InstancePtr> read_status;
+  ASSERT_OK(handle->write(dispatcher_.get(), contents, 5, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, IsOkAndHolds(expected.size()));
+  ASSERT_OK(handle->read(dispatcher_.get(), 5, expected.size() + 1,
+                         [&](absl::StatusOr<Buffer::InstancePtr> status) {
+                           read_status = std::move(status);
+                         }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  EXPECT_EQ(expected, read_status.value()->toString());
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, ReadErrorIsReported) {
+  auto handle = createAnonymousFile();
+  ASSERT_NE(nullptr, handle);
+  absl::StatusOr<Buffer::InstancePtr> read_status;
+  ASSERT_OK(handle->read(dispatcher_.get(), -2, 5, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    read_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(read_status, StatusIs(absl::StatusCode::kInvalidArgument));
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, CurrentPositionOffsetIsRejected) {
+  auto handle = createAnonymousFile();
+  ASSERT_NE(nullptr, handle);
+  // io_uring would read and write at the current position for an offset of -1, but pread and
+  // pwrite reject it, so the io_uring manager must too.
+  absl::StatusOr<size_t> write_status;
+  absl::StatusOr<Buffer::InstancePtr> read_status;
+  Buffer::OwnedImpl hello("hello");
+  ASSERT_OK(handle->write(dispatcher_.get(), hello, -1, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, StatusIs(absl::StatusCode::kInvalidArgument));
+  ASSERT_OK(handle->read(dispatcher_.get(), -1, 5, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    read_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(read_status, StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // Nothing was written at the current position either.
+  absl::StatusOr<Buffer::InstancePtr> contents_status;
+  ASSERT_OK(handle->read(dispatcher_.get(), 0, 5, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    contents_status = std::move(status);
+  }));
+  resolveFileActions();
+  ASSERT_OK(contents_status);
+  EXPECT_EQ(0, contents_status.value()->length());
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, CancelledWriteDoesNotCallBack) {
+  auto handle = createAnonymousFile();
+  ASSERT_NE(nullptr, handle);
+  Buffer::OwnedImpl hello("hello");
+  bool called = false;
+  CancelFunction cancel =
+      handle->write(dispatcher_.get(), hello, 0, [&](absl::StatusOr<size_t>) { called = true; })
+          .value();
+  cancel();
+  resolveFileActions();
+  EXPECT_FALSE(called);
+  close(handle);
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,127 @@
+// Compares the throughput of the thread pool and io_uring async file managers, writing and then
+// reading back many files at once.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/singleton/manager_impl.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+#include "source/extensions/common/async_files/async_file_manager_factory.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+namespace {
+
+enum class ManagerType { ThreadPool, IoUring };
+
+class FileBenchmark {
+public:
+  FileBenchmark(ManagerType type, uint32_t num_files) {
+    envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+    if (type == ManagerType::ThreadPool) {
+      config.mutable_thread_pool()->set_thread_count(4);
+    } else {
+      config.mutable_io_uring()->mutable_thread_pool()->set_thread_count(1);
+      config.mutable_io_uring()->set_io_uring_size(num_files);
+    }
+    manager_ = factory_->getAsyncFileManager(config);
+
+    const char* test_tmpdir = std::getenv("TEST_TMPDIR");
+    const std::string tmpdir = test_tmpdir ? test_tmpdir : "/tmp";
+    handles_.resize(num_files);
+    for (AsyncFileHandle& handle : handles_) {
+      manager_->createAnonymousFile(dispatcher_.get(), tmpdir,
+                                    [&handle](absl::StatusOr<AsyncFileHandle> result) {
+                                      handle = std::move(result.value());
+                                    });
+    }
+    resolveFileActions();
+  }
+
+  ~FileBenchmark() {
+    for (AsyncFileHandle& handle : handles_) {
+      handle->close(nullptr, [](absl::Status) {}).IgnoreError();
+    }
+    manager_->waitForIdle();
+  }
+
+  // Writes the data to every file and reads it back once the write has completed, with all the
+  // files in flight at once.
+  void writeAndReadAll(const std::string& data) {
+    remaining_ = handles_.size();
+    for (AsyncFileHandle& handle : handles_) {
+      Buffer::OwnedImpl contents(data);
+      handle
+          ->write(dispatcher_.get(), contents, 0,
+                  [this, &handle, size = data.size()](absl::StatusOr<size_t> written) {
+                    RELEASE_ASSERT(written.ok(), "");
+                    handle
+                        ->read(dispatcher_.get(), 0, size,
+                               [this](absl::StatusOr<Buffer::InstancePtr> read) {
+                                 RELEASE_ASSERT(read.ok(), "");
+                                 if (--remaining_ == 0) {
+                                   dispatcher_->exit();
+                                 }
+                               })
+                        .IgnoreError();
+                  })
+          .IgnoreError();
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  }
+
+private:
+  void resolveFileActions() {
+    manager_->waitForIdle();
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+  Singleton::ManagerImpl singleton_manager_;
+  std::shared_ptr<AsyncFileManagerFactory> factory_ =
+      AsyncFileManagerFactory::singleton(&singleton_manager_);
+  std::shared_ptr<AsyncFileManager> manager_;
+  std::vector<AsyncFileHandle> handles_;
+  size_t remaining_{0};
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_WriteAndReadManyFiles(benchmark::State& state) {
+  const ManagerType type = static_cast<ManagerType>(state.range(0));
+  if (type == ManagerType::IoUring && !Io::isIoUringSupported()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  FileBenchmark bench(type, state.range(1));
+  const std::string data(state.range(2), 'a');
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    bench.writeAndReadAll(data);
+  }
+  state.SetBytesProcessed(2 * state.iterations() * state.range(1) * state.range(2));
+}
+BENCHMARK(BM_WriteAndReadManyFiles)
+    ->ArgsProduct({{static_cast<int64_t>(ManagerType::ThreadPool),
+                    static_cast<int64_t>(ManagerType::IoUring)},
+                   {16, 256},
+                   {4096, 65536}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,202 @@
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/compression/zstd/compressor/dictionary_trainer.h"
+#include "source/extensions/compression/zstd/compressor/zstd_compressor_impl.h"
+#include "source/extensions/compression/zstd/decompressor/zstd_decompressor_impl.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/time/clock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Zstd {
+namespace Compressor {
+namespace {
+
+using ::testing::NiceMock;
+
+class DictionaryTrainerTest : public testing::Test {
+protected:
+  DictionaryTrainerTest() {
+    config_.set_dictionary_path(TestEnvironment::temporaryPath("zstd_trained_dictionary"));
+    config_.mutable_sample_bytes()->set_value(64);
+    config_.mutable_max_samples()->set_value(1000);
+    config_.mutable_min_samples()->set_value(100);
+    config_.mutable_max_dictionary_bytes()->set_value(4096);
+    config_.mutable_training_interval()->set_seconds(3600);
+    cdict_manager_ = std::make_unique<ZstdCDictManager>(
+        Protobuf::RepeatedPtrField<envoy::config::core::v3::DataSource>(), *dispatcher_, *api_,
+        tls_, true, [](const void* dict_buffer, size_t dict_size) -> ZSTD_CDict* {
+          return ZSTD_createCDict(dict_buffer, dict_size, CompressionLevel);
+        });
+    trainer_ = makeTrainer();
+  }
+
+  DictionaryTrainerPtr makeTrainer() {
+    return std::make_unique<DictionaryTrainer>(
+        config_, *dispatcher_, *api_, *store_.rootScope(), training_thread_,
+        [this](absl::string_view dictionary) {
+          return cdict_manager_->publishDictionary(dictionary);
+        });
+  }
+
+  // JSON objects with a shared structure, as a dictionary is good for.
+  static std::string response(int i) {
+    return absl::StrCat(R"({"id":)", i, R"(,"name":"user)", i * 7, R"(","email":"user)", i * 7,
+                        R"(@example.com","active":)", i % 2 == 0 ? "true" : "false",
+                        R"(,"roles":["reader","writer"],"region":"eu-west-)", i % 3, R"("})");
+  }
+
+  std::string compress(const std::string& input) {
+    ZstdCompressorImpl compressor(CompressionLevel, false, 0, cdict_manager_, 4096,
+                                  trainer_.get());
+    Buffer::OwnedImpl buffer(input);
+    compressor.compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    return buffer.toString();
+  }
+
+  void addSamples(int count) {
+    for (int i = 0; i < count; ++i) {
+      compress(response(i));
+    }
+  }
+
+  uint64_t counter(absl::string_view name) {
+    return TestUtility::findCounter(store_, absl::StrCat("zstd.dictionary_training.", name))
+        ->value();
+  }
+
+  uint64_t gauge(absl::string_view name) {
+    return TestUtility::findGauge(store_, absl::StrCat("zstd.dictionary_training.", name))
+        ->value();
+  }
+
+  static constexpr uint32_t CompressionLevel = 3;
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+  DictionaryTrainingThreadSharedPtr training_thread_ =
+      std::make_shared<DictionaryTrainingThread>(*api_);
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Stats::IsolatedStoreImpl store_;
+  envoy::extensions::compression::zstd::compressor::v3::Zstd::DictionaryTraining config_;
+  ZstdCDictManagerPtr cdict_manager_;
+  DictionaryTrainerPtr trainer_;
+};
+
+TEST_F(DictionaryTrainerTest, CompressorsRecordSamplesAndStats) {
+  const std::string input = response(1);
+  const std::string compressed = compress(input);
+  EXPECT_EQ(counter("samples"), 1);
+  EXPECT_EQ(counter("uncompressed_bytes"), input.size());
+  EXPECT_EQ(counter("compressed_bytes"), compressed.size());
+  // Nothing is sampled from an empty response.
+  compress("");
+  EXPECT_EQ(counter("samples"), 1);
+}
+
+TEST_F(DictionaryTrainerTest, TrainsOnlyWithEnoughNewSamples) {
+  addSamples(99);
+  EXPECT_FALSE(trainer_->train());
+  EXPECT_EQ(counter("trainings"), 0);
+  addSamples(1);
+  EXPECT_TRUE(trainer_->train());
+  EXPECT_EQ(counter("trainings"), 1);
+  // The same samples are not trained on again.
+  EXPECT_FALSE(trainer_->train());
+}
+
+TEST_F(DictionaryTrainerTest, TrainedDictionaryIsWrittenAndUsedByNewCompressors) {
+  addSamples(1000);
+  const std::string without_dictionary = compress(response(5000));
+  ASSERT_TRUE(trainer_->train());
+  EXPECT_TRUE(api_->fileSystem().fileExists(config_.dictionary_path()));
+  // Nothing changes until the dictionary is published on the main thread.
+  EXPECT_EQ(gauge("dictionary_version"), 0);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(counter("training_failures"), 0);
+  EXPECT_EQ(gauge("dictionary_version"), 1);
+  const uint64_t dictionary_id = gauge("dictionary_id");
+  EXPECT_NE(dictionary_id, 0);
+
+  const std::string input = response(5000);
+  const std::string with_dictionary = compress(input);
+  EXPECT_EQ(ZSTD_getDictID_fromFrame(with_dictionary.data(), with_dictionary.size()),
+            dictionary_id);
+  EXPECT_LT(with_dictionary.size(), without_dictionary.size());
+
+  // A decompressor configured with the dictionary file can decompress the response.
+  Protobuf::RepeatedPtrField<envoy::config::core::v3::DataSource> dictionaries;
+  dictionaries.Add()->set_filename(config_.dictionary_path());
+  auto ddict_manager = std::make_unique<Decompressor::ZstdDDictManager>(
+      dictionaries, *dispatcher_, *api_, tls_, false,
+      [](const void* dict_buffer, size_t dict_size) -> ZSTD_DDict* {
+        return ZSTD_createDDict(dict_buffer, dict_size);
+      });
+  Decompressor::ZstdDecompressorImpl decompressor{*store_.rootScope(), "test.", ddict_manager,
+                                                  4096};
+  Buffer::OwnedImpl compressed(with_dictionary);
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(compressed, decompressed);
+  EXPECT_EQ(decompressed.toString(), input);
+}
+
+TEST_F(DictionaryTrainerTest, CompressorKeepsItsDictionaryWhenItIsReplaced) {
+  addSamples(1000);
+  ASSERT_TRUE(trainer_->train());
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  const uint64_t first_id = gauge("dictionary_id");
+
+  ZstdCompressorImpl compressor(CompressionLevel, false, 0, cdict_manager_, 4096, trainer_.get());
+  Buffer::OwnedImpl first_half(response(1));
+  compressor.compress(first_half, Envoy::Compression::Compressor::State::Flush);
+
+  for (int i = 1000; i < 1100; ++i) {
+    compress(absl::StrCat(response(i), response(i + 1)));
+  }
+  ASSERT_TRUE(trainer_->train());
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(gauge("dictionary_version"), 2);
+
+  Buffer::OwnedImpl second_half(response(2));
+  compressor.compress(second_half, Envoy::Compression::Compressor::State::Finish);
+  first_half.move(second_half);
+  const std::string compressed = first_half.toString();
+  EXPECT_EQ(ZSTD_getDictID_fromFrame(compressed.data(), compressed.size()), first_id);
+}
+
+TEST_F(DictionaryTrainerTest, TrainingThreadTrainsEachTrainer) {
+  trainer_.reset();
+  config_.mutable_training_interval()->set_seconds(0);
+  config_.mutable_training_interval()->set_nanos(10 * 1000 * 1000);
+  trainer_ = makeTrainer();
+  addSamples(1000);
+  while (gauge("dictionary_version") == 0) {
+    absl::SleepFor(absl::Milliseconds(1));
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  // The thread may have trained before all the samples were added, too.
+  EXPECT_GE(counter("trainings"), 1);
+  EXPECT_NE(gauge("dictionary_id"), 0);
+}
+
+TEST_F(DictionaryTrainerTest, PublishAfterDestructionIsDropped) {
+  addSamples(1000);
+  ASSERT_TRUE(trainer_->train());
+  trainer_.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(cdict_manager_->getFirstDictionary(), nullptr);
+}
+
+} // namespace
+} // namespace Compressor
+} // namespace Zstd
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
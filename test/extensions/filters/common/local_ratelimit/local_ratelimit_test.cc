@@ -440,6 +440,81 @@ TEST_F(LocalRateLimiterImplTest, AtomicTokenBucketMaxTokensGreaterThanTokensPerF
   EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_).allowed);
 }
 
+// Verify that leasing tokens in batches admits exactly the configured number of tokens.
+TEST_F(LocalRateLimiterImplTest, AtomicTokenBucketWithTokenLease) {
+  rate_limiter_ = std::make_shared<LocalRateLimiterImpl>(
+      std::chrono::milliseconds(200), 10, 10, dispatcher_, descriptors_, true, nullptr, 20, 4);
+
+  // Two batches of 4 tokens are borrowed from the shared bucket, then the last 2 tokens are
+  // consumed one at a time.
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_).allowed);
+  }
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_).allowed);
+
+  // 0 -> 10 tokens
+  dispatcher_.globalTimeSystem().advanceTimeWait(std::chrono::milliseconds(200));
+
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_).allowed);
+  }
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_).allowed);
+}
+
+// Verify that tokens leased by one thread are not admitted twice, and that the tokens held by
+// another thread's lease are only available to the threads sharing its lease slot.
+TEST_F(LocalRateLimiterImplTest, AtomicTokenBucketWithTokenLeaseAcrossThreads) {
+  rate_limiter_ = std::make_shared<LocalRateLimiterImpl>(
+      std::chrono::milliseconds(200), 10, 10, dispatcher_, descriptors_, true, nullptr, 20, 4);
+
+  uint32_t allowed = 0;
+  auto consume_all = [&](uint32_t limit) {
+    for (uint32_t i = 0; i < limit && rate_limiter_->requestAllowed(route_descriptors_).allowed;
+         i++) {
+      allowed++;
+    }
+  };
+
+  // The other thread borrows a batch of 4 and uses one token of it.
+  Thread::threadFactoryForTest().createThread([&]() { consume_all(1); })->join();
+  EXPECT_EQ(1, allowed);
+
+  // Threads are given consecutive lease slots, so neither this thread nor the next one share the
+  // first thread's slot. They can only use the 6 tokens left in the shared bucket, and the 3
+  // tokens of the first thread's lease stay with its slot.
+  consume_all(100);
+  EXPECT_EQ(7, allowed);
+  Thread::threadFactoryForTest().createThread([&]() { consume_all(100); })->join();
+  EXPECT_EQ(7, allowed);
+}
+
+// Verify that tokens held in leases count against the shared bucket when it refills, so that no
+// more than max tokens are admitted at once.
+TEST_F(LocalRateLimiterImplTest, AtomicTokenBucketWithTokenLeaseRefill) {
+  rate_limiter_ = std::make_shared<LocalRateLimiterImpl>(
+      std::chrono::milliseconds(200), 10, 10, dispatcher_, descriptors_, true, nullptr, 20, 4);
+
+  uint32_t allowed = 0;
+  auto consume_all = [&](uint32_t limit) {
+    for (uint32_t i = 0; i < limit && rate_limiter_->requestAllowed(route_descriptors_).allowed;
+         i++) {
+      allowed++;
+    }
+  };
+
+  // The other thread keeps 3 leased tokens, and this thread drains the shared bucket.
+  auto thread = Thread::threadFactoryForTest().createThread([&]() { consume_all(1); });
+  thread->join();
+  consume_all(100);
+  EXPECT_EQ(7, allowed);
+
+  // 0 -> 10 tokens, of which 3 are still leased.
+  dispatcher_.globalTimeSystem().advanceTimeWait(std::chrono::milliseconds(200));
+  allowed = 0;
+  consume_all(100);
+  EXPECT_EQ(7, allowed);
+}
+
 // Verify token bucket status of max tokens, remaining tokens and remaining fill interval.
 TEST_F(LocalRateLimiterImplTest, AtomicTokenBucketStatus) {
   initializeWithAtomicTokenBucket(std::chrono::milliseconds(3000), 2, 2);
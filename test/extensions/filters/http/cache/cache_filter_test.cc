@@ -359,6 +359,30 @@ TEST_F(CacheFilterTest, UncacheableResponse) {
   }
 }
 
+TEST_F(CacheFilterTest, UncacheableResponseReleasesLookupBeforeResponseEnds) {
+  request_headers_.setHost("UncacheableResponseReleasesLookup");
+  response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl, "no-store");
+  auto mock_http_cache = std::make_shared<MockHttpCache>();
+  MockLookupContext* mock_lookup_context = mock_http_cache->mockLookupContext();
+  EXPECT_CALL(*mock_lookup_context, getHeaders(_)).WillOnce([&](LookupHeadersCallback&& cb) {
+    dispatcher_->post([cb = std::move(cb)]() mutable { std::move(cb)(LookupResult{}, false); });
+  });
+  bool lookup_destroyed = false;
+  ON_CALL(*mock_lookup_context, onDestroy()).WillByDefault([&lookup_destroyed]() {
+    lookup_destroyed = true;
+  });
+  CacheFilterSharedPtr filter = makeFilter(mock_http_cache);
+  testDecodeRequestMiss(0, filter);
+  receiveUpstreamHeaders(0, response_headers_, false);
+  // A cache may have other lookups waiting for this one's insert, so the lookup is released as
+  // soon as the response turns out to be uncacheable, not when the response ends.
+  EXPECT_TRUE(lookup_destroyed);
+  receiveUpstreamBody(0, "abc", true);
+  pumpDispatcher();
+  filter->onStreamComplete();
+  EXPECT_THAT(insertStatus(), IsOkAndHolds(InsertStatus::NoInsertResponseNotCacheable));
+}
+
 TEST_F(CacheFilterTest, CacheMiss) {
   for (int request = 0; request < 2; request++) {
     std::cerr << "  request " << request << std::endl;
@@ -432,6 +432,67 @@ BENCHMARK(compressChunks1024WithGzip)
     ->UseManualTime()
     ->Unit(benchmark::kMillisecond);
 
+// Compresses the same response repeatedly, as with popular static content. The argument selects
+// no compressed response cache (0), a cache keyed by the body's digest (1), or a cache keyed by
+// the response's ETag (2).
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void compressRepeatedResponseWithGzip(benchmark::State& state) {
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  const auto mode = state.range(0);
+  const auto& params = gzip_compression_params[0];
+
+  Stats::IsolatedStoreImpl stats;
+  testing::NiceMock<Runtime::MockLoader> runtime;
+  ON_CALL(runtime.snapshot_, featureEnabled("test.filter_enabled", 100))
+      .WillByDefault(Return(true));
+  envoy::extensions::filters::http::compressor::v3::Compressor compressor;
+  if (mode != 0) {
+    auto* cache =
+        compressor.mutable_response_direction_config()->mutable_compressed_response_cache();
+    cache->set_max_size_bytes(16 * 1024 * 1024);
+    cache->set_cache_by_body_digest(true);
+  }
+  CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
+      compressor, "test.", *stats.rootScope(), runtime,
+      std::make_unique<MockGzipCompressorFactory>(
+          static_cast<Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionLevel>(
+              params.level),
+          static_cast<Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy>(
+              params.strategy),
+          params.window_bits, params.memory_level));
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Buffer::OwnedImpl data(testData());
+    auto start = std::chrono::high_resolution_clock::now();
+    auto filter = std::make_unique<CompressorFilter>(config);
+    filter->setDecoderFilterCallbacks(decoder_callbacks);
+
+    Http::TestRequestHeaderMapImpl headers = {{":method", "get"},
+                                              {":authority", "example.com"},
+                                              {":path", "/static/app.js"},
+                                              {"accept-encoding", "gzip"}};
+    filter->decodeHeaders(headers, true);
+
+    Http::TestResponseHeaderMapImpl response_headers = {
+        {":status", "200"},
+        {"content-length", "122880"},
+        {"content-type", "application/json;charset=utf-8"}};
+    if (mode == 2) {
+      response_headers.addCopy("etag", "\"v1\"");
+    }
+    filter->encodeHeaders(response_headers, false);
+    filter->encodeData(data, true);
+    auto end = std::chrono::high_resolution_clock::now();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+    state.SetIterationTime(elapsed.count());
+  }
+}
+BENCHMARK(compressRepeatedResponseWithGzip)
+    ->DenseRange(0, 2, 1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
 static constexpr CompressionParams zstd_compression_params[] = {
     // level1 + default
     {1, 0, 0, 0},
@@ -2418,6 +2418,251 @@ TEST_F(CompressorPerRouteLibraryTest, GetCompressorFactoryUsesPerRoute) {
   EXPECT_EQ(per_route_factory.contentEncoding(), "test");
 }
 
+class CompressedResponseCacheTest : public CompressorFilterTest {
+public:
+  void SetUp() override {
+    setUpFilter(R"EOF(
+{
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  },
+  "response_direction_config": {
+    "compressed_response_cache": {
+      "max_size_bytes": 100000,
+      "max_body_bytes": 2000,
+      "cache_by_body_digest": true
+    }
+  }
+}
+)EOF");
+    response_stats_prefix_ = "response.";
+  }
+
+  // Starts a response with the given body on a new filter.
+  std::unique_ptr<CompressorFilter> startResponse(uint64_t content_length,
+                                                  absl::string_view etag = "",
+                                                  absl::string_view status = "200") {
+    auto filter = std::make_unique<CompressorFilter>(config_);
+    filter->setDecoderFilterCallbacks(decoder_callbacks_);
+    filter->setEncoderFilterCallbacks(encoder_callbacks_);
+    Http::TestRequestHeaderMapImpl request_headers{{":method", "GET"},
+                                                   {":authority", "example.com"},
+                                                   {":path", "/static/app.js"},
+                                                   {"accept-encoding", "test"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter->decodeHeaders(request_headers, true));
+    Http::TestResponseHeaderMapImpl headers{{":status", std::string(status)},
+                                            {"content-length", absl::StrCat(content_length)},
+                                            {"content-type", "text/plain"}};
+    if (!etag.empty()) {
+      headers.addCopy("etag", etag);
+    }
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter->encodeHeaders(headers, false));
+    EXPECT_EQ("test", headers.get_("content-encoding"));
+    return filter;
+  }
+
+  // Sends a whole response through a new filter, and returns the body the filter sends on.
+  std::string doCachedResponse(const std::string& body, absl::string_view etag = "",
+                               absl::string_view status = "200") {
+    auto filter = startResponse(body.size(), etag, status);
+    Buffer::OwnedImpl data(body);
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter->encodeData(data, true));
+    return data.toString();
+  }
+
+  // Sends a response through twice, which is what it takes for its body to be cached.
+  void admitResponse(const std::string& body, absl::string_view etag = "") {
+    EXPECT_EQ(body, doCachedResponse(body, etag));
+    EXPECT_EQ(body, doCachedResponse(body, etag));
+  }
+
+  uint64_t counter(absl::string_view name) {
+    return stats_.counter(absl::StrCat("test.compressor.test.test.response.", name)).value();
+  }
+
+  uint64_t gauge(absl::string_view name) {
+    return stats_
+        .gauge(absl::StrCat("test.compressor.test.test.response.", name),
+               Stats::Gauge::ImportMode::NeverImport)
+        .value();
+  }
+};
+
+TEST_F(CompressedResponseCacheTest, RepeatedBodyIsCachedOnSecondSighting) {
+  const std::string body(100, 'a');
+  EXPECT_EQ(body, doCachedResponse(body));
+  EXPECT_EQ(1, counter("response_cache_miss"));
+  // A body which has been seen once isn't copied into the cache.
+  EXPECT_EQ(0, gauge("response_cache_entries"));
+
+  EXPECT_EQ(body, doCachedResponse(body));
+  EXPECT_EQ(2, counter("response_cache_miss"));
+  EXPECT_EQ(1, gauge("response_cache_entries"));
+  // The key is "sha256:" and the hex digest of the body.
+  EXPECT_EQ(7 + 64 + body.size(), gauge("response_cache_size_bytes"));
+
+  // The mock compressor passes data through, so the cached body is the body itself.
+  compressor_factory_->setExpectedCompressCalls(0);
+  EXPECT_EQ(body, doCachedResponse(body));
+  EXPECT_EQ(1, counter("response_cache_hit"));
+  EXPECT_EQ(3 * body.size(), counter("total_uncompressed_bytes"));
+  EXPECT_EQ(3 * body.size(), counter("total_compressed_bytes"));
+  EXPECT_EQ(3, counter("compressed"));
+}
+
+TEST_F(CompressedResponseCacheTest, DifferentBodiesCachedSeparately) {
+  admitResponse(std::string(100, 'a'));
+  admitResponse(std::string(100, 'b'));
+  EXPECT_EQ(4, counter("response_cache_miss"));
+  EXPECT_EQ(0, counter("response_cache_hit"));
+  EXPECT_EQ(2, gauge("response_cache_entries"));
+}
+
+TEST_F(CompressedResponseCacheTest, LeastRecentlyUsedBodiesAreEvicted) {
+  setUpFilter(R"EOF(
+{
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  },
+  "response_direction_config": {
+    "compressed_response_cache": {
+      "max_size_bytes": 400,
+      "cache_by_body_digest": true
+    }
+  }
+}
+)EOF");
+  // Each entry takes 71 bytes of key and 100 of body, so only two fit.
+  admitResponse(std::string(100, 'a'));
+  admitResponse(std::string(100, 'b'));
+  compressor_factory_->setExpectedCompressCalls(0);
+  doCachedResponse(std::string(100, 'a'));
+  compressor_factory_->setExpectedCompressCalls(1);
+  admitResponse(std::string(100, 'c'));
+  EXPECT_EQ(1, counter("response_cache_eviction"));
+  EXPECT_EQ(2, gauge("response_cache_entries"));
+
+  // 'b' was evicted, while 'a' was used more recently.
+  doCachedResponse(std::string(100, 'b'));
+  EXPECT_EQ(7, counter("response_cache_miss"));
+  EXPECT_EQ(1, counter("response_cache_hit"));
+}
+
+TEST_F(CompressedResponseCacheTest, StrongEtagHitReplacesUpstreamBody) {
+  const std::string body(100, 'a');
+  EXPECT_EQ(body, doCachedResponse(body, "\"v1\""));
+  EXPECT_EQ(0, gauge("response_cache_entries"));
+  EXPECT_EQ(body, doCachedResponse(body, "\"v1\""));
+  EXPECT_EQ(2, counter("response_cache_miss"));
+  EXPECT_EQ(1, gauge("response_cache_entries"));
+
+  // The ETag promises the same body, so the upstream's body isn't even looked at.
+  compressor_factory_->setExpectedCompressCalls(0);
+  EXPECT_EQ(body, doCachedResponse(std::string(100, 'b'), "\"v1\""));
+  EXPECT_EQ(1, counter("response_cache_hit"));
+
+  compressor_factory_->setExpectedCompressCalls(1);
+  EXPECT_EQ(std::string(100, 'b'), doCachedResponse(std::string(100, 'b'), "\"v2\""));
+  EXPECT_EQ(3, counter("response_cache_miss"));
+}
+
+TEST_F(CompressedResponseCacheTest, WeakEtagUsesBodyDigest) {
+  EXPECT_EQ(std::string(100, 'a'), doCachedResponse(std::string(100, 'a'), "W/\"v1\""));
+  EXPECT_EQ(std::string(100, 'b'), doCachedResponse(std::string(100, 'b'), "W/\"v1\""));
+  EXPECT_EQ(2, counter("response_cache_miss"));
+  EXPECT_EQ(0, counter("response_cache_hit"));
+}
+
+TEST_F(CompressedResponseCacheTest, BodyIsBufferedUntilEndOfStream) {
+  auto filter = startResponse(100);
+  Buffer::OwnedImpl first(std::string(60, 'a'));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter->encodeData(first, false));
+  EXPECT_EQ(0, first.length());
+  Buffer::OwnedImpl second(std::string(40, 'b'));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter->encodeData(second, true));
+  EXPECT_EQ(absl::StrCat(std::string(60, 'a'), std::string(40, 'b')), second.toString());
+  EXPECT_EQ(1, counter("response_cache_miss"));
+}
+
+TEST_F(CompressedResponseCacheTest, BodyDigestIsOptIn) {
+  setUpFilter(R"EOF(
+{
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  },
+  "response_direction_config": {
+    "compressed_response_cache": {
+      "max_size_bytes": 100000
+    }
+  }
+}
+)EOF");
+  // Without a strong ETag the body is compressed as it arrives, without being buffered.
+  auto filter = startResponse(100, "W/\"v1\"");
+  Buffer::OwnedImpl first(std::string(60, 'a'));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter->encodeData(first, false));
+  Buffer::OwnedImpl second(std::string(40, 'b'));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter->encodeData(second, true));
+  EXPECT_EQ(0, counter("response_cache_miss"));
+}
+
+TEST_F(CompressedResponseCacheTest, OnlyOkResponsesAreCached) {
+  const std::string body(100, 'a');
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(body, doCachedResponse(body, "\"v1\"", "404"));
+    EXPECT_EQ(body, doCachedResponse(body, "", "500"));
+  }
+  EXPECT_EQ(0, counter("response_cache_miss"));
+  EXPECT_EQ(0, gauge("response_cache_entries"));
+}
+
+TEST_F(CompressedResponseCacheTest, BodyLargerThanContentLengthIsNotCached) {
+  auto filter = startResponse(100);
+  Buffer::OwnedImpl first(std::string(1500, 'a'));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter->encodeData(first, false));
+  // Past max_body_bytes, what was buffered is compressed and sent on uncached.
+  Buffer::OwnedImpl second(std::string(1500, 'b'));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter->encodeData(second, true));
+  EXPECT_EQ(absl::StrCat(std::string(1500, 'a'), std::string(1500, 'b')), second.toString());
+  EXPECT_EQ(0, counter("response_cache_miss"));
+}
+
+TEST_F(CompressedResponseCacheTest, LargeResponseIsNotCached) {
+  populateBuffer(3000);
+  auto filter = startResponse(3000);
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter->encodeData(data_, true));
+  verifyCompressedData();
+  EXPECT_EQ(0, counter("response_cache_miss"));
+  EXPECT_EQ(0, gauge("response_cache_entries"));
+}
+
+TEST_F(CompressedResponseCacheTest, TrailersEndTheCachedBody) {
+  const std::string body(100, 'a');
+  for (int i = 0; i < 3; ++i) {
+    compressor_factory_->setExpectedCompressCalls(i < 2 ? 1 : 0);
+    auto filter = startResponse(body.size());
+    Buffer::OwnedImpl data(body);
+    EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter->encodeData(data, false));
+    std::string sent;
+    EXPECT_CALL(encoder_callbacks_, addEncodedData(_, true))
+        .WillOnce(Invoke([&](Buffer::Instance& data, bool) { sent = data.toString(); }));
+    Http::TestResponseTrailerMapImpl trailers;
+    EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter->encodeTrailers(trailers));
+    EXPECT_EQ(body, sent);
+  }
+  EXPECT_EQ(2, counter("response_cache_miss"));
+  EXPECT_EQ(1, counter("response_cache_hit"));
+}
+
 } // namespace
 } // namespace Compressor
 } // namespace HttpFilters
@@ -122,6 +122,70 @@ public:
   std::string category() const override { return "envoy.compression.compressor"; }
 };
 
+// Factory that counts a statistic of its own, as the zstd dictionary trainer does.
+class TestStatsCompressorLibraryFactory : public TestCheckingCompressorLibraryFactory {
+public:
+  Envoy::Compression::Compressor::CompressorFactoryPtr
+  createCompressorFactoryFromProto(const Protobuf::Message& config,
+                                   Server::Configuration::GenericFactoryContext& context) override {
+    context.scope().counterFromString("library_stat").inc();
+    return TestCheckingCompressorLibraryFactory::createCompressorFactoryFromProto(config, context);
+  }
+
+  std::string name() const override { return "test.mock.stats"; }
+};
+
+TEST(CompressorFilterFactoryTests, LibraryStatsAreScopedToTheFilterConfig) {
+  const std::string yaml_string = R"EOF(
+  compressor_library:
+    name: my_library
+    typed_config:
+      "@type": type.googleapis.com/test.mock_compressor_library.Registered
+  )EOF";
+
+  envoy::extensions::filters::http::compressor::v3::Compressor proto_config;
+  TestUtility::loadFromYaml(yaml_string, proto_config);
+  CompressorFilterFactory factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  TestStatsCompressorLibraryFactory stats_impl;
+  Envoy::Registry::InjectFactory<
+      Envoy::Compression::Compressor::NamedCompressorLibraryConfigFactory>
+      reg(stats_impl);
+  EXPECT_TRUE(factory.createFilterFactoryFromProto(proto_config, "test.", context).status().ok());
+  EXPECT_EQ(
+      TestUtility::findCounter(context.store_, "test.compressor.my_library.library_stat")->value(),
+      1);
+}
+
+TEST(CompressorFilterFactoryTests, PerRouteLibraryStatsAreScopedToTheRouteConfig) {
+  const std::string yaml_string = R"EOF(
+  overrides:
+    response_direction_config: {}
+    compressor_library:
+      name: my_library
+      typed_config:
+        "@type": type.googleapis.com/test.mock_compressor_library.Registered
+  )EOF";
+
+  envoy::extensions::filters::http::compressor::v3::CompressorPerRoute per_route;
+  TestUtility::loadFromYaml(yaml_string, per_route);
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  CompressorFilterFactory factory;
+  TestStatsCompressorLibraryFactory stats_impl;
+  Envoy::Registry::InjectFactory<
+      Envoy::Compression::Compressor::NamedCompressorLibraryConfigFactory>
+      reg(stats_impl);
+  EXPECT_TRUE(factory
+                  .createRouteSpecificFilterConfig(per_route, context,
+                                                   context.messageValidationVisitor())
+                  .status()
+                  .ok());
+  const std::string stat_name =
+      fmt::format("per_route.{:x}.compressor.my_library.library_stat",
+                  MessageUtil::hash(per_route.overrides().compressor_library()));
+  EXPECT_EQ(TestUtility::findCounter(context.store_, stat_name)->value(), 1);
+}
+
 TEST(CompressorFilterFactoryTests, PerRouteWithGenericFactoryContext) {
   // Per-route config with a typed compressor_library using the checking factory.
   const std::string yaml_string = R"EOF(
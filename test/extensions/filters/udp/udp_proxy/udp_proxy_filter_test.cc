@@ -28,6 +28,7 @@
 #include "test/mocks/upstream/host.h"
 #include "test/mocks/upstream/load_balancer_context.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/registry.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 
 #include "gmock/gmock.h"
@@ -51,6 +52,84 @@ namespace UdpFilters {
 namespace UdpProxy {
 namespace {
 
+// A batching packet writer that records datagrams instead of sending them.
+class TestBatchingWriter : public Network::UdpPacketWriter {
+public:
+  Api::IoCallUint64Result writePacket(const Buffer::Instance& buffer, const Network::Address::Ip*,
+                                      const Network::Address::Instance&) override {
+    EXPECT_EQ(1, buffer.getRawSlices().size());
+    buffered_.push_back(buffer.toString());
+    return makeNoError(buffer.length());
+  }
+  bool isWriteBlocked() const override { return write_blocked_; }
+  void setWritable() override { write_blocked_ = false; }
+  uint64_t getMaxPacketSize(const Network::Address::Instance&) const override {
+    return Network::UdpMaxOutgoingPacketSize;
+  }
+  bool isBatchMode() const override { return true; }
+  Network::UdpPacketWriterBuffer
+  getNextWriteLocation(const Network::Address::Ip*, const Network::Address::Instance&) override {
+    return {nullptr, 0, nullptr};
+  }
+  Api::IoCallUint64Result flush() override {
+    ++flushes_;
+    if (block_on_flush_) {
+      // Keep the datagrams buffered until the socket becomes writable.
+      write_blocked_ = true;
+      return {/*rc=*/0, Network::IoSocketError::getIoSocketEagainError()};
+    }
+    for (auto& datagram : buffered_) {
+      sent_.push_back(std::move(datagram));
+    }
+    buffered_.clear();
+    return makeNoError(0);
+  }
+
+  std::vector<std::string> buffered_;
+  std::vector<std::string> sent_;
+  uint32_t flushes_{};
+  bool block_on_flush_{};
+  bool write_blocked_{};
+};
+
+class TestBatchingWriterFactory : public Network::UdpPacketWriterFactory,
+                                  public Network::UdpPacketWriterFactoryFactory {
+public:
+  // Network::UdpPacketWriterFactory
+  Network::UdpPacketWriterPtr createUdpPacketWriter(Network::IoHandle&, Stats::Scope&,
+                                                    Event::Dispatcher&,
+                                                    absl::AnyInvocable<void() &&>) override {
+    auto writer = std::make_unique<TestBatchingWriter>();
+    writers_.push_back(writer.get());
+    return writer;
+  }
+
+  // Network::UdpPacketWriterFactoryFactory
+  std::string name() const override { return "envoy.udp_packet_writer.test_batching"; }
+  Network::UdpPacketWriterFactoryPtr
+  createUdpPacketWriterFactory(const envoy::config::core::v3::TypedExtensionConfig&) override {
+    return std::make_unique<ForwardingFactory>(*this);
+  }
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<ProtobufWkt::Struct>();
+  }
+
+  std::vector<TestBatchingWriter*> writers_;
+
+private:
+  struct ForwardingFactory : public Network::UdpPacketWriterFactory {
+    ForwardingFactory(TestBatchingWriterFactory& parent) : parent_(parent) {}
+    Network::UdpPacketWriterPtr
+    createUdpPacketWriter(Network::IoHandle& io_handle, Stats::Scope& scope,
+                          Event::Dispatcher& dispatcher,
+                          absl::AnyInvocable<void() &&> on_can_write_cb) override {
+      return parent_.createUdpPacketWriter(io_handle, scope, dispatcher,
+                                           std::move(on_can_write_cb));
+    }
+    TestBatchingWriterFactory& parent_;
+  };
+};
+
 class TestUdpProxyFilter : public virtual UdpProxyFilter {
 public:
   using UdpProxyFilter::UdpProxyFilter;
@@ -672,6 +751,119 @@ matcher:
   EXPECT_EQ(output_.front(), "2 1");
 }
 
+// Verify that with a batching upstream packet writer, datagrams written during one event loop
+// iteration are flushed together at the end of it.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamWrites) {
+  TestBatchingWriterFactory writer_factory;
+  Registry::InjectFactory<Network::UdpPacketWriterFactoryFactory> registration(writer_factory);
+
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_packet_writer_config:
+  name: envoy.udp_packet_writer.test_batching
+  typed_config:
+    '@type': type.googleapis.com/google.protobuf.Struct
+  )EOF"));
+
+  expectSessionCreate(upstream_address_);
+  auto* flush_cb =
+      new NiceMock<Event::MockSchedulableCallback>(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, nullptr)).Times(3);
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, connect(_))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello2");
+  ASSERT_EQ(1, writer_factory.writers_.size());
+  TestBatchingWriter& writer = *writer_factory.writers_[0];
+  EXPECT_THAT(writer.buffered_, testing::ElementsAre("hello", "hello2"));
+  EXPECT_EQ(0, writer.flushes_);
+
+  flush_cb->invokeCallback();
+  EXPECT_THAT(writer.sent_, testing::ElementsAre("hello", "hello2"));
+  EXPECT_EQ(1, writer.flushes_);
+  EXPECT_EQ(2, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_datagrams")
+                   ->value());
+
+  // The next iteration schedules a new flush.
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello3");
+  EXPECT_THAT(writer.buffered_, testing::ElementsAre("hello3"));
+
+  // Destroying the session sends any remaining datagrams.
+  filter_.reset();
+  EXPECT_THAT(writer.sent_, testing::ElementsAre("hello", "hello2", "hello3"));
+}
+
+// Verify that datagrams are dropped while the upstream packet writer is blocked, and that the
+// buffered datagrams are flushed once the socket becomes writable.
+TEST_F(UdpProxyFilterTest, BlockedUpstreamWriter) {
+  TestBatchingWriterFactory writer_factory;
+  Registry::InjectFactory<Network::UdpPacketWriterFactoryFactory> registration(writer_factory);
+
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_packet_writer_config:
+  name: envoy.udp_packet_writer.test_batching
+  typed_config:
+    '@type': type.googleapis.com/google.protobuf.Struct
+  )EOF"));
+
+  expectSessionCreate(upstream_address_);
+  auto* flush_cb =
+      new NiceMock<Event::MockSchedulableCallback>(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, nullptr)).Times(2);
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, connect(_))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  ASSERT_EQ(1, writer_factory.writers_.size());
+  TestBatchingWriter& writer = *writer_factory.writers_[0];
+
+  // The flush blocks, so the session waits for the socket to become writable.
+  writer.block_on_flush_ = true;
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_,
+              enableFileEvents(Event::FileReadyType::Read | Event::FileReadyType::Write));
+  flush_cb->invokeCallback();
+  EXPECT_THAT(writer.buffered_, testing::ElementsAre("hello"));
+
+  // A datagram written while the writer is blocked is dropped and counted as a send error.
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration()).Times(0);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello2");
+  EXPECT_THAT(writer.buffered_, testing::ElementsAre("hello"));
+  Stats::Store& cluster_stats_store = factory_context_.server_factory_context_.cluster_manager_
+                                          .thread_local_cluster_.cluster_.info_->stats_store_;
+  EXPECT_EQ(1, TestUtility::findCounter(cluster_stats_store, "udp.sess_tx_errors")->value());
+  EXPECT_EQ(1, TestUtility::findCounter(cluster_stats_store, "udp.sess_tx_datagrams")->value());
+
+  // The write event stops watching for writability and flushes the buffered datagram.
+  writer.block_on_flush_ = false;
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_,
+              enableFileEvents(Event::FileReadyType::Read));
+  EXPECT_TRUE(test_sessions_[0].file_event_cb_(Event::FileReadyType::Write).ok());
+  EXPECT_FALSE(writer.isWriteBlocked());
+  EXPECT_TRUE(writer.buffered_.empty());
+  EXPECT_THAT(writer.sent_, testing::ElementsAre("hello"));
+  EXPECT_EQ(1, TestUtility::findCounter(cluster_stats_store, "udp.sess_tx_errors")->value());
+}
+
 // Verify downstream send and receive error handling.
 TEST_F(UdpProxyFilterTest, SendReceiveErrorHandling) {
   InSequence s;
@@ -0,0 +1,150 @@
+// Compares the loopback throughput of the UDP proxy's upstream egress paths: writing each datagram
+// directly to the session socket, as without upstream_packet_writer_config, and writing through
+// the GSO batch writer, flushed once per batch as at the end of an event loop iteration.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/core/v3/extension.pb.h"
+#include "envoy/extensions/udp_packet_writer/v3/udp_gso_batch_writer_factory.pb.h"
+#include "envoy/network/udp_packet_writer_handler.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/socket_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/test_common/network_utility.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace UdpProxy {
+namespace {
+
+enum class WriterType { Direct, Gso };
+
+constexpr size_t DatagramSize = 1200;
+
+class UpstreamWriterBenchmark {
+public:
+  UpstreamWriterBenchmark() {
+    auto bound = Network::Test::bindFreeLoopbackPort(Network::Address::IpVersion::v4,
+                                                     Network::Socket::Type::Datagram);
+    upstream_address_ = std::move(bound.first);
+    upstream_socket_ = std::move(bound.second);
+    // The session socket is created as the proxy creates it, and bound on the first write.
+    session_socket_ = std::make_unique<Network::SocketImpl>(
+        Network::Socket::Type::Datagram, upstream_address_, nullptr,
+        Network::SocketCreationOptions{});
+  }
+
+  // @return false if the writer is not supported by this build.
+  bool setWriter(WriterType type) {
+    if (type == WriterType::Direct) {
+      return true;
+    }
+    envoy::config::core::v3::TypedExtensionConfig config;
+    config.set_name("envoy.udp_packet_writer.gso");
+    config.mutable_typed_config()->PackFrom(
+        envoy::extensions::udp_packet_writer::v3::UdpGsoBatchWriterFactory());
+    auto* factory_factory =
+        Registry::FactoryRegistry<Network::UdpPacketWriterFactoryFactory>::getFactory(
+            config.name());
+    if (factory_factory == nullptr) {
+      return false;
+    }
+    writer_factory_ = factory_factory->createUdpPacketWriterFactory(config);
+    if (writer_factory_ == nullptr) {
+      return false;
+    }
+    writer_ = writer_factory_->createUdpPacketWriter(session_socket_->ioHandle(),
+                                                     *stats_store_.rootScope(), *dispatcher_,
+                                                     []() {});
+    return true;
+  }
+
+  // Writes a batch of datagrams upstream as the proxy does within one event loop iteration, and
+  // then drains them from the upstream socket.
+  // @return false if a write failed.
+  bool sendBatch(uint32_t datagrams) {
+    for (uint32_t i = 0; i < datagrams; i++) {
+      Buffer::OwnedImpl buffer(payload_);
+      const Api::IoCallUint64Result rc =
+          writer_ != nullptr
+              ? writer_->writePacket(buffer, nullptr, *upstream_address_)
+              : Network::Utility::writeToSocket(session_socket_->ioHandle(), buffer, nullptr,
+                                                *upstream_address_);
+      if (!rc.ok()) {
+        return false;
+      }
+    }
+    if (writer_ != nullptr && !writer_->flush().ok()) {
+      return false;
+    }
+    drain();
+    return true;
+  }
+
+  uint64_t bytesReceived() const { return bytes_received_; }
+
+private:
+  void drain() {
+    while (true) {
+      const Api::IoCallUint64Result rc =
+          upstream_socket_->ioHandle().recv(receive_buffer_.data(), receive_buffer_.size(), 0);
+      if (!rc.ok()) {
+        return;
+      }
+      bytes_received_ += rc.return_value_;
+    }
+  }
+
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+  Stats::IsolatedStoreImpl stats_store_;
+  const std::string payload_ = std::string(DatagramSize, 'a');
+  std::vector<char> receive_buffer_ = std::vector<char>(64 * 1024);
+  Network::Address::InstanceConstSharedPtr upstream_address_;
+  Network::SocketPtr upstream_socket_;
+  Network::SocketPtr session_socket_;
+  Network::UdpPacketWriterFactoryPtr writer_factory_;
+  // Declared after session_socket_ as it refers to the socket's IO handle.
+  Network::UdpPacketWriterPtr writer_;
+  uint64_t bytes_received_ = 0;
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_UpstreamEgress(benchmark::State& state) {
+  const WriterType type = static_cast<WriterType>(state.range(0));
+  const uint32_t datagrams = state.range(1);
+  UpstreamWriterBenchmark bench;
+  if (!bench.setWriter(type)) {
+    state.SkipWithError("the GSO packet writer is not supported by this build");
+    return;
+  }
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    if (!bench.sendBatch(datagrams)) {
+      state.SkipWithError("writing to the loopback socket failed");
+      return;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * datagrams * DatagramSize);
+  state.counters["received_bytes"] = bench.bytesReceived();
+}
+BENCHMARK(BM_UpstreamEgress)
+    ->ArgsProduct(
+        {{static_cast<int64_t>(WriterType::Direct), static_cast<int64_t>(WriterType::Gso)},
+         {1, 16, 64}})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace UdpProxy
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,249 @@
+#include <limits>
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_entry_in_progress.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/status_utility.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+namespace {
+
+using StatusHelpers::StatusIs;
+using ::testing::_;
+using ::testing::NiceMock;
+
+constexpr uint64_t MaxBufferedBodyBytes = 10;
+constexpr uint64_t Unbounded = std::numeric_limits<uint64_t>::max();
+
+class CacheEntryInProgressTest : public ::testing::Test {
+protected:
+  // The results of the most recent callback of each kind.
+  struct Results {
+    absl::StatusOr<CacheEntryInProgress::Headers> headers_ = absl::UnknownError("not called");
+    absl::StatusOr<Buffer::InstancePtr> body_ = absl::UnknownError("not called");
+    bool body_end_stream_ = false;
+    Http::ResponseTrailerMapPtr trailers_;
+  };
+
+  void getHeaders(CacheEntryInProgress::Follower& follower, Results& results) {
+    follower.getHeaders([&results](absl::StatusOr<CacheEntryInProgress::Headers>&& headers) {
+      results.headers_ = std::move(headers);
+    });
+  }
+
+  void getBody(CacheEntryInProgress::Follower& follower, uint64_t begin, uint64_t end,
+               Results& results) {
+    results.body_ = absl::UnknownError("not called");
+    follower.getBody({begin, end},
+                     [&results](absl::StatusOr<Buffer::InstancePtr>&& body, bool end_stream) {
+                       results.body_ = std::move(body);
+                       results.body_end_stream_ = end_stream;
+                     });
+  }
+
+  void getTrailers(CacheEntryInProgress::Follower& follower, Results& results) {
+    follower.getTrailers([&results](Http::ResponseTrailerMapPtr&& trailers) {
+      results.trailers_ = std::move(trailers);
+    });
+  }
+
+  Key key_;
+  std::shared_ptr<CacheEntryInProgress> entry_ =
+      std::make_shared<CacheEntryInProgress>(key_, MaxBufferedBodyBytes);
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Http::TestResponseHeaderMapImpl response_headers_{{":status", "200"}};
+  Http::TestResponseTrailerMapImpl response_trailers_{{"fruit", "banana"}};
+  const ResponseMetadata metadata_{};
+};
+
+TEST_F(CacheEntryInProgressTest, FollowerStreamsResponseAsItIsPublished) {
+  auto follower = entry_->join(dispatcher_);
+  ASSERT_NE(nullptr, follower);
+  Results results;
+  getHeaders(*follower, results);
+  EXPECT_THAT(results.headers_, StatusIs(absl::StatusCode::kUnknown));
+  entry_->publishHeaders(key_, response_headers_, metadata_, false);
+  ASSERT_OK(results.headers_);
+  EXPECT_THAT(results.headers_->headers_, HeaderMapEqualIgnoreOrder(&response_headers_));
+  EXPECT_FALSE(results.headers_->end_stream_);
+
+  getBody(*follower, 0, Unbounded, results);
+  EXPECT_THAT(results.body_, StatusIs(absl::StatusCode::kUnknown));
+  entry_->publishBody(Buffer::OwnedImpl("hello"), false);
+  ASSERT_OK(results.body_);
+  EXPECT_EQ("hello", results.body_.value()->toString());
+  EXPECT_FALSE(results.body_end_stream_);
+
+  getBody(*follower, 5, Unbounded, results);
+  EXPECT_THAT(results.body_, StatusIs(absl::StatusCode::kUnknown));
+  entry_->publishTrailers(response_trailers_);
+  // The body ended, so the follower moves on to the trailers.
+  ASSERT_OK(results.body_);
+  EXPECT_EQ(nullptr, results.body_.value());
+
+  getTrailers(*follower, results);
+  ASSERT_NE(nullptr, results.trailers_);
+  EXPECT_THAT(results.trailers_, HeaderMapEqualIgnoreOrder(&response_trailers_));
+}
+
+TEST_F(CacheEntryInProgressTest, FollowerJoiningLateReadsTheWholeBody) {
+  entry_->publishHeaders(key_, response_headers_, metadata_, false);
+  entry_->publishBody(Buffer::OwnedImpl("hello"), false);
+  entry_->publishBody(Buffer::OwnedImpl(" you"), true);
+  auto follower = entry_->join(dispatcher_);
+  ASSERT_NE(nullptr, follower);
+  Results results;
+  getHeaders(*follower, results);
+  ASSERT_OK(results.headers_);
+  getBody(*follower, 0, 9, results);
+  ASSERT_OK(results.body_);
+  EXPECT_EQ("hello you", results.body_.value()->toString());
+  EXPECT_TRUE(results.body_end_stream_);
+}
+
+TEST_F(CacheEntryInProgressTest, AbandonBeforeHeadersMakesFollowersFallBack) {
+  auto follower = entry_->join(dispatcher_);
+  ASSERT_NE(nullptr, follower);
+  Results results;
+  getHeaders(*follower, results);
+  entry_->abandon();
+  EXPECT_THAT(results.headers_, StatusIs(absl::StatusCode::kUnavailable));
+  EXPECT_EQ(nullptr, entry_->join(dispatcher_));
+}
+
+TEST_F(CacheEntryInProgressTest, AbandonPartWayThroughBodyFailsAfterPublishedBody) {
+  auto follower = entry_->join(dispatcher_);
+  ASSERT_NE(nullptr, follower);
+  entry_->publishHeaders(key_, response_headers_, metadata_, false);
+  entry_->publishBody(Buffer::OwnedImpl("hello"), false);
+  entry_->abandon();
+  Results results;
+  getHeaders(*follower, results);
+  // A follower which hadn't received headers yet can still fall back.
+  EXPECT_THAT(results.headers_, StatusIs(absl::StatusCode::kUnavailable));
+  getBody(*follower, 0, Unbounded, results);
+  ASSERT_OK(results.body_);
+  EXPECT_EQ("hello", results.body_.value()->toString());
+  getBody(*follower, 5, Unbounded, results);
+  EXPECT_THAT(results.body_, StatusIs(absl::StatusCode::kUnavailable));
+}
+
+TEST_F(CacheEntryInProgressTest, AbandonAfterCompleteResponseDoesNothing) {
+  auto follower = entry_->join(dispatcher_);
+  ASSERT_NE(nullptr, follower);
+  entry_->publishHeaders(key_, response_headers_, metadata_, false);
+  entry_->publishBody(Buffer::OwnedImpl("hello"), true);
+  entry_->abandon();
+  Results results;
+  getHeaders(*follower, results);
+  ASSERT_OK(results.headers_);
+  getBody(*follower, 0, Unbounded, results);
+  ASSERT_OK(results.body_);
+  EXPECT_EQ("hello", results.body_.value()->toString());
+  EXPECT_TRUE(results.body_end_stream_);
+}
+
+TEST_F(CacheEntryInProgressTest, ContentLengthLargerThanBufferIsNotShared) {
+  auto follower = entry_->join(dispatcher_);
+  ASSERT_NE(nullptr, follower);
+  Results results;
+  getHeaders(*follower, results);
+  response_headers_.setContentLength(MaxBufferedBodyBytes + 1);
+  entry_->publishHeaders(key_, response_headers_, metadata_, false);
+  EXPECT_THAT(results.headers_, StatusIs(absl::StatusCode::kResourceExhausted));
+  EXPECT_EQ(nullptr, entry_->join(dispatcher_));
+}
+
+TEST_F(CacheEntryInProgressTest, BodyLargerThanBufferStopsNewFollowers) {
+  auto follower = entry_->join(dispatcher_);
+  ASSERT_NE(nullptr, follower);
+  entry_->publishHeaders(key_, response_headers_, metadata_, false);
+  Results results;
+  getBody(*follower, 0, Unbounded, results);
+  const std::string large_body(MaxBufferedBodyBytes + 5, 'x');
+  entry_->publishBody(Buffer::OwnedImpl(large_body), false);
+  EXPECT_EQ(nullptr, entry_->join(dispatcher_));
+  ASSERT_OK(results.body_);
+  EXPECT_EQ(large_body, results.body_.value()->toString());
+  entry_->publishBody(Buffer::OwnedImpl("yz"), true);
+  getBody(*follower, large_body.size(), Unbounded, results);
+  ASSERT_OK(results.body_);
+  EXPECT_EQ("yz", results.body_.value()->toString());
+  EXPECT_TRUE(results.body_end_stream_);
+}
+
+TEST_F(CacheEntryInProgressTest, StalledFollowerFallingTooFarBehindIsFailed) {
+  auto stalled = entry_->join(dispatcher_);
+  ASSERT_NE(nullptr, stalled);
+  auto reading = entry_->join(dispatcher_);
+  ASSERT_NE(nullptr, reading);
+  entry_->publishHeaders(key_, response_headers_, metadata_, false);
+  Results stalled_results, reading_results;
+  getBody(*stalled, 0, Unbounded, stalled_results);
+  getBody(*reading, 0, Unbounded, reading_results);
+  entry_->publishBody(Buffer::OwnedImpl("hello"), false);
+  ASSERT_OK(stalled_results.body_);
+  ASSERT_OK(reading_results.body_);
+
+  // The stalled follower stops asking for more while the other one keeps up. Being exactly
+  // MaxBufferedBodyBytes behind is still allowed.
+  const std::string chunk(MaxBufferedBodyBytes, 'x');
+  getBody(*reading, 5, Unbounded, reading_results);
+  entry_->publishBody(Buffer::OwnedImpl(chunk), false);
+  ASSERT_OK(reading_results.body_);
+  EXPECT_EQ(chunk, reading_results.body_.value()->toString());
+  getBody(*reading, 5 + chunk.size(), Unbounded, reading_results);
+  entry_->publishBody(Buffer::OwnedImpl("y"), false);
+  ASSERT_OK(reading_results.body_);
+  EXPECT_EQ("y", reading_results.body_.value()->toString());
+
+  // One more byte puts it too far behind, so the body it hadn't read was released.
+  getBody(*stalled, 5, Unbounded, stalled_results);
+  EXPECT_THAT(stalled_results.body_, StatusIs(absl::StatusCode::kUnavailable));
+  getTrailers(*stalled, stalled_results);
+  ASSERT_NE(nullptr, stalled_results.trailers_);
+  EXPECT_TRUE(stalled_results.trailers_->empty());
+
+  // The follower which kept up is unaffected.
+  getBody(*reading, 6 + chunk.size(), Unbounded, reading_results);
+  entry_->publishTrailers(response_trailers_);
+  ASSERT_OK(reading_results.body_);
+  EXPECT_EQ(nullptr, reading_results.body_.value());
+  getTrailers(*reading, reading_results);
+  EXPECT_THAT(reading_results.trailers_, HeaderMapEqualIgnoreOrder(&response_trailers_));
+}
+
+TEST_F(CacheEntryInProgressTest, DestroyedFollowerIsNotCalledBack) {
+  auto follower = entry_->join(dispatcher_);
+  ASSERT_NE(nullptr, follower);
+  Event::PostCb posted;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce([&posted](Event::PostCb cb) {
+    posted = std::move(cb);
+  });
+  bool called = false;
+  follower->getHeaders([&called](absl::StatusOr<CacheEntryInProgress::Headers>&&) {
+    called = true;
+  });
+  entry_->publishHeaders(key_, response_headers_, metadata_, true);
+  ASSERT_TRUE(posted);
+  follower.reset();
+  posted();
+  EXPECT_FALSE(called);
+}
+
+} // namespace
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,143 @@
+// Measures the latency of repeated lookups of one small, hot cache entry, served either from its
+// cache file or from the memory tier.
+
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/cache/v3/cache.pb.h"
+#include "envoy/extensions/http/cache/file_system_http_cache/v3/file_system_http_cache.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/file_system_http_cache/file_system_http_cache.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+namespace {
+
+using ::testing::NiceMock;
+using ::testing::ReturnRef;
+
+class HotEntryBenchmark {
+public:
+  HotEntryBenchmark(bool memory_tier, uint64_t body_size) : body_(body_size, 'x') {
+    ON_CALL(context_.server_factory_context_.api_, threadFactory())
+        .WillByDefault([]() -> Thread::ThreadFactory& { return Thread::threadFactoryForTest(); });
+    ON_CALL(decoder_callbacks_, dispatcher()).WillByDefault(ReturnRef(*dispatcher_));
+    ON_CALL(encoder_callbacks_, dispatcher()).WillByDefault(ReturnRef(*dispatcher_));
+    ConfigProto cfg;
+    cfg.mutable_manager_config()->mutable_thread_pool()->set_thread_count(1);
+    cfg.set_cache_path(absl::StrCat(TestEnvironment::temporaryDirectory(), "/hot_entry_",
+                                    memory_tier ? "memory_tier_" : "file_tier_", body_size, "/"));
+    TestEnvironment::createPath(cfg.cache_path());
+    if (memory_tier) {
+      cfg.mutable_memory_tier()->set_max_size_bytes(1024 * 1024);
+      cfg.mutable_memory_tier()->mutable_promotion_threshold()->set_value(1);
+    }
+    envoy::extensions::filters::http::cache::v3::CacheConfig cache_config;
+    cache_config.mutable_typed_config()->PackFrom(cfg);
+    auto* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+        std::string(TypeUtil::typeUrlToDescriptorFullName(cache_config.typed_config().type_url())));
+    RELEASE_ASSERT(factory != nullptr, "file system cache not registered");
+    cache_ =
+        std::dynamic_pointer_cast<FileSystemHttpCache>(factory->getCache(cache_config, context_));
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setScheme("https");
+    request_headers_.setPath("/hot");
+    insertEntry();
+    // The first read from the file promotes the entry, if there is a memory tier.
+    lookupEntry();
+  }
+
+  ~HotEntryBenchmark() { cache_->drainAsyncFileActionsForTest(); }
+
+  // Looks up the entry and reads its whole body.
+  void lookupEntry() {
+    auto lookup = makeLookupContext();
+    lookup->getHeaders([this, &lookup](LookupResult&& result, bool) {
+      RELEASE_ASSERT(result.cache_entry_status_ != CacheEntryStatus::Unusable, "cache miss");
+      lookup->getBody(AdjustedByteRange(0, body_.size()), [this](Buffer::InstancePtr body, bool) {
+        RELEASE_ASSERT(body != nullptr && body->length() == body_.size(), "failed to read body");
+        dispatcher_->exit();
+      });
+    });
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+    lookup->onDestroy();
+  }
+
+private:
+  LookupContextPtr makeLookupContext() {
+    return cache_->makeLookupContext(
+        LookupRequest{request_headers_, api_->timeSource().systemTime(), vary_allow_list_},
+        decoder_callbacks_);
+  }
+
+  void insertEntry() {
+    auto lookup = makeLookupContext();
+    lookup->getHeaders([this](LookupResult&&, bool) { dispatcher_->exit(); });
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+    const std::string date = DateFormatter("%a, %d %b %Y %H:%M:%S GMT")
+                                 .fromTime(api_->timeSource().systemTime());
+    Http::TestResponseHeaderMapImpl response_headers{
+        {":status", "200"}, {"date", date}, {"cache-control", "public,max-age=3600"}};
+    auto insert = cache_->makeInsertContext(std::move(lookup), encoder_callbacks_);
+    insert->insertHeaders(
+        response_headers, ResponseMetadata{api_->timeSource().systemTime()},
+        [this, &insert](bool ready) {
+          RELEASE_ASSERT(ready, "failed to insert headers");
+          insert->insertBody(
+              Buffer::OwnedImpl(body_),
+              [this](bool inserted) {
+                RELEASE_ASSERT(inserted, "failed to insert body");
+                dispatcher_->exit();
+              },
+              true);
+        },
+        false);
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+    insert->onDestroy();
+  }
+
+  const std::string body_;
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+  NiceMock<Server::Configuration::MockFactoryContext> context_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+  VaryAllowList vary_allow_list_{
+      Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>(),
+      context_.server_factory_context_};
+  Http::TestRequestHeaderMapImpl request_headers_;
+  std::shared_ptr<FileSystemHttpCache> cache_;
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_LookupHotEntry(benchmark::State& state) {
+  HotEntryBenchmark bench(state.range(0) != 0, state.range(1));
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    bench.lookupEntry();
+  }
+}
+BENCHMARK(BM_LookupHotEntry)
+    ->ArgNames({"memory_tier", "body_size"})
+    ->ArgsProduct({{0, 1}, {128, 4096, 65536}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -4,6 +4,7 @@
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/filesystem/directory.h"
+#include "source/common/http/header_map_impl.h"
 #include "source/extensions/filters/http/cache/cache_entry_utils.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_eviction_thread.h"
@@ -186,6 +187,45 @@ TEST_F(FileSystemHttpCacheTestWithNoDefaultCache, EvictsOldestFilesUntilUnderSiz
   EXPECT_EQ(cache_->stats().eviction_runs_.value(), 1);
 }
 
+TEST_F(FileSystemHttpCacheTestWithNoDefaultCache, EvictionDropsMemoryEntriesOfEvictedFiles) {
+  const std::string file_contents = "XXXXX";
+  ConfigProto cfg = testConfig();
+  cfg.mutable_max_cache_entry_count()->set_value(1);
+  cfg.mutable_memory_tier()->set_max_size_bytes(1024 * 1024);
+  cfg.mutable_memory_tier()->mutable_promotion_threshold()->set_value(1);
+  cache_ = std::dynamic_pointer_cast<FileSystemHttpCache>(
+      http_cache_factory_->getCache(cacheConfig(cfg), context_));
+  waitForEvictionThreadIdle();
+  Key evicted_key;
+  evicted_key.set_host("example.com");
+  evicted_key.set_path("/evicted");
+  Key kept_key = evicted_key;
+  kept_key.set_path("/kept");
+  MemoryTier& memory_tier = *cache_->memoryTier();
+  for (const Key& key : {evicted_key, kept_key}) {
+    absl::optional<uint64_t> generation = memory_tier.recordFileRead(key, 0);
+    ASSERT_TRUE(generation.has_value());
+    memory_tier.insert(key,
+                       {Http::createHeaderMap<Http::ResponseHeaderMapImpl>(
+                            Http::TestResponseHeaderMapImpl{{":status", "200"}}),
+                        {}, "", nullptr},
+                       generation.value());
+  }
+  const std::string evicted_path = absl::StrCat(cache_path_, cache_->generateFilename(evicted_key));
+  env_.writeStringToFileForTest(evicted_path, file_contents, true);
+  // TODO(#24994): replace this with backdating the files when that's possible.
+  sleep(1); // NO_CHECK_FORMAT(real_time)
+  env_.writeStringToFileForTest(absl::StrCat(cache_path_, cache_->generateFilename(kept_key)),
+                                file_contents, true);
+  cache_->trackFileAdded(file_contents.size());
+  cache_->trackFileAdded(file_contents.size());
+  waitForEvictionThreadIdle();
+  EXPECT_FALSE(Filesystem::fileSystemForTest().fileExists(evicted_path));
+  EXPECT_EQ(memory_tier.lookup(evicted_key), nullptr);
+  EXPECT_NE(memory_tier.lookup(kept_key), nullptr);
+  EXPECT_EQ(cache_->stats().memory_tier_size_count_.value(), 1);
+}
+
 class FileSystemHttpCacheTest : public FileSystemCacheTestContext, public ::testing::Test {
   void SetUp() override { initCache(); }
 };
@@ -1367,6 +1407,346 @@ TEST_F(FileSystemHttpCacheTestWithMockFiles, UpdateHeadersAbortsEarlyIfCacheEntr
   EXPECT_OK(mock_async_file_handle_->close(nullptr, [](absl::Status) {}));
 }
 
+class FileSystemHttpCacheTestWithCoalescing : public FileSystemHttpCacheTestWithMockFiles {
+public:
+  void SetUp() override {}
+
+  void initCoalescingCache(ConfigProto::Coalescing::LeaderFailureAction leader_failure_action) {
+    ConfigProto cfg = testConfig();
+    cfg.mutable_coalescing()->set_leader_failure_action(leader_failure_action);
+    cache_ = std::dynamic_pointer_cast<FileSystemHttpCache>(
+        http_cache_factory_->getCache(cacheConfig(cfg), context_));
+  }
+
+  // Starts a lookup for which there is no cache file.
+  LookupContextPtr missingFileLookup(LookupResult& result, bool& end_stream) {
+    auto lookup = testLookupContext();
+    EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, _, _, _));
+    lookup->getHeaders([&result, &end_stream](LookupResult&& r, bool e) {
+      result = std::move(r);
+      end_stream = e;
+    });
+    mock_async_file_manager_->nextActionCompletes(
+        absl::StatusOr<AsyncFileHandle>(absl::NotFoundError("no cache file")));
+    pumpDispatcher();
+    return lookup;
+  }
+};
+
+TEST_F(FileSystemHttpCacheTestWithCoalescing, LookupDuringInsertStreamsTheInsertedResponse) {
+  initCoalescingCache(ConfigProto::Coalescing::CACHE_MISS);
+  LookupResult leader_result, follower_result;
+  bool leader_end_stream, follower_end_stream;
+  auto leader = missingFileLookup(leader_result, leader_end_stream);
+  EXPECT_EQ(leader_result.cache_entry_status_, CacheEntryStatus::Unusable);
+  auto follower = missingFileLookup(follower_result, follower_end_stream);
+  absl::Cleanup destroy_follower([&follower]() { follower->onDestroy(); });
+  // The follower waits for the leader's response instead of missing.
+  EXPECT_EQ(follower_result.headers_, nullptr);
+
+  auto inserter = cache_->makeInsertContext(std::move(leader), encoder_callbacks_);
+  absl::Cleanup destroy_inserter{[&inserter]() { inserter->onDestroy(); }};
+  EXPECT_CALL(*mock_async_file_manager_, createAnonymousFile(_, _, _));
+  inserter->insertHeaders(response_headers_, metadata_, [](bool) {}, false);
+  pumpDispatcher();
+  ASSERT_NE(follower_result.headers_, nullptr);
+  EXPECT_EQ(follower_result.cache_entry_status_, CacheEntryStatus::Ok);
+  EXPECT_EQ(follower_result.headers_->getStatusValue(), "200");
+  EXPECT_FALSE(follower_end_stream);
+  EXPECT_EQ(cache_->stats().cache_miss_.value(), 1);
+  EXPECT_EQ(cache_->stats().cache_coalesced_.value(), 1);
+  EXPECT_EQ(cache_->stats().coalescing_fallbacks_.value(), 0);
+  // The file handle didn't actually get used in this test, but is expected to be closed.
+  EXPECT_OK(mock_async_file_handle_->close(nullptr, [](absl::Status) {}));
+}
+
+TEST_F(FileSystemHttpCacheTestWithCoalescing, LeaderFailureMakesFollowersMiss) {
+  initCoalescingCache(ConfigProto::Coalescing::CACHE_MISS);
+  LookupResult leader_result, follower_result;
+  bool leader_end_stream, follower_end_stream;
+  auto leader = missingFileLookup(leader_result, leader_end_stream);
+  auto follower = missingFileLookup(follower_result, follower_end_stream);
+  absl::Cleanup destroy_follower([&follower]() { follower->onDestroy(); });
+  EXPECT_EQ(follower_result.headers_, nullptr);
+  // The leading request never inserts, e.g. because its response was not cacheable.
+  leader->onDestroy();
+  pumpDispatcher();
+  EXPECT_EQ(follower_result.cache_entry_status_, CacheEntryStatus::Unusable);
+  EXPECT_EQ(cache_->stats().cache_miss_.value(), 2);
+  EXPECT_EQ(cache_->stats().cache_coalesced_.value(), 0);
+  EXPECT_EQ(cache_->stats().coalescing_fallbacks_.value(), 1);
+  // The file handle didn't actually get used in this test, but is expected to be closed.
+  EXPECT_OK(mock_async_file_handle_->close(nullptr, [](absl::Status) {}));
+}
+
+TEST_F(FileSystemHttpCacheTestWithCoalescing, LeaderFailureCanMakeFollowersBypassTheCache) {
+  initCoalescingCache(ConfigProto::Coalescing::BYPASS_CACHE);
+  LookupResult leader_result, follower_result;
+  bool leader_end_stream, follower_end_stream;
+  auto leader = missingFileLookup(leader_result, leader_end_stream);
+  auto follower = missingFileLookup(follower_result, follower_end_stream);
+  absl::Cleanup destroy_follower([&follower]() { follower->onDestroy(); });
+  leader->onDestroy();
+  pumpDispatcher();
+  EXPECT_EQ(follower_result.cache_entry_status_, CacheEntryStatus::LookupError);
+  EXPECT_EQ(cache_->stats().cache_miss_.value(), 1);
+  EXPECT_EQ(cache_->stats().coalescing_fallbacks_.value(), 1);
+  // The file handle didn't actually get used in this test, but is expected to be closed.
+  EXPECT_OK(mock_async_file_handle_->close(nullptr, [](absl::Status) {}));
+}
+
+TEST_F(FileSystemHttpCacheTestWithCoalescing, LookupAfterInsertCompletesDoesNotFollowIt) {
+  initCoalescingCache(ConfigProto::Coalescing::CACHE_MISS);
+  LookupResult leader_result, result;
+  bool leader_end_stream, end_stream;
+  auto leader = missingFileLookup(leader_result, leader_end_stream);
+  leader->onDestroy();
+  // With no insert in progress, this lookup leads a new one and misses straight away.
+  auto lookup = missingFileLookup(result, end_stream);
+  absl::Cleanup destroy_lookup([&lookup]() { lookup->onDestroy(); });
+  EXPECT_EQ(result.cache_entry_status_, CacheEntryStatus::Unusable);
+  EXPECT_EQ(cache_->stats().cache_miss_.value(), 2);
+  EXPECT_EQ(cache_->stats().coalescing_fallbacks_.value(), 0);
+  // The file handle didn't actually get used in this test, but is expected to be closed.
+  EXPECT_OK(mock_async_file_handle_->close(nullptr, [](absl::Status) {}));
+}
+
+TEST_F(FileSystemHttpCacheTestWithCoalescing, FollowerStreamsBodyAndTrailersFromTheLeader) {
+  initCoalescingCache(ConfigProto::Coalescing::CACHE_MISS);
+  LookupResult leader_result, follower_result;
+  bool leader_end_stream, follower_end_stream;
+  auto leader = missingFileLookup(leader_result, leader_end_stream);
+  auto follower = missingFileLookup(follower_result, follower_end_stream);
+  absl::Cleanup destroy_follower([&follower]() { follower->onDestroy(); });
+
+  auto inserter = cache_->makeInsertContext(std::move(leader), encoder_callbacks_);
+  absl::Cleanup destroy_inserter{[&inserter]() { inserter->onDestroy(); }};
+  EXPECT_CALL(*mock_async_file_manager_, createAnonymousFile(_, _, _));
+  EXPECT_CALL(*mock_async_file_handle_, write(_, _, _, _)).Times(4);
+  inserter->insertHeaders(response_headers_, metadata_, expect_true_callback_, false);
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<AsyncFileHandle>(mock_async_file_handle_));
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<size_t>(CacheFileFixedBlock::size()));
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<size_t>(headers_size_));
+  pumpDispatcher();
+  ASSERT_NE(follower_result.headers_, nullptr);
+
+  Buffer::InstancePtr body;
+  bool body_end_stream = true;
+  follower->getBody(AdjustedByteRange(0, std::numeric_limits<uint64_t>::max()),
+                    [&body, &body_end_stream](Buffer::InstancePtr b, bool e) {
+                      body = std::move(b);
+                      body_end_stream = e;
+                    });
+  pumpDispatcher();
+  // Nothing has been published yet, so the follower waits.
+  EXPECT_EQ(body, nullptr);
+  const absl::string_view body_chunk = "woop";
+  inserter->insertBody(Buffer::OwnedImpl(body_chunk), expect_true_callback_, false);
+  pumpDispatcher();
+  ASSERT_NE(body, nullptr);
+  EXPECT_EQ(body->toString(), body_chunk);
+  EXPECT_FALSE(body_end_stream);
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<size_t>(body_chunk.size()));
+  pumpDispatcher();
+
+  Http::ResponseTrailerMapPtr trailers;
+  follower->getTrailers([&trailers](Http::ResponseTrailerMapPtr t) { trailers = std::move(t); });
+  pumpDispatcher();
+  EXPECT_EQ(trailers, nullptr);
+  // The trailers are published before they are written, so the insert can be left in flight.
+  inserter->insertTrailers(response_trailers_, [](bool) {});
+  pumpDispatcher();
+  ASSERT_NE(trailers, nullptr);
+  EXPECT_THAT(*trailers, HeaderMapEqualRef(&response_trailers_));
+  EXPECT_EQ(cache_->stats().cache_coalesced_.value(), 1);
+  EXPECT_EQ(cache_->stats().coalescing_fallbacks_.value(), 0);
+}
+
+TEST_F(FileSystemHttpCacheTestWithCoalescing, LeaderFailureMidBodyResetsFollowerStream) {
+  initCoalescingCache(ConfigProto::Coalescing::CACHE_MISS);
+  LookupResult leader_result, follower_result;
+  bool leader_end_stream, follower_end_stream;
+  auto leader = missingFileLookup(leader_result, leader_end_stream);
+  auto follower = missingFileLookup(follower_result, follower_end_stream);
+  absl::Cleanup destroy_follower([&follower]() { follower->onDestroy(); });
+
+  auto inserter = cache_->makeInsertContext(std::move(leader), encoder_callbacks_);
+  EXPECT_CALL(*mock_async_file_manager_, createAnonymousFile(_, _, _));
+  EXPECT_CALL(*mock_async_file_handle_, write(_, _, _, _)).Times(3);
+  inserter->insertHeaders(response_headers_, metadata_, expect_true_callback_, false);
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<AsyncFileHandle>(mock_async_file_handle_));
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<size_t>(CacheFileFixedBlock::size()));
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<size_t>(headers_size_));
+  pumpDispatcher();
+  ASSERT_NE(follower_result.headers_, nullptr);
+  const absl::string_view body_chunk = "woop";
+  inserter->insertBody(Buffer::OwnedImpl(body_chunk), expect_true_callback_, false);
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<size_t>(body_chunk.size()));
+  pumpDispatcher();
+
+  Buffer::InstancePtr body;
+  follower->getBody(AdjustedByteRange(0, std::numeric_limits<uint64_t>::max()),
+                    [&body](Buffer::InstancePtr b, bool) { body = std::move(b); });
+  pumpDispatcher();
+  ASSERT_NE(body, nullptr);
+  EXPECT_EQ(body->toString(), body_chunk);
+  bool body_callback_called = false;
+  follower->getBody(AdjustedByteRange(body_chunk.size(), std::numeric_limits<uint64_t>::max()),
+                    [&body_callback_called](Buffer::InstancePtr, bool) {
+                      body_callback_called = true;
+                    });
+  pumpDispatcher();
+  EXPECT_FALSE(body_callback_called);
+  // The leading stream goes away part way through the body, so the follower's response can
+  // never be completed.
+  EXPECT_CALL(decoder_callbacks_, resetStream(_, _));
+  inserter->onDestroy();
+  pumpDispatcher();
+  EXPECT_FALSE(body_callback_called);
+}
+
+TEST_F(FileSystemHttpCacheTestWithCoalescing, VaryMismatchMakesFollowerMiss) {
+  initCoalescingCache(ConfigProto::Coalescing::CACHE_MISS);
+  LookupResult leader_result, follower_result;
+  bool leader_end_stream, follower_end_stream;
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/html");
+  auto leader = missingFileLookup(leader_result, leader_end_stream);
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "image/png");
+  auto follower = missingFileLookup(follower_result, follower_end_stream);
+  absl::Cleanup destroy_follower([&follower]() { follower->onDestroy(); });
+  EXPECT_EQ(follower_result.headers_, nullptr);
+
+  auto inserter = cache_->makeInsertContext(std::move(leader), encoder_callbacks_);
+  absl::Cleanup destroy_inserter{[&inserter]() { inserter->onDestroy(); }};
+  response_headers_.setCopy(Http::LowerCaseString("vary"), "accept");
+  // One file created for the vary node, one for the actual write.
+  EXPECT_CALL(*mock_async_file_manager_, createAnonymousFile(_, _, _)).Times(2);
+  inserter->insertHeaders(response_headers_, metadata_, expect_false_callback_, false);
+  pumpDispatcher();
+  // The leader's response varies on a header the follower sent differently, so it can't be
+  // used for the follower.
+  EXPECT_EQ(follower_result.cache_entry_status_, CacheEntryStatus::Unusable);
+  EXPECT_EQ(follower_result.headers_, nullptr);
+  EXPECT_EQ(cache_->stats().cache_miss_.value(), 2);
+  EXPECT_EQ(cache_->stats().cache_coalesced_.value(), 0);
+  EXPECT_EQ(cache_->stats().coalescing_fallbacks_.value(), 1);
+
+  EXPECT_CALL(*mock_async_file_handle_, write(_, _, _, _));
+  // File handle for the vary node.
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<AsyncFileHandle>{mock_async_file_handle_});
+  pumpDispatcher();
+  // Fail to create file for the cache entry node.
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<AsyncFileHandle>{absl::UnknownError("open failure")});
+  pumpDispatcher();
+  // Fail to write for the vary node.
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<size_t>(absl::UnknownError("write failure")));
+  pumpDispatcher();
+}
+
+class FileSystemHttpCacheTestWithMemoryTier : public FileSystemHttpCacheTestWithMockFiles {
+public:
+  void SetUp() override {
+    ConfigProto cfg = testConfig();
+    cfg.mutable_memory_tier()->set_max_size_bytes(1024 * 1024);
+    cfg.mutable_memory_tier()->mutable_promotion_threshold()->set_value(1);
+    cache_ = std::dynamic_pointer_cast<FileSystemHttpCache>(
+        http_cache_factory_->getCache(cacheConfig(cfg), context_));
+  }
+
+  // Reads the whole of an entry with an 8 byte body and no trailers from its cache file.
+  void readEntryFromFile() {
+    trailers_size_ = 0;
+    auto lookup = testLookupContext();
+    EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, _, _, _));
+    EXPECT_CALL(*mock_async_file_handle_, read(_, 0, CacheFileFixedBlock::size(), _));
+    EXPECT_CALL(*mock_async_file_handle_,
+                read(_, CacheFileFixedBlock::offsetToHeaders(), headers_size_, _));
+    lookup->getHeaders([](LookupResult&&, bool) {});
+    mock_async_file_manager_->nextActionCompletes(
+        absl::StatusOr<AsyncFileHandle>(mock_async_file_handle_));
+    pumpDispatcher();
+    mock_async_file_manager_->nextActionCompletes(
+        absl::StatusOr<Buffer::InstancePtr>(testHeaderBlock(8)));
+    pumpDispatcher();
+    mock_async_file_manager_->nextActionCompletes(
+        absl::StatusOr<Buffer::InstancePtr>(testHeaderBuffer()));
+    pumpDispatcher();
+    EXPECT_CALL(*mock_async_file_handle_,
+                read(_, CacheFileFixedBlock::offsetToHeaders() + headers_size_, 8, _));
+    lookup->getBody(AdjustedByteRange(0, 8), [](Buffer::InstancePtr, bool) {});
+    mock_async_file_manager_->nextActionCompletes(
+        absl::StatusOr<Buffer::InstancePtr>(std::make_unique<Buffer::OwnedImpl>("beepboop")));
+    pumpDispatcher();
+    lookup->onDestroy();
+    lookup.reset();
+    // There should be a file-close in the queue.
+    mock_async_file_manager_->nextActionCompletes(absl::OkStatus());
+    pumpDispatcher();
+  }
+};
+
+TEST_F(FileSystemHttpCacheTestWithMemoryTier, EntryReadFromFileIsThenServedFromMemory) {
+  readEntryFromFile();
+  EXPECT_EQ(cache_->stats().cache_hit_file_.value(), 1);
+  EXPECT_EQ(cache_->stats().memory_tier_promotions_.value(), 1);
+  EXPECT_EQ(cache_->stats().memory_tier_size_count_.value(), 1);
+
+  auto lookup = testLookupContext();
+  absl::Cleanup destroy_lookup([&lookup]() { lookup->onDestroy(); });
+  EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, _, _, _)).Times(0);
+  LookupResult result;
+  bool end_stream_after_headers = true;
+  lookup->getHeaders([&](LookupResult&& r, bool es) {
+    result = std::move(r);
+    end_stream_after_headers = es;
+  });
+  // The callback is posted rather than called directly.
+  EXPECT_EQ(result.headers_, nullptr);
+  pumpDispatcher();
+  ASSERT_NE(result.headers_, nullptr);
+  EXPECT_NE(result.cache_entry_status_, CacheEntryStatus::Unusable);
+  EXPECT_EQ(result.headers_->getStatusValue(), "200");
+  EXPECT_EQ(result.content_length_, 8);
+  EXPECT_FALSE(end_stream_after_headers);
+  std::string body;
+  bool end_stream_after_body = false;
+  lookup->getBody(AdjustedByteRange(4, 8), [&](Buffer::InstancePtr b, bool es) {
+    body = b->toString();
+    end_stream_after_body = es;
+  });
+  pumpDispatcher();
+  EXPECT_EQ(body, "boop");
+  EXPECT_TRUE(end_stream_after_body);
+  EXPECT_EQ(cache_->stats().cache_hit_.value(), 2);
+  EXPECT_EQ(cache_->stats().cache_hit_memory_.value(), 1);
+  EXPECT_EQ(cache_->stats().cache_hit_file_.value(), 1);
+}
+
+TEST_F(FileSystemHttpCacheTestWithMemoryTier, UpdateHeadersDropsEntryFromMemory) {
+  readEntryFromFile();
+  EXPECT_EQ(cache_->stats().memory_tier_size_count_.value(), 1);
+  auto lookup_context = testLookupContext();
+  EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, _, _, _));
+  cache_->updateHeaders(*lookup_context, response_headers_, metadata_, [](bool) {});
+  EXPECT_EQ(cache_->stats().memory_tier_size_count_.value(), 0);
+  EXPECT_EQ(cache_->stats().memory_tier_size_bytes_.value(), 0);
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<AsyncFileHandle>(absl::UnknownError("Intentionally failed to open file")));
+  pumpDispatcher();
+  lookup_context->onDestroy();
+}
+
 // For the standard cache tests from http_cache_implementation_test_common.cc
 // These will be run with the real file system, and therefore only cover the
 // "no file errors" paths.
@@ -0,0 +1,184 @@
+#include <string>
+
+#include "source/common/http/header_map_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/http/cache/file_system_http_cache/memory_tier.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+namespace {
+
+using MemoryTierConfig = envoy::extensions::http::cache::file_system_http_cache::v3::
+    FileSystemHttpCacheConfig::MemoryTier;
+
+class MemoryTierTest : public ::testing::Test {
+protected:
+  void init(uint64_t max_size_bytes, uint32_t promotion_threshold) {
+    MemoryTierConfig config;
+    config.set_max_size_bytes(max_size_bytes);
+    config.mutable_max_entry_body_bytes()->set_value(100);
+    config.mutable_promotion_threshold()->set_value(promotion_threshold);
+    memory_tier_ = std::make_unique<MemoryTier>(config, stats_);
+  }
+
+  static Key testKey(absl::string_view path) {
+    Key key;
+    key.set_host("example.com");
+    key.set_path(std::string(path));
+    return key;
+  }
+
+  static MemoryTier::Entry testEntry(absl::string_view body) {
+    return {Http::createHeaderMap<Http::ResponseHeaderMapImpl>(
+                Http::TestResponseHeaderMapImpl{{":status", "200"}}),
+            {}, std::string(body), nullptr};
+  }
+
+  // Promotes an entry as a lookup reading it from its file would.
+  void promote(const Key& key, absl::string_view body) {
+    absl::optional<uint64_t> generation = memory_tier_->recordFileRead(key, body.size());
+    ASSERT_TRUE(generation.has_value());
+    memory_tier_->insert(key, testEntry(body), generation.value());
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  CacheStatNames stat_names_{store_.symbolTable()};
+  CacheStats stats_{generateStats(stat_names_, *store_.rootScope(), "/tmp")};
+  std::unique_ptr<MemoryTier> memory_tier_;
+};
+
+TEST_F(MemoryTierTest, PromotesAfterThresholdFileReads) {
+  init(1024 * 1024, 3);
+  const Key key = testKey("/a");
+  EXPECT_FALSE(memory_tier_->recordFileRead(key, 10).has_value());
+  EXPECT_FALSE(memory_tier_->recordFileRead(key, 10).has_value());
+  EXPECT_TRUE(memory_tier_->recordFileRead(key, 10).has_value());
+  // The count restarts, in case the entry the caller was collecting never gets inserted.
+  EXPECT_FALSE(memory_tier_->recordFileRead(key, 10).has_value());
+}
+
+TEST_F(MemoryTierTest, DoesNotPromoteLargeBodies) {
+  init(1024 * 1024, 1);
+  EXPECT_FALSE(memory_tier_->recordFileRead(testKey("/a"), 101).has_value());
+  EXPECT_TRUE(memory_tier_->recordFileRead(testKey("/a"), 100).has_value());
+}
+
+TEST_F(MemoryTierTest, LookupReturnsInsertedEntry) {
+  init(1024 * 1024, 1);
+  const Key key = testKey("/a");
+  EXPECT_EQ(memory_tier_->lookup(key), nullptr);
+  promote(key, "hello");
+  auto entry = memory_tier_->lookup(key);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->body_, "hello");
+  EXPECT_EQ(entry->headers_->getStatusValue(), "200");
+  EXPECT_EQ(stats_.memory_tier_promotions_.value(), 1);
+  EXPECT_EQ(stats_.memory_tier_size_count_.value(), 1);
+  EXPECT_GT(stats_.memory_tier_size_bytes_.value(), 5);
+  // A promoted entry is not promoted again.
+  EXPECT_FALSE(memory_tier_->recordFileRead(key, 5).has_value());
+}
+
+TEST_F(MemoryTierTest, RemoveDropsEntry) {
+  init(1024 * 1024, 1);
+  const Key key = testKey("/a");
+  promote(key, "hello");
+  auto held = memory_tier_->lookup(key);
+  memory_tier_->remove(key);
+  EXPECT_EQ(memory_tier_->lookup(key), nullptr);
+  EXPECT_EQ(stats_.memory_tier_size_count_.value(), 0);
+  EXPECT_EQ(stats_.memory_tier_size_bytes_.value(), 0);
+  // A lookup which already had the entry can still use it.
+  EXPECT_EQ(held->body_, "hello");
+  memory_tier_->remove(key);
+}
+
+TEST_F(MemoryTierTest, PromotionStartedBeforeRemoveIsDropped) {
+  init(1024 * 1024, 1);
+  const Key key = testKey("/a");
+  absl::optional<uint64_t> generation = memory_tier_->recordFileRead(key, 5);
+  ASSERT_TRUE(generation.has_value());
+  // The cache file is replaced while the lookup is still reading the old one.
+  memory_tier_->remove(key);
+  memory_tier_->insert(key, testEntry("stale"), generation.value());
+  EXPECT_EQ(memory_tier_->lookup(key), nullptr);
+  EXPECT_EQ(stats_.memory_tier_promotions_.value(), 0);
+  // Promotions which start after the removal are unaffected.
+  promote(key, "fresh");
+  auto entry = memory_tier_->lookup(key);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->body_, "fresh");
+}
+
+TEST_F(MemoryTierTest, RemoveOfAnotherKeyDoesNotDropPromotion) {
+  init(1024 * 1024, 1);
+  const Key key = testKey("/a");
+  absl::optional<uint64_t> generation = memory_tier_->recordFileRead(key, 5);
+  ASSERT_TRUE(generation.has_value());
+  memory_tier_->remove(testKey("/b"));
+  memory_tier_->insert(key, testEntry("hello"), generation.value());
+  EXPECT_NE(memory_tier_->lookup(key), nullptr);
+}
+
+TEST_F(MemoryTierTest, RemoveHashDropsEntry) {
+  init(1024 * 1024, 1);
+  const Key key = testKey("/a");
+  promote(key, "hello");
+  absl::optional<uint64_t> generation = memory_tier_->recordFileRead(testKey("/b"), 5);
+  ASSERT_TRUE(generation.has_value());
+  memory_tier_->removeHash(stableHashKey(key));
+  memory_tier_->removeHash(stableHashKey(testKey("/b")));
+  EXPECT_EQ(memory_tier_->lookup(key), nullptr);
+  EXPECT_EQ(stats_.memory_tier_size_count_.value(), 0);
+  EXPECT_EQ(stats_.memory_tier_size_bytes_.value(), 0);
+  // A promotion read from the removed file is dropped too.
+  memory_tier_->insert(testKey("/b"), testEntry("stale"), generation.value());
+  EXPECT_EQ(memory_tier_->lookup(testKey("/b")), nullptr);
+}
+
+TEST_F(MemoryTierTest, EvictsUnreferencedEntriesWhenFull) {
+  init(1024 * 1024, 1);
+  promote(testKey("/a"), "a");
+  const uint64_t entry_size = stats_.memory_tier_size_bytes_.value();
+  // Room for two entries.
+  init(2 * entry_size + 1, 1);
+  promote(testKey("/a"), "a");
+  promote(testKey("/b"), "b");
+  // Using /a makes the hand pass over it, once, and evict /b instead.
+  EXPECT_NE(memory_tier_->lookup(testKey("/a")), nullptr);
+  promote(testKey("/c"), "c");
+  EXPECT_NE(memory_tier_->lookup(testKey("/a")), nullptr);
+  EXPECT_EQ(memory_tier_->lookup(testKey("/b")), nullptr);
+  EXPECT_NE(memory_tier_->lookup(testKey("/c")), nullptr);
+  EXPECT_EQ(stats_.memory_tier_evictions_.value(), 1);
+  EXPECT_EQ(stats_.memory_tier_size_count_.value(), 2);
+  EXPECT_EQ(stats_.memory_tier_size_bytes_.value(), 2 * entry_size);
+  // The lookups above referenced both /a and /c, so the hand clears both bits and then evicts /a,
+  // the first entry it comes back to.
+  promote(testKey("/d"), "d");
+  EXPECT_EQ(memory_tier_->lookup(testKey("/a")), nullptr);
+  EXPECT_NE(memory_tier_->lookup(testKey("/c")), nullptr);
+  EXPECT_NE(memory_tier_->lookup(testKey("/d")), nullptr);
+  EXPECT_EQ(stats_.memory_tier_evictions_.value(), 2);
+}
+
+TEST_F(MemoryTierTest, EntryLargerThanTheTierIsNotInserted) {
+  init(10, 1);
+  promote(testKey("/a"), "a");
+  EXPECT_EQ(memory_tier_->lookup(testKey("/a")), nullptr);
+  EXPECT_EQ(stats_.memory_tier_promotions_.value(), 0);
+}
+
+} // namespace
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
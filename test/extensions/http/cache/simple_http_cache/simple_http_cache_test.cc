@@ -2,6 +2,7 @@
 #include "envoy/registry/registry.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/filters/http/cache/cache_entry_utils.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/http/cache/simple_http_cache/simple_http_cache.h"
@@ -45,6 +46,147 @@ TEST(Registration, GetFactory) {
             "envoy.extensions.http.cache.simple");
 }
 
+TEST(Registration, EquivalentConfigsShareCache) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.http.cache.simple_http_cache.v3.SimpleHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  testing::NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  SimpleHttpCache::ConfigProto cache_config;
+  cache_config.mutable_max_size_bytes()->set_value(1024 * 1024);
+  envoy::extensions::filters::http::cache::v3::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(cache_config);
+
+  std::shared_ptr<HttpCache> cache1 = factory->getCache(config, factory_context);
+  std::shared_ptr<HttpCache> cache2 = factory->getCache(config, factory_context);
+  EXPECT_EQ(cache1, cache2);
+
+  cache_config.set_shard_count(4);
+  config.mutable_typed_config()->PackFrom(cache_config);
+  std::shared_ptr<HttpCache> cache3 = factory->getCache(config, factory_context);
+  EXPECT_NE(cache1, cache3);
+}
+
+class SimpleHttpCacheEvictionTest : public testing::Test {
+protected:
+  // Bodies dominate the entry size, so three entries fit in a shard of this size but four don't.
+  static constexpr size_t BodySize = 10000;
+  static constexpr uint64_t ShardSize = 35000;
+
+  SimpleHttpCache::ConfigProto boundedConfig(uint32_t shard_count = 1) {
+    SimpleHttpCache::ConfigProto config;
+    config.mutable_max_size_bytes()->set_value(ShardSize * shard_count);
+    config.set_shard_count(shard_count);
+    return config;
+  }
+
+  LookupRequest makeLookupRequest(absl::string_view path) {
+    request_headers_.setPath(path);
+    return {request_headers_, time_system_.systemTime(), vary_allow_list_};
+  }
+
+  void insert(SimpleHttpCache& cache, absl::string_view path, size_t body_size = BodySize) {
+    LookupRequest request = makeLookupRequest(path);
+    EXPECT_TRUE(cache.insert(
+        request.key(), Http::createHeaderMap<Http::ResponseHeaderMapImpl>({{":status", "200"}}),
+        {}, std::string(body_size, 'a'), nullptr));
+  }
+
+  bool cached(SimpleHttpCache& cache, absl::string_view path) {
+    return cache.lookup(makeLookupRequest(path)).response_headers_ != nullptr;
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  testing::NiceMock<Server::Configuration::MockServerFactoryContext> factory_context_;
+  Event::SimulatedTimeSystem time_system_;
+  VaryAllowList vary_allow_list_{{}, factory_context_};
+  Http::TestRequestHeaderMapImpl request_headers_{
+      {":path", "/"}, {":method", "GET"}, {":scheme", "https"}, {":authority", "example.com"}};
+};
+
+TEST_F(SimpleHttpCacheEvictionTest, UnboundedCacheNeverEvicts) {
+  SimpleHttpCache cache;
+  for (int i = 0; i < 100; i++) {
+    insert(cache, absl::StrCat("/", i));
+  }
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(cached(cache, absl::StrCat("/", i)));
+  }
+  EXPECT_EQ(0, cache.stats().eviction_.value());
+  EXPECT_EQ(100, cache.stats().entries_.value());
+  EXPECT_EQ(100, cache.stats().hit_.value());
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, EvictsProbationBeforeProtected) {
+  SimpleHttpCache cache(boundedConfig(), *stats_store_.rootScope());
+  insert(cache, "/a");
+  insert(cache, "/b");
+  insert(cache, "/c");
+  EXPECT_EQ(3, cache.stats().entries_.value());
+
+  // A hit promotes /a to the protected segment.
+  EXPECT_TRUE(cached(cache, "/a"));
+
+  // /b is the least recently used probationary entry and is evicted first.
+  insert(cache, "/d");
+  EXPECT_EQ(1, cache.stats().eviction_.value());
+  EXPECT_EQ(3, cache.stats().entries_.value());
+  EXPECT_FALSE(cached(cache, "/b"));
+  EXPECT_TRUE(cached(cache, "/c"));
+  EXPECT_TRUE(cached(cache, "/a"));
+  EXPECT_TRUE(cached(cache, "/d"));
+  EXPECT_EQ(4, cache.stats().hit_.value());
+  EXPECT_EQ(1, cache.stats().miss_.value());
+  EXPECT_LE(cache.stats().size_bytes_.value(), ShardSize);
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, ScanDoesNotFlushProtectedEntries) {
+  SimpleHttpCache cache(boundedConfig(), *stats_store_.rootScope());
+  insert(cache, "/hot");
+  EXPECT_TRUE(cached(cache, "/hot"));
+
+  // A scan of objects requested once only churns the probationary segment.
+  for (int i = 0; i < 20; i++) {
+    insert(cache, absl::StrCat("/scan/", i));
+  }
+  EXPECT_TRUE(cached(cache, "/hot"));
+  EXPECT_TRUE(cached(cache, "/scan/19"));
+  EXPECT_FALSE(cached(cache, "/scan/0"));
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, RejectsEntriesLargerThanShard) {
+  SimpleHttpCache cache(boundedConfig(), *stats_store_.rootScope());
+  insert(cache, "/small");
+  insert(cache, "/large", ShardSize);
+  EXPECT_EQ(1, cache.stats().insert_rejected_.value());
+  EXPECT_FALSE(cached(cache, "/large"));
+  EXPECT_TRUE(cached(cache, "/small"));
+  EXPECT_EQ(1, cache.stats().entries_.value());
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, ReplacingEntryUpdatesSize) {
+  SimpleHttpCache cache(boundedConfig(4), *stats_store_.rootScope());
+  insert(cache, "/a");
+  const uint64_t size_bytes = cache.stats().size_bytes_.value();
+  insert(cache, "/a", 2 * BodySize);
+  EXPECT_EQ(1, cache.stats().entries_.value());
+  EXPECT_EQ(size_bytes + BodySize, cache.stats().size_bytes_.value());
+  EXPECT_EQ(2 * BodySize, cache.lookup(makeLookupRequest("/a")).body_.size());
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, DestroyedCacheRemovesItsEntriesFromSharedGauges) {
+  SimpleHttpCache cache(boundedConfig(4), *stats_store_.rootScope());
+  insert(cache, "/a");
+  const uint64_t size_bytes = cache.stats().size_bytes_.value();
+  {
+    SimpleHttpCache other(boundedConfig(2), *stats_store_.rootScope());
+    insert(other, "/b");
+    insert(other, "/c");
+    EXPECT_EQ(3, cache.stats().entries_.value());
+  }
+  EXPECT_EQ(1, cache.stats().entries_.value());
+  EXPECT_EQ(size_bytes, cache.stats().size_bytes_.value());
+}
+
 } // namespace
 } // namespace Cache
 } // namespace HttpFilters
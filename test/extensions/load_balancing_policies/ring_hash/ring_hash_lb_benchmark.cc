@@ -9,9 +9,11 @@ namespace {
 
 class RingHashTester : public BaseTester {
 public:
-  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
+  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size, bool use_lookup_index = false)
+      : BaseTester(num_hosts) {
     envoy::extensions::load_balancing_policies::ring_hash::v3::RingHash config;
     config.mutable_minimum_ring_size()->set_value(min_ring_size);
+    config.set_use_lookup_index(use_lookup_index);
     ring_hash_lb_ = std::make_unique<RingHashLoadBalancer>(
         priority_set_, stats_, stats_scope_, runtime_, random_, 50, config, hash_policy_);
   }
@@ -87,6 +89,46 @@ BENCHMARK(benchmarkRingHashLoadBalancerChooseHost)
     ->Args({500, 256000, 100000})
     ->Unit(::benchmark::kMillisecond);
 
+// Compares host selection latency and ring memory with and without the lookup index, for ring
+// sizes from 1k to 8M entries. Memory is reported for the whole load balancer, which is dominated
+// by the ring itself.
+void benchmarkRingHashLoadBalancerLookup(::benchmark::State& state) {
+  const uint64_t min_ring_size = state.range(0);
+  const bool use_lookup_index = state.range(1) != 0;
+
+  if (benchmark::skipExpensiveBenchmarks() && min_ring_size > 65536) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  RingHashTester tester(100, min_ring_size, use_lookup_index);
+  const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+  ASSERT_TRUE(tester.ring_hash_lb_->initialize().ok());
+  const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+  LoadBalancerPtr lb = tester.ring_hash_lb_->factory()->create(tester.lb_params_);
+  TestLoadBalancerContext context;
+
+  // Precompute the keys so only host selection is timed. Use enough of them that lookups on the
+  // larger rings are not served from a warm cache.
+  constexpr uint64_t num_keys = 1 << 16;
+  std::vector<uint64_t> keys(num_keys);
+  for (uint64_t i = 0; i < num_keys; i++) {
+    keys[i] = hashInt(i);
+  }
+
+  uint64_t i = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    tester.hash_policy_->hash_key_ = keys[i++ & (num_keys - 1)];
+    ::benchmark::DoNotOptimize(lb->chooseHost(&context).host);
+  }
+
+  state.counters["memory"] = end_mem - start_mem;
+  state.counters["memory_per_entry"] =
+      static_cast<double>(end_mem - start_mem) / tester.ring_hash_lb_->stats().size_.value();
+}
+BENCHMARK(benchmarkRingHashLoadBalancerLookup)
+    ->ArgsProduct({{1024, 16384, 65536, 262144, 1048576, 8388608}, {0, 1}});
+
 void benchmarkRingHashLoadBalancerHostLoss(::benchmark::State& state) {
   const uint64_t num_hosts = state.range(0);
   const uint64_t min_ring_size = state.range(1);
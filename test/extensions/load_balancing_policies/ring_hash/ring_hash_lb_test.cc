@@ -807,6 +807,94 @@ TEST_P(RingHashLoadBalancerTest, HostWeightedLargeRing) {
   EXPECT_EQ(3081, counts[2]); // :92 | ~3000 expected hits
 }
 
+// Same as Basic, but with the lookup index enabled. Host selection must not change.
+TEST_P(RingHashLoadBalancerTest, BasicWithLookupIndex) {
+  hostSet().hosts_ = {
+      makeTestHost(info_, "tcp://127.0.0.1:90"), makeTestHost(info_, "tcp://127.0.0.1:91"),
+      makeTestHost(info_, "tcp://127.0.0.1:92"), makeTestHost(info_, "tcp://127.0.0.1:93"),
+      makeTestHost(info_, "tcp://127.0.0.1:94"), makeTestHost(info_, "tcp://127.0.0.1:95")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_.mutable_minimum_ring_size()->set_value(12);
+  config_.set_use_lookup_index(true);
+
+  init();
+  EXPECT_EQ(12, lb_->stats().size_.value());
+
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+  {
+    TestLoadBalancerContext context(0);
+    EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context).host);
+  }
+  {
+    TestLoadBalancerContext context(std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context).host);
+  }
+  {
+    TestLoadBalancerContext context(833437586790550860);
+    EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context).host);
+  }
+  {
+    TestLoadBalancerContext context(833437586790550861);
+    EXPECT_EQ(hostSet().hosts_[2], lb->chooseHost(&context).host);
+  }
+  {
+    TestLoadBalancerContext context(3551244743356806947);
+    EXPECT_EQ(hostSet().hosts_[5], lb->chooseHost(&context).host);
+  }
+  {
+    TestLoadBalancerContext context(3551244743356806948);
+    EXPECT_EQ(hostSet().hosts_[3], lb->chooseHost(&context).host);
+  }
+  {
+    TestLoadBalancerContext context(16117243373044804889UL);
+    EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context).host);
+  }
+  {
+    TestLoadBalancerContext context(16117243373044804890UL);
+    EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context).host);
+  }
+}
+
+// Host selection with the lookup index must match the binary search for every hash, including
+// hashes that land exactly on, or just past, a ring entry.
+TEST_P(RingHashLoadBalancerTest, LookupIndexMatchesBinarySearch) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", 1),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", 2),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", 3),
+                      makeTestHost(info_, "tcp://127.0.0.1:93", 5)};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_.mutable_minimum_ring_size()->set_value(5000);
+  init();
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+
+  config_.set_use_lookup_index(true);
+  init();
+  LoadBalancerPtr indexed_lb = lb_->factory()->create(lb_params_);
+
+  auto expect_same_host = [&](uint64_t h) {
+    TestLoadBalancerContext context(h);
+    EXPECT_EQ(lb->chooseHost(&context).host, indexed_lb->chooseHost(&context).host) << h;
+  };
+  expect_same_host(0);
+  expect_same_host(std::numeric_limits<uint64_t>::max());
+  for (uint64_t i = 0; i < 10000; ++i) {
+    expect_same_host(i * (std::numeric_limits<uint64_t>::max() / 10000));
+  }
+  // Hash keys are generated the same way the ring is built, so these hit ring entries exactly.
+  for (uint32_t port = 90; port <= 93; ++port) {
+    for (uint32_t i = 0; i < 2500; ++i) {
+      const uint64_t h = HashUtil::xxHash64(absl::StrCat("127.0.0.1:", port, "_", i));
+      expect_same_host(h - 1);
+      expect_same_host(h);
+      expect_same_host(h + 1);
+    }
+  }
+}
+
 // Given locality weights all 0, expect the same behavior as if no hosts were provided at all.
 TEST_P(RingHashLoadBalancerTest, ZeroLocalityWeights) {
   envoy::config::core::v3::Locality zone_a;
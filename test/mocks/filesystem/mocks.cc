@@ -31,6 +31,24 @@ Api::IoCallSizeResult MockFile::write(absl::string_view buffer) {
   return result;
 }
 
+Api::IoCallSizeResult MockFile::writev(absl::Span<const absl::string_view> buffers) {
+  ssize_t total = 0;
+  for (absl::string_view buffer : buffers) {
+    Api::IoCallSizeResult result = write(buffer);
+    if (!result.ok()) {
+      if (total == 0) {
+        return result;
+      }
+      break;
+    }
+    total += result.return_value_;
+    if (result.return_value_ < static_cast<ssize_t>(buffer.size())) {
+      break;
+    }
+  }
+  return {total, Api::IoErrorPtr(nullptr, [](Api::IoError*) { PANIC("reached unexpected code"); })};
+}
+
 Api::IoCallSizeResult MockFile::pread(void* buf, uint64_t count, uint64_t offset) {
   absl::MutexLock lock(mutex_);
   if (!is_open_) {
@@ -42,6 +42,7 @@ MockServerContextConfig::MockServerContextConfig() {
   ON_CALL(*this, alpnProtocols()).WillByDefault(testing::ReturnRef(alpn_));
   ON_CALL(*this, signatureAlgorithms()).WillByDefault(testing::ReturnRef(sigalgs_));
   ON_CALL(*this, sessionTicketKeys()).WillByDefault(testing::ReturnRef(ticket_keys_));
+  ON_CALL(*this, sessionCacheConfig()).WillByDefault(testing::ReturnRef(session_cache_config_));
   ON_CALL(*this, tlsKeyLogLocal()).WillByDefault(testing::ReturnRef(iplist_));
   ON_CALL(*this, tlsKeyLogRemote()).WillByDefault(testing::ReturnRef(iplist_));
   ON_CALL(*this, tlsKeyLogPath()).WillByDefault(testing::ReturnRef(path_));
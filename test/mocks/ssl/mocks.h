@@ -166,6 +166,7 @@ public:
   MOCK_METHOD(const std::vector<SessionTicketKey>&, sessionTicketKeys, (), (const));
   MOCK_METHOD(bool, disableStatelessSessionResumption, (), (const));
   MOCK_METHOD(bool, disableStatefulSessionResumption, (), (const));
+  MOCK_METHOD(const absl::optional<SessionCacheConfig>&, sessionCacheConfig, (), (const));
   MOCK_METHOD(const Network::Address::IpList&, tlsKeyLogLocal, (), (const));
   MOCK_METHOD(const Network::Address::IpList&, tlsKeyLogRemote, (), (const));
   MOCK_METHOD(const std::string&, tlsKeyLogPath, (), (const));
@@ -183,6 +184,7 @@ public:
   Network::Address::IpList iplist_;
   std::string path_;
   std::vector<SessionTicketKey> ticket_keys_;
+  absl::optional<SessionCacheConfig> session_cache_config_;
   std::vector<std::string> server_names_;
 };
 
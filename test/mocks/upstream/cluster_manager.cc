@@ -32,6 +32,7 @@ MockClusterManager::MockClusterManager()
                     OptRef<xds::core::v3::ResourceLocator>,
                     ProtobufMessage::ValidationVisitor&) { return MockOdCdsApiHandle::create(); }));
   ON_CALL(*this, addOrUpdateCluster(_, _, _)).WillByDefault(Return(false));
+  ON_CALL(*this, addOrUpdateClusterWithHash(_, _, _, _)).WillByDefault(Return(false));
   ON_CALL(*this, hasActiveClusters()).WillByDefault(Return(false));
 }
 
@@ -38,6 +38,9 @@ public:
   MOCK_METHOD(absl::StatusOr<bool>, addOrUpdateCluster,
               (const envoy::config::cluster::v3::Cluster& cluster, const std::string& version_info,
                const bool avoid_cds_removal));
+  MOCK_METHOD(absl::StatusOr<bool>, addOrUpdateClusterWithHash,
+              (const envoy::config::cluster::v3::Cluster& cluster, const std::string& version_info,
+               uint64_t config_hash, const bool avoid_cds_removal));
   MOCK_METHOD(void, setPrimaryClustersInitializedCb, (PrimaryClustersReadyCallback));
   MOCK_METHOD(void, setInitializedCb, (InitializationCompleteCallback));
   MOCK_METHOD(absl::Status, initializeSecondaryClusters,
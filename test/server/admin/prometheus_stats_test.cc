@@ -1,4 +1,5 @@
 #include <cmath>
+#include <limits>
 #include <map>
 #include <regex>
 #include <string>
@@ -625,6 +626,180 @@ envoy_invalid_tag_values{tag1="\\",tag2="\n",tag3="\"",text_value="test"} 0
   EXPECT_EQ(expected_output, response.toString());
 }
 
+// Test that rendering through a label cache produces the same output as rendering without it,
+// including after text readout values change.
+TEST_F(PrometheusStatsFormatterTest, LabelCacheOutputMatchesUncached) {
+  Stats::CustomStatNamespacesImpl custom_namespaces;
+
+  addCounter("cluster.upstream_cx_total_count", {{makeStat("cluster"), makeStat("c1")}});
+  addCounter("cluster.upstream_cx_total_count", {{makeStat("cluster"), makeStat("c2")}});
+  addCounter("server.no_tags", {});
+  addGauge("cluster.upstream_cx_total", {{makeStat("cluster"), makeStat("c1")}});
+  addTextReadout("control_plane.identifier", "CP-1", {{makeStat("cluster"), makeStat("c1")}});
+  addTextReadout("no_tags_readout", "value", {});
+  addTextReadout("invalid_tag_values", "test",
+                 {{makeStat("tag1"), makeStat(R"(\)")},
+                  {makeStat("tag2"), makeStat("\n")},
+                  {makeStat("tag3"), makeStat(R"(")")}});
+
+  const auto render_uncached = [&]() {
+    Buffer::OwnedImpl response;
+    PrometheusStatsFormatter::statsAsPrometheusText(counters_, gauges_, histograms_, textReadouts_,
+                                                    endpoints_helper_->cm_, response,
+                                                    StatsParams(), custom_namespaces);
+    return response.toString();
+  };
+
+  PrometheusLabelCache label_cache(*symbol_table_);
+  const StatsParams params;
+  const auto render_cached = [&]() {
+    Http::TestRequestHeaderMapImpl request_headers;
+    Http::TestResponseHeaderMapImpl response_headers;
+    PrometheusStatsFormatter::OutputFormatPtr output_format =
+        PrometheusStatsFormatter::makeOutputFormat(params, request_headers, response_headers,
+                                                   &label_cache);
+    PrometheusStatsRenderer renderer(counters_, gauges_, histograms_, textReadouts_,
+                                     endpoints_helper_->cm_, params, custom_namespaces,
+                                     *output_format);
+    Buffer::OwnedImpl response;
+    EXPECT_FALSE(renderer.nextChunk(response, std::numeric_limits<uint64_t>::max()));
+    EXPECT_EQ(6UL, renderer.metricNameCount());
+    return response.toString();
+  };
+
+  const std::string expected_output = render_uncached();
+  EXPECT_EQ(expected_output, render_cached());
+  EXPECT_EQ(7UL, label_cache.size());
+  EXPECT_EQ(expected_output, render_cached());
+  EXPECT_EQ(7UL, label_cache.size());
+
+  textReadouts_.front()->set("CP-2");
+  const std::string updated_output = render_uncached();
+  EXPECT_NE(expected_output, updated_output);
+  EXPECT_EQ(updated_output, render_cached());
+}
+
+// Test that the label cache drops the entries of metrics which are no longer rendered.
+TEST_F(PrometheusStatsFormatterTest, LabelCacheDropsUnrenderedMetrics) {
+  Stats::CustomStatNamespacesImpl custom_namespaces;
+
+  addCounter("cluster.upstream_cx_total_count", {{makeStat("cluster"), makeStat("c1")}});
+  addCounter("cluster.upstream_cx_total_count", {{makeStat("cluster"), makeStat("c2")}});
+  addGauge("cluster.upstream_cx_total", {{makeStat("cluster"), makeStat("c1")}});
+
+  PrometheusLabelCache label_cache(*symbol_table_);
+  const auto render_cached = [&](const StatsParams& params) {
+    Http::TestRequestHeaderMapImpl request_headers;
+    Http::TestResponseHeaderMapImpl response_headers;
+    PrometheusStatsFormatter::OutputFormatPtr output_format =
+        PrometheusStatsFormatter::makeOutputFormat(params, request_headers, response_headers,
+                                                   &label_cache);
+    PrometheusStatsRenderer renderer(counters_, gauges_, histograms_, textReadouts_,
+                                     endpoints_helper_->cm_, params, custom_namespaces,
+                                     *output_format);
+    Buffer::OwnedImpl response;
+    renderer.nextChunk(response, std::numeric_limits<uint64_t>::max());
+  };
+
+  render_cached(StatsParams());
+  EXPECT_EQ(3UL, label_cache.size());
+
+  // A deleted stat is dropped at the end of the next scrape.
+  counters_.pop_back();
+  render_cached(StatsParams());
+  EXPECT_EQ(2UL, label_cache.size());
+
+  // The protobuf format does not use the cache, and must not drop its entries.
+  StatsParams protobuf_params;
+  Buffer::OwnedImpl parse_buffer;
+  protobuf_params.parse("?prom_protobuf=1", parse_buffer);
+  render_cached(protobuf_params);
+  EXPECT_EQ(2UL, label_cache.size());
+
+  // Scrapes which don't render every metric don't drop the entries of those they skip.
+  for (absl::string_view query : {"?filter=upstream_cx_total_count", "?usedonly", "?hidden=only"}) {
+    StatsParams filtered_params;
+    filtered_params.parse(query, parse_buffer);
+    render_cached(filtered_params);
+    EXPECT_EQ(2UL, label_cache.size()) << query;
+  }
+}
+
+// Test that a scrape which ends while an older one is still rendering doesn't make the older one
+// drop the entries the newer one rendered.
+TEST_F(PrometheusStatsFormatterTest, LabelCacheKeepsEntriesOfOverlappingScrapes) {
+  Stats::CustomStatNamespacesImpl custom_namespaces;
+
+  addCounter("cluster.upstream_cx_total_count", {{makeStat("cluster"), makeStat("c1")}});
+  addGauge("cluster.upstream_cx_total", {{makeStat("cluster"), makeStat("c1")}});
+
+  PrometheusLabelCache label_cache(*symbol_table_);
+  const StatsParams params;
+  Http::TestRequestHeaderMapImpl request_headers;
+  Http::TestResponseHeaderMapImpl response_headers;
+  const auto make_renderer = [&](PrometheusStatsFormatter::OutputFormatPtr& output_format) {
+    output_format = PrometheusStatsFormatter::makeOutputFormat(params, request_headers,
+                                                               response_headers, &label_cache);
+    return std::make_unique<PrometheusStatsRenderer>(counters_, gauges_, histograms_,
+                                                     textReadouts_, endpoints_helper_->cm_, params,
+                                                     custom_namespaces, *output_format);
+  };
+
+  PrometheusStatsFormatter::OutputFormatPtr older_format;
+  auto older = make_renderer(older_format);
+  Buffer::OwnedImpl response;
+  // Renders the counter only.
+  EXPECT_TRUE(older->nextChunk(response, 1));
+  PrometheusStatsFormatter::OutputFormatPtr newer_format;
+  auto newer = make_renderer(newer_format);
+  EXPECT_FALSE(newer->nextChunk(response, std::numeric_limits<uint64_t>::max()));
+  EXPECT_EQ(2UL, label_cache.size());
+  EXPECT_FALSE(older->nextChunk(response, std::numeric_limits<uint64_t>::max()));
+  EXPECT_EQ(2UL, label_cache.size());
+}
+
+// Test that rendering in small chunks produces the same output as rendering at once.
+TEST_F(PrometheusStatsFormatterTest, ChunkedOutputMatchesUnchunked) {
+  Stats::CustomStatNamespacesImpl custom_namespaces;
+
+  addCounter("cluster.upstream_cx_total_count", {{makeStat("cluster"), makeStat("c1")}});
+  addCounter("cluster.upstream_cx_total_count", {{makeStat("cluster"), makeStat("c2")}});
+  addCounter("cluster.upstream_rq_total", {{makeStat("cluster"), makeStat("c1")}});
+  addGauge("cluster.upstream_cx_total", {{makeStat("cluster"), makeStat("c1")}});
+  addTextReadout("control_plane.identifier", "CP-1", {{makeStat("cluster"), makeStat("c1")}});
+  addHistogram(makeHistogram("cluster.test_1.upstream_rq_time",
+                             {{makeStat("key1"), makeStat("value1")}}));
+  addClusterEndpoints("cluster1", 1, {{"a.tag-name", "a.tag-value"}});
+
+  Buffer::OwnedImpl expected_response;
+  const uint64_t size = PrometheusStatsFormatter::statsAsPrometheusText(
+      counters_, gauges_, histograms_, textReadouts_, endpoints_helper_->cm_, expected_response,
+      StatsParams(), custom_namespaces);
+
+  Http::TestRequestHeaderMapImpl request_headers;
+  Http::TestResponseHeaderMapImpl response_headers;
+  const StatsParams params;
+  PrometheusStatsFormatter::OutputFormatPtr output_format =
+      PrometheusStatsFormatter::makeOutputFormat(params, request_headers, response_headers,
+                                                 nullptr);
+  PrometheusStatsRenderer renderer(counters_, gauges_, histograms_, textReadouts_,
+                                   endpoints_helper_->cm_, params, custom_namespaces,
+                                   *output_format);
+  std::string chunked_response;
+  uint64_t num_chunks = 0;
+  bool more = true;
+  while (more) {
+    Buffer::OwnedImpl chunk;
+    more = renderer.nextChunk(chunk, 1);
+    chunked_response += chunk.toString();
+    ++num_chunks;
+  }
+
+  EXPECT_GT(num_chunks, 5);
+  EXPECT_EQ(size, renderer.metricNameCount());
+  EXPECT_EQ(expected_response.toString(), chunked_response);
+}
+
 // Test that output groups all metrics of the same name (with different tags) together,
 // as required by the Prometheus exposition format spec. Additionally, groups of metrics
 // should be sorted by their tags; the format specifies that it is preferred that metrics
@@ -5,6 +5,7 @@
 #include "source/common/http/header_map_impl.h"
 #include "source/common/stats/custom_stat_namespaces_impl.h"
 #include "source/common/stats/thread_local_store.h"
+#include "source/server/admin/prometheus_stats.h"
 #include "source/server/admin/stats_handler.h"
 
 #include "test/benchmark/main.h"
@@ -214,7 +215,38 @@ public:
     return count;
   }
 
+  /**
+   * Issues a prometheus request the way the admin handler streams it, rendering labels through a
+   * label cache kept across calls and draining the output a chunk at a time.
+   */
+  uint64_t prometheusStreamed(const StatsParams& params) {
+    if (label_cache_ == nullptr) {
+      label_cache_ = std::make_unique<PrometheusLabelCache>(store_->symbolTable());
+    }
+    auto request_headers = Http::RequestHeaderMapImpl::create();
+    auto response_headers = Http::ResponseHeaderMapImpl::create();
+    const std::vector<Stats::CounterSharedPtr> counters = store_->counters();
+    const std::vector<Stats::GaugeSharedPtr> gauges = store_->gauges();
+    const std::vector<Stats::ParentHistogramSharedPtr> histograms = store_->histograms();
+    const std::vector<Stats::TextReadoutSharedPtr> text_readouts;
+    PrometheusStatsFormatter::OutputFormatPtr output_format =
+        PrometheusStatsFormatter::makeOutputFormat(params, *request_headers, *response_headers,
+                                                   label_cache_.get());
+    PrometheusStatsRenderer renderer(counters, gauges, histograms, text_readouts, cm_, params,
+                                     custom_namespaces_, *output_format);
+    Buffer::OwnedImpl data;
+    uint64_t count = 0;
+    bool more = true;
+    do {
+      more = renderer.nextChunk(data, StatsRequest::DefaultChunkSize);
+      count += data.length();
+      data.drain(data.length());
+    } while (more);
+    return count;
+  }
+
   std::vector<Stats::ScopeSharedPtr> scopes_;
+  std::unique_ptr<PrometheusLabelCache> label_cache_;
   Envoy::Stats::CustomStatNamespacesImpl custom_namespaces_;
   FastMockClusterManager cm_;
   bool endpoint_stats_initialized_{false};
@@ -385,6 +417,27 @@ BENCHMARK_CAPTURE(BM_AllCountersPrometheus, per_endpoint_stats_disabled, false)
 BENCHMARK_CAPTURE(BM_AllCountersPrometheus, per_endpoint_stats_enabled, true)
     ->Unit(benchmark::kMillisecond);
 
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_AllCountersPrometheusStreamed(benchmark::State& state, bool per_endpoint_stats) {
+  Envoy::Server::StatsHandlerTest& test_context = testContext(per_endpoint_stats);
+  Envoy::Server::StatsParams params;
+  Envoy::Buffer::OwnedImpl response;
+  params.parse("?format=prometheus&type=Counters", response);
+
+  uint64_t count;
+  for (auto _ : state) { // NOLINT
+    count = test_context.prometheusStreamed(params);
+    RELEASE_ASSERT(count > 250 * 1000 * 1000, "expected count > 250M");
+  }
+
+  auto label = absl::StrCat("output per iteration: ", count);
+  state.SetLabel(label);
+}
+BENCHMARK_CAPTURE(BM_AllCountersPrometheusStreamed, per_endpoint_stats_disabled, false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_AllCountersPrometheusStreamed, per_endpoint_stats_enabled, true)
+    ->Unit(benchmark::kMillisecond);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_UsedCountersPrometheus(benchmark::State& state, bool per_endpoint_stats) {
   Envoy::Server::StatsHandlerTest& test_context = testContext(per_endpoint_stats);